@@ -22,6 +22,7 @@
 #include "render/integrator.h"
 #include "render/scene.h"
 #include "render/session.h"
+#include "render/stats.h"
 
 #include "util/util_args.h"
 #include "util/util_foreach.h"
@@ -31,6 +32,8 @@
 #include "util/util_path.h"
 #include "util/util_progress.h"
 #include "util/util_string.h"
+#include "util/util_system.h"
+#include "util/util_thread.h"
 #include "util/util_time.h"
 #include "util/util_transform.h"
 #include "util/util_unique_ptr.h"
@@ -58,6 +61,14 @@ struct Options {
   bool show_help, interactive, pause;
   string output_filepath;
   string output_pass;
+  string profile_json_filepath;
+
+  /* Splitting the frame across worker processes. The coordinator starts the workers with its
+   * own arguments, and each worker renders a share of the tiles. */
+  vector<string> args;
+  int num_workers;
+  int worker_index;
+  string worker_manifest_filepath;
 } options;
 
 static void session_print(const string &str)
@@ -125,12 +136,72 @@ static void scene_init()
   options.scene->camera->compute_auto_viewplane();
 }
 
+static int worker_tile_size()
+{
+  /* Use the largest tiles which still give every worker at least one tile. */
+  int tile_size = 2048;
+  while (tile_size > 8) {
+    const int num_tiles = divide_up(options.width, tile_size) *
+                          divide_up(options.height, tile_size);
+    if (num_tiles >= options.num_workers) {
+      break;
+    }
+    tile_size /= 2;
+  }
+  return tile_size;
+}
+
+static void worker_full_buffer_written(string_view filename)
+{
+  /* Let the coordinator know which file holds the tiles of this worker. */
+  string text(filename);
+  if (!path_write_text(options.worker_manifest_filepath, text)) {
+    fprintf(stderr, "Failed to write worker manifest %s\n",
+            options.worker_manifest_filepath.c_str());
+  }
+}
+
+static void worker_init()
+{
+  options.session_params.tile_split_index = options.worker_index;
+  options.session_params.num_tile_splits = options.num_workers;
+  options.session_params.use_auto_tile = true;
+
+  /* Run workers on separate NUMA nodes when possible, so that the scene and render buffers of a
+   * worker are in memory local to the processors rendering them. */
+  vector<int> nodes;
+  const int num_nodes = system_cpu_num_numa_nodes();
+  for (int node = 0; node < num_nodes; ++node) {
+    if (system_cpu_is_numa_node_available(node)) {
+      nodes.push_back(node);
+    }
+  }
+
+  if (nodes.size() > 1) {
+    const int node_index = options.worker_index % nodes.size();
+    const int node = nodes[node_index];
+    system_cpu_run_thread_on_node(node);
+
+    if (options.session_params.threads == 0) {
+      const int num_node_workers = divide_up(options.num_workers - node_index, nodes.size());
+      options.session_params.threads = max(
+          system_cpu_num_numa_node_processors(node) / num_node_workers, 1);
+    }
+  }
+  else if (options.session_params.threads == 0) {
+    options.session_params.threads = max(system_cpu_thread_count() / options.num_workers, 1);
+  }
+}
+
 static void session_init()
 {
   options.output_pass = "combined";
   options.session = new Session(options.session_params, options.scene_params);
 
-  if (!options.output_filepath.empty()) {
+  if (options.worker_index != -1) {
+    options.session->full_buffer_written_cb = worker_full_buffer_written;
+  }
+  else if (!options.output_filepath.empty()) {
     options.session->set_output_driver(make_unique<OIIOOutputDriver>(
         options.output_filepath, options.output_pass, session_print));
   }
@@ -145,6 +216,10 @@ static void session_init()
   /* load scene */
   scene_init();
 
+  if (options.worker_index != -1 && options.session_params.tile_size == 0) {
+    options.session_params.tile_size = worker_tile_size();
+  }
+
   /* add pass for output. */
   Pass *pass = options.scene->create_node<Pass>();
   pass->set_name(ustring(options.output_pass.c_str()));
@@ -154,9 +229,32 @@ static void session_init()
   options.session->start();
 }
 
+static void session_write_profile_json()
+{
+  /* Workers each write their own report, the coordinator only merges their tiles. */
+  string filepath = options.profile_json_filepath;
+  if (options.worker_index != -1) {
+    filepath += string_printf(".%d", options.worker_index);
+  }
+  else if (options.num_workers > 1) {
+    return;
+  }
+
+  RenderStats stats;
+  options.session->collect_statistics(&stats);
+
+  string report = stats.json_report(path_filename(options.filepath)) + "\n";
+  if (!path_write_text(filepath, report)) {
+    fprintf(stderr, "Failed to write profiling report %s\n", filepath.c_str());
+  }
+}
+
 static void session_exit()
 {
   if (options.session) {
+    if (!options.profile_json_filepath.empty()) {
+      session_write_profile_json();
+    }
     delete options.session;
     options.session = NULL;
   }
@@ -167,6 +265,86 @@ static void session_exit()
   }
 }
 
+static bool coordinator_run()
+{
+  const int num_workers = options.num_workers;
+
+  if (!options.quiet) {
+    printf("Rendering with %d worker processes\n", num_workers);
+  }
+
+  /* Workers report their result through a manifest file, and the tiles are exchanged through the
+   * same on-disk storage which is used for tiled rendering. */
+  vector<string> manifest_filepaths;
+  for (int i = 0; i < num_workers; i++) {
+    manifest_filepaths.push_back(path_temp_get(string_printf(
+        "cycles-worker-%llu-%d.txt", (unsigned long long)system_self_process_id(), i)));
+  }
+
+  vector<int> worker_success(num_workers, 0);
+  vector<unique_ptr<thread>> worker_threads;
+  for (int i = 0; i < num_workers; i++) {
+    vector<string> args = options.args;
+    args.push_back("--worker-index");
+    args.push_back(to_string(i));
+    args.push_back("--worker-manifest");
+    args.push_back(manifest_filepaths[i]);
+
+    worker_threads.push_back(make_unique<thread>(
+        [&worker_success, args, i]() { worker_success[i] = system_call_self(args); }));
+  }
+
+  bool success = true;
+  vector<string> filepaths;
+  for (int i = 0; i < num_workers; i++) {
+    worker_threads[i]->join();
+
+    string filepath;
+    if (!worker_success[i]) {
+      fprintf(stderr, "Worker %d failed to render\n", i);
+      success = false;
+    }
+    else if (path_read_text(manifest_filepaths[i], filepath)) {
+      filepaths.push_back(filepath);
+    }
+    else {
+      /* Workers without tiles to render do not write any file. */
+      VLOG(1) << "Worker " << i << " did not write tiles.";
+    }
+
+    path_remove(manifest_filepaths[i]);
+  }
+
+  if (success && filepaths.empty()) {
+    fprintf(stderr, "No tiles were rendered\n");
+    success = false;
+  }
+
+  if (success) {
+    /* Merge the tiles of all workers and denoise the full frame once. */
+    options.output_pass = "combined";
+    options.session = new Session(options.session_params, options.scene_params);
+    options.session->set_output_driver(make_unique<OIIOOutputDriver>(
+        options.output_filepath, options.output_pass, session_print));
+
+    options.session->process_full_buffer_from_disk(filepaths);
+
+    const string error = options.session->progress.get_error_message();
+    if (!error.empty()) {
+      fprintf(stderr, "%s\n", error.c_str());
+      success = false;
+    }
+
+    session_exit();
+  }
+
+  foreach (const string &filepath, filepaths) {
+    path_remove(filepath);
+  }
+
+  return success;
+}
+
 #ifdef WITH_CYCLES_STANDALONE_GUI
 static void display_info(Progress &progress)
 {
@@ -356,6 +534,12 @@ static void options_parse(int argc, const char **argv)
   options.quiet = false;
   options.session_params.use_auto_tile = false;
   options.session_params.tile_size = 0;
+  options.num_workers = 1;
+  options.worker_index = -1;
+
+  for (int i = 1; i < argc; i++) {
+    options.args.push_back(argv[i]);
+  }
 
   /* device names */
   string device_names = "";
@@ -403,6 +587,10 @@ static void options_parse(int argc, const char **argv)
              "--output %s",
              &options.output_filepath,
              "File path to write output image",
+             "--profile-json %s",
+             &options.profile_json_filepath,
+             "File path to write a JSON report of the render time per kernel stage, shader, "
+             "object and light, and the number of rays traced (CPU only)",
              "--threads %d",
              &options.session_params.threads,
              "CPU Rendering Threads",
@@ -415,6 +603,15 @@ static void options_parse(int argc, const char **argv)
              "--tile-size %d",
              &options.session_params.tile_size,
              "Tile size in pixels",
+             "--workers %d",
+             &options.num_workers,
+             "Number of processes to split rendering of the frame across",
+             "--worker-index %d",
+             &options.worker_index,
+             "Index of the tiles to render, used internally by worker processes",
+             "--worker-manifest %s",
+             &options.worker_manifest_filepath,
+             "File to report the tiles file to, used internally by worker processes",
              "--list-devices",
              &list,
              "List information about all available devices",
@@ -440,6 +637,8 @@ static void options_parse(int argc, const char **argv)
     exit(EXIT_FAILURE);
   }
 
+  options.session_params.use_profiling = !options.profile_json_filepath.empty();
+
   if (debug) {
     util_logging_start();
     util_logging_verbosity_set(verbosity);
@@ -514,6 +713,25 @@ static void options_parse(int argc, const char **argv)
     fprintf(stderr, "No file path specified\n");
     exit(EXIT_FAILURE);
   }
+  else if (options.num_workers < 1) {
+    fprintf(stderr, "Invalid number of workers: %d\n", options.num_workers);
+    exit(EXIT_FAILURE);
+  }
+  else if (options.num_workers > 1 && !options.session_params.background) {
+    fprintf(stderr, "Worker processes are only supported for background rendering\n");
+    exit(EXIT_FAILURE);
+  }
+  else if (options.num_workers > 1 && options.worker_index == -1 &&
+           options.output_filepath.empty()) {
+    fprintf(stderr, "Worker processes require an output file path\n");
+    exit(EXIT_FAILURE);
+  }
+  else if (options.worker_index != -1 &&
+           (options.worker_index >= options.num_workers || options.num_workers == 1 ||
+            options.worker_manifest_filepath.empty())) {
+    fprintf(stderr, "Invalid worker configuration\n");
+    exit(EXIT_FAILURE);
+  }
 }
 
 CCL_NAMESPACE_END
@@ -526,6 +744,13 @@ int main(int argc, const char **argv)
   path_init();
   options_parse(argc, argv);
 
+  if (options.num_workers > 1) {
+    if (options.worker_index == -1) {
+      return coordinator_run() ? 0 : 1;
+    }
+    worker_init();
+  }
+
 #ifdef WITH_CYCLES_STANDALONE_GUI
   if (options.session_params.background) {
 #endif
@@ -26,6 +26,9 @@ def _configure_argument_parser():
     parser.add_argument("--cycles-print-stats",
                         help="Print rendering statistics to stderr",
                         action='store_true')
+    parser.add_argument("--cycles-stats-json",
+                        help="Append a JSON profiling report of every rendered view layer to the given file",
+                        default=None)
     parser.add_argument("--cycles-device",
                         help="Set the device to use for Cycles, overriding user preferences and the scene setting."
                              "Valid options are 'CPU', 'CUDA', 'OPTIX', or 'HIP'"
@@ -48,6 +51,10 @@ def _parse_command_line():
         import _cycles
         _cycles.enable_print_stats()
 
+    if args.cycles_stats_json:
+        import _cycles
+        _cycles.set_stats_json_filepath(args.cycles_stats_json)
+
     if args.cycles_device:
         import _cycles
         _cycles.set_device_override(args.cycles_device)
@@ -52,6 +52,7 @@ enum_displacement_methods = (
 
 enum_bvh_layouts = (
     ('BVH2', "BVH2", "", 1),
+    ('BVH4', "BVH4", "", 2),
     ('EMBREE', "Embree", "", 4),
 )
 
@@ -276,6 +277,11 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_denoising_input_passes,
         default='RGB_ALBEDO_NORMAL',
     )
+    denoising_use_async: BoolProperty(
+        name="Denoise Progressive Updates",
+        description="Denoise progressive updates of the render result in the background on a few of the CPU threads, while the other threads keep rendering. Only used by OpenImageDenoise when rendering on the CPU",
+        default=False,
+    )
 
     use_preview_denoising: BoolProperty(
         name="Use Viewport Denoising",
@@ -306,6 +312,11 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         min=0, max=(1 << 24),
         default=1,
     )
+    preview_denoising_use_async: BoolProperty(
+        name="Viewport Denoising in Background",
+        description="Denoise viewport updates in the background on a few of the CPU threads, while the other threads keep rendering. Only used by OpenImageDenoise when rendering on the CPU",
+        default=False,
+    )
 
     samples: IntProperty(
         name="Samples",
@@ -351,6 +362,12 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         min=0.0, max=1.0,
         default=0.01,
     )
+    use_light_tree: BoolProperty(
+        name="Light Tree",
+        description="Sample lights and emissive objects by their estimated contribution to the shading point, "
+        "using a hierarchy of lights. Reduces noise in scenes with many lights, at a small cost per sample",
+        default=False,
+    )
 
     use_adaptive_sampling: BoolProperty(
         name="Use Adaptive Sampling",
@@ -750,6 +767,19 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         min=8, max=16384,
     )
 
+    use_texture_cache: BoolProperty(
+        name="Texture Cache",
+        description="Load image textures on demand in tiles and mipmap levels when rendering on the CPU, keeping only the parts that are used within the cache size. Works best with tiled and mipmapped .tx or EXR files",
+        default=False,
+    )
+    texture_cache_size: IntProperty(
+        name="Cache Size",
+        default=4096,
+        description="Maximum memory used for image textures loaded through the texture cache, in megabytes",
+        min=64, max=1048576,
+        subtype='UNSIGNED',
+    )
+
     # Various fine-tuning debug flags
 
     def _devices_update_callback(self, context):
@@ -767,6 +797,21 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_bvh_layouts,
         default='EMBREE',
     )
+    debug_use_cpu_wavefront: BoolProperty(
+        name="Wavefront",
+        description="Render paths in batches one kernel at a time, sorted by shader, instead of tracing each path to completion",
+        default=False,
+    )
+    debug_use_cpu_numa: BoolProperty(
+        name="NUMA",
+        description="Render with threads of each NUMA node working on their own pixels, using a copy of the scene data in the memory of the node",
+        default=False,
+    )
+    debug_use_cpu_svm_specialization: BoolProperty(
+        name="SVM Specialization",
+        description="Evaluate surface shaders made of common nodes with a specialized shader interpreter",
+        default=True,
+    )
 
     debug_use_cuda_adaptive_compile: BoolProperty(name="Adaptive Compile", default=False)
 
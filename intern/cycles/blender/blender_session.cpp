@@ -53,6 +53,7 @@ CCL_NAMESPACE_BEGIN
 DeviceTypeMask BlenderSession::device_override = DEVICE_MASK_ALL;
 bool BlenderSession::headless = false;
 bool BlenderSession::print_render_stats = false;
+string BlenderSession::stats_json_filepath;
 
 BlenderSession::BlenderSession(BL::RenderEngine &b_engine,
                                BL::Preferences &b_userpref,
@@ -297,6 +298,19 @@ static void add_cryptomatte_layer(BL::RenderResult &b_rr, string name, string ma
   render_add_metadata(b_rr, prefix + "manifest", manifest);
 }
 
+void BlenderSession::write_render_stats_json(const string &report)
+{
+  /* One report per line, so that multiple frames and view layers can be appended to the same
+   * file, also from multiple render processes. */
+  FILE *f = path_fopen(stats_json_filepath, "a");
+  if (f == NULL) {
+    fprintf(stderr, "Failed to write render statistics to %s\n", stats_json_filepath.c_str());
+    return;
+  }
+  fprintf(f, "%s\n", report.c_str());
+  fclose(f);
+}
+
 void BlenderSession::stamp_view_layer_metadata(Scene *scene, const string &view_layer_name)
 {
   BL::RenderResult b_rr = b_engine.get_result();
@@ -440,17 +454,29 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
     session->reset(effective_session_params, buffer_params);
 
     /* render */
-    if (!b_engine.is_preview() && background && print_render_stats) {
+    if (!b_engine.is_preview() && background && use_render_stats()) {
       scene->enable_update_stats();
     }
 
     session->start();
     session->wait();
 
-    if (!b_engine.is_preview() && background && print_render_stats) {
+    if (!b_engine.is_preview() && background && use_render_stats()) {
       RenderStats stats;
       session->collect_statistics(&stats);
-      printf("Render statistics:\n%s\n", stats.full_report().c_str());
+      if (print_render_stats) {
+        printf("Render statistics:\n%s\n", stats.full_report().c_str());
+      }
+      if (!stats_json_filepath.empty()) {
+        string name = string_printf("%s/%s/%d",
+                                    b_scene.name().c_str(),
+                                    b_view_layer.name().c_str(),
+                                    b_scene.frame_current());
+        if (num_views > 1) {
+          name += "/" + b_rview_name;
+        }
+        write_render_stats_json(stats.json_report(name));
+      }
     }
 
     if (session->progress.get_cancel())
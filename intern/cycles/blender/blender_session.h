@@ -130,9 +130,20 @@ class BlenderSession {
 
   static bool print_render_stats;
 
+  /* File to append a JSON profiling report of every rendered view layer to. */
+  static string stats_json_filepath;
+
+  /* Whether render statistics are printed or written to a file. */
+  static bool use_render_stats()
+  {
+    return print_render_stats || !stats_json_filepath.empty();
+  }
+
  protected:
   void stamp_view_layer_metadata(Scene *scene, const string &view_layer_name);
 
+  void write_render_stats_json(const string &report);
+
   /* Check whether session error happened.
    * If so, it is reported to the render engine and true is returned.
    * Otherwise false is returned. */
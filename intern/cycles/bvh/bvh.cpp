@@ -18,6 +18,7 @@
 #include "bvh/bvh.h"
 
 #include "bvh/bvh2.h"
+#include "bvh/bvh4.h"
 #include "bvh/bvh_embree.h"
 #include "bvh/bvh_multi.h"
 #include "bvh/bvh_optix.h"
@@ -36,6 +37,8 @@ const char *bvh_layout_name(BVHLayout layout)
       return "NONE";
     case BVH_LAYOUT_BVH2:
       return "BVH2";
+    case BVH_LAYOUT_BVH4:
+      return "BVH4";
     case BVH_LAYOUT_EMBREE:
       return "EMBREE";
     case BVH_LAYOUT_OPTIX:
@@ -90,6 +93,8 @@ BVH *BVH::create(const BVHParams &params,
   switch (params.bvh_layout) {
     case BVH_LAYOUT_BVH2:
       return new BVH2(params, geometry, objects);
+    case BVH_LAYOUT_BVH4:
+      return new BVH4(params, geometry, objects);
     case BVH_LAYOUT_EMBREE:
 #ifdef WITH_EMBREE
       return new BVHEmbree(params, geometry, objects);
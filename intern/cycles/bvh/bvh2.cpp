@@ -42,7 +42,7 @@ int BVHStackEntry::encodeIdx() const
 BVH2::BVH2(const BVHParams &params_,
            const vector<Geometry *> &geometry_,
            const vector<Object *> &objects_)
-    : BVH(params_, geometry_, objects_)
+    : BVH(params_, geometry_, objects_), num_top_level_prims(0)
 {
 }
 
@@ -101,7 +101,15 @@ void BVH2::build(Progress &progress, Stats *)
 void BVH2::refit(Progress &progress)
 {
   progress.set_substatus("Packing BVH primitives");
-  pack_primitives();
+  if (params.top_level) {
+    /* Primitive indices were already offset when merging instances, and the instanced geometry
+     * BVHs need to be merged again after they were refitted. */
+    refit_top_level_primitives();
+    refit_instances();
+  }
+  else {
+    pack_primitives();
+  }
 
   if (progress.get_cancel())
     return;
@@ -315,8 +323,6 @@ void BVH2::pack_nodes(const BVHNode *root)
 
 void BVH2::refit_nodes()
 {
-  assert(!params.top_level);
-
   BoundBox bbox = BoundBox::empty;
   uint visibility = 0;
   refit_node(0, (pack.root_index == -1) ? true : false, bbox, visibility);
@@ -331,7 +337,13 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     const int c0 = data[0].x;
     const int c1 = data[0].y;
 
-    refit_primitives(c0, c1, bbox, visibility);
+    if (c0 < 0) {
+      /* Object instance in the top level BVH. */
+      refit_primitives(~c0, ~c0 + 1, bbox, visibility);
+    }
+    else {
+      refit_primitives(c0, c1, bbox, visibility);
+    }
 
     /* TODO(sergey): De-duplicate with pack_leaf(). */
     float4 leaf_data[BVH_NODE_LEAF_SIZE];
@@ -516,9 +528,12 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
   size_t prim_offset = pack.prim_index.size();
   size_t nodes_offset = nodes_size;
   size_t nodes_leaf_offset = leaf_nodes_size;
+  num_top_level_prims = prim_offset;
 
   /* clear array that gives the node indexes for instanced objects */
   pack.object_node.clear();
+  object_geometry.clear();
+  instance_offsets.clear();
 
   /* reserve */
   size_t prim_index_size = pack.prim_index.size();
@@ -570,6 +585,7 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
   /* merge */
   foreach (Object *ob, objects) {
     Geometry *geom = ob->get_geometry();
+    object_geometry.push_back(geom);
 
     /* We assume that if mesh doesn't need own BVH it was already included
      * into a top-level BVH and no packing here is needed.
@@ -603,6 +619,15 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
 
     geometry_map[geom] = pack.object_node[object_offset - 1];
 
+    InstanceOffset &instance_offset = instance_offsets[geom];
+    instance_offset.nodes = pack_nodes_offset;
+    instance_offset.leaf_nodes = pack_leaf_nodes_offset;
+    instance_offset.prim = prim_offset;
+    instance_offset.prim_tri_verts = pack_prim_tri_verts_offset;
+    instance_offset.nodes_size = bvh->pack.nodes.size();
+    instance_offset.leaf_nodes_size = bvh->pack.leaf_nodes.size();
+    instance_offset.prim_size = bvh->pack.prim_index.size();
+
     /* merge primitive, object and triangle indexes */
     if (bvh->pack.prim_index.size()) {
       size_t bvh_prim_index_size = bvh->pack.prim_index.size();
@@ -644,58 +669,170 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
 
     /* merge nodes */
     if (bvh->pack.leaf_nodes.size()) {
-      int4 *leaf_nodes_offset = &bvh->pack.leaf_nodes[0];
-      size_t leaf_nodes_offset_size = bvh->pack.leaf_nodes.size();
-      for (size_t i = 0, j = 0; i < leaf_nodes_offset_size; i += BVH_NODE_LEAF_SIZE, j++) {
-        int4 data = leaf_nodes_offset[i];
-        data.x += prim_offset;
-        data.y += prim_offset;
-        pack_leaf_nodes[pack_leaf_nodes_offset] = data;
-        for (int j = 1; j < BVH_NODE_LEAF_SIZE; ++j) {
-          pack_leaf_nodes[pack_leaf_nodes_offset + j] = leaf_nodes_offset[i + j];
-        }
-        pack_leaf_nodes_offset += BVH_NODE_LEAF_SIZE;
-      }
+      pack_instance_leaf_nodes(bvh, pack_leaf_nodes + pack_leaf_nodes_offset, prim_offset);
+      pack_leaf_nodes_offset += bvh->pack.leaf_nodes.size();
     }
 
     if (bvh->pack.nodes.size()) {
-      int4 *bvh_nodes = &bvh->pack.nodes[0];
-      size_t bvh_nodes_size = bvh->pack.nodes.size();
-
-      for (size_t i = 0, j = 0; i < bvh_nodes_size; j++) {
-        size_t nsize, nsize_bbox;
-        if (bvh_nodes[i].x & PATH_RAY_NODE_UNALIGNED) {
-          nsize = BVH_UNALIGNED_NODE_SIZE;
-          nsize_bbox = 0;
-        }
-        else {
-          nsize = BVH_NODE_SIZE;
-          nsize_bbox = 0;
-        }
+      pack_instance_nodes(bvh, pack_nodes + pack_nodes_offset, noffset, noffset_leaf);
+      pack_nodes_offset += bvh->pack.nodes.size();
+    }
+
+    nodes_offset += bvh->pack.nodes.size();
+    nodes_leaf_offset += bvh->pack.leaf_nodes.size();
+    prim_offset += bvh->pack.prim_index.size();
+  }
+}
+
+void BVH2::pack_instance_leaf_nodes(const BVH2 *bvh, int4 *pack_leaf_nodes, int prim_offset)
+{
+  const int4 *leaf_nodes = &bvh->pack.leaf_nodes[0];
+  const size_t leaf_nodes_size = bvh->pack.leaf_nodes.size();
+
+  for (size_t i = 0; i < leaf_nodes_size; i += BVH_NODE_LEAF_SIZE) {
+    int4 data = leaf_nodes[i];
+    data.x += prim_offset;
+    data.y += prim_offset;
+    pack_leaf_nodes[i] = data;
+    for (int j = 1; j < BVH_NODE_LEAF_SIZE; ++j) {
+      pack_leaf_nodes[i + j] = leaf_nodes[i + j];
+    }
+  }
+}
+
+void BVH2::pack_instance_nodes(const BVH2 *bvh, int4 *pack_nodes, int noffset, int noffset_leaf)
+{
+  const int4 *bvh_nodes = &bvh->pack.nodes[0];
+  const size_t bvh_nodes_size = bvh->pack.nodes.size();
+  size_t pack_nodes_offset = 0;
+
+  for (size_t i = 0, j = 0; i < bvh_nodes_size; j++) {
+    size_t nsize, nsize_bbox;
+    if (bvh_nodes[i].x & PATH_RAY_NODE_UNALIGNED) {
+      nsize = BVH_UNALIGNED_NODE_SIZE;
+      nsize_bbox = 0;
+    }
+    else {
+      nsize = BVH_NODE_SIZE;
+      nsize_bbox = 0;
+    }
+
+    memcpy(pack_nodes + pack_nodes_offset, bvh_nodes + i, nsize_bbox * sizeof(int4));
+
+    /* Modify offsets into arrays */
+    int4 data = bvh_nodes[i + nsize_bbox];
+    data.z += (data.z < 0) ? -noffset_leaf : noffset;
+    data.w += (data.w < 0) ? -noffset_leaf : noffset;
+    pack_nodes[pack_nodes_offset + nsize_bbox] = data;
+
+    /* Usually this copies nothing, but we better
+     * be prepared for possible node size extension.
+     */
+    memcpy(&pack_nodes[pack_nodes_offset + nsize_bbox + 1],
+           &bvh_nodes[i + nsize_bbox + 1],
+           sizeof(int4) * (nsize - (nsize_bbox + 1)));
 
-        memcpy(pack_nodes + pack_nodes_offset, bvh_nodes + i, nsize_bbox * sizeof(int4));
+    pack_nodes_offset += nsize;
+    i += nsize;
+  }
+}
 
-        /* Modify offsets into arrays */
-        int4 data = bvh_nodes[i + nsize_bbox];
-        data.z += (data.z < 0) ? -noffset_leaf : noffset;
-        data.w += (data.w < 0) ? -noffset_leaf : noffset;
-        pack_nodes[pack_nodes_offset + nsize_bbox] = data;
+/* Refit Top Level */
+
+bool BVH2::can_refit_top_level(const vector<Object *> &objects_) const
+{
+  if (!params.top_level || objects_.size() != object_geometry.size()) {
+    return false;
+  }
 
-        /* Usually this copies nothing, but we better
-         * be prepared for possible node size extension.
-         */
-        memcpy(&pack_nodes[pack_nodes_offset + nsize_bbox + 1],
-               &bvh_nodes[i + nsize_bbox + 1],
-               sizeof(int4) * (nsize - (nsize_bbox + 1)));
+  for (size_t i = 0; i < objects_.size(); i++) {
+    Geometry *geom = objects_[i]->get_geometry();
+    if (geom != object_geometry[i]) {
+      return false;
+    }
 
-        pack_nodes_offset += nsize;
-        i += nsize;
+    /* Geometry must still be either instanced or part of the top level BVH, and instanced
+     * geometry BVHs must have the same size to fit in place. */
+    const unordered_map<Geometry *, InstanceOffset>::const_iterator it = instance_offsets.find(
+        geom);
+    if (!geom->need_build_bvh(params.bvh_layout)) {
+      if (it != instance_offsets.end()) {
+        return false;
       }
+      continue;
     }
 
-    nodes_offset += bvh->pack.nodes.size();
-    nodes_leaf_offset += bvh->pack.leaf_nodes.size();
-    prim_offset += bvh->pack.prim_index.size();
+    if (it == instance_offsets.end() || geom->bvh == NULL) {
+      return false;
+    }
+
+    const BVH2 *bvh = static_cast<const BVH2 *>(geom->bvh);
+    const InstanceOffset &instance_offset = it->second;
+    if (bvh->pack.nodes.size() != instance_offset.nodes_size ||
+        bvh->pack.leaf_nodes.size() != instance_offset.leaf_nodes_size ||
+        bvh->pack.prim_index.size() != instance_offset.prim_size) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void BVH2::refit_top_level_primitives()
+{
+  for (size_t i = 0; i < num_top_level_prims; i++) {
+    const int pidx = pack.prim_index[i];
+    if (pidx == -1) {
+      continue;
+    }
+
+    const Object *ob = objects[pack.prim_object[i]];
+    pack.prim_visibility[i] = ob->visibility_for_tracing();
+
+    if ((pack.prim_type[i] & PRIMITIVE_ALL_TRIANGLE) != 0) {
+      const Mesh *mesh = static_cast<const Mesh *>(ob->get_geometry());
+      const Mesh::Triangle t = mesh->get_triangle(pidx - mesh->prim_offset);
+      const float3 *vpos = &mesh->verts[0];
+      float4 *tri_verts = &pack.prim_tri_verts[pack.prim_tri_index[i]];
+
+      tri_verts[0] = float3_to_float4(vpos[t.v[0]]);
+      tri_verts[1] = float3_to_float4(vpos[t.v[1]]);
+      tri_verts[2] = float3_to_float4(vpos[t.v[2]]);
+    }
+  }
+}
+
+void BVH2::refit_instances()
+{
+  /* Copy the refitted BVHs of modified geometry in place, unmodified geometry is still the
+   * same as when it was merged. */
+  foreach (Geometry *geom, geometry) {
+    const unordered_map<Geometry *, InstanceOffset>::const_iterator it = instance_offsets.find(
+        geom);
+    if (it == instance_offsets.end() || !geom->is_modified()) {
+      continue;
+    }
+
+    const BVH2 *bvh = static_cast<const BVH2 *>(geom->bvh);
+    const InstanceOffset &instance_offset = it->second;
+
+    if (bvh->pack.nodes.size()) {
+      pack_instance_nodes(bvh,
+                          &pack.nodes[instance_offset.nodes],
+                          instance_offset.nodes,
+                          instance_offset.leaf_nodes);
+    }
+
+    if (bvh->pack.leaf_nodes.size()) {
+      pack_instance_leaf_nodes(
+          bvh, &pack.leaf_nodes[instance_offset.leaf_nodes], instance_offset.prim);
+    }
+
+    if (bvh->pack.prim_tri_verts.size()) {
+      memcpy(&pack.prim_tri_verts[instance_offset.prim_tri_verts],
+             &bvh->pack.prim_tri_verts[0],
+             bvh->pack.prim_tri_verts.size() * sizeof(float4));
+    }
   }
 }
 
@@ -21,6 +21,7 @@
 #include "bvh/bvh.h"
 #include "bvh/bvh_params.h"
 
+#include "util/util_map.h"
 #include "util/util_types.h"
 #include "util/util_vector.h"
 
@@ -48,9 +49,31 @@ class BVH2 : public BVH {
   void build(Progress &progress, Stats *stats);
   void refit(Progress &progress);
 
+  /* Check whether the top level BVH still has the same instances as when it was built, so it
+   * can be refitted instead of built again. */
+  bool can_refit_top_level(const vector<Object *> &objects) const;
+
   PackedBVH pack;
 
  protected:
+  /* Location of an instanced geometry BVH merged into the top level BVH. */
+  struct InstanceOffset {
+    size_t nodes;
+    size_t leaf_nodes;
+    size_t prim;
+    size_t prim_tri_verts;
+    size_t nodes_size;
+    size_t leaf_nodes_size;
+    size_t prim_size;
+  };
+
+  /* Geometry of every object, and where instanced geometry BVHs are in the top level BVH. */
+  vector<Geometry *> object_geometry;
+  unordered_map<Geometry *, InstanceOffset> instance_offsets;
+
+  /* Number of primitives of the top level BVH, before the merged instance primitives. */
+  size_t num_top_level_prims;
+
   /* constructor */
   friend class BVH;
   BVH2(const BVHParams &params,
@@ -61,7 +84,7 @@ class BVH2 : public BVH {
   virtual BVHNode *widen_children_nodes(const BVHNode *root);
 
   /* pack */
-  void pack_nodes(const BVHNode *root);
+  virtual void pack_nodes(const BVHNode *root);
 
   void pack_leaf(const BVHStackEntry &e, const LeafNode *leaf);
   void pack_inner(const BVHStackEntry &e, const BVHStackEntry &e0, const BVHStackEntry &e1);
@@ -91,7 +114,7 @@ class BVH2 : public BVH {
                            uint visibility1);
 
   /* refit */
-  void refit_nodes();
+  virtual void refit_nodes();
   void refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility);
 
   /* Refit range of primitives. */
@@ -101,8 +124,17 @@ class BVH2 : public BVH {
   void pack_primitives();
   void pack_triangle(int idx, float4 storage[3]);
 
+  /* Update primitives of a top level BVH for refit. */
+  void refit_top_level_primitives();
+
   /* merge instance BVH's */
   void pack_instances(size_t nodes_size, size_t leaf_nodes_size);
+  void pack_instance_leaf_nodes(const BVH2 *bvh, int4 *pack_leaf_nodes, int prim_offset);
+  void refit_instances();
+  virtual void pack_instance_nodes(const BVH2 *bvh,
+                                   int4 *pack_nodes,
+                                   int noffset,
+                                   int noffset_leaf);
 };
 
 CCL_NAMESPACE_END
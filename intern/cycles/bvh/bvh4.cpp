@@ -0,0 +1,259 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bvh/bvh4.h"
+
+#include "bvh/bvh_node.h"
+
+CCL_NAMESPACE_BEGIN
+
+BVH4::BVH4(const BVHParams &params_,
+           const vector<Geometry *> &geometry_,
+           const vector<Object *> &objects_)
+    : BVH2(params_, geometry_, objects_)
+{
+  /* The SSE traversal only intersects axis aligned bounds. */
+  params.use_unaligned_nodes = false;
+}
+
+/* Building process. */
+
+static BVHNode *bvh4_node_merge_children_recursively(const BVHNode *node)
+{
+  if (node->is_leaf()) {
+    return new LeafNode(*reinterpret_cast<const LeafNode *>(node));
+  }
+
+  /* Pull up grandchildren in place of the child with the largest surface area, until the node
+   * is full or only leaves are left. Opening the largest child first gives the four children
+   * that overlap the least, so rays visit fewer of them. */
+  assert(node->num_children() == 2);
+  const BVHNode *children[BVH4_NUM_CHILDREN] = {node->get_child(0), node->get_child(1)};
+  int num_children = 2;
+
+  while (num_children < BVH4_NUM_CHILDREN) {
+    int best_child = -1;
+    float best_area = -FLT_MAX;
+    for (int i = 0; i < num_children; i++) {
+      if (!children[i]->is_leaf() && children[i]->bounds.safe_area() > best_area) {
+        best_child = i;
+        best_area = children[i]->bounds.safe_area();
+      }
+    }
+
+    if (best_child == -1) {
+      break;
+    }
+
+    const BVHNode *child = children[best_child];
+    children[best_child] = child->get_child(0);
+    children[num_children++] = child->get_child(1);
+  }
+
+  BVHNode *children4[BVH4_NUM_CHILDREN];
+  for (int i = 0; i < num_children; i++) {
+    children4[i] = bvh4_node_merge_children_recursively(children[i]);
+  }
+
+  return new InnerNode(node->bounds, children4, num_children);
+}
+
+BVHNode *BVH4::widen_children_nodes(const BVHNode *root)
+{
+  if (root == NULL || root->is_leaf()) {
+    return const_cast<BVHNode *>(root);
+  }
+  return bvh4_node_merge_children_recursively(root);
+}
+
+/* Pack */
+
+void BVH4::pack_inner(const BVHStackEntry &e, const BVHStackEntry *children, int num_children)
+{
+  BoundBox bounds[BVH4_NUM_CHILDREN];
+  int child[BVH4_NUM_CHILDREN];
+  uint visibility[BVH4_NUM_CHILDREN];
+
+  for (int i = 0; i < BVH4_NUM_CHILDREN; i++) {
+    if (i < num_children) {
+      bounds[i] = children[i].node->bounds;
+      child[i] = children[i].encodeIdx();
+      visibility[i] = children[i].node->visibility;
+    }
+    else {
+      /* Empty child, with inverted bounds so that rays never intersect it. The root is never a
+       * child, which leaves index zero to mark empty children. */
+      bounds[i] = BoundBox::empty;
+      child[i] = 0;
+      visibility[i] = 0;
+    }
+  }
+
+  pack_node(e.idx, bounds, child, visibility);
+}
+
+void BVH4::pack_node(int idx, const BoundBox *bounds, const int *child, const uint *visibility)
+{
+  assert(idx + BVH4_NODE_SIZE <= pack.nodes.size());
+
+  int4 data[BVH4_NODE_SIZE];
+  for (int i = 0; i < BVH4_NUM_CHILDREN; i++) {
+    assert(child[i] < 0 || child[i] < pack.nodes.size());
+
+    data[0][i] = visibility[i] & ~PATH_RAY_NODE_UNALIGNED;
+    data[1][i] = __float_as_int(bounds[i].min.x);
+    data[2][i] = __float_as_int(bounds[i].max.x);
+    data[3][i] = __float_as_int(bounds[i].min.y);
+    data[4][i] = __float_as_int(bounds[i].max.y);
+    data[5][i] = __float_as_int(bounds[i].min.z);
+    data[6][i] = __float_as_int(bounds[i].max.z);
+    data[7][i] = child[i];
+  }
+
+  memcpy(&pack.nodes[idx], data, sizeof(int4) * BVH4_NODE_SIZE);
+}
+
+void BVH4::pack_nodes(const BVHNode *root)
+{
+  const size_t num_nodes = root->getSubtreeSize(BVH_STAT_NODE_COUNT);
+  const size_t num_leaf_nodes = root->getSubtreeSize(BVH_STAT_LEAF_COUNT);
+  assert(num_leaf_nodes <= num_nodes);
+  const size_t num_inner_nodes = num_nodes - num_leaf_nodes;
+  const size_t node_size = num_inner_nodes * BVH4_NODE_SIZE;
+
+  /* Resize arrays */
+  pack.nodes.clear();
+  pack.leaf_nodes.clear();
+  /* For top level BVH, first merge existing BVH's so we know the offsets. */
+  if (params.top_level) {
+    pack_instances(node_size, num_leaf_nodes * BVH_NODE_LEAF_SIZE);
+  }
+  else {
+    pack.nodes.resize(node_size);
+    pack.leaf_nodes.resize(num_leaf_nodes * BVH_NODE_LEAF_SIZE);
+  }
+
+  int nextNodeIdx = 0, nextLeafNodeIdx = 0;
+
+  vector<BVHStackEntry> stack;
+  stack.reserve(BVHParams::MAX_DEPTH * 2);
+  if (root->is_leaf()) {
+    stack.push_back(BVHStackEntry(root, nextLeafNodeIdx++));
+  }
+  else {
+    stack.push_back(BVHStackEntry(root, nextNodeIdx));
+    nextNodeIdx += BVH4_NODE_SIZE;
+  }
+
+  while (stack.size()) {
+    BVHStackEntry e = stack.back();
+    stack.pop_back();
+
+    if (e.node->is_leaf()) {
+      /* leaf node */
+      const LeafNode *leaf = reinterpret_cast<const LeafNode *>(e.node);
+      pack_leaf(e, leaf);
+    }
+    else {
+      /* inner node */
+      const int num_children = e.node->num_children();
+      BVHStackEntry children[BVH4_NUM_CHILDREN];
+      for (int i = 0; i < num_children; ++i) {
+        const BVHNode *child = e.node->get_child(i);
+        if (child->is_leaf()) {
+          children[i] = BVHStackEntry(child, nextLeafNodeIdx++);
+        }
+        else {
+          children[i] = BVHStackEntry(child, nextNodeIdx);
+          nextNodeIdx += BVH4_NODE_SIZE;
+        }
+        stack.push_back(children[i]);
+      }
+
+      pack_inner(e, children, num_children);
+    }
+  }
+  assert(node_size == nextNodeIdx);
+  /* root index to start traversal at, to handle case of single leaf node */
+  pack.root_index = (root->is_leaf()) ? -1 : 0;
+}
+
+/* Refit */
+
+void BVH4::refit_nodes()
+{
+  BoundBox bbox = BoundBox::empty;
+  uint visibility = 0;
+  refit_node(0, (pack.root_index == -1) ? true : false, bbox, visibility);
+}
+
+void BVH4::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
+{
+  if (leaf) {
+    /* Leaf nodes are the same as BVH2. */
+    BVH2::refit_node(idx, true, bbox, visibility);
+    return;
+  }
+
+  assert(idx + BVH4_NODE_SIZE <= pack.nodes.size());
+
+  const int4 data = pack.nodes[idx + BVH4_NODE_SIZE - 1];
+  BoundBox child_bbox[BVH4_NUM_CHILDREN];
+  int child[BVH4_NUM_CHILDREN];
+  uint child_visibility[BVH4_NUM_CHILDREN];
+
+  /* Refit inner node, set bbox from children. */
+  for (int i = 0; i < BVH4_NUM_CHILDREN; i++) {
+    const int c = data[i];
+    child[i] = c;
+    child_bbox[i] = BoundBox::empty;
+    child_visibility[i] = 0;
+
+    /* The root is never a child, so a zero index is an empty child. */
+    if (c == 0) {
+      continue;
+    }
+
+    refit_node((c < 0) ? -c - 1 : c, (c < 0), child_bbox[i], child_visibility[i]);
+
+    bbox.grow(child_bbox[i]);
+    visibility |= child_visibility[i];
+  }
+
+  pack_node(idx, child_bbox, child, child_visibility);
+}
+
+/* Pack Instances */
+
+void BVH4::pack_instance_nodes(const BVH2 *bvh, int4 *pack_nodes, int noffset, int noffset_leaf)
+{
+  const int4 *bvh_nodes = &bvh->pack.nodes[0];
+  const size_t bvh_nodes_size = bvh->pack.nodes.size();
+
+  memcpy(pack_nodes, bvh_nodes, sizeof(int4) * bvh_nodes_size);
+
+  /* Modify offsets into arrays, the child indices are in the last row of every node. */
+  for (size_t i = BVH4_NODE_SIZE - 1; i < bvh_nodes_size; i += BVH4_NODE_SIZE) {
+    int4 &data = pack_nodes[i];
+    for (int j = 0; j < BVH4_NUM_CHILDREN; j++) {
+      if (data[j] != 0) {
+        data[j] += (data[j] < 0) ? -noffset_leaf : noffset;
+      }
+    }
+  }
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __BVH4_H__
+#define __BVH4_H__
+
+#include "bvh/bvh2.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Inner node of four children: visibility, then minimum and maximum of each axis, and child
+ * indices, each row holding the values of all four children. */
+#define BVH4_NODE_SIZE 8
+#define BVH4_NUM_CHILDREN 4
+
+/* BVH4
+ *
+ * BVH with up to four children per inner node, collapsed from the binary BVH so that the CPU
+ * kernel can intersect all children of a node at once with SSE. Leaf nodes and primitives are
+ * packed the same as BVH2.
+ */
+class BVH4 : public BVH2 {
+ protected:
+  /* constructor */
+  friend class BVH;
+  BVH4(const BVHParams &params,
+       const vector<Geometry *> &geometry,
+       const vector<Object *> &objects);
+
+  /* Building process. */
+  BVHNode *widen_children_nodes(const BVHNode *root) override;
+
+  /* pack */
+  void pack_nodes(const BVHNode *root) override;
+  void pack_inner(const BVHStackEntry &e, const BVHStackEntry *children, int num_children);
+  void pack_node(int idx, const BoundBox *bounds, const int *child, const uint *visibility);
+
+  /* refit */
+  void refit_nodes() override;
+  void refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility);
+
+  /* merge instance BVH's */
+  void pack_instance_nodes(const BVH2 *bvh,
+                           int4 *pack_nodes,
+                           int noffset,
+                           int noffset_leaf) override;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __BVH4_H__ */
@@ -82,6 +82,7 @@ CPUDevice::CPUDevice(const DeviceInfo &info_, Stats &stats_, Profiler &profiler_
   embree_device = rtcNewDevice("verbose=0");
 #endif
   need_texture_info = false;
+  need_numa_replicas_update = true;
 }
 
 CPUDevice::~CPUDevice()
@@ -90,6 +91,10 @@ CPUDevice::~CPUDevice()
   rtcReleaseDevice(embree_device);
 #endif
 
+  for (auto &it : numa_replicas) {
+    numa_replica_free(it.second);
+  }
+
   texture_info.free();
 }
 
@@ -101,6 +106,9 @@ bool CPUDevice::show_samples() const
 BVHLayoutMask CPUDevice::get_bvh_layout_mask() const
 {
   BVHLayoutMask bvh_layout_mask = BVH_LAYOUT_BVH2;
+#ifdef __KERNEL_SSE2__
+  bvh_layout_mask |= BVH_LAYOUT_BVH4;
+#endif
 #ifdef WITH_EMBREE
   bvh_layout_mask |= BVH_LAYOUT_EMBREE;
 #endif /* WITH_EMBREE */
@@ -233,6 +241,8 @@ void CPUDevice::global_alloc(device_memory &mem)
   mem.device_pointer = (device_ptr)mem.host_pointer;
   mem.device_size = mem.memory_size();
   stats.mem_alloc(mem.device_size);
+
+  need_numa_replicas_update = true;
 }
 
 void CPUDevice::global_free(device_memory &mem)
@@ -241,6 +251,8 @@ void CPUDevice::global_free(device_memory &mem)
     mem.device_pointer = 0;
     stats.mem_free(mem.device_size);
     mem.device_size = 0;
+
+    need_numa_replicas_update = true;
   }
 }
 
@@ -315,6 +327,91 @@ void CPUDevice::get_cpu_kernel_thread_globals(
   }
 }
 
+void CPUDevice::get_cpu_kernel_thread_globals(
+    vector<CPUKernelThreadGlobals> &kernel_thread_globals, int numa_node, int num_threads)
+{
+  /* Ensure latest texture info is loaded into kernel globals before replicating it. */
+  load_texture_info();
+
+  if (need_numa_replicas_update) {
+    for (auto &it : numa_replicas) {
+      numa_replica_free(it.second);
+    }
+    numa_replicas.clear();
+    need_numa_replicas_update = false;
+  }
+
+  if (numa_replicas.find(numa_node) == numa_replicas.end()) {
+    numa_replica_update(numa_node);
+  }
+
+  /* Use the latest constant data, and the global memory of the replica. */
+  const NUMAReplica &replica = numa_replicas[numa_node];
+  KernelGlobals node_kernel_globals = kernel_globals;
+#define KERNEL_TEX(type, name) node_kernel_globals.name = replica.kernel_globals.name;
+#include "kernel/kernel_textures.h"
+
+  kernel_thread_globals.clear();
+  void *osl_memory = get_cpu_osl_memory();
+  for (int i = 0; i < num_threads; i++) {
+    kernel_thread_globals.emplace_back(node_kernel_globals, osl_memory, profiler);
+  }
+}
+
+template<typename T>
+static size_t numa_texture_replicate(const texture<T> &tex,
+                                     texture<T> &replica_tex,
+                                     int numa_node,
+                                     vector<pair<void *, size_t>> &allocations)
+{
+  replica_tex = tex;
+
+  if (tex.data == nullptr || tex.width == 0) {
+    return 0;
+  }
+
+  const size_t size = sizeof(T) * tex.width;
+  void *data = system_cpu_numa_node_alloc(size, numa_node);
+  if (data == nullptr) {
+    /* Keep reading from the original memory. */
+    return 0;
+  }
+
+  memcpy(data, tex.data, size);
+  replica_tex.data = (T *)data;
+  allocations.emplace_back(data, size);
+
+  return size;
+}
+
+void CPUDevice::numa_replica_update(int numa_node)
+{
+  NUMAReplica &replica = numa_replicas[numa_node];
+  numa_replica_free(replica);
+
+  /* Image textures are referenced from the texture info and stay shared between nodes, the
+   * global memory with the BVH, geometry, shaders and lights is copied. */
+  size_t replica_size = 0;
+#define KERNEL_TEX(type, name) \
+  replica_size += numa_texture_replicate( \
+      kernel_globals.name, replica.kernel_globals.name, numa_node, replica.allocations);
+#include "kernel/kernel_textures.h"
+
+  stats.mem_alloc(replica_size);
+
+  VLOG(1) << "Replicated " << string_human_readable_size(replica_size)
+          << " of scene data in memory of NUMA node " << numa_node << ".";
+}
+
+void CPUDevice::numa_replica_free(NUMAReplica &replica)
+{
+  for (const pair<void *, size_t> &allocation : replica.allocations) {
+    system_cpu_numa_node_free(allocation.first, allocation.second);
+    stats.mem_free(allocation.second);
+  }
+  replica.allocations.clear();
+}
+
 void *CPUDevice::get_cpu_osl_memory()
 {
 #ifdef WITH_OSL
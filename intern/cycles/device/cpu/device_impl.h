@@ -31,6 +31,8 @@
 #include "device/device.h"
 #include "device/device_memory.h"
 
+#include "util/util_map.h"
+
 // clang-format off
 #include "kernel/device/cpu/compat.h"
 #include "kernel/device/cpu/kernel.h"
@@ -59,6 +61,15 @@ class CPUDevice : public Device {
 
   CPUKernels kernels;
 
+  /* Copies of the global memory in the memory of NUMA nodes, so that threads running on a node
+   * read scene data from local memory. Updated lazily whenever global memory changes. */
+  struct NUMAReplica {
+    KernelGlobals kernel_globals;
+    vector<pair<void *, size_t>> allocations;
+  };
+  map<int, NUMAReplica> numa_replicas;
+  bool need_numa_replicas_update;
+
   CPUDevice(const DeviceInfo &info_, Stats &stats_, Profiler &profiler_);
   ~CPUDevice();
 
@@ -93,10 +104,16 @@ class CPUDevice : public Device {
   virtual const CPUKernels *get_cpu_kernels() const override;
   virtual void get_cpu_kernel_thread_globals(
       vector<CPUKernelThreadGlobals> &kernel_thread_globals) override;
+  virtual void get_cpu_kernel_thread_globals(vector<CPUKernelThreadGlobals> &kernel_thread_globals,
+                                             int numa_node,
+                                             int num_threads) override;
   virtual void *get_cpu_osl_memory() override;
 
  protected:
   virtual bool load_kernels(uint /*kernel_features*/) override;
+
+  void numa_replica_update(int numa_node);
+  void numa_replica_free(NUMAReplica &replica);
 };
 
 CCL_NAMESPACE_END
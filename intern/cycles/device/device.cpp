@@ -58,7 +58,7 @@ Device::~Device() noexcept(false)
 
 void Device::build_bvh(BVH *bvh, Progress &progress, bool refit)
 {
-  assert(bvh->params.bvh_layout == BVH_LAYOUT_BVH2);
+  assert(bvh->params.bvh_layout == BVH_LAYOUT_BVH2 || bvh->params.bvh_layout == BVH_LAYOUT_BVH4);
 
   BVH2 *const bvh2 = static_cast<BVH2 *>(bvh);
   if (refit) {
@@ -377,6 +377,14 @@ void Device::get_cpu_kernel_thread_globals(
   LOG(FATAL) << "Device does not support CPU kernels.";
 }
 
+void Device::get_cpu_kernel_thread_globals(
+    vector<CPUKernelThreadGlobals> & /*kernel_thread_globals*/,
+    int /*numa_node*/,
+    int /*num_threads*/)
+{
+  LOG(FATAL) << "Device does not support CPU kernels.";
+}
+
 void *Device::get_cpu_osl_memory()
 {
   return nullptr;
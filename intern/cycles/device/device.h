@@ -184,6 +184,12 @@ class Device {
   /* Get kernel globals to pass to kernels. */
   virtual void get_cpu_kernel_thread_globals(
       vector<CPUKernelThreadGlobals> & /*kernel_thread_globals*/);
+  /* Get kernel globals for the given number of threads running on a NUMA node. The globals read
+   * scene data from a copy in the memory of that node. */
+  virtual void get_cpu_kernel_thread_globals(
+      vector<CPUKernelThreadGlobals> & /*kernel_thread_globals*/,
+      int /*numa_node*/,
+      int /*num_threads*/);
   /* Get OpenShadingLanguage memory buffer. */
   virtual void *get_cpu_osl_memory();
 
@@ -78,6 +78,8 @@ NODE_DEFINE(DenoiseParams)
 
   SOCKET_ENUM(prefilter, "Prefilter", *prefilter_enum, DENOISER_PREFILTER_FAST);
 
+  SOCKET_BOOLEAN(use_async, "Use Async", false);
+
   return type;
 }
 
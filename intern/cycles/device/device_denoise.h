@@ -74,6 +74,10 @@ class DenoiseParams : public Node {
 
   DenoiserPrefilter prefilter = DENOISER_PREFILTER_FAST;
 
+  /* Denoise progressive updates in the background, on a snapshot of the render buffers, while
+   * path tracing carries on. The final result is always denoised synchronously. */
+  bool use_async = false;
+
   static const NodeEnum *get_type_enum();
   static const NodeEnum *get_prefilter_enum();
 
@@ -83,7 +87,8 @@ class DenoiseParams : public Node {
   {
     return !(use == other.use && type == other.type && start_sample == other.start_sample &&
              use_pass_albedo == other.use_pass_albedo &&
-             use_pass_normal == other.use_pass_normal && prefilter == other.prefilter);
+             use_pass_normal == other.use_pass_normal && prefilter == other.prefilter &&
+             use_async == other.use_async);
   }
 };
 
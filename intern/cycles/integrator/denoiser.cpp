@@ -71,6 +71,11 @@ const DenoiseParams &Denoiser::get_params() const
   return params_;
 }
 
+void Denoiser::set_num_threads(int num_threads)
+{
+  num_threads_ = num_threads;
+}
+
 bool Denoiser::load_kernels(Progress *progress)
 {
   const Device *denoiser_device = ensure_denoiser_device(progress);
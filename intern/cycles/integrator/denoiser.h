@@ -52,6 +52,10 @@ class Denoiser {
   void set_params(const DenoiseParams &params);
   const DenoiseParams &get_params() const;
 
+  /* Limit number of threads used by denoisers which run on the CPU, leaving the other threads for
+   * path tracing. Zero means all threads are used. */
+  void set_num_threads(int num_threads);
+
   /* Create devices and load kernels needed for denoising.
    * The progress is used to communicate state when kernels actually needs to be loaded.
    *
@@ -122,6 +126,8 @@ class Denoiser {
   Device *path_trace_device_;
   DenoiseParams params_;
 
+  int num_threads_ = 0;
+
   /* Cached pointer to the device on which denoising will happen.
    * Used to avoid lookup of a device for every denoising request. */
   Device *denoiser_device_ = nullptr;
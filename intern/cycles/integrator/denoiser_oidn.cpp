@@ -112,13 +112,15 @@ class OIDNDenoiseContext {
                      const BufferParams &buffer_params,
                      RenderBuffers *render_buffers,
                      const int num_samples,
-                     const bool allow_inplace_modification)
+                     const bool allow_inplace_modification,
+                     const int num_threads)
       : denoiser_(denoiser),
         denoise_params_(denoise_params),
         buffer_params_(buffer_params),
         render_buffers_(render_buffers),
         num_samples_(num_samples),
         allow_inplace_modification_(allow_inplace_modification),
+        num_threads_(num_threads),
         pass_sample_count_(buffer_params_.get_pass_offset(PASS_SAMPLE_COUNT))
   {
     if (denoise_params_.use_pass_albedo) {
@@ -169,6 +171,9 @@ class OIDNDenoiseContext {
     OIDNPass oidn_color_access_pass = read_input_pass(oidn_color_pass, oidn_output_pass);
 
     oidn::DeviceRef oidn_device = oidn::newDevice();
+    if (num_threads_ > 0) {
+      oidn_device.set("numThreads", num_threads_);
+    }
     oidn_device.commit();
 
     /* Create a filter for denoising a beauty (color) image using prefiltered auxiliary images too.
@@ -529,6 +534,7 @@ class OIDNDenoiseContext {
   RenderBuffers *render_buffers_ = nullptr;
   int num_samples_ = 0;
   bool allow_inplace_modification_ = false;
+  int num_threads_ = 0;
   int pass_sample_count_ = PASS_UNUSED;
 
   /* Optional albedo and normal passes, reused by denoising of different pass types. */
@@ -587,8 +593,13 @@ bool OIDNDenoiser::denoise_buffer(const BufferParams &buffer_params,
   copy_render_buffers_from_device(queue, render_buffers);
 
 #ifdef WITH_OPENIMAGEDENOISE
-  OIDNDenoiseContext context(
-      this, params_, buffer_params, render_buffers, num_samples, allow_inplace_modification);
+  OIDNDenoiseContext context(this,
+                             params_,
+                             buffer_params,
+                             render_buffers,
+                             num_samples,
+                             allow_inplace_modification,
+                             num_threads_);
 
   if (context.need_denoising()) {
     context.read_guiding_passes();
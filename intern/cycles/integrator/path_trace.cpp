@@ -28,6 +28,7 @@
 #include "util/util_algorithm.h"
 #include "util/util_logging.h"
 #include "util/util_progress.h"
+#include "util/util_system.h"
 #include "util/util_tbb.h"
 #include "util/util_time.h"
 
@@ -67,6 +68,8 @@ PathTrace::PathTrace(Device *device,
 
 PathTrace::~PathTrace()
 {
+  denoise_async_cancel();
+
   /* Destroy any GPU resource which was used for graphics interop.
    * Need to have access to the PathTraceDisplay as it is the only source of drawing context which
    * is used for interop. */
@@ -134,6 +137,9 @@ void PathTrace::reset(const BufferParams &full_params, const BufferParams &big_t
   render_state_.has_denoised_result = false;
   render_state_.tile_written = false;
 
+  /* Snapshot which is being denoised in the background belongs to the previous render. */
+  denoise_async_cancel();
+
   did_draw_after_reset_ = false;
 }
 
@@ -207,11 +213,15 @@ void PathTrace::render_pipeline(RenderWork render_work)
     return;
   }
 
+  denoise_async_merge_if_finished();
+
   denoise(render_work);
   if (render_cancel_.is_requested) {
     return;
   }
 
+  denoise_async_rescale_result();
+
   write_tile_buffer(render_work);
   update_display(render_work);
 
@@ -353,11 +363,18 @@ void PathTrace::path_trace(RenderWork &render_work)
 
   const int num_works = path_trace_works_.size();
 
+  /* Leave threads to the denoiser while it works on a snapshot in the background. */
+  const int num_reserved_cpu_threads = (denoise_async_.denoise_thread &&
+                                        !denoise_async_.is_finished) ?
+                                           denoise_async_.num_threads :
+                                           0;
+
   tbb::parallel_for(0, num_works, [&](int i) {
     const double work_start_time = time_dt();
     const int num_samples = render_work.path_trace.num_samples;
 
     PathTraceWork *path_trace_work = path_trace_works_[i].get();
+    path_trace_work->set_num_reserved_cpu_threads(num_reserved_cpu_threads);
 
     PathTraceWork::RenderStatistics statistics;
     path_trace_work->render_samples(statistics, render_work.path_trace.start_sample, num_samples);
@@ -443,7 +460,18 @@ void PathTrace::adaptive_sample(RenderWork &render_work)
 
 void PathTrace::set_denoiser_params(const DenoiseParams &params)
 {
-  render_scheduler_.set_denoiser_params(params);
+  /* Let the scheduler schedule progressive updates of the render result as regular denoising work
+   * when it can not happen in the background. */
+  DenoiseParams scheduler_params = params;
+  scheduler_params.use_async &= is_denoise_async_supported(params);
+  render_scheduler_.set_denoiser_params(scheduler_params);
+
+  if (denoiser_ && !denoiser_->get_params().modified(params)) {
+    return;
+  }
+
+  /* The denoiser is not to be modified while it is used in the background. */
+  denoise_async_cancel();
 
   if (!params.use) {
     denoiser_.reset();
@@ -459,7 +487,9 @@ void PathTrace::set_denoiser_params(const DenoiseParams &params)
   }
 
   denoiser_ = Denoiser::create(device_, params);
-  denoiser_->is_cancelled_cb = [this]() { return is_cancel_requested(); };
+  denoiser_->is_cancelled_cb = [this]() {
+    return is_cancel_requested() || denoise_async_.is_cancel_requested;
+  };
 }
 
 void PathTrace::set_adaptive_sampling(const AdaptiveSampling &adaptive_sampling)
@@ -490,6 +520,14 @@ void PathTrace::denoise(const RenderWork &render_work)
     return;
   }
 
+  if (render_work.tile.denoise_async) {
+    denoise_async_start(render_work);
+    return;
+  }
+
+  /* Result of an earlier snapshot is outdated by the denoising of the current state. */
+  denoise_async_cancel();
+
   VLOG(3) << "Perform denoising work.";
 
   const double start_time = time_dt();
@@ -536,6 +574,141 @@ void PathTrace::denoise(const RenderWork &render_work)
   render_scheduler_.report_denoise_time(render_work, time_dt() - start_time);
 }
 
+bool PathTrace::is_denoise_async_supported(const DenoiseParams &params) const
+{
+  /* The denoiser shares CPU threads with path tracing, and reads the snapshot from the host
+   * memory. */
+  return params.type == DENOISER_OPENIMAGEDENOISE && device_->info.type == DEVICE_CPU;
+}
+
+void PathTrace::denoise_async_start(const RenderWork &render_work)
+{
+  if (denoise_async_.denoise_thread) {
+    /* Rather than stalling path tracing skip the work, and let the next work denoise a more
+     * recent snapshot. */
+    VLOG(3) << "Skip denoising work, previous snapshot is still being denoised.";
+    return;
+  }
+
+  VLOG(3) << "Perform asynchronous denoising work.";
+
+  const double start_time = time_dt();
+
+  denoise_async_.buffer_params = render_state_.effective_big_tile_params;
+  denoise_async_.render_buffers = make_unique<RenderBuffers>(cpu_device_.get());
+  denoise_async_.render_buffers->reset(denoise_async_.buffer_params);
+  copy_to_render_buffers(denoise_async_.render_buffers.get());
+
+  denoise_async_.num_samples = get_num_samples_in_buffer();
+  denoise_async_.is_finished = false;
+  denoise_async_.is_denoised = false;
+
+  const int num_threads = (device_->info.cpu_threads) ? device_->info.cpu_threads :
+                                                        system_cpu_thread_count();
+  denoise_async_.num_threads = max(num_threads / 4, 1);
+  denoiser_->set_num_threads(denoise_async_.num_threads);
+
+  denoise_async_.denoise_thread = make_unique<thread>([this]() {
+    denoise_async_.is_denoised = denoiser_->denoise_buffer(denoise_async_.buffer_params,
+                                                           denoise_async_.render_buffers.get(),
+                                                           denoise_async_.num_samples,
+                                                           true);
+    denoise_async_.is_finished = true;
+  });
+
+  /* Only the snapshot stalls path tracing, which is what the scheduler is to account for. */
+  render_scheduler_.report_denoise_time(render_work, time_dt() - start_time);
+}
+
+void PathTrace::denoise_async_merge_if_finished()
+{
+  if (!denoise_async_.denoise_thread || !denoise_async_.is_finished) {
+    return;
+  }
+
+  denoise_async_join();
+
+  unique_ptr<RenderBuffers> render_buffers = std::move(denoise_async_.render_buffers);
+
+  if (!denoise_async_.is_denoised) {
+    return;
+  }
+
+  /* Resolution divider might have changed since the snapshot was taken. */
+  if (denoise_async_.buffer_params.modified(render_state_.effective_big_tile_params)) {
+    VLOG(3) << "Discard denoised snapshot of different buffer parameters.";
+    return;
+  }
+
+  VLOG(3) << "Use denoised snapshot of " << denoise_async_.num_samples << " samples.";
+
+  denoise_async_.result_render_buffers = std::move(render_buffers);
+  denoise_async_.result_buffer_params = denoise_async_.buffer_params;
+  denoise_async_.result_num_samples = denoise_async_.num_samples;
+  denoise_async_copy_result();
+
+  render_state_.has_denoised_result = true;
+}
+
+void PathTrace::denoise_async_rescale_result()
+{
+  if (!denoise_async_.result_render_buffers) {
+    return;
+  }
+
+  /* Resolution divider might have changed since the result was merged. */
+  if (denoise_async_.result_buffer_params.modified(render_state_.effective_big_tile_params)) {
+    denoise_async_.result_render_buffers.reset();
+    return;
+  }
+
+  /* Path tracing of every work adds samples to the noisy passes, while the denoised passes stay
+   * scaled to the number of samples they were copied at. */
+  if (denoise_async_.result_scaled_num_samples != get_num_samples_in_buffer()) {
+    denoise_async_copy_result();
+  }
+}
+
+void PathTrace::denoise_async_copy_result()
+{
+  const int num_samples = get_num_samples_in_buffer();
+  tbb::parallel_for_each(path_trace_works_, [&](unique_ptr<PathTraceWork> &path_trace_work) {
+    path_trace_work->copy_from_denoised_render_buffers(denoise_async_.result_render_buffers.get(),
+                                                       denoise_async_.result_num_samples,
+                                                       num_samples);
+  });
+  denoise_async_.result_scaled_num_samples = num_samples;
+}
+
+void PathTrace::denoise_async_join()
+{
+  if (!denoise_async_.denoise_thread) {
+    return;
+  }
+
+  denoise_async_.denoise_thread->join();
+  denoise_async_.denoise_thread.reset();
+
+  if (denoiser_) {
+    denoiser_->set_num_threads(0);
+  }
+}
+
+void PathTrace::denoise_async_cancel()
+{
+  denoise_async_.result_render_buffers.reset();
+
+  if (!denoise_async_.denoise_thread) {
+    return;
+  }
+
+  denoise_async_.is_cancel_requested = true;
+  denoise_async_join();
+  denoise_async_.is_cancel_requested = false;
+
+  denoise_async_.render_buffers.reset();
+}
+
 void PathTrace::set_output_driver(unique_ptr<OutputDriver> driver)
 {
   output_driver_ = move(driver);
@@ -902,16 +1075,16 @@ static string get_layer_view_name(const RenderBuffers &buffers)
   return result;
 }
 
-void PathTrace::process_full_buffer_from_disk(string_view filename)
+void PathTrace::process_full_buffer_from_disk(const vector<string> &filenames)
 {
-  VLOG(3) << "Processing full frame buffer file " << filename;
+  VLOG(3) << "Processing full frame buffer from " << filenames.size() << " file(s)";
 
   progress_set_status("Reading full buffer from disk");
 
   RenderBuffers full_frame_buffers(cpu_device_.get());
 
   DenoiseParams denoise_params;
-  if (!tile_manager_.read_full_buffer_from_disk(filename, &full_frame_buffers, &denoise_params)) {
+  if (!tile_manager_.read_full_buffer_from_disk(filenames, &full_frame_buffers, &denoise_params)) {
     const string error_message = "Error reading tiles from file";
     if (progress_) {
       progress_->set_error(error_message);
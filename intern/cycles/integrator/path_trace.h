@@ -133,9 +133,10 @@ class PathTrace {
    * Return true if all copies are successful. */
   bool copy_render_tile_from_device();
 
-  /* Read given full-frame file from disk, perform needed processing and write it to the software
-   * via the write callback. */
-  void process_full_buffer_from_disk(string_view filename);
+  /* Read given full-frame files from disk, perform needed processing and write it to the software
+   * via the write callback. Several files are merged, each of them holding another tile split of
+   * the same frame. */
+  void process_full_buffer_from_disk(const vector<string> &filenames);
 
   /* Get number of samples in the current big tile render buffers. */
   int get_num_render_tile_samples() const;
@@ -207,12 +208,29 @@ class PathTrace {
   void path_trace(RenderWork &render_work);
   void adaptive_sample(RenderWork &render_work);
   void denoise(const RenderWork &render_work);
+  void denoise_async_merge_if_finished();
+  void denoise_async_rescale_result();
   void cryptomatte_postprocess(const RenderWork &render_work);
   void update_display(const RenderWork &render_work);
   void rebalance(const RenderWork &render_work);
   void write_tile_buffer(const RenderWork &render_work);
   void finalize_full_buffer_on_disk(const RenderWork &render_work);
 
+  /* Asynchronous denoising.
+   *
+   * A snapshot of the big tile render buffers is denoised in a background thread, on a few of the
+   * CPU threads which are taken away from path tracing until the denoiser has finished. The
+   * denoised passes are copied into the render buffers of the works once the denoiser has finished
+   * and the path tracing of the current work is done. The denoised snapshot is kept, so that the
+   * denoised passes are rescaled to the samples added by every following work. */
+  bool is_denoise_async_supported(const DenoiseParams &params) const;
+  void denoise_async_start(const RenderWork &render_work);
+  void denoise_async_join();
+  void denoise_async_copy_result();
+  /* Cancel denoising which happens in the background, discarding its result and the result of an
+   * earlier snapshot. */
+  void denoise_async_cancel();
+
   /* Get number of samples in the current state of the render buffers. */
   int get_num_samples_in_buffer();
 
@@ -313,6 +331,32 @@ class PathTrace {
    * Used by `ready_to_reset()` to implement logic which feels the most interactive. */
   bool did_draw_after_reset_ = true;
 
+  /* State of the asynchronous denoising. */
+  struct {
+    unique_ptr<thread> denoise_thread;
+
+    /* Snapshot of the render buffers which is being denoised, and the number of samples in it. */
+    unique_ptr<RenderBuffers> render_buffers;
+    BufferParams buffer_params;
+    int num_samples = 0;
+
+    /* Number of CPU threads used by the denoiser. */
+    int num_threads = 0;
+
+    std::atomic<bool> is_finished = false;
+    bool is_denoised = false;
+
+    /* Denoising is to be canceled as soon as possible, the result will be discarded. */
+    std::atomic<bool> is_cancel_requested = false;
+
+    /* Denoised snapshot which is used for the denoised passes of the works, the number of samples
+     * in it, and the number of samples the denoised passes of the works are scaled to. */
+    unique_ptr<RenderBuffers> result_render_buffers;
+    BufferParams result_buffer_params;
+    int result_num_samples = 0;
+    int result_scaled_num_samples = 0;
+  } denoise_async_;
+
   /* State of the full frame processing and writing to the software. */
   struct {
     RenderBuffers *render_buffers = nullptr;
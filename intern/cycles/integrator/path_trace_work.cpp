@@ -81,6 +81,11 @@ bool PathTraceWork::has_multiple_works() const
            effective_big_tile_params_.full_y == effective_buffer_params_.full_y);
 }
 
+void PathTraceWork::set_num_reserved_cpu_threads(int num_threads)
+{
+  num_reserved_cpu_threads_ = num_threads;
+}
+
 void PathTraceWork::copy_to_render_buffers(RenderBuffers *render_buffers)
 {
   copy_render_buffers_from_device();
@@ -119,14 +124,21 @@ void PathTraceWork::copy_from_render_buffers(const RenderBuffers *render_buffers
   copy_render_buffers_to_device();
 }
 
-void PathTraceWork::copy_from_denoised_render_buffers(const RenderBuffers *render_buffers)
+void PathTraceWork::copy_from_denoised_render_buffers(const RenderBuffers *render_buffers,
+                                                      const int src_num_samples,
+                                                      const int dst_num_samples)
 {
   const int64_t width = effective_buffer_params_.width;
   const int64_t offset_y = effective_buffer_params_.full_y - effective_big_tile_params_.full_y;
   const int64_t offset = offset_y * width;
 
-  render_buffers_host_copy_denoised(
-      buffers_.get(), effective_buffer_params_, render_buffers, effective_buffer_params_, offset);
+  render_buffers_host_copy_denoised(buffers_.get(),
+                                    effective_buffer_params_,
+                                    render_buffers,
+                                    effective_buffer_params_,
+                                    offset,
+                                    src_num_samples,
+                                    dst_num_samples);
 
   copy_render_buffers_to_device();
 }
@@ -73,6 +73,10 @@ class PathTraceWork {
    * to an every call of the `render_samples()`. */
   virtual void init_execution() = 0;
 
+  /* Leave the given number of CPU threads for work which runs in parallel with path tracing, such
+   * as background denoising. Only affects works which path trace on the CPU. */
+  void set_num_reserved_cpu_threads(int num_threads);
+
   /* Render given number of samples as a synchronous blocking call.
    * The samples are added to the render buffer associated with this work. */
   virtual void render_samples(RenderStatistics &statistics, int start_sample, int samples_num) = 0;
@@ -105,8 +109,13 @@ class PathTraceWork {
   /* Special version of the `copy_from_render_buffers()` which only copies denoised passes from the
    * given render buffers, leaving rest of the passes.
    *
-   * Same notes about device copying applies to this call as well. */
-  void copy_from_denoised_render_buffers(const RenderBuffers *render_buffers);
+   * Same notes about device copying applies to this call as well.
+   *
+   * The sample numbers are used to rescale denoised passes of an earlier snapshot of the buffers,
+   * as described for `render_buffers_host_copy_denoised()`. */
+  void copy_from_denoised_render_buffers(const RenderBuffers *render_buffers,
+                                         const int src_num_samples = 0,
+                                         const int dst_num_samples = 0);
 
   /* Copy render buffers to/from device using an appropriate device queue when needed so that
    * things are executed in order with the `render_samples()`. */
@@ -186,6 +195,9 @@ class PathTraceWork {
   BufferParams effective_big_tile_params_;
   BufferParams effective_buffer_params_;
 
+  /* Number of CPU threads which are not to be used by path tracing. */
+  int num_reserved_cpu_threads_ = 0;
+
   bool *cancel_requested_flag_ = nullptr;
 };
 
@@ -28,18 +28,27 @@
 #include "render/scene.h"
 
 #include "util/util_atomic.h"
+#include "util/util_debug.h"
 #include "util/util_logging.h"
+#include "util/util_system.h"
 #include "util/util_tbb.h"
 
 CCL_NAMESPACE_BEGIN
 
 /* Create TBB arena for execution of path tracing and rendering tasks. */
-static inline tbb::task_arena local_tbb_arena_create(const Device *device)
+static inline tbb::task_arena local_tbb_arena_create(const Device *device,
+                                                     const int num_reserved_threads)
 {
   /* TODO: limit this to number of threads of CPU device, it may be smaller than
    * the system number of threads when we reduce the number of CPU threads in
    * CPU + GPU rendering to dedicate some cores to handling the GPU device. */
-  return tbb::task_arena(device->info.cpu_threads);
+  if (num_reserved_threads == 0) {
+    return tbb::task_arena(device->info.cpu_threads);
+  }
+
+  const int num_threads = (device->info.cpu_threads) ? device->info.cpu_threads :
+                                                       system_cpu_thread_count();
+  return tbb::task_arena(max(num_threads - num_reserved_threads, 1));
 }
 
 /* Get CPUKernelThreadGlobals for the current thread. */
@@ -53,6 +62,73 @@ static inline CPUKernelThreadGlobals *kernel_thread_globals_get(
   return &kernel_thread_globals[thread_index];
 }
 
+/* Pin worker threads which join an arena to a NUMA node. */
+class NUMAThreadObserver : public tbb::task_scheduler_observer {
+ public:
+  NUMAThreadObserver(tbb::task_arena &arena, int node)
+      : tbb::task_scheduler_observer(arena), node_(node)
+  {
+    observe(true);
+  }
+
+  ~NUMAThreadObserver()
+  {
+    observe(false);
+  }
+
+  void on_scheduler_entry(bool is_worker) override
+  {
+    /* The thread which waits for the arena is shared by all nodes, leave it as it is. */
+    if (!is_worker) {
+      return;
+    }
+
+    ThreadState &thread_state = thread_state_.local();
+    thread_state.is_affinity_saved = system_cpu_thread_affinity_get(&thread_state.affinity);
+
+    system_cpu_run_thread_on_node(node_);
+  }
+
+  void on_scheduler_exit(bool is_worker) override
+  {
+    /* Worker threads are shared with the other arenas, so restore the affinity they had before
+     * joining this one. */
+    if (!is_worker) {
+      return;
+    }
+
+    ThreadState &thread_state = thread_state_.local();
+    if (thread_state.is_affinity_saved) {
+      system_cpu_thread_affinity_set(thread_state.affinity);
+      thread_state.is_affinity_saved = false;
+    }
+  }
+
+ protected:
+  struct ThreadState {
+    bool is_affinity_saved = false;
+    SystemThreadAffinity affinity;
+  };
+
+  int node_;
+  tbb::enumerable_thread_specific<ThreadState> thread_state_;
+};
+
+struct PathTraceWorkCPU::NUMANode {
+  int node;
+  int num_threads;
+
+  unique_ptr<tbb::task_arena> arena;
+  unique_ptr<NUMAThreadObserver> observer;
+  tbb::task_group task_group;
+
+  /* Kernel globals of threads of this node, reading scene data from memory of the node. */
+  vector<CPUKernelThreadGlobals> kernel_thread_globals;
+
+  /* Number of pixel samples rendered by threads of this node. */
+  int64_t num_pixel_samples = 0;
+};
+
 PathTraceWorkCPU::PathTraceWorkCPU(Device *device,
                                    Film *film,
                                    DeviceScene *device_scene,
@@ -63,10 +139,81 @@ PathTraceWorkCPU::PathTraceWorkCPU(Device *device,
   DCHECK_EQ(device->info.type, DEVICE_CPU);
 }
 
+PathTraceWorkCPU::~PathTraceWorkCPU()
+{
+  for (const unique_ptr<NUMANode> &numa_node : numa_nodes_) {
+    VLOG(1) << "NUMA node " << numa_node->node << " rendered " << numa_node->num_pixel_samples
+            << " pixel samples with " << numa_node->num_threads
+            << " threads reading node-local scene data.";
+  }
+}
+
 void PathTraceWorkCPU::init_execution()
 {
   /* Cache per-thread kernel globals. */
   device_->get_cpu_kernel_thread_globals(kernel_thread_globals_);
+
+  /* Wavefront rendering uses the regular arena, so there is no need for NUMA nodes. */
+  if (DebugFlags().cpu.use_numa && !DebugFlags().cpu.use_wavefront) {
+    numa_nodes_init();
+
+    for (unique_ptr<NUMANode> &numa_node : numa_nodes_) {
+      device_->get_cpu_kernel_thread_globals(
+          numa_node->kernel_thread_globals, numa_node->node, numa_node->num_threads);
+    }
+  }
+}
+
+void PathTraceWorkCPU::numa_nodes_init()
+{
+  if (!numa_nodes_.empty()) {
+    return;
+  }
+
+  vector<int> nodes;
+  int num_processors = 0;
+  const int num_nodes = system_cpu_num_numa_nodes();
+  for (int node = 0; node < num_nodes; ++node) {
+    if (system_cpu_is_numa_node_available(node) &&
+        system_cpu_num_numa_node_processors(node) > 0) {
+      nodes.push_back(node);
+      num_processors += system_cpu_num_numa_node_processors(node);
+    }
+  }
+
+  const int num_threads = (device_->info.cpu_threads) ? device_->info.cpu_threads :
+                                                         system_cpu_thread_count();
+  if (nodes.size() < 2 || num_threads < int(nodes.size())) {
+    VLOG(1) << "Not enough NUMA nodes or threads, rendering with a single arena.";
+    return;
+  }
+
+  /* Distribute threads in proportion to the processors of the nodes. */
+  int num_assigned_threads = 0;
+  for (int i = 0; i < nodes.size(); ++i) {
+    const int node = nodes[i];
+    const int num_node_threads =
+        (i == nodes.size() - 1) ?
+            num_threads - num_assigned_threads :
+            max(num_threads * system_cpu_num_numa_node_processors(node) / num_processors, 1);
+    num_assigned_threads += num_node_threads;
+
+    if (num_node_threads <= 0) {
+      continue;
+    }
+
+    unique_ptr<NUMANode> numa_node = make_unique<NUMANode>();
+    numa_node->node = node;
+    numa_node->num_threads = num_node_threads;
+    /* No slots are reserved for the thread which waits for the arena, so that all threads of
+     * the arena run on the node. */
+    numa_node->arena = make_unique<tbb::task_arena>(num_node_threads, 0);
+    numa_node->observer = make_unique<NUMAThreadObserver>(*numa_node->arena, node);
+
+    VLOG(1) << "Rendering with " << num_node_threads << " threads on NUMA node " << node << ".";
+
+    numa_nodes_.push_back(std::move(numa_node));
+  }
 }
 
 void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
@@ -81,37 +228,103 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
     kernel_globals.start_profiling();
   }
 
-  tbb::task_arena local_arena = local_tbb_arena_create(device_);
-  local_arena.execute([&]() {
-    tbb::parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
-      if (is_cancel_requested()) {
-        return;
-      }
+  if (DebugFlags().cpu.use_wavefront) {
+    tbb::task_arena local_arena = local_tbb_arena_create(device_, num_reserved_cpu_threads_);
+    local_arena.execute([&]() { render_samples_wavefront(start_sample, samples_num); });
+  }
+  else if (!numa_nodes_.empty() && num_reserved_cpu_threads_ == 0) {
+    /* The node arenas have a fixed number of threads, so the single arena is used when threads
+     * are reserved for other work. */
+    render_samples_numa(start_sample, samples_num);
+  }
+  else {
+    tbb::task_arena local_arena = local_tbb_arena_create(device_, num_reserved_cpu_threads_);
+    local_arena.execute([&]() {
+      tbb::parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
+        CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
+        render_samples_pixel(kernel_globals, work_index, start_sample, samples_num);
+      });
+    });
+  }
+
+  for (CPUKernelThreadGlobals &kernel_globals : kernel_thread_globals_) {
+    kernel_globals.stop_profiling();
+  }
+
+  statistics.occupancy = 1.0f;
+}
+
+void PathTraceWorkCPU::render_samples_pixel(KernelGlobals *kernel_globals,
+                                            const int64_t pixel_index,
+                                            const int start_sample,
+                                            const int samples_num)
+{
+  if (is_cancel_requested()) {
+    return;
+  }
 
-      const int y = work_index / image_width;
-      const int x = work_index - y * image_width;
+  const int64_t image_width = effective_buffer_params_.width;
+  const int y = pixel_index / image_width;
+  const int x = pixel_index - y * image_width;
+
+  KernelWorkTile work_tile;
+  work_tile.x = effective_buffer_params_.full_x + x;
+  work_tile.y = effective_buffer_params_.full_y + y;
+  work_tile.w = 1;
+  work_tile.h = 1;
+  work_tile.start_sample = start_sample;
+  work_tile.num_samples = 1;
+  work_tile.offset = effective_buffer_params_.offset;
+  work_tile.stride = effective_buffer_params_.stride;
+
+  render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
+}
 
-      KernelWorkTile work_tile;
-      work_tile.x = effective_buffer_params_.full_x + x;
-      work_tile.y = effective_buffer_params_.full_y + y;
-      work_tile.w = 1;
-      work_tile.h = 1;
-      work_tile.start_sample = start_sample;
-      work_tile.num_samples = 1;
-      work_tile.offset = effective_buffer_params_.offset;
-      work_tile.stride = effective_buffer_params_.stride;
+void PathTraceWorkCPU::render_samples_numa(const int start_sample, const int samples_num)
+{
+  const int64_t total_pixels_num = int64_t(effective_buffer_params_.width) *
+                                   effective_buffer_params_.height;
+
+  int num_threads = 0;
+  for (const unique_ptr<NUMANode> &numa_node : numa_nodes_) {
+    num_threads += numa_node->num_threads;
+  }
 
-      CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
+  /* Give every node a contiguous range of pixels, so that each node writes to its own part of
+   * the render buffer. */
+  int64_t pixel_begin = 0;
+  for (int i = 0; i < numa_nodes_.size(); ++i) {
+    NUMANode *numa_node = numa_nodes_[i].get();
+    const int64_t pixel_end = (i == numa_nodes_.size() - 1) ?
+                                  total_pixels_num :
+                                  pixel_begin + total_pixels_num * numa_node->num_threads /
+                                                    num_threads;
+
+    for (CPUKernelThreadGlobals &kernel_globals : numa_node->kernel_thread_globals) {
+      kernel_globals.start_profiling();
+    }
 
-      render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
+    numa_node->arena->execute([=]() {
+      numa_node->task_group.run([=]() {
+        tbb::parallel_for(pixel_begin, pixel_end, [=](int64_t work_index) {
+          CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(
+              numa_node->kernel_thread_globals);
+          render_samples_pixel(kernel_globals, work_index, start_sample, samples_num);
+        });
+      });
     });
-  });
 
-  for (CPUKernelThreadGlobals &kernel_globals : kernel_thread_globals_) {
-    kernel_globals.stop_profiling();
+    numa_node->num_pixel_samples += (pixel_end - pixel_begin) * samples_num;
+    pixel_begin = pixel_end;
   }
 
-  statistics.occupancy = 1.0f;
+  for (unique_ptr<NUMANode> &numa_node : numa_nodes_) {
+    numa_node->arena->execute([&]() { numa_node->task_group.wait(); });
+
+    for (CPUKernelThreadGlobals &kernel_globals : numa_node->kernel_thread_globals) {
+      kernel_globals.stop_profiling();
+    }
+  }
 }
 
 void PathTraceWorkCPU::render_samples_full_pipeline(KernelGlobals *kernel_globals,
@@ -161,6 +374,208 @@ void PathTraceWorkCPU::render_samples_full_pipeline(KernelGlobals *kernel_global
   }
 }
 
+/* Number of paths per render thread the wavefront integrator keeps in flight. Enough to give
+ * every shading batch a coherent set of shaders, while the integrator states of the batch still
+ * fit in a few megabytes per thread. */
+static constexpr int64_t WAVEFRONT_PATHS_PER_THREAD = 2048;
+
+/* Minimum number of paths a thread executes a kernel for, to amortize scheduling overhead. */
+static constexpr int64_t WAVEFRONT_GRAIN_SIZE = 32;
+
+void PathTraceWorkCPU::render_samples_wavefront(const int start_sample, const int samples_num)
+{
+  const int64_t image_width = effective_buffer_params_.width;
+  const int64_t image_height = effective_buffer_params_.height;
+  const int64_t total_pixels_num = image_width * image_height;
+  const int64_t batch_pixels_num = std::min(
+      total_pixels_num, WAVEFRONT_PATHS_PER_THREAD * int64_t(kernel_thread_globals_.size()));
+
+  const bool has_bake = device_scene_->data.bake.use;
+  const bool has_shadow_catcher = device_scene_->data.integrator.has_shadow_catcher;
+
+  /* With a shadow catcher every pixel uses two consecutive states, as the kernel splits the
+   * shadow catcher path into `state + 1`. */
+  const int64_t states_per_pixel = has_shadow_catcher ? 2 : 1;
+  vector<IntegratorStateCPU> integrator_states(batch_pixels_num * states_per_pixel);
+  vector<uint8_t> pixel_active(batch_pixels_num);
+  vector<IntegratorStateCPU *> paths;
+  paths.reserve(batch_pixels_num);
+
+  KernelGlobals *kernel_globals = &kernel_thread_globals_[0];
+  float *render_buffer = buffers_->buffer.data();
+
+  for (int64_t batch_start = 0; batch_start < total_pixels_num; batch_start += batch_pixels_num) {
+    const int64_t batch_num = std::min(batch_pixels_num, total_pixels_num - batch_start);
+
+    /* States may be left in flight by a previous cancelled render. */
+    for (IntegratorStateCPU &state : integrator_states) {
+      path_state_init_queues(kernel_globals, &state);
+    }
+    std::fill(pixel_active.begin(), pixel_active.end(), 1);
+
+    for (int sample = 0; sample < samples_num; ++sample) {
+      if (is_cancel_requested()) {
+        return;
+      }
+
+      /* Initialize a path for every pixel which still needs samples. */
+      tbb::parallel_for(
+          blocked_range<int64_t>(0, batch_num, WAVEFRONT_GRAIN_SIZE),
+          [&](const blocked_range<int64_t> &range) {
+            CPUKernelThreadGlobals *kg = kernel_thread_globals_get(kernel_thread_globals_);
+
+            for (int64_t i = range.begin(); i != range.end(); ++i) {
+              if (!pixel_active[i]) {
+                continue;
+              }
+
+              const int64_t work_index = batch_start + i;
+              const int y = work_index / image_width;
+              const int x = work_index - y * image_width;
+
+              KernelWorkTile work_tile;
+              work_tile.x = effective_buffer_params_.full_x + x;
+              work_tile.y = effective_buffer_params_.full_y + y;
+              work_tile.w = 1;
+              work_tile.h = 1;
+              work_tile.start_sample = start_sample + sample;
+              work_tile.num_samples = 1;
+              work_tile.offset = effective_buffer_params_.offset;
+              work_tile.stride = effective_buffer_params_.stride;
+
+              IntegratorStateCPU *state = &integrator_states[i * states_per_pixel];
+              const bool active = (has_bake) ?
+                                      kernels_.integrator_init_from_bake(
+                                          kg, state, &work_tile, render_buffer) :
+                                      kernels_.integrator_init_from_camera(
+                                          kg, state, &work_tile, render_buffer);
+              if (!active) {
+                pixel_active[i] = 0;
+              }
+            }
+          });
+
+      /* The shadow catcher path of a pixel writes to the same pixel as its main path, so only
+       * trace it once all main paths are done, like the megakernel does. */
+      for (int64_t state_offset = 0; state_offset < states_per_pixel; ++state_offset) {
+        paths.clear();
+        for (int64_t i = 0; i < batch_num; ++i) {
+          paths.push_back(&integrator_states[i * states_per_pixel + state_offset]);
+        }
+        render_wavefront_paths(paths);
+      }
+    }
+  }
+}
+
+void PathTraceWorkCPU::render_wavefront_paths(vector<IntegratorStateCPU *> &paths)
+{
+  float *render_buffer = buffers_->buffer.data();
+  const int max_shaders = max(int(device_scene_->data.max_shaders), 1);
+
+  vector<IntegratorStateCPU *> queues[DEVICE_KERNEL_INTEGRATOR_NUM];
+  vector<IntegratorStateCPU *> sorted_queue;
+  vector<int> shader_offsets(max_shaders + 1);
+
+  while (!paths.empty()) {
+    if (is_cancel_requested()) {
+      return;
+    }
+
+    /* Group paths by their next kernel, dropping the terminated ones. As in the megakernel, a
+     * queued shadow path is handled before the main path can continue. */
+    for (vector<IntegratorStateCPU *> &queue : queues) {
+      queue.clear();
+    }
+
+    int64_t active_paths_num = 0;
+    for (IntegratorStateCPU *state : paths) {
+      const uint32_t kernel = (state->shadow_path.queued_kernel) ?
+                                  state->shadow_path.queued_kernel :
+                                  state->path.queued_kernel;
+      if (kernel) {
+        queues[kernel].push_back(state);
+        paths[active_paths_num++] = state;
+      }
+    }
+    paths.resize(active_paths_num);
+
+    for (int kernel = 0; kernel < DEVICE_KERNEL_INTEGRATOR_NUM; ++kernel) {
+      vector<IntegratorStateCPU *> *queue = &queues[kernel];
+      if (queue->empty()) {
+        continue;
+      }
+
+      /* Sort surface shading by shader, so that threads evaluate the same shader graph for
+       * consecutive paths. Counting sort, keeping the path order within a shader. */
+      if (kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE ||
+          kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_RAYTRACE) {
+        std::fill(shader_offsets.begin(), shader_offsets.end(), 0);
+        for (const IntegratorStateCPU *state : *queue) {
+          shader_offsets[min(int(state->path.shader_sort_key), max_shaders - 1) + 1]++;
+        }
+        for (int i = 0; i < max_shaders; ++i) {
+          shader_offsets[i + 1] += shader_offsets[i];
+        }
+        sorted_queue.resize(queue->size());
+        for (IntegratorStateCPU *state : *queue) {
+          sorted_queue[shader_offsets[min(int(state->path.shader_sort_key), max_shaders - 1)]++] =
+              state;
+        }
+        queue = &sorted_queue;
+      }
+
+      tbb::parallel_for(
+          blocked_range<int64_t>(0, queue->size(), WAVEFRONT_GRAIN_SIZE),
+          [&](const blocked_range<int64_t> &range) {
+            CPUKernelThreadGlobals *kg = kernel_thread_globals_get(kernel_thread_globals_);
+
+            for (int64_t i = range.begin(); i != range.end(); ++i) {
+              IntegratorStateCPU *state = (*queue)[i];
+
+              switch (kernel) {
+                case DEVICE_KERNEL_INTEGRATOR_INTERSECT_CLOSEST:
+                  kernels_.integrator_intersect_closest(kg, state);
+                  break;
+                case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW:
+                  kernels_.integrator_intersect_shadow(kg, state);
+                  break;
+                case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SUBSURFACE:
+                  kernels_.integrator_intersect_subsurface(kg, state);
+                  break;
+                case DEVICE_KERNEL_INTEGRATOR_INTERSECT_VOLUME_STACK:
+                  kernels_.integrator_intersect_volume_stack(kg, state);
+                  break;
+                case DEVICE_KERNEL_INTEGRATOR_SHADE_BACKGROUND:
+                  kernels_.integrator_shade_background(kg, state, render_buffer);
+                  break;
+                case DEVICE_KERNEL_INTEGRATOR_SHADE_LIGHT:
+                  kernels_.integrator_shade_light(kg, state, render_buffer);
+                  break;
+                case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE:
+                  kernels_.integrator_shade_surface(kg, state, render_buffer);
+                  break;
+                case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_RAYTRACE:
+                  kernels_.integrator_shade_surface_raytrace(kg, state, render_buffer);
+                  break;
+                case DEVICE_KERNEL_INTEGRATOR_SHADE_VOLUME:
+                  kernels_.integrator_shade_volume(kg, state, render_buffer);
+                  break;
+                case DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW:
+                  kernels_.integrator_shade_shadow(kg, state, render_buffer);
+                  break;
+                default:
+                  LOG(DFATAL) << "Unhandled kernel "
+                              << device_kernel_as_string((DeviceKernel)kernel)
+                              << " in the wavefront integrator.";
+                  break;
+              }
+            }
+          });
+    }
+  }
+}
+
 void PathTraceWorkCPU::copy_to_display(PathTraceDisplay *display,
                                        PassMode pass_mode,
                                        int num_samples)
@@ -181,7 +596,7 @@ void PathTraceWorkCPU::copy_to_display(PathTraceDisplay *display,
   PassAccessor::Destination destination = get_display_destination_template(display);
   destination.pixels_half_rgba = rgba_half;
 
-  tbb::task_arena local_arena = local_tbb_arena_create(device_);
+  tbb::task_arena local_arena = local_tbb_arena_create(device_, num_reserved_cpu_threads_);
   local_arena.execute([&]() {
     pass_accessor.get_render_tile_pixels(buffers_.get(), effective_buffer_params_, destination);
   });
@@ -223,7 +638,7 @@ int PathTraceWorkCPU::adaptive_sampling_converge_filter_count_active(float thres
 
   uint num_active_pixels = 0;
 
-  tbb::task_arena local_arena = local_tbb_arena_create(device_);
+  tbb::task_arena local_arena = local_tbb_arena_create(device_, num_reserved_cpu_threads_);
 
   /* Check convergency and do x-filter in a single `parallel_for`, to reduce threading overhead. */
   local_arena.execute([&]() {
@@ -269,7 +684,7 @@ void PathTraceWorkCPU::cryptomatte_postproces()
 
   float *render_buffer = buffers_->buffer.data();
 
-  tbb::task_arena local_arena = local_tbb_arena_create(device_);
+  tbb::task_arena local_arena = local_tbb_arena_create(device_, num_reserved_cpu_threads_);
 
   /* Check convergency and do x-filter in a single `parallel_for`, to reduce threading overhead. */
   local_arena.execute([&]() {
@@ -23,6 +23,7 @@
 
 #include "integrator/path_trace_work.h"
 
+#include "util/util_unique_ptr.h"
 #include "util/util_vector.h"
 
 CCL_NAMESPACE_BEGIN
@@ -43,6 +44,7 @@ class PathTraceWorkCPU : public PathTraceWork {
                    Film *film,
                    DeviceScene *device_scene,
                    bool *cancel_requested_flag);
+  ~PathTraceWorkCPU();
 
   virtual void init_execution() override;
 
@@ -68,6 +70,27 @@ class PathTraceWorkCPU : public PathTraceWork {
                                     const KernelWorkTile &work_tile,
                                     const int samples_num);
 
+  /* Render samples of the pixel with the given index within the effective buffer. */
+  void render_samples_pixel(KernelGlobals *kernel_globals,
+                            int64_t pixel_index,
+                            int start_sample,
+                            int samples_num);
+
+  /* Render with a TBB arena per NUMA node, with pixels split between the nodes in proportion to
+   * their number of threads. */
+  void render_samples_numa(int start_sample, int samples_num);
+
+  /* Create arenas of the NUMA nodes, when there are multiple nodes to render on. */
+  void numa_nodes_init();
+
+  /* Wavefront path tracing routine. Renders the pixels in batches, where all paths of a batch
+   * execute the same kernel before moving on to the next one, with surface shading sorted by
+   * shader. Must be called from within the local TBB arena. */
+  void render_samples_wavefront(int start_sample, int samples_num);
+
+  /* Execute the queued kernels of the given paths until all of them are terminated. */
+  void render_wavefront_paths(vector<IntegratorStateCPU *> &paths);
+
   /* CPU kernels. */
   const CPUKernels &kernels_;
 
@@ -77,6 +100,10 @@ class PathTraceWorkCPU : public PathTraceWork {
    * accessing it, but some "localization" is required to decouple from kernel globals stored
    * on the device level. */
   vector<CPUKernelThreadGlobals> kernel_thread_globals_;
+
+  /* Per-node arenas and kernel globals, when rendering with NUMA nodes. */
+  struct NUMANode;
+  vector<unique_ptr<NUMANode>> numa_nodes_;
 };
 
 CCL_NAMESPACE_END
@@ -190,6 +190,7 @@ bool RenderScheduler::render_work_reschedule_on_converge(RenderWork &render_work
 
   bool denoiser_delayed, denoiser_ready_to_display;
   render_work.tile.denoise = work_need_denoise(denoiser_delayed, denoiser_ready_to_display);
+  render_work.tile.denoise_async = false;
 
   render_work.display.update = work_need_update_display(denoiser_delayed);
   render_work.display.use_denoised_result = denoiser_ready_to_display;
@@ -336,6 +337,10 @@ RenderWork RenderScheduler::get_render_work()
 
   render_work.tile.write = done();
 
+  /* The final result is always denoised synchronously. */
+  render_work.tile.denoise_async = render_work.tile.denoise && denoiser_params_.use_async &&
+                                   !render_work.tile.write;
+
   render_work.display.update = work_need_update_display(denoiser_delayed);
   render_work.display.use_denoised_result = denoiser_ready_to_display;
 
@@ -364,7 +369,9 @@ void RenderScheduler::update_state_for_render_work(const RenderWork &render_work
     state_.last_display_update_sample = state_.num_rendered_samples;
   }
 
-  state_.last_work_tile_was_denoised = render_work.tile.denoise;
+  /* Result of asynchronous denoising is not guaranteed to be available for the last work, so the
+   * final result still needs to be denoised. */
+  state_.last_work_tile_was_denoised = render_work.tile.denoise && !render_work.tile.denoise_async;
   state_.tile_result_was_written |= render_work.tile.write;
   state_.full_frame_was_written |= render_work.full.write;
 }
@@ -914,14 +921,14 @@ bool RenderScheduler::work_need_denoise(bool &delayed, bool &ready_to_display)
     return true;
   }
 
-  if (background_) {
+  if (background_ && !denoiser_params_.use_async) {
     /* Background render, only denoise when rendering the last sample. */
     /* TODO(sergey): Follow similar logic to viewport, giving an overview of how final denoised
      * image looks like even for the background rendering. */
     return false;
   }
 
-  /* Viewport render. */
+  /* Viewport render, or background render with progressive updates denoised asynchronously. */
 
   /* Navigation might render multiple samples at a lower resolution. Those are not to be counted as
    * final samples. */
@@ -941,6 +948,12 @@ bool RenderScheduler::work_need_denoise(bool &delayed, bool &ready_to_display)
     return false;
   }
 
+  if (denoiser_params_.use_async) {
+    /* Denoising of a snapshot does not stall path tracing, and the path tracer skips the work
+     * while the previous snapshot is still being denoised. */
+    return true;
+  }
+
   /* Avoid excessive denoising in viewport after reaching a certain sample count and render time.
    */
   /* TODO(sergey): Consider making time interval and sample configurable. */
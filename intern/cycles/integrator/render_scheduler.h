@@ -64,6 +64,10 @@ class RenderWork {
     bool write = false;
 
     bool denoise = false;
+
+    /* Denoise a snapshot of the render buffers in the background, without waiting for the result.
+     * The result is used by one of the following works once the denoiser has finished. */
+    bool denoise_async = false;
   } tile;
 
   /* Work related on the full-frame render buffer. */
@@ -261,7 +265,10 @@ class RenderScheduler {
    * later sample, to reduce overhead.
    *
    * ready_to_display will be false if we may have a denoised result that is outdated due to
-   * increased samples. */
+   * increased samples.
+   *
+   * With asynchronous denoising progressive updates are denoised in the background render as well,
+   * and are never delayed since they do not stall path tracing. */
   bool work_need_denoise(bool &delayed, bool &ready_to_display);
 
   /* Check whether current work need to update display.
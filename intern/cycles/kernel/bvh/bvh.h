@@ -41,6 +41,9 @@ CCL_NAMESPACE_BEGIN
 /* Regular BVH traversal */
 
 #  include "kernel/bvh/bvh_nodes.h"
+#  ifdef __BVH4__
+#    include "kernel/bvh/bvh4_nodes.h"
+#  endif
 
 #  define BVH_FUNCTION_NAME bvh_intersect
 #  define BVH_FUNCTION_FEATURES 0
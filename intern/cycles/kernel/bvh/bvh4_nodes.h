@@ -0,0 +1,101 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* BVH4 Nodes
+ *
+ * Inner nodes of four children, with one row per bounding plane holding the value of all four
+ * children, so a ray is tested against all of them with a single SSE slab test. */
+
+/* Intersect the children of an inner node, push the intersected children on the traversal stack
+ * from farthest to closest and return the closest one to continue traversal with. When no child
+ * is intersected the next node is popped from the stack instead. */
+ccl_device_forceinline int bvh4_node_traverse(const KernelGlobals *kg,
+                                              const float3 P,
+                                              const float3 idir,
+                                              const float t,
+                                              const int node_addr,
+                                              const uint visibility,
+                                              int *traversal_stack,
+                                              int *stack_ptr)
+{
+  const ssef *node = (const ssef *)&kernel_tex_fetch(__bvh_nodes, node_addr);
+
+  /* Pick the near and far plane of each axis from the ray direction, so that empty children
+   * with inverted bounds never intersect. */
+  const int near_x = (idir.x >= 0.0f) ? 1 : 2;
+  const int near_y = (idir.y >= 0.0f) ? 3 : 4;
+  const int near_z = (idir.z >= 0.0f) ? 5 : 6;
+  const int far_x = near_x ^ 3;
+  const int far_y = near_y ^ 7;
+  const int far_z = near_z ^ 3;
+
+  const ssef idir_x(idir.x), idir_y(idir.y), idir_z(idir.z);
+  const ssef org_idir_x(P.x * idir.x), org_idir_y(P.y * idir.y), org_idir_z(P.z * idir.z);
+
+  const ssef near_t_x = msub(node[near_x], idir_x, org_idir_x);
+  const ssef near_t_y = msub(node[near_y], idir_y, org_idir_y);
+  const ssef near_t_z = msub(node[near_z], idir_z, org_idir_z);
+  const ssef far_t_x = msub(node[far_x], idir_x, org_idir_x);
+  const ssef far_t_y = msub(node[far_y], idir_y, org_idir_y);
+  const ssef far_t_z = msub(node[far_z], idir_z, org_idir_z);
+
+  const ssef near_t = max(max(near_t_x, near_t_y), max(near_t_z, ssef(0.0f)));
+  const ssef far_t = min(min(far_t_x, far_t_y), min(far_t_z, ssef(t)));
+
+#ifdef __VISIBILITY_FLAG__
+  const sseb visible = (cast(node[0]) & ssei(visibility)) != ssei(0);
+  uint32_t mask = movemask((near_t <= far_t) & visible);
+#else
+  uint32_t mask = movemask(near_t <= far_t);
+#endif
+
+  if (mask == 0) {
+    /* No child was intersected. */
+    return traversal_stack[(*stack_ptr)--];
+  }
+
+  const ssei children = cast(node[7]);
+
+  if ((mask & (mask - 1)) == 0) {
+    /* One child was intersected. */
+    return children[__bsf(mask)];
+  }
+
+  /* Sort the intersected children from farthest to closest. */
+  int num_hits = 0;
+  int hit_addr[4];
+  float hit_dist[4];
+  do {
+    const uint32_t i = __bsf(mask);
+    mask &= mask - 1;
+
+    int j = num_hits++;
+    for (; j > 0 && hit_dist[j - 1] < near_t[i]; j--) {
+      hit_addr[j] = hit_addr[j - 1];
+      hit_dist[j] = hit_dist[j - 1];
+    }
+    hit_addr[j] = children[i];
+    hit_dist[j] = near_t[i];
+  } while (mask);
+
+  for (int j = 0; j < num_hits - 1; j++) {
+    ++(*stack_ptr);
+    kernel_assert(*stack_ptr < BVH_STACK_SIZE);
+    traversal_stack[*stack_ptr] = hit_addr[j];
+  }
+
+  return hit_addr[num_hits - 1];
+}
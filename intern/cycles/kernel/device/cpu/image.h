@@ -24,6 +24,18 @@
 
 CCL_NAMESPACE_BEGIN
 
+/* Sample an image from the texture cache, with the derivatives of the texture coordinate used
+ * to pick the mipmap level. Defined once in kernel.cpp for all instruction sets, which is why
+ * only plain floats are passed. */
+void kernel_tex_image_cache_lookup(const TextureInfo &info,
+                                   float x,
+                                   float y,
+                                   float dxdx,
+                                   float dydx,
+                                   float dxdy,
+                                   float dydy,
+                                   float result[4]);
+
 /* Make template functions private so symbols don't conflict between kernels with different
  * instruction sets. */
 namespace {
@@ -583,11 +595,24 @@ template<typename T> struct NanoVDBInterpolator {
 
 #undef SET_CUBIC_SPLINE_WEIGHTS
 
+ccl_device_inline float4 kernel_tex_image_cache(const TextureInfo &info,
+                                                float x,
+                                                float y,
+                                                float2 dx,
+                                                float2 dy)
+{
+  float result[4];
+  kernel_tex_image_cache_lookup(info, x, y, dx.x, dx.y, dy.x, dy.y, result);
+  return make_float4(result[0], result[1], result[2], result[3]);
+}
+
 ccl_device float4 kernel_tex_image_interp(const KernelGlobals *kg, int id, float x, float y)
 {
   const TextureInfo &info = kernel_tex_fetch(__texture_info, id);
 
   switch (info.data_type) {
+    case IMAGE_DATA_TYPE_TEXTURE_CACHE:
+      return kernel_tex_image_cache(info, x, y, zero_float2(), zero_float2());
     case IMAGE_DATA_TYPE_HALF:
       return TextureInterpolator<half>::interp(info, x, y);
     case IMAGE_DATA_TYPE_BYTE:
@@ -652,6 +677,20 @@ ccl_device float4 kernel_tex_image_interp_3d(const KernelGlobals *kg,
   }
 }
 
+/* Image lookup with the derivatives of the texture coordinate, which are only used to filter
+ * images from the texture cache. */
+ccl_device float4 kernel_tex_image_interp_deriv(
+    const KernelGlobals *kg, int id, float x, float y, float2 dx, float2 dy)
+{
+  const TextureInfo &info = kernel_tex_fetch(__texture_info, id);
+
+  if (info.data_type == IMAGE_DATA_TYPE_TEXTURE_CACHE) {
+    return kernel_tex_image_cache(info, x, y, dx, dy);
+  }
+
+  return kernel_tex_image_interp(kg, id, x, y);
+}
+
 } /* Namespace. */
 
 CCL_NAMESPACE_END
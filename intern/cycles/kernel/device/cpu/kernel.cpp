@@ -60,6 +60,8 @@
 #define KERNEL_ARCH cpu
 #include "kernel/device/cpu/kernel_arch_impl.h"
 
+#include <OpenImageIO/texture.h>
+
 CCL_NAMESPACE_BEGIN
 
 /* Memory Copy */
@@ -91,4 +93,78 @@ void kernel_global_memory_copy(KernelGlobals *kg, const char *name, void *mem, s
   }
 }
 
+/* Texture Cache */
+
+void kernel_tex_image_cache_lookup(const TextureInfo &info,
+                                   float x,
+                                   float y,
+                                   float dxdx,
+                                   float dydx,
+                                   float dxdy,
+                                   float dydy,
+                                   float result[4])
+{
+  const TextureCacheImage *image = (const TextureCacheImage *)info.data;
+  OIIO::TextureSystem *texture_system = (OIIO::TextureSystem *)image->texture_system;
+
+  OIIO::TextureOpt options;
+  switch (info.interpolation) {
+    case INTERPOLATION_CLOSEST:
+      options.interpmode = OIIO::TextureOpt::InterpClosest;
+      options.mipmode = OIIO::TextureOpt::MipModeOneLevel;
+      break;
+    case INTERPOLATION_LINEAR:
+      options.interpmode = OIIO::TextureOpt::InterpBilinear;
+      break;
+    default:
+      options.interpmode = OIIO::TextureOpt::InterpBicubic;
+      break;
+  }
+  switch (info.extension) {
+    case EXTENSION_REPEAT:
+      options.swrap = options.twrap = OIIO::TextureOpt::WrapPeriodic;
+      break;
+    case EXTENSION_EXTEND:
+      options.swrap = options.twrap = OIIO::TextureOpt::WrapClamp;
+      break;
+    default:
+      options.swrap = options.twrap = OIIO::TextureOpt::WrapBlack;
+      break;
+  }
+
+  /* Image rows are stored bottom to top in Cycles, and top to bottom in the file. */
+  const int channels = min(image->channels, 4);
+  if (!texture_system->texture(
+          (OIIO::TextureSystem::TextureHandle *)image->texture_handle,
+          NULL,
+          options,
+          x,
+          1.0f - y,
+          dxdx,
+          -dydx,
+          dxdy,
+          -dydy,
+          channels,
+          result)) {
+    result[0] = TEX_IMAGE_MISSING_R;
+    result[1] = TEX_IMAGE_MISSING_G;
+    result[2] = TEX_IMAGE_MISSING_B;
+    result[3] = TEX_IMAGE_MISSING_A;
+    return;
+  }
+
+  /* Expand to RGBA the same way as images loaded into memory. */
+  if (channels == 1) {
+    result[1] = result[2] = result[0];
+    result[3] = 1.0f;
+  }
+  else if (channels == 2) {
+    result[3] = result[1];
+    result[1] = result[2] = result[0];
+  }
+  else if (channels == 3) {
+    result[3] = 1.0f;
+  }
+}
+
 CCL_NAMESPACE_END
@@ -67,6 +67,7 @@ ccl_device_noinline_cpu float3 light_sample_shader_eval(INTEGRATOR_STATE_ARGS,
     }
 
     PROFILING_SHADER(emission_sd->object, emission_sd->shader);
+    PROFILING_LIGHT(ls->lamp);
     PROFILING_EVENT(PROFILING_SHADE_LIGHT_EVAL);
 
     /* No proper path flag, we're evaluating this for all closures. that's
@@ -19,6 +19,7 @@
 #include "geom/geom.h"
 
 #include "kernel_light_background.h"
+#include "kernel_light_tree.h"
 #include "kernel_montecarlo.h"
 #include "kernel_projection.h"
 #include "kernel_types.h"
@@ -42,6 +43,36 @@ typedef struct LightSample {
   LightType type; /* type of light */
 } LightSample;
 
+/* Light Selection */
+
+/* Probability of selecting the lamp for shading point P. */
+ccl_device_inline float light_distribution_lamp_pdf(const KernelGlobals *kg,
+                                                    const int lamp,
+                                                    const float3 P)
+{
+  if (kernel_data.integrator.light_tree_pdf > 0.0f) {
+    const int leaf = light_tree_lamp_leaf(kg, lamp);
+    if (leaf != -1) {
+      return kernel_data.integrator.light_tree_pdf * light_tree_leaf_pdf(kg, leaf, P);
+    }
+  }
+  return kernel_data.integrator.pdf_lights;
+}
+
+/* Probability of selecting the triangle for shading point P when sampling from the light tree,
+ * zero when it does not contribute to the shading point. */
+ccl_device_inline float light_tree_triangle_pdf(const KernelGlobals *kg,
+                                                const int object,
+                                                const int prim,
+                                                const float3 P)
+{
+  const int leaf = light_tree_triangle_leaf(kg, object, prim);
+  if (leaf == -1) {
+    return 0.0f;
+  }
+  return kernel_data.integrator.light_tree_pdf * light_tree_leaf_pdf(kg, leaf, P);
+}
+
 /* Regular Light */
 
 template<bool in_volume_segment>
@@ -51,6 +82,7 @@ ccl_device_inline bool light_sample(const KernelGlobals *kg,
                                     const float randv,
                                     const float3 P,
                                     const int path_flag,
+                                    const float selection_pdf,
                                     LightSample *ls)
 {
   const ccl_global KernelLight *klight = &kernel_tex_fetch(__lights, lamp);
@@ -204,7 +236,7 @@ ccl_device_inline bool light_sample(const KernelGlobals *kg,
     }
   }
 
-  ls->pdf *= kernel_data.integrator.pdf_lights;
+  ls->pdf *= selection_pdf;
 
   return (ls->pdf > 0.0f);
 }
@@ -455,7 +487,7 @@ ccl_device bool light_sample_from_intersection(const KernelGlobals *ccl_restrict
     return false;
   }
 
-  ls->pdf *= kernel_data.integrator.pdf_lights;
+  ls->pdf *= light_distribution_lamp_pdf(kg, lamp, ray_P);
 
   return true;
 }
@@ -492,12 +524,11 @@ ccl_device_inline bool triangle_world_space_vertices(
   return has_motion;
 }
 
-ccl_device_inline float triangle_light_pdf_area(const KernelGlobals *kg,
-                                                const float3 Ng,
+ccl_device_inline float triangle_light_pdf_area(const float3 Ng,
                                                 const float3 I,
-                                                float t)
+                                                float t,
+                                                const float pdf)
 {
-  float pdf = kernel_data.integrator.pdf_triangles;
   float cos_pi = fabsf(dot(Ng, I));
 
   if (cos_pi == 0.0f)
@@ -524,10 +555,20 @@ ccl_device_forceinline float triangle_light_pdf(const KernelGlobals *kg,
   const float3 N = cross(e0, e1);
   const float distance_to_plane = fabsf(dot(N, sd->I * t)) / dot(N, N);
 
+  /* sd contains the point on the light source
+   * calculate Px, the point that we're shading */
+  const float3 Px = sd->P + sd->I * t;
+
+  /* Probability of selecting the triangle when sampling from the light tree. */
+  float tree_pdf = 0.0f;
+  if (kernel_data.integrator.light_tree_pdf > 0.0f) {
+    tree_pdf = light_tree_triangle_pdf(kg, sd->object, sd->prim, Px);
+    if (tree_pdf == 0.0f) {
+      return 0.0f;
+    }
+  }
+
   if (longest_edge_squared > distance_to_plane * distance_to_plane) {
-    /* sd contains the point on the light source
-     * calculate Px, the point that we're shading */
-    const float3 Px = sd->P + sd->I * t;
     const float3 v0_p = V[0] - Px;
     const float3 v1_p = V[1] - Px;
     const float3 v2_p = V[2] - Px;
@@ -545,6 +586,9 @@ ccl_device_forceinline float triangle_light_pdf(const KernelGlobals *kg,
     if (UNLIKELY(solid_angle == 0.0f)) {
       return 0.0f;
     }
+    else if (tree_pdf > 0.0f) {
+      return tree_pdf / solid_angle;
+    }
     else {
       float area = 1.0f;
       if (has_motion) {
@@ -559,8 +603,15 @@ ccl_device_forceinline float triangle_light_pdf(const KernelGlobals *kg,
       return pdf / solid_angle;
     }
   }
+  else if (tree_pdf > 0.0f) {
+    const float area = 0.5f * len(N);
+    if (UNLIKELY(area == 0.0f)) {
+      return 0.0f;
+    }
+    return triangle_light_pdf_area(sd->Ng, sd->I, t, tree_pdf / area);
+  }
   else {
-    float pdf = triangle_light_pdf_area(kg, sd->Ng, sd->I, t);
+    float pdf = triangle_light_pdf_area(sd->Ng, sd->I, t, kernel_data.integrator.pdf_triangles);
     if (has_motion) {
       const float area = 0.5f * len(N);
       if (UNLIKELY(area == 0.0f)) {
@@ -585,7 +636,8 @@ ccl_device_forceinline void triangle_light_sample(const KernelGlobals *kg,
                                                   float randv,
                                                   float time,
                                                   LightSample *ls,
-                                                  const float3 P)
+                                                  const float3 P,
+                                                  const float selection_pdf)
 {
   /* A naive heuristic to decide between costly solid angle sampling
    * and simple area sampling, comparing the distance to the triangle plane
@@ -703,6 +755,9 @@ ccl_device_forceinline void triangle_light_sample(const KernelGlobals *kg,
       ls->pdf = 0.0f;
       return;
     }
+    else if (selection_pdf > 0.0f) {
+      ls->pdf = selection_pdf / solid_angle;
+    }
     else {
       if (has_motion) {
         /* get the center frame vertices, this is what the PDF was calculated from */
@@ -731,8 +786,16 @@ ccl_device_forceinline void triangle_light_sample(const KernelGlobals *kg,
     ls->P = u * V[0] + v * V[1] + t * V[2];
     /* compute incoming direction, distance and pdf */
     ls->D = normalize_len(ls->P - P, &ls->t);
-    ls->pdf = triangle_light_pdf_area(kg, ls->Ng, -ls->D, ls->t);
-    if (has_motion && area != 0.0f) {
+    if (selection_pdf > 0.0f) {
+      ls->pdf = (area != 0.0f) ?
+                    triangle_light_pdf_area(ls->Ng, -ls->D, ls->t, selection_pdf / area) :
+                    0.0f;
+    }
+    else {
+      ls->pdf = triangle_light_pdf_area(
+          ls->Ng, -ls->D, ls->t, kernel_data.integrator.pdf_triangles);
+    }
+    if (selection_pdf == 0.0f && has_motion && area != 0.0f) {
       /* scale the PDF.
        * area = the area the sample was taken from
        * area_pre = the are from which pdf_triangles was calculated from */
@@ -802,8 +865,35 @@ ccl_device_noinline bool light_distribution_sample(const KernelGlobals *kg,
                                                    const int path_flag,
                                                    LightSample *ls)
 {
-  /* Sample light index from distribution. */
-  const int index = light_distribution_sample(kg, &randu);
+  /* Sample light index from the light tree or the distribution. */
+  int index;
+  float selection_pdf = 0.0f;
+  const float light_tree_pdf = kernel_data.integrator.light_tree_pdf;
+
+  if (light_tree_pdf > 0.0f) {
+    if (randu < light_tree_pdf) {
+      /* Local lights and triangles, by importance for the shading point. */
+      randu = randu / light_tree_pdf;
+      index = light_tree_sample(kg, &randu, P, &selection_pdf);
+      if (index == -1) {
+        return false;
+      }
+      selection_pdf *= light_tree_pdf;
+    }
+    else {
+      /* Distant and background lights, stored at the end of the distribution. */
+      const int num_distant = kernel_data.integrator.num_distant_lights;
+      randu = (randu - light_tree_pdf) / (1.0f - light_tree_pdf) * num_distant;
+      const int distant_index = min((int)randu, num_distant - 1);
+      randu = randu - distant_index;
+      index = kernel_data.integrator.num_distribution - num_distant + distant_index;
+      selection_pdf = kernel_data.integrator.pdf_lights;
+    }
+  }
+  else {
+    index = light_distribution_sample(kg, &randu);
+  }
+
   const ccl_global KernelLightDistribution *kdistribution = &kernel_tex_fetch(__light_distribution,
                                                                               index);
   const int prim = kdistribution->prim;
@@ -819,7 +909,8 @@ ccl_device_noinline bool light_distribution_sample(const KernelGlobals *kg,
     }
 
     const int shader_flag = kdistribution->mesh_light.shader_flag;
-    triangle_light_sample<in_volume_segment>(kg, prim, object, randu, randv, time, ls, P);
+    triangle_light_sample<in_volume_segment>(
+        kg, prim, object, randu, randv, time, ls, P, selection_pdf);
     ls->shader |= shader_flag;
     return (ls->pdf > 0.0f);
   }
@@ -830,7 +921,12 @@ ccl_device_noinline bool light_distribution_sample(const KernelGlobals *kg,
     return false;
   }
 
-  return light_sample<in_volume_segment>(kg, lamp, randu, randv, P, path_flag, ls);
+  if (light_tree_pdf == 0.0f) {
+    selection_pdf = kernel_data.integrator.pdf_lights;
+  }
+
+  return light_sample<in_volume_segment>(
+      kg, lamp, randu, randv, P, path_flag, selection_pdf, ls);
 }
 
 ccl_device_inline bool light_distribution_sample_from_volume_segment(const KernelGlobals *kg,
@@ -864,13 +960,23 @@ ccl_device_inline bool light_distribution_sample_new_position(const KernelGlobal
                                                               const float3 P,
                                                               LightSample *ls)
 {
-  /* Sample a new position on the same light, for volume sampling. */
+  /* Sample a new position on the same light, for volume sampling. The selection probability
+   * of the light tree depends on the position, so it is computed again. */
   if (ls->type == LIGHT_TRIANGLE) {
-    triangle_light_sample<false>(kg, ls->prim, ls->object, randu, randv, time, ls, P);
+    float selection_pdf = 0.0f;
+    if (kernel_data.integrator.light_tree_pdf > 0.0f) {
+      selection_pdf = light_tree_triangle_pdf(kg, ls->object, ls->prim, P);
+      if (selection_pdf == 0.0f) {
+        return false;
+      }
+    }
+    triangle_light_sample<false>(
+        kg, ls->prim, ls->object, randu, randv, time, ls, P, selection_pdf);
     return (ls->pdf > 0.0f);
   }
   else {
-    return light_sample<false>(kg, ls->lamp, randu, randv, P, 0, ls);
+    const float selection_pdf = light_distribution_lamp_pdf(kg, ls->lamp, P);
+    return light_sample<false>(kg, ls->lamp, randu, randv, P, 0, selection_pdf, ls);
   }
 }
 
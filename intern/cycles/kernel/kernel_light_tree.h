@@ -0,0 +1,164 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+CCL_NAMESPACE_BEGIN
+
+/* Light Tree
+ *
+ * Local lights and emissive triangles are stored in a bounding volume hierarchy, where every
+ * node bounds the position, orientation and energy of its emitters. An emitter is selected by
+ * descending the tree and picking each child with a probability proportional to its estimated
+ * contribution to the shading point.
+ *
+ * The importance only depends on the shading position and not on the normal, so the same
+ * probability is found for light samples and for rays that hit a light by chance. */
+
+ccl_device float light_tree_node_importance(const ccl_global KernelLightTreeNode *knode,
+                                            const float3 P)
+{
+  if (knode->energy == 0.0f) {
+    return 0.0f;
+  }
+
+  const float3 bbox_min = make_float3(knode->bbox_min[0], knode->bbox_min[1], knode->bbox_min[2]);
+  const float3 bbox_max = make_float3(knode->bbox_max[0], knode->bbox_max[1], knode->bbox_max[2]);
+  const float3 centroid = 0.5f * (bbox_min + bbox_max);
+  const float radius_squared = 0.25f * len_squared(bbox_max - bbox_min);
+
+  float distance;
+  const float3 D = normalize_len(P - centroid, &distance);
+  const float distance_squared = distance * distance;
+
+  /* Inside the bounds any orientation is possible. */
+  if (distance_squared <= radius_squared) {
+    return knode->energy / max(radius_squared, 1e-8f);
+  }
+
+  /* Smallest angle between the emission cone and the direction towards the shading point,
+   * taking into account the angle the bounds cover as seen from the shading point. */
+  const float3 axis = make_float3(knode->axis[0], knode->axis[1], knode->axis[2]);
+  float theta = safe_acosf(dot(axis, D));
+  if (knode->two_sided) {
+    theta = min(theta, M_PI_F - theta);
+  }
+  const float theta_u = safe_asinf(sqrtf(radius_squared) / distance);
+  const float theta_prime = max(theta - knode->theta_o - theta_u, 0.0f);
+
+  if (theta_prime >= knode->theta_e) {
+    return 0.0f;
+  }
+
+  return knode->energy * cosf(theta_prime) / distance_squared;
+}
+
+/* Probability of choosing the first child of an inner node, returns false if neither child
+ * contributes to the shading point. */
+ccl_device_inline bool light_tree_child_probability(const KernelGlobals *kg,
+                                                    const int node_index,
+                                                    const float3 P,
+                                                    float *first_pdf)
+{
+  const ccl_global KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes, node_index);
+  const float first_importance = light_tree_node_importance(
+      &kernel_tex_fetch(__light_tree_nodes, node_index + 1), P);
+  const float second_importance = light_tree_node_importance(
+      &kernel_tex_fetch(__light_tree_nodes, knode->child_index), P);
+  const float total_importance = first_importance + second_importance;
+
+  if (!(total_importance > 0.0f)) {
+    return false;
+  }
+
+  *first_pdf = first_importance / total_importance;
+  return true;
+}
+
+/* Pick an emitter by descending the tree, returning its index in the light distribution or -1
+ * when no emitter can contribute. The random number is rescaled for reuse, like the light
+ * distribution sampling does. */
+ccl_device int light_tree_sample(const KernelGlobals *kg, float *randu, const float3 P, float *pdf)
+{
+  int node_index = 0;
+  float node_pdf = 1.0f;
+  float u = *randu;
+
+  int child_index = kernel_tex_fetch(__light_tree_nodes, node_index).child_index;
+  while (child_index >= 0) {
+    float first_pdf;
+    if (!light_tree_child_probability(kg, node_index, P, &first_pdf)) {
+      return -1;
+    }
+
+    if (u < first_pdf) {
+      u = u / first_pdf;
+      node_pdf *= first_pdf;
+      node_index = node_index + 1;
+    }
+    else {
+      u = (u - first_pdf) / (1.0f - first_pdf);
+      node_pdf *= 1.0f - first_pdf;
+      node_index = child_index;
+    }
+
+    child_index = kernel_tex_fetch(__light_tree_nodes, node_index).child_index;
+  }
+
+  *randu = min(u, 1.0f - FLT_EPSILON);
+  *pdf = node_pdf;
+  return ~child_index;
+}
+
+/* Probability of light_tree_sample picking the emitter in the given leaf. */
+ccl_device float light_tree_leaf_pdf(const KernelGlobals *kg, int node_index, const float3 P)
+{
+  float pdf = 1.0f;
+
+  int parent_index = kernel_tex_fetch(__light_tree_nodes, node_index).parent_index;
+  while (parent_index >= 0) {
+    float first_pdf;
+    if (!light_tree_child_probability(kg, parent_index, P, &first_pdf)) {
+      return 0.0f;
+    }
+
+    pdf *= (node_index == parent_index + 1) ? first_pdf : 1.0f - first_pdf;
+    node_index = parent_index;
+    parent_index = kernel_tex_fetch(__light_tree_nodes, node_index).parent_index;
+  }
+
+  return pdf;
+}
+
+/* Leaf of a lamp, or -1 for lamps that are not in the tree. */
+ccl_device_inline int light_tree_lamp_leaf(const KernelGlobals *kg, const int lamp)
+{
+  return kernel_tex_fetch(__light_tree_leaf, lamp);
+}
+
+/* Leaf of an emissive triangle, or -1 for triangles that are not in the tree. */
+ccl_device_inline int light_tree_triangle_leaf(const KernelGlobals *kg,
+                                               const int object,
+                                               const int prim)
+{
+  const int2 object_leafs = kernel_tex_fetch(__object_light_tree, object);
+  if (object_leafs.x == -1) {
+    return -1;
+  }
+  return kernel_tex_fetch(__light_tree_leaf, object_leafs.x + prim - object_leafs.y);
+}
+
+CCL_NAMESPACE_END
@@ -599,8 +599,17 @@ ccl_device void shader_eval_surface(INTEGRATOR_STATE_CONST_ARGS,
 #endif
   {
 #ifdef __SVM__
-    svm_eval_nodes<node_feature_mask, SHADER_TYPE_SURFACE>(
-        INTEGRATOR_STATE_PASS, sd, buffer, path_flag);
+#  ifdef __KERNEL_CPU__
+    if (kernel_tex_fetch(__shaders, (sd->shader & SHADER_MASK)).specialization ==
+        SHADER_SPECIALIZATION_SURFACE_BSDF) {
+      svm_eval_nodes_surface_bsdf<node_feature_mask>(INTEGRATOR_STATE_PASS, sd, path_flag);
+    }
+    else
+#  endif
+    {
+      svm_eval_nodes<node_feature_mask, SHADER_TYPE_SURFACE>(
+          INTEGRATOR_STATE_PASS, sd, buffer, path_flag);
+    }
 #else
     if (sd->object == OBJECT_NONE) {
       sd->closure_emission_background = make_float3(0.8f, 0.8f, 0.8f);
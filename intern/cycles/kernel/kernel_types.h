@@ -102,6 +102,9 @@ CCL_NAMESPACE_BEGIN
 #    define __OSL__
 #  endif
 #  define __VOLUME_RECORD_ALL__
+#  ifdef __KERNEL_SSE2__
+#    define __BVH4__
+#  endif
 #endif /* __KERNEL_CPU__ */
 
 #ifdef __KERNEL_OPTIX__
@@ -1118,6 +1121,10 @@ typedef struct KernelIntegrator {
   float pdf_lights;
   float light_inv_rr_threshold;
 
+  /* light tree, zero probability when lights are sampled from the distribution */
+  float light_tree_pdf;
+  int num_distant_lights;
+
   /* bounces */
   int min_bounce;
   int max_bounce;
@@ -1161,9 +1168,6 @@ typedef struct KernelIntegrator {
   float volume_step_rate;
 
   int has_shadow_catcher;
-
-  /* padding */
-  int pad1, pad2;
 } KernelIntegrator;
 static_assert_align(KernelIntegrator, 16);
 
@@ -1171,14 +1175,15 @@ typedef enum KernelBVHLayout {
   BVH_LAYOUT_NONE = 0,
 
   BVH_LAYOUT_BVH2 = (1 << 0),
-  BVH_LAYOUT_EMBREE = (1 << 1),
-  BVH_LAYOUT_OPTIX = (1 << 2),
-  BVH_LAYOUT_MULTI_OPTIX = (1 << 3),
-  BVH_LAYOUT_MULTI_OPTIX_EMBREE = (1 << 4),
+  BVH_LAYOUT_BVH4 = (1 << 1),
+  BVH_LAYOUT_EMBREE = (1 << 2),
+  BVH_LAYOUT_OPTIX = (1 << 3),
+  BVH_LAYOUT_MULTI_OPTIX = (1 << 4),
+  BVH_LAYOUT_MULTI_OPTIX_EMBREE = (1 << 5),
 
   /* Default BVH layout to use for CPU. */
   BVH_LAYOUT_AUTO = BVH_LAYOUT_EMBREE,
-  BVH_LAYOUT_ALL = BVH_LAYOUT_BVH2 | BVH_LAYOUT_EMBREE | BVH_LAYOUT_OPTIX,
+  BVH_LAYOUT_ALL = BVH_LAYOUT_BVH2 | BVH_LAYOUT_BVH4 | BVH_LAYOUT_EMBREE | BVH_LAYOUT_OPTIX,
 } KernelBVHLayout;
 
 typedef struct KernelBVH {
@@ -1332,6 +1337,25 @@ typedef struct KernelLightDistribution {
 } KernelLightDistribution;
 static_assert_align(KernelLightDistribution, 16);
 
+typedef struct KernelLightTreeNode {
+  float bbox_min[3];
+  float energy;
+  float bbox_max[3];
+  /* Spread of the emitter normals around the axis. */
+  float theta_o;
+  float axis[3];
+  /* Spread of the emission around the emitter normals. */
+  float theta_e;
+  /* Second child of an inner node, the first child directly follows the node. For leaves the
+   * bitwise negated index of the emitter in the light distribution. */
+  int child_index;
+  int parent_index;
+  /* Emitters also emit around the negated normals. */
+  int two_sided;
+  int pad;
+} KernelLightTreeNode;
+static_assert_align(KernelLightTreeNode, 16);
+
 typedef struct KernelParticle {
   int index;
   float age;
@@ -1351,7 +1375,8 @@ typedef struct KernelShader {
   float cryptomatte_id;
   int flags;
   int pass_id;
-  int pad2, pad3;
+  int specialization;
+  int pad3;
 } KernelShader;
 static_assert_align(KernelShader, 16);
 
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Nodes of the specialized surface BSDF interpreter loop, with the code evaluating them.
+ *
+ * Included by svm_eval_nodes_surface_bsdf() in the kernel to generate its switch, and by the SVM
+ * compiler to decide which shaders can use the loop, so that both always handle the same nodes.
+ * The code uses the variables of the interpreter loop. */
+
+#ifndef SVM_SURFACE_BSDF_NODE
+#  define SVM_SURFACE_BSDF_NODE(node_type, ...)
+#endif
+
+SVM_SURFACE_BSDF_NODE(NODE_END, return;)
+SVM_SURFACE_BSDF_NODE(NODE_SHADER_JUMP, offset = node.y;)
+SVM_SURFACE_BSDF_NODE(NODE_CLOSURE_BSDF,
+                      offset = svm_node_closure_bsdf<node_feature_mask, type>(
+                          kg, sd, stack, node, path_flag, offset);)
+SVM_SURFACE_BSDF_NODE(NODE_CLOSURE_EMISSION,
+                      if (KERNEL_NODES_FEATURE(EMISSION)) {
+                        svm_node_closure_emission(sd, stack, node);
+                      })
+SVM_SURFACE_BSDF_NODE(NODE_CLOSURE_SET_WEIGHT,
+                      svm_node_closure_set_weight(sd, node.y, node.z, node.w);)
+SVM_SURFACE_BSDF_NODE(NODE_CLOSURE_WEIGHT, svm_node_closure_weight(sd, stack, node.y);)
+SVM_SURFACE_BSDF_NODE(NODE_EMISSION_WEIGHT,
+                      if (KERNEL_NODES_FEATURE(EMISSION)) {
+                        svm_node_emission_weight(kg, sd, stack, node);
+                      })
+SVM_SURFACE_BSDF_NODE(NODE_MIX_CLOSURE, svm_node_mix_closure(sd, stack, node);)
+SVM_SURFACE_BSDF_NODE(NODE_JUMP_IF_ZERO,
+                      if (stack_load_float(stack, node.z) == 0.0f)
+                        offset += node.y;)
+SVM_SURFACE_BSDF_NODE(NODE_JUMP_IF_ONE,
+                      if (stack_load_float(stack, node.z) == 1.0f)
+                        offset += node.y;)
+SVM_SURFACE_BSDF_NODE(NODE_GEOMETRY, svm_node_geometry(kg, sd, stack, node.y, node.z);)
+SVM_SURFACE_BSDF_NODE(NODE_CONVERT, svm_node_convert(kg, sd, stack, node.y, node.z, node.w);)
+SVM_SURFACE_BSDF_NODE(NODE_TEX_COORD,
+                      offset = svm_node_tex_coord(kg, sd, path_flag, stack, node, offset);)
+SVM_SURFACE_BSDF_NODE(NODE_VALUE_F, svm_node_value_f(kg, sd, stack, node.y, node.z);)
+SVM_SURFACE_BSDF_NODE(NODE_VALUE_V, offset = svm_node_value_v(kg, sd, stack, node.y, offset);)
+SVM_SURFACE_BSDF_NODE(NODE_ATTR, svm_node_attr<node_feature_mask>(kg, sd, stack, node);)
+SVM_SURFACE_BSDF_NODE(NODE_VERTEX_COLOR,
+                      svm_node_vertex_color(kg, sd, stack, node.y, node.z, node.w);)
+SVM_SURFACE_BSDF_NODE(NODE_TEX_IMAGE, offset = svm_node_tex_image(kg, sd, stack, node, offset);)
+SVM_SURFACE_BSDF_NODE(NODE_TEX_IMAGE_BOX, svm_node_tex_image_box(kg, sd, stack, node);)
+SVM_SURFACE_BSDF_NODE(NODE_MAPPING, svm_node_mapping(kg, sd, stack, node.y, node.z, node.w);)
+SVM_SURFACE_BSDF_NODE(NODE_NORMAL_MAP, svm_node_normal_map(kg, sd, stack, node);)
+SVM_SURFACE_BSDF_NODE(NODE_MATH, svm_node_math(kg, sd, stack, node.y, node.z, node.w);)
+SVM_SURFACE_BSDF_NODE(NODE_VECTOR_MATH,
+                      offset = svm_node_vector_math(
+                          kg, sd, stack, node.y, node.z, node.w, offset);)
+SVM_SURFACE_BSDF_NODE(NODE_MIX,
+                      offset = svm_node_mix(kg, sd, stack, node.y, node.z, node.w, offset);)
+SVM_SURFACE_BSDF_NODE(NODE_INVERT, svm_node_invert(sd, stack, node.y, node.z, node.w);)
+SVM_SURFACE_BSDF_NODE(NODE_GAMMA, svm_node_gamma(sd, stack, node.y, node.z, node.w);)
+SVM_SURFACE_BSDF_NODE(NODE_BRIGHTCONTRAST, svm_node_brightness(sd, stack, node.y, node.z, node.w);)
+SVM_SURFACE_BSDF_NODE(NODE_HSV, svm_node_hsv(kg, sd, stack, node);)
+SVM_SURFACE_BSDF_NODE(NODE_SEPARATE_VECTOR,
+                      svm_node_separate_vector(sd, stack, node.y, node.z, node.w);)
+SVM_SURFACE_BSDF_NODE(NODE_COMBINE_VECTOR,
+                      svm_node_combine_vector(sd, stack, node.y, node.z, node.w);)
+SVM_SURFACE_BSDF_NODE(NODE_FRESNEL, svm_node_fresnel(sd, stack, node.y, node.z, node.w);)
+SVM_SURFACE_BSDF_NODE(NODE_LAYER_WEIGHT, svm_node_layer_weight(sd, stack, node);)
+SVM_SURFACE_BSDF_NODE(NODE_RGB_RAMP, offset = svm_node_rgb_ramp(kg, sd, stack, node, offset);)
+SVM_SURFACE_BSDF_NODE(NODE_MAP_RANGE,
+                      offset = svm_node_map_range(kg, sd, stack, node.y, node.z, node.w, offset);)
+SVM_SURFACE_BSDF_NODE(NODE_CLAMP,
+                      offset = svm_node_clamp(kg, sd, stack, node.y, node.z, node.w, offset);)
+
+#undef SVM_SURFACE_BSDF_NODE
@@ -487,6 +487,14 @@ typedef enum ShaderType {
   SHADER_TYPE_BUMP,
 } ShaderType;
 
+/* Specialized interpreter loop to evaluate the surface of a shader on the CPU, chosen by the
+ * SVM compiler from the nodes the surface program is made of. */
+typedef enum ShaderSpecialization {
+  SHADER_SPECIALIZATION_NONE = 0,
+  /* BSDF and emission closures with inputs from textures, attributes and simple math. */
+  SHADER_SPECIALIZATION_SURFACE_BSDF = 1,
+} ShaderSpecialization;
+
 typedef enum NodePrincipledHairParametrization {
   NODE_PRINCIPLED_HAIR_REFLECTANCE = 0,
   NODE_PRINCIPLED_HAIR_PIGMENT_CONCENTRATION = 1,
@@ -178,12 +178,19 @@ class RenderBuffers {
  * `src_offset` allows to offset source pixel index which is used when a fraction of the source
  * buffer is to be copied.
  *
- * Copy happens of the number of pixels in the destination. */
+ * Copy happens of the number of pixels in the destination.
+ *
+ * Non-zero `src_num_samples` rescales denoised pixels from the number of samples they were
+ * denoised at to the `dst_num_samples` which are in the destination. This allows to use denoised
+ * result of an earlier snapshot of the destination. If both buffers have the sample count pass
+ * the per-pixel number of samples is used instead. */
 void render_buffers_host_copy_denoised(RenderBuffers *dst,
                                        const BufferParams &dst_params,
                                        const RenderBuffers *src,
                                        const BufferParams &src_params,
-                                       const size_t src_offset = 0);
+                                       const size_t src_offset = 0,
+                                       const int src_num_samples = 0,
+                                       const int dst_num_samples = 0);
 
 CCL_NAMESPACE_END
 
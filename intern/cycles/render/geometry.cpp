@@ -41,6 +41,7 @@
 #include "util/util_logging.h"
 #include "util/util_progress.h"
 #include "util/util_task.h"
+#include "util/util_time.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -309,6 +310,7 @@ GeometryManager::GeometryManager()
 {
   update_flags = UPDATE_ALL;
   need_flags_update = true;
+  scene_bvh_build_time = 0.0;
 }
 
 GeometryManager::~GeometryManager()
@@ -1253,8 +1255,22 @@ void GeometryManager::device_update_bvh(Device *device,
 
   VLOG(1) << "Using " << bvh_layout_name(bparams.bvh_layout) << " layout.";
 
-  const bool can_refit = scene->bvh != nullptr &&
-                         (bparams.bvh_layout == BVHLayout::BVH_LAYOUT_OPTIX);
+  const bool has_bvh2_layout = (bparams.bvh_layout == BVH_LAYOUT_BVH2 ||
+                                bparams.bvh_layout == BVH_LAYOUT_BVH4);
+
+  /* The scene BVH is deleted when geometry is added, removed or changes topology, so an existing
+   * BVH2 has the same primitives and only needs its bounds refitted to the new positions. Time
+   * steps in the BVH can not be refitted. */
+  bool can_refit = false;
+  if (scene->bvh != nullptr) {
+    if (bparams.bvh_layout == BVHLayout::BVH_LAYOUT_OPTIX) {
+      can_refit = true;
+    }
+    else if (has_bvh2_layout && scene->bvh->params.bvh_layout == bparams.bvh_layout &&
+             scene->params.num_bvh_time_steps == 0 && dscene->bvh_leaf_nodes.size() != 0) {
+      can_refit = static_cast<BVH2 *>(scene->bvh)->can_refit_top_level(scene->objects);
+    }
+  }
 
   PackFlags pack_flags = PackFlags::PACK_NONE;
 
@@ -1271,13 +1287,41 @@ void GeometryManager::device_update_bvh(Device *device,
     bvh = scene->bvh = BVH::create(bparams, scene->geometry, scene->objects, device);
   }
 
+  if (can_refit && has_bvh2_layout) {
+    /* Refit in place, taking back the packed BVH from the device arrays. */
+    BVH2 *bvh2 = static_cast<BVH2 *>(bvh);
+    bvh2->geometry = scene->geometry;
+    bvh2->objects = scene->objects;
+
+    dscene->bvh_nodes.give_data(bvh2->pack.nodes);
+    dscene->bvh_leaf_nodes.give_data(bvh2->pack.leaf_nodes);
+    dscene->object_node.give_data(bvh2->pack.object_node);
+    dscene->prim_tri_index.give_data(bvh2->pack.prim_tri_index);
+    dscene->prim_tri_verts.give_data(bvh2->pack.prim_tri_verts);
+    dscene->prim_type.give_data(bvh2->pack.prim_type);
+    dscene->prim_visibility.give_data(bvh2->pack.prim_visibility);
+    dscene->prim_index.give_data(bvh2->pack.prim_index);
+    dscene->prim_object.give_data(bvh2->pack.prim_object);
+    dscene->prim_time.give_data(bvh2->pack.prim_time);
+    bvh2->pack.root_index = dscene->data.bvh.root;
+  }
+
+  const double build_start_time = time_dt();
+
   device->build_bvh(bvh, progress, can_refit);
 
   if (progress.get_cancel()) {
     return;
   }
 
-  const bool has_bvh2_layout = (bparams.bvh_layout == BVH_LAYOUT_BVH2);
+  const double build_time = time_dt() - build_start_time;
+  if (!can_refit) {
+    scene_bvh_build_time = build_time;
+  }
+  else if (scene_bvh_build_time > 0.0) {
+    VLOG(1) << "Refitted scene BVH in " << build_time << " seconds, saved "
+            << max(scene_bvh_build_time - build_time, 0.0) << " seconds of building.";
+  }
 
   PackedBVH pack;
   if (has_bvh2_layout) {
@@ -1993,9 +2037,19 @@ void GeometryManager::device_update(Device *device,
     TaskPool pool;
 
     size_t i = 0;
+    size_t num_bvh_refit = 0, num_bvh_reused = 0;
     foreach (Geometry *geom, scene->geometry) {
-      if (geom->is_modified() || geom->need_update_bvh_for_offset) {
+      if (!(geom->is_modified() || geom->need_update_bvh_for_offset)) {
+        if (geom->need_build_bvh(bvh_layout) && geom->bvh) {
+          num_bvh_reused++;
+        }
+      }
+      else {
         need_update_scene_bvh = true;
+        /* Count before pushing, the task resets the geometry update flags. */
+        if (geom->need_build_bvh(bvh_layout) && geom->bvh && !geom->need_update_rebuild) {
+          num_bvh_refit++;
+        }
         pool.push(function_bind(
             &Geometry::compute_bvh, geom, device, dscene, &scene->params, &progress, i, num_bvh));
         if (geom->need_build_bvh(bvh_layout)) {
@@ -2007,6 +2061,8 @@ void GeometryManager::device_update(Device *device,
     TaskPool::Summary summary;
     pool.wait_work(&summary);
     VLOG(2) << "Objects BVH build pool statistics:\n" << summary.full_report();
+    VLOG(1) << "Built " << i - num_bvh_refit << " and refitted " << num_bvh_refit
+            << " object BVHs, reused " << num_bvh_reused << " unchanged.";
   }
 
   foreach (Shader *shader, scene->shaders) {
@@ -193,6 +193,9 @@ class Geometry : public Node {
 class GeometryManager {
   uint32_t update_flags;
 
+  /* Time of the last full scene BVH build, to report the time saved by refitting. */
+  double scene_bvh_build_time;
+
  public:
   enum : uint32_t {
     UV_PASS_NEEDED = (1 << 0),
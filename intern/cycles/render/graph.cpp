@@ -383,6 +383,9 @@ void ShaderGraph::finalize(Scene *scene, bool do_bump, bool do_simplify, bool bu
     if (do_bump)
       bump_from_displacement(bump_in_object_space);
 
+    if (scene->image_manager->use_texture_cache())
+      image_texture_differentials(scene);
+
     ShaderInput *surface_in = output()->input("Surface");
     ShaderInput *volume_in = output()->input("Volume");
 
@@ -954,6 +957,61 @@ void ShaderGraph::refine_bump_nodes()
   }
 }
 
+void ShaderGraph::image_texture_differentials(Scene *scene)
+{
+  /* Images from the texture cache pick a mipmap level from the differentials of their texture
+   * coordinate. Like bump mapping, we make 2 extra copies of the subgraph defined in the vector
+   * input, with texture coordinates shifted by dx/dy, and connect these to internal inputs. */
+  vector<ShaderNode *> image_nodes;
+
+  foreach (ShaderNode *node, nodes) {
+    if (node->type != ImageTextureNode::get_node_type() || node->bump != SHADER_BUMP_NONE ||
+        !node->input("Vector")->link) {
+      continue;
+    }
+    ImageTextureNode *image_node = (ImageTextureNode *)node;
+    if (image_node->get_projection() == NODE_IMAGE_PROJ_BOX) {
+      continue;
+    }
+    /* Builtin, packed and other images that are fully loaded don't use the differentials. */
+    image_node->ensure_handle(scene, this);
+    if (!image_node->handle.use_texture_cache(scene->params.texture_limit)) {
+      continue;
+    }
+    image_nodes.push_back(node);
+  }
+
+  foreach (ShaderNode *node, image_nodes) {
+    ShaderInput *vector_input = node->input("Vector");
+    ShaderNodeSet nodes_vector;
+
+    ShaderNodeMap nodes_dx;
+    ShaderNodeMap nodes_dy;
+
+    find_dependencies(nodes_vector, vector_input);
+
+    copy_nodes(nodes_vector, nodes_dx);
+    copy_nodes(nodes_vector, nodes_dy);
+
+    foreach (NodePair &pair, nodes_dx)
+      pair.second->bump = SHADER_BUMP_DX;
+    foreach (NodePair &pair, nodes_dy)
+      pair.second->bump = SHADER_BUMP_DY;
+
+    ShaderOutput *out = vector_input->link;
+    ShaderOutput *out_dx = nodes_dx[out->parent]->output(out->name());
+    ShaderOutput *out_dy = nodes_dy[out->parent]->output(out->name());
+
+    connect(out_dx, node->input("Vector Dx"));
+    connect(out_dy, node->input("Vector Dy"));
+
+    foreach (NodePair &pair, nodes_dx)
+      add(pair.second);
+    foreach (NodePair &pair, nodes_dy)
+      add(pair.second);
+  }
+}
+
 void ShaderGraph::bump_from_displacement(bool use_object_space)
 {
   /* generate bump mapping automatically from displacement. bump mapping is
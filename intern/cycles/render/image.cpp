@@ -32,6 +32,8 @@
 #include "util/util_texture.h"
 #include "util/util_unique_ptr.h"
 
+#include <OpenImageIO/texture.h>
+
 #ifdef WITH_OSL
 #  include <OSL/oslexec.h>
 #endif
@@ -77,6 +79,8 @@ const char *name_from_type(ImageDataType type)
       return "nanovdb_float";
     case IMAGE_DATA_TYPE_NANOVDB_FLOAT3:
       return "nanovdb_float3";
+    case IMAGE_DATA_TYPE_TEXTURE_CACHE:
+      return "texture_cache";
     case IMAGE_DATA_NUM_TYPES:
       assert(!"System enumerator type, should never be used");
       return "";
@@ -151,6 +155,19 @@ ImageMetaData ImageHandle::metadata()
   return img->metadata;
 }
 
+/* Whether the image will be read on demand from the texture cache. All tiles are loaded the
+ * same way, so only the first one is checked. */
+bool ImageHandle::use_texture_cache(const int texture_limit)
+{
+  if (tile_slots.empty()) {
+    return false;
+  }
+
+  ImageManager::Image *img = manager->images[tile_slots.front()];
+  manager->load_image_metadata(img);
+  return manager->image_use_texture_cache(img, texture_limit);
+}
+
 int ImageHandle::svm_slot(const int tile_index) const
 {
   if (tile_index >= tile_slots.size()) {
@@ -300,17 +317,23 @@ ImageManager::ImageManager(const DeviceInfo &info)
 {
   need_update_ = true;
   osl_texture_system = NULL;
+  texture_cache = NULL;
   animation_frame = 0;
 
   /* Set image limits */
   features.has_half_float = info.has_half_images;
   features.has_nanovdb = info.has_nanovdb;
+  features.has_texture_cache = (info.type == DEVICE_CPU);
 }
 
 ImageManager::~ImageManager()
 {
   for (size_t slot = 0; slot < images.size(); slot++)
     assert(!images[slot]);
+
+  if (texture_cache) {
+    OIIO::TextureSystem::destroy(texture_cache);
+  }
 }
 
 void ImageManager::set_osl_texture_system(void *texture_system)
@@ -318,6 +341,29 @@ void ImageManager::set_osl_texture_system(void *texture_system)
   osl_texture_system = texture_system;
 }
 
+void ImageManager::set_texture_cache_size(int max_memory_mb)
+{
+  if (!features.has_texture_cache) {
+    return;
+  }
+
+  if (texture_cache == NULL) {
+    texture_cache = OIIO::TextureSystem::create(false);
+    /* Split files that are not tiled or mipmapped on load, so that large scanline images can
+     * still be partially resident. */
+    texture_cache->attribute("autotile", 64);
+    texture_cache->attribute("automip", 1);
+  }
+
+  texture_cache->attribute("max_memory_MB", (float)max_memory_mb);
+}
+
+bool ImageManager::use_texture_cache() const
+{
+  /* OSL has its own texture system for file images. */
+  return texture_cache != NULL && osl_texture_system == NULL;
+}
+
 bool ImageManager::set_animation_frame_update(int frame)
 {
   if (frame != animation_frame) {
@@ -486,6 +532,34 @@ static bool image_associate_alpha(ImageManager::Image *img)
            img->params.alpha_type == IMAGE_ALPHA_CHANNEL_PACKED);
 }
 
+bool ImageManager::image_use_texture_cache(Image *img, const int texture_limit)
+{
+  if (!use_texture_cache() || img->builtin || img->loader->osl_filepath().empty()) {
+    return false;
+  }
+
+  /* Images are not resized when loaded on demand, so the texture limit takes precedence. */
+  if (texture_limit > 0) {
+    return false;
+  }
+
+  /* Only 2D images, and files that could not be read keep using the missing texture. */
+  const ImageMetaData &metadata = img->metadata;
+  if (metadata.channels == 0 || metadata.depth > 1 || metadata.use_transform_3d) {
+    return false;
+  }
+
+  /* Pixels are returned as stored in the file, so no color space conversion is possible. An sRGB
+   * image is converted by the kernel like other images with compress_as_srgb. */
+  if (metadata.colorspace != u_colorspace_raw && metadata.colorspace != u_colorspace_srgb) {
+    return false;
+  }
+
+  /* The texture system always associates alpha. */
+  const bool has_alpha = (metadata.channels == 2 || metadata.channels == 4);
+  return !has_alpha || image_associate_alpha(img);
+}
+
 template<TypeDesc::BASETYPE FileFormat, typename StorageType>
 bool ImageManager::file_load_image(Image *img, int texture_limit)
 {
@@ -657,6 +731,10 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
   load_image_metadata(img);
   ImageDataType type = img->metadata.type;
 
+  if (image_use_texture_cache(img, texture_limit)) {
+    type = IMAGE_DATA_TYPE_TEXTURE_CACHE;
+  }
+
   /* Name for debugging. */
   img->mem_name = string_printf("__tex_image_%s_%03d", name_from_type(type), slot);
 
@@ -673,7 +751,22 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
   img->mem->info.transform_3d = img->metadata.transform_3d;
 
   /* Create new texture. */
-  if (type == IMAGE_DATA_TYPE_FLOAT4) {
+  if (type == IMAGE_DATA_TYPE_TEXTURE_CACHE) {
+    /* Tiles are read by the kernel when sampled, only store where to find them. Invalidate
+     * first so modified files are read again. */
+    const ustring filepath = img->loader->osl_filepath();
+    texture_cache->invalidate(filepath);
+    OIIO::TextureSystem::TextureHandle *handle = texture_cache->get_texture_handle(filepath);
+
+    thread_scoped_lock device_lock(device_mutex);
+    TextureCacheImage *cache_image = (TextureCacheImage *)img->mem->alloc(
+        sizeof(TextureCacheImage), 0);
+
+    cache_image->texture_system = texture_cache;
+    cache_image->texture_handle = handle;
+    cache_image->channels = img->metadata.channels;
+  }
+  else if (type == IMAGE_DATA_TYPE_FLOAT4) {
     if (!file_load_image<TypeDesc::FLOAT, float>(img, texture_limit)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
@@ -794,6 +887,11 @@ void ImageManager::device_free_image(Device *, int slot)
 #endif
   }
 
+  if (img->mem && img->mem->info.data_type == IMAGE_DATA_TYPE_TEXTURE_CACHE) {
+    /* Release cached tiles of the file. */
+    texture_cache->invalidate(img->loader->osl_filepath());
+  }
+
   if (img->mem) {
     thread_scoped_lock device_lock(device_mutex);
     delete img->mem;
@@ -27,6 +27,10 @@
 #include "util/util_unique_ptr.h"
 #include "util/util_vector.h"
 
+OIIO_NAMESPACE_BEGIN
+class TextureSystem;
+OIIO_NAMESPACE_END
+
 CCL_NAMESPACE_BEGIN
 
 class Device;
@@ -102,6 +106,7 @@ class ImageDeviceFeatures {
  public:
   bool has_half_float;
   bool has_nanovdb;
+  bool has_texture_cache;
 };
 
 /* Image loader base class, that can be subclassed to load image data
@@ -157,6 +162,7 @@ class ImageHandle {
   int num_tiles();
 
   ImageMetaData metadata();
+  bool use_texture_cache(const int texture_limit);
   int svm_slot(const int tile_index = 0) const;
   device_texture *image_memory(const int tile_index = 0) const;
 
@@ -192,6 +198,8 @@ class ImageManager {
   void device_free_builtin(Device *device);
 
   void set_osl_texture_system(void *texture_system);
+  void set_texture_cache_size(int max_memory_mb);
+  bool use_texture_cache() const;
   bool set_animation_frame_update(int frame);
 
   void collect_statistics(RenderStats *stats);
@@ -229,11 +237,15 @@ class ImageManager {
   vector<Image *> images;
   void *osl_texture_system;
 
+  /* OpenImageIO texture system used as texture cache on the CPU. */
+  OIIO::TextureSystem *texture_cache;
+
   int add_image_slot(ImageLoader *loader, const ImageParams &params, const bool builtin);
   void add_image_user(int slot);
   void remove_image_user(int slot);
 
   void load_image_metadata(Image *img);
+  bool image_use_texture_cache(Image *img, const int texture_limit);
 
   template<TypeDesc::BASETYPE FileFormat, typename StorageType>
   bool file_load_image(Image *img, int texture_limit);
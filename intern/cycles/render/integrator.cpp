@@ -75,6 +75,7 @@ NODE_DEFINE(Integrator)
   SOCKET_INT(adaptive_min_samples, "Adaptive Min Samples", 0);
 
   SOCKET_FLOAT(light_sampling_threshold, "Light Sampling Threshold", 0.05f);
+  SOCKET_BOOLEAN(use_light_tree, "Use Light Tree", false);
 
   static NodeEnum sampling_pattern_enum;
   sampling_pattern_enum.insert("sobol", SAMPLING_PATTERN_SOBOL);
@@ -100,6 +101,7 @@ NODE_DEFINE(Integrator)
   SOCKET_BOOLEAN(use_denoise_pass_normal, "Use Normal Pass for Denoiser", true);
   SOCKET_ENUM(
       denoiser_prefilter, "Denoiser Type", denoiser_prefilter_enum, DENOISER_PREFILTER_ACCURATE);
+  SOCKET_BOOLEAN(use_denoise_async, "Use Asynchronous Denoising", false);
 
   return type;
 }
@@ -266,6 +268,10 @@ void Integrator::tag_update(Scene *scene, uint32_t flag)
     scene->object_manager->tag_update(scene, ObjectManager::MOTION_BLUR_MODIFIED);
     scene->camera->tag_modified();
   }
+
+  if (use_light_tree_is_modified()) {
+    scene->light_manager->tag_update(scene, LightManager::UPDATE_ALL);
+  }
 }
 
 AdaptiveSampling Integrator::get_adaptive_sampling() const
@@ -326,6 +332,8 @@ DenoiseParams Integrator::get_denoise_params() const
 
   denoise_params.prefilter = denoiser_prefilter;
 
+  denoise_params.use_async = use_denoise_async;
+
   return denoise_params;
 }
 
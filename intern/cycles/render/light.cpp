@@ -21,6 +21,7 @@
 #include "render/graph.h"
 #include "render/integrator.h"
 #include "render/light.h"
+#include "render/light_tree.h"
 #include "render/mesh.h"
 #include "render/nodes.h"
 #include "render/object.h"
@@ -30,9 +31,11 @@
 
 #include "integrator/shader_eval.h"
 
+#include "util/util_algorithm.h"
 #include "util/util_foreach.h"
 #include "util/util_hash.h"
 #include "util/util_logging.h"
+#include "util/util_map.h"
 #include "util/util_path.h"
 #include "util/util_progress.h"
 #include "util/util_task.h"
@@ -269,6 +272,62 @@ bool LightManager::object_usable_as_light(Object *object)
   return false;
 }
 
+/* Rough estimate of the emitted radiance of a shader, to balance emitters in the light tree.
+ * Shaders with textures or other varying emission are assumed to emit uniformly. */
+static float light_tree_emission_estimate(Shader *shader, map<Shader *, float> &estimates)
+{
+  map<Shader *, float>::iterator it = estimates.find(shader);
+  if (it != estimates.end()) {
+    return it->second;
+  }
+
+  float3 emission;
+  const float estimate = (shader->is_constant_emission(&emission)) ? average(fabs(emission)) :
+                                                                     1.0f;
+  estimates[shader] = estimate;
+  return estimate;
+}
+
+static bool light_tree_use_light(const Light *light)
+{
+  return light->get_light_type() == LIGHT_POINT || light->get_light_type() == LIGHT_SPOT ||
+         light->get_light_type() == LIGHT_AREA;
+}
+
+static LightTreeEmitter light_tree_light_emitter(const Light *light, const float emission)
+{
+  LightTreeEmitter emitter;
+  const float3 co = light->get_co();
+  const float3 dir = safe_normalize(light->get_dir());
+  const float strength = average(fabs(light->get_strength())) * emission;
+
+  if (light->get_light_type() == LIGHT_AREA) {
+    const float3 axisu = light->get_axisu() * (0.5f * light->get_sizeu() * light->get_size());
+    const float3 axisv = light->get_axisv() * (0.5f * light->get_sizev() * light->get_size());
+    emitter.bbox.grow(co - axisu - axisv);
+    emitter.bbox.grow(co - axisu + axisv);
+    emitter.bbox.grow(co + axisu - axisv);
+    emitter.bbox.grow(co + axisu + axisv);
+    emitter.cone.axis = dir;
+    emitter.energy = 0.25f * strength;
+  }
+  else {
+    const float3 radius = make_float3(light->get_size(), light->get_size(), light->get_size());
+    emitter.bbox.grow(co - radius);
+    emitter.bbox.grow(co + radius);
+    if (light->get_light_type() == LIGHT_SPOT) {
+      emitter.cone.axis = dir;
+      emitter.cone.theta_e = min(0.5f * light->get_spot_angle(), M_PI_2_F);
+    }
+    else {
+      emitter.cone.theta_o = M_PI_F;
+    }
+    emitter.energy = 0.25f * M_1_PI_F * strength;
+  }
+
+  return emitter;
+}
+
 void LightManager::device_update_distribution(Device *,
                                               DeviceScene *dscene,
                                               Scene *scene,
@@ -280,13 +339,21 @@ void LightManager::device_update_distribution(Device *,
   size_t num_lights = 0;
   size_t num_portals = 0;
   size_t num_background_lights = 0;
+  size_t num_distant_lights = 0;
   size_t num_triangles = 0;
 
   bool background_mis = false;
 
+  /* Lights to add to the distribution, with their index in the device lights. */
+  vector<pair<Light *, int>> distribution_lights;
+
   foreach (Light *light, scene->lights) {
     if (light->is_enabled) {
+      distribution_lights.push_back(pair<Light *, int>(light, (int)num_lights));
       num_lights++;
+      if (!light_tree_use_light(light)) {
+        num_distant_lights++;
+      }
     }
     if (light->is_portal) {
       num_portals++;
@@ -319,6 +386,27 @@ void LightManager::device_update_distribution(Device *,
   size_t num_distribution = num_triangles + num_lights;
   VLOG(1) << "Total " << num_distribution << " of light distribution primitives.";
 
+  /* The light tree contains triangles and local lights, distant and background lights are
+   * sampled separately and are stored at the end of the distribution. */
+  const bool use_light_tree = scene->integrator->get_use_light_tree() &&
+                              num_distribution > num_distant_lights;
+  vector<LightTreeEmitter> emitters;
+  /* Emitter of every light, followed by the emitters of the triangles of every object. */
+  vector<int> emitter_map;
+  vector<int2> object_emitter_map;
+  map<Shader *, float> emission_estimates;
+
+  if (use_light_tree) {
+    std::stable_partition(distribution_lights.begin(),
+                          distribution_lights.end(),
+                          [](const pair<Light *, int> &light) {
+                            return light_tree_use_light(light.first);
+                          });
+    emitters.reserve(num_distribution - num_distant_lights);
+    emitter_map.resize(num_lights, -1);
+    object_emitter_map.resize(scene->objects.size(), make_int2(-1, 0));
+  }
+
   /* emission area */
   KernelLightDistribution *distribution = dscene->light_distribution.alloc(num_distribution + 1);
   float totarea = 0.0f;
@@ -362,6 +450,12 @@ void LightManager::device_update_distribution(Device *,
     }
 
     size_t mesh_num_triangles = mesh->num_triangles();
+    const int emitter_map_offset = emitter_map.size();
+    if (use_light_tree) {
+      emitter_map.resize(emitter_map_offset + mesh_num_triangles, -1);
+      object_emitter_map[object_id] = make_int2(emitter_map_offset, mesh->prim_offset);
+    }
+
     for (size_t i = 0; i < mesh_num_triangles; i++) {
       int shader_index = mesh->get_shader()[i];
       Shader *shader = (shader_index < mesh->get_used_shaders().size()) ?
@@ -369,6 +463,7 @@ void LightManager::device_update_distribution(Device *,
                            scene->default_surface;
 
       if (shader->get_use_mis() && shader->has_surface_emission) {
+        const int distribution_index = offset;
         distribution[offset].totarea = totarea;
         distribution[offset].prim = i + mesh->prim_offset;
         distribution[offset].mesh_light.shader_flag = shader_flag;
@@ -389,7 +484,21 @@ void LightManager::device_update_distribution(Device *,
           p3 = transform_point(&tfm, p3);
         }
 
-        totarea += triangle_area(p1, p2, p3);
+        const float area = triangle_area(p1, p2, p3);
+        totarea += area;
+
+        if (use_light_tree) {
+          LightTreeEmitter emitter;
+          emitter.bbox.grow(p1);
+          emitter.bbox.grow(p2);
+          emitter.bbox.grow(p3);
+          emitter.cone.axis = safe_normalize(cross(p2 - p1, p3 - p1));
+          emitter.cone.two_sided = true;
+          emitter.energy = area * light_tree_emission_estimate(shader, emission_estimates);
+          emitter.distribution_index = distribution_index;
+          emitter_map[emitter_map_offset + i] = emitters.size();
+          emitters.push_back(emitter);
+        }
       }
     }
 
@@ -403,9 +512,18 @@ void LightManager::device_update_distribution(Device *,
 
   if (num_lights > 0) {
     float lightarea = (totarea > 0.0f) ? totarea / num_lights : 1.0f;
-    foreach (Light *light, scene->lights) {
-      if (!light->is_enabled)
-        continue;
+    foreach (const auto &distribution_light, distribution_lights) {
+      Light *light = distribution_light.first;
+      light_index = distribution_light.second;
+
+      if (use_light_tree && light_tree_use_light(light)) {
+        Shader *shader = (light->shader) ? light->shader : scene->default_light;
+        LightTreeEmitter emitter = light_tree_light_emitter(
+            light, light_tree_emission_estimate(shader, emission_estimates));
+        emitter.distribution_index = offset;
+        emitter_map[light_index] = emitters.size();
+        emitters.push_back(emitter);
+      }
 
       distribution[offset].totarea = totarea;
       distribution[offset].prim = ~light_index;
@@ -427,9 +545,9 @@ void LightManager::device_update_distribution(Device *,
         background_mis |= light->use_mis;
       }
 
-      light_index++;
       offset++;
     }
+    light_index = num_lights;
   }
 
   /* normalize cumulative distribution functions */
@@ -478,6 +596,43 @@ void LightManager::device_update_distribution(Device *,
 
     kintegrator->use_lamp_mis = use_lamp_mis;
 
+    /* Light tree */
+    kintegrator->light_tree_pdf = 0.0f;
+    kintegrator->num_distant_lights = 0;
+
+    if (use_light_tree && !emitters.empty()) {
+      progress.set_status("Updating Lights", "Building light tree");
+
+      const LightTree light_tree(emitters);
+
+      const vector<KernelLightTreeNode> &nodes = light_tree.get_nodes();
+      KernelLightTreeNode *knodes = dscene->light_tree_nodes.alloc(nodes.size());
+      std::copy(nodes.begin(), nodes.end(), knodes);
+
+      const vector<int> &emitter_leafs = light_tree.get_emitter_leafs();
+      int *leafs = dscene->light_tree_leaf.alloc(emitter_map.size());
+      for (size_t i = 0; i < emitter_map.size(); i++) {
+        leafs[i] = (emitter_map[i] != -1) ? emitter_leafs[emitter_map[i]] : -1;
+      }
+
+      int2 *object_leafs = dscene->object_light_tree.alloc(object_emitter_map.size());
+      std::copy(object_emitter_map.begin(), object_emitter_map.end(), object_leafs);
+
+      dscene->light_tree_nodes.copy_to_device();
+      dscene->light_tree_leaf.copy_to_device();
+      dscene->object_light_tree.copy_to_device();
+
+      /* Half of the samples go to distant and background lights, if there are any. */
+      kintegrator->light_tree_pdf = (num_distant_lights) ? 0.5f : 1.0f;
+      kintegrator->num_distant_lights = num_distant_lights;
+      kintegrator->pdf_lights = (num_distant_lights) ?
+                                    (1.0f - kintegrator->light_tree_pdf) / num_distant_lights :
+                                    0.0f;
+
+      VLOG(1) << "Light tree with " << nodes.size() << " nodes for " << emitters.size()
+              << " emitters.";
+    }
+
     /* bit of an ugly hack to compensate for emitting triangles influencing
      * amount of samples we get for this pass */
     kfilm->pass_shadow_scale = 1.0f;
@@ -514,6 +669,8 @@ void LightManager::device_update_distribution(Device *,
     kintegrator->pdf_triangles = 0.0f;
     kintegrator->pdf_lights = 0.0f;
     kintegrator->use_lamp_mis = false;
+    kintegrator->light_tree_pdf = 0.0f;
+    kintegrator->num_distant_lights = 0;
 
     kbackground->num_portals = 0;
     kbackground->portal_offset = 0;
@@ -1008,6 +1165,9 @@ void LightManager::device_free(Device *, DeviceScene *dscene, const bool free_ba
 {
   dscene->light_distribution.free();
   dscene->lights.free();
+  dscene->light_tree_nodes.free();
+  dscene->light_tree_leaf.free();
+  dscene->object_light_tree.free();
   if (free_background) {
     dscene->light_background_marginal_cdf.free();
     dscene->light_background_conditional_cdf.free();
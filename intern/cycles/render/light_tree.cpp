@@ -0,0 +1,246 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/light_tree.h"
+
+#include "util/util_algorithm.h"
+#include "util/util_math.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Number of buckets to evaluate split candidates with. */
+static const int LIGHT_TREE_NUM_BUCKETS = 12;
+
+/* Below this depth nodes are split in the middle, which keeps the tree depth bounded even when
+ * the cost based splits are very unbalanced. */
+static const int LIGHT_TREE_MAX_COST_DEPTH = 64;
+
+/* Union of two cones, see "Importance Sampling of Many Lights with Adaptive Tree Splitting"
+ * by Conty Estevez and Kulla. */
+LightTreeCone LightTreeCone::merge(const LightTreeCone &cone_a, const LightTreeCone &cone_b)
+{
+  const bool swap = cone_a.theta_o < cone_b.theta_o;
+  const LightTreeCone &a = (swap) ? cone_b : cone_a;
+  const LightTreeCone &b = (swap) ? cone_a : cone_b;
+
+  LightTreeCone result;
+  result.axis = a.axis;
+  result.theta_e = max(a.theta_e, b.theta_e);
+  result.two_sided = a.two_sided || b.two_sided;
+
+  /* A two-sided cone covers the negated axis as well, use whichever is closer. */
+  float3 b_axis = b.axis;
+  if (result.two_sided && dot(a.axis, b_axis) < 0.0f) {
+    b_axis = -b_axis;
+  }
+
+  const float cos_theta_d = clamp(dot(a.axis, b_axis), -1.0f, 1.0f);
+  const float theta_d = acosf(cos_theta_d);
+
+  if (min(theta_d + b.theta_o, M_PI_F) <= a.theta_o) {
+    /* The first cone already contains the second one. */
+    result.theta_o = a.theta_o;
+    return result;
+  }
+
+  const float theta_o = 0.5f * (a.theta_o + theta_d + b.theta_o);
+  const float3 ortho = b_axis - a.axis * cos_theta_d;
+  const float ortho_len = len(ortho);
+  if (theta_o >= M_PI_F || ortho_len < 1e-6f) {
+    result.theta_o = M_PI_F;
+    return result;
+  }
+
+  /* Rotate the axis of the first cone towards the second one. */
+  const float theta_r = theta_o - a.theta_o;
+  result.axis = normalize(a.axis * cosf(theta_r) + (ortho / ortho_len) * sinf(theta_r));
+  result.theta_o = theta_o;
+  return result;
+}
+
+/* Measure of the directions the emitters in a cone emit towards. */
+static float light_tree_cone_measure(const LightTreeCone &cone)
+{
+  const float theta_o = cone.theta_o;
+  const float theta_w = min(theta_o + cone.theta_e, M_PI_F);
+  const float cos_theta_o = cosf(theta_o);
+  const float sin_theta_o = sinf(theta_o);
+  const float measure = M_2PI_F * (1.0f - cos_theta_o) +
+                        M_PI_2_F * (2.0f * theta_w * sin_theta_o - cosf(theta_o - 2.0f * theta_w) -
+                                    2.0f * theta_o * sin_theta_o + cos_theta_o);
+  return (cone.two_sided) ? 2.0f * measure : measure;
+}
+
+/* Surface area orientation heuristic. */
+static float light_tree_cost(const float energy, const BoundBox &bbox, const LightTreeCone &cone)
+{
+  return energy * bbox.safe_area() * light_tree_cone_measure(cone);
+}
+
+LightTree::LightTree(const vector<LightTreeEmitter> &emitters) : emitters_(emitters)
+{
+  const int num_emitters = emitters_.size();
+  if (num_emitters == 0) {
+    return;
+  }
+
+  order_.resize(num_emitters);
+  for (int i = 0; i < num_emitters; i++) {
+    order_[i] = i;
+  }
+
+  emitter_leafs_.resize(num_emitters);
+  nodes_.reserve(2 * num_emitters - 1);
+
+  build_recursive(0, num_emitters, -1, 0);
+}
+
+int LightTree::build_recursive(const int begin, const int end, const int parent_index, int depth)
+{
+  BuildNode node;
+  for (int i = begin; i < end; i++) {
+    const LightTreeEmitter &emitter = emitters_[order_[i]];
+    node.bbox.grow(emitter.bbox);
+    node.centroid_bbox.grow(emitter.bbox.center());
+    node.cone = (i == begin) ? emitter.cone : LightTreeCone::merge(node.cone, emitter.cone);
+    node.energy += emitter.energy;
+  }
+
+  const int node_index = nodes_.size();
+  nodes_.push_back(KernelLightTreeNode());
+
+  int child_index;
+  if (end - begin == 1) {
+    child_index = ~emitters_[order_[begin]].distribution_index;
+    emitter_leafs_[order_[begin]] = node_index;
+  }
+  else {
+    const int middle = split(begin, end, node, depth);
+    build_recursive(begin, middle, node_index, depth + 1);
+    child_index = build_recursive(middle, end, node_index, depth + 1);
+  }
+
+  /* Children were added after this node, so only take the reference now. */
+  KernelLightTreeNode &knode = nodes_[node_index];
+  knode.bbox_min[0] = node.bbox.min.x;
+  knode.bbox_min[1] = node.bbox.min.y;
+  knode.bbox_min[2] = node.bbox.min.z;
+  knode.bbox_max[0] = node.bbox.max.x;
+  knode.bbox_max[1] = node.bbox.max.y;
+  knode.bbox_max[2] = node.bbox.max.z;
+  knode.energy = node.energy;
+  knode.axis[0] = node.cone.axis.x;
+  knode.axis[1] = node.cone.axis.y;
+  knode.axis[2] = node.cone.axis.z;
+  knode.theta_o = node.cone.theta_o;
+  knode.theta_e = node.cone.theta_e;
+  knode.two_sided = node.cone.two_sided;
+  knode.child_index = child_index;
+  knode.parent_index = parent_index;
+  knode.pad = 0;
+
+  return node_index;
+}
+
+int LightTree::split(const int begin, const int end, const BuildNode &node, const int depth)
+{
+  const float3 extent = node.centroid_bbox.size();
+  const int dim = (extent.x >= extent.y && extent.x >= extent.z) ? 0 :
+                  (extent.y >= extent.z)                       ? 1 :
+                                                                 2;
+  const float centroid_min = node.centroid_bbox.min[dim];
+  const float size = extent[dim];
+
+  if (size > 0.0f && depth < LIGHT_TREE_MAX_COST_DEPTH) {
+    /* Bin the emitters by their centroid along the longest axis. */
+    struct Bucket {
+      BoundBox bbox = BoundBox::empty;
+      LightTreeCone cone;
+      float energy = 0.0f;
+      int count = 0;
+    } buckets[LIGHT_TREE_NUM_BUCKETS];
+
+    auto bucket_index = [&](const LightTreeEmitter &emitter) {
+      const float t = (emitter.bbox.center()[dim] - centroid_min) / size;
+      const int index = (int)(t * LIGHT_TREE_NUM_BUCKETS);
+      return clamp(index, 0, LIGHT_TREE_NUM_BUCKETS - 1);
+    };
+
+    for (int i = begin; i < end; i++) {
+      const LightTreeEmitter &emitter = emitters_[order_[i]];
+      Bucket &bucket = buckets[bucket_index(emitter)];
+      bucket.bbox.grow(emitter.bbox);
+      bucket.cone = (bucket.count == 0) ? emitter.cone :
+                                          LightTreeCone::merge(bucket.cone, emitter.cone);
+      bucket.energy += emitter.energy;
+      bucket.count++;
+    }
+
+    /* Cost of all emitters up to and including each bucket. */
+    float below_cost[LIGHT_TREE_NUM_BUCKETS];
+    Bucket below;
+    for (int i = 0; i < LIGHT_TREE_NUM_BUCKETS; i++) {
+      const Bucket &bucket = buckets[i];
+      if (bucket.count) {
+        below.bbox.grow(bucket.bbox);
+        below.cone = (below.count == 0) ? bucket.cone :
+                                          LightTreeCone::merge(below.cone, bucket.cone);
+        below.energy += bucket.energy;
+        below.count += bucket.count;
+      }
+      below_cost[i] = (below.count) ? light_tree_cost(below.energy, below.bbox, below.cone) : 0.0f;
+    }
+
+    int best_split = -1;
+    float best_cost = FLT_MAX;
+    Bucket above;
+    for (int i = LIGHT_TREE_NUM_BUCKETS - 1; i > 0; i--) {
+      const Bucket &bucket = buckets[i];
+      if (bucket.count) {
+        above.bbox.grow(bucket.bbox);
+        above.cone = (above.count == 0) ? bucket.cone :
+                                          LightTreeCone::merge(above.cone, bucket.cone);
+        above.energy += bucket.energy;
+        above.count += bucket.count;
+      }
+      if (above.count == 0 || above.count == end - begin) {
+        continue;
+      }
+      const float cost = below_cost[i - 1] + light_tree_cost(above.energy, above.bbox, above.cone);
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_split = i;
+      }
+    }
+
+    if (best_split != -1) {
+      int *middle = std::partition(&order_[begin], &order_[0] + end, [&](const int index) {
+        return bucket_index(emitters_[index]) < best_split;
+      });
+      return middle - &order_[0];
+    }
+  }
+
+  /* Split in the middle, for coincident emitters and deep trees. */
+  const int middle = (begin + end) / 2;
+  std::nth_element(
+      &order_[begin], &order_[middle], &order_[0] + end, [&](const int a, const int b) {
+        return emitters_[a].bbox.center()[dim] < emitters_[b].bbox.center()[dim];
+      });
+  return middle;
+}
+
+CCL_NAMESPACE_END
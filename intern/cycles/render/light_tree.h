@@ -0,0 +1,89 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIGHT_TREE_H__
+#define __LIGHT_TREE_H__
+
+#include "kernel/kernel_types.h"
+
+#include "util/util_boundbox.h"
+#include "util/util_types.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Cone bounding the normals of a set of emitters, and the spread of their emission around
+ * those normals. Two-sided emitters also emit around the negated normals. */
+struct LightTreeCone {
+  float3 axis = make_float3(0.0f, 0.0f, 1.0f);
+  float theta_o = 0.0f;
+  float theta_e = M_PI_2_F;
+  bool two_sided = false;
+
+  static LightTreeCone merge(const LightTreeCone &a, const LightTreeCone &b);
+};
+
+/* Emitter in the light tree: an emissive triangle, a point, spot or area light. */
+struct LightTreeEmitter {
+  BoundBox bbox = BoundBox::empty;
+  LightTreeCone cone;
+  float energy = 0.0f;
+  /* Index of the emitter in the light distribution. */
+  int distribution_index = 0;
+};
+
+/* Bounding volume hierarchy over the emitters, used to importance sample lights by their
+ * distance and orientation relative to the shading point.
+ *
+ * Nodes are stored in depth-first order, the first child of an inner node directly follows it.
+ * Every leaf holds a single emitter, so the probability of picking an emitter can be computed by
+ * walking from its leaf up to the root. */
+class LightTree {
+ public:
+  explicit LightTree(const vector<LightTreeEmitter> &emitters);
+
+  const vector<KernelLightTreeNode> &get_nodes() const
+  {
+    return nodes_;
+  }
+
+  /* Index of the leaf node of every emitter, in the order they were passed in. */
+  const vector<int> &get_emitter_leafs() const
+  {
+    return emitter_leafs_;
+  }
+
+ protected:
+  struct BuildNode {
+    BoundBox bbox = BoundBox::empty;
+    BoundBox centroid_bbox = BoundBox::empty;
+    LightTreeCone cone;
+    float energy = 0.0f;
+  };
+
+  int build_recursive(int begin, int end, int parent_index, int depth);
+  int split(int begin, int end, const BuildNode &node, int depth);
+
+  const vector<LightTreeEmitter> &emitters_;
+  /* Indices into the emitters, reordered by the build so every node covers a range of them. */
+  vector<int> order_;
+  vector<KernelLightTreeNode> nodes_;
+  vector<int> emitter_leafs_;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __LIGHT_TREE_H__ */
@@ -251,6 +251,8 @@ NODE_DEFINE(ImageTextureNode)
   SOCKET_BOOLEAN(animated, "Animated", false);
 
   SOCKET_IN_POINT(vector, "Vector", zero_float3(), SocketType::LINK_TEXTURE_UV);
+  SOCKET_IN_POINT(vector_dx, "Vector Dx", zero_float3(), SocketType::SVM_INTERNAL);
+  SOCKET_IN_POINT(vector_dy, "Vector Dy", zero_float3(), SocketType::SVM_INTERNAL);
 
   SOCKET_OUT_COLOR(color, "Color");
   SOCKET_OUT_FLOAT(alpha, "Alpha");
@@ -345,6 +347,16 @@ void ImageTextureNode::cull_tiles(Scene *scene, ShaderGraph *graph)
   tiles.steal_data(new_tiles);
 }
 
+/* Add the image to the image manager, unless the node already has a handle from sync. */
+void ImageTextureNode::ensure_handle(Scene *scene, ShaderGraph *graph)
+{
+  if (handle.empty()) {
+    cull_tiles(scene, graph);
+    ImageManager *image_manager = scene->image_manager;
+    handle = image_manager->add_image(filename.string(), image_params(), tiles);
+  }
+}
+
 void ImageTextureNode::attributes(Shader *shader, AttributeRequestSet *attributes)
 {
 #ifdef WITH_PTEX
@@ -366,11 +378,7 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
   ShaderOutput *color_out = output("Color");
   ShaderOutput *alpha_out = output("Alpha");
 
-  if (handle.empty()) {
-    cull_tiles(compiler.scene, compiler.current_graph);
-    ImageManager *image_manager = compiler.scene->image_manager;
-    handle = image_manager->add_image(filename.string(), image_params(), tiles);
-  }
+  ensure_handle(compiler.scene, compiler.current_graph);
 
   /* All tiles have the same metadata. */
   const ImageMetaData metadata = handle.metadata();
@@ -380,6 +388,16 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
   int vector_offset = tex_mapping.compile_begin(compiler, vector_in);
   uint flags = 0;
 
+  /* Vectors shifted by the ray differentials, only linked for the texture cache. */
+  ShaderInput *vector_dx_in = input("Vector Dx");
+  ShaderInput *vector_dy_in = input("Vector Dy");
+  int vector_dx_offset = SVM_STACK_INVALID;
+  int vector_dy_offset = SVM_STACK_INVALID;
+  if (vector_dx_in->link && vector_dy_in->link) {
+    vector_dx_offset = tex_mapping.compile_begin(compiler, vector_dx_in);
+    vector_dy_offset = tex_mapping.compile_begin(compiler, vector_dy_in);
+  }
+
   if (compress_as_srgb) {
     flags |= NODE_IMAGE_COMPRESS_AS_SRGB;
   }
@@ -409,7 +427,7 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
                                              compiler.stack_assign_if_linked(color_out),
                                              compiler.stack_assign_if_linked(alpha_out),
                                              flags),
-                      projection);
+                      compiler.encode_uchar4(projection, vector_dx_offset, vector_dy_offset));
 
     if (num_nodes > 0) {
       for (int i = 0; i < num_nodes; i++) {
@@ -440,6 +458,10 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
   }
 
   tex_mapping.compile_end(compiler, vector_in, vector_offset);
+  if (vector_dx_offset != SVM_STACK_INVALID) {
+    tex_mapping.compile_end(compiler, vector_dx_in, vector_dx_offset);
+    tex_mapping.compile_end(compiler, vector_dy_in, vector_dy_offset);
+  }
 }
 
 void ImageTextureNode::compile(OSLCompiler &compiler)
@@ -6415,7 +6437,7 @@ void CurvesNode::constant_fold(const ConstantFolder &folder, ShaderInput *value_
 }
 
 void CurvesNode::compile(SVMCompiler &compiler,
-                         int type,
+                         ShaderNodeType type,
                          ShaderInput *value_in,
                          ShaderOutput *value_out)
 {
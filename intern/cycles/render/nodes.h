@@ -117,6 +117,7 @@ class ImageTextureNode : public ImageSlotTextureNode {
   }
 
   ImageParams image_params() const;
+  void ensure_handle(Scene *scene, ShaderGraph *graph);
 
   /* Parameters. */
   NODE_SOCKET_API(ustring, filename)
@@ -128,6 +129,8 @@ class ImageTextureNode : public ImageSlotTextureNode {
   NODE_SOCKET_API(float, projection_blend)
   NODE_SOCKET_API(bool, animated)
   NODE_SOCKET_API(float3, vector)
+  NODE_SOCKET_API(float3, vector_dx)
+  NODE_SOCKET_API(float3, vector_dy)
   NODE_SOCKET_API_ARRAY(array<int>, tiles)
 
  protected:
@@ -1382,7 +1385,10 @@ class CurvesNode : public ShaderNode {
  protected:
   using ShaderNode::constant_fold;
   void constant_fold(const ConstantFolder &folder, ShaderInput *value_in);
-  void compile(SVMCompiler &compiler, int type, ShaderInput *value_in, ShaderOutput *value_out);
+  void compile(SVMCompiler &compiler,
+               ShaderNodeType type,
+               ShaderInput *value_in,
+               ShaderOutput *value_out);
   void compile(OSLCompiler &compiler, const char *name);
 };
 
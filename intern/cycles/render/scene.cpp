@@ -79,6 +79,9 @@ DeviceScene::DeviceScene(Device *device)
       lights(device, "__lights", MEM_GLOBAL),
       light_background_marginal_cdf(device, "__light_background_marginal_cdf", MEM_GLOBAL),
       light_background_conditional_cdf(device, "__light_background_conditional_cdf", MEM_GLOBAL),
+      light_tree_nodes(device, "__light_tree_nodes", MEM_GLOBAL),
+      light_tree_leaf(device, "__light_tree_leaf", MEM_GLOBAL),
+      object_light_tree(device, "__object_light_tree", MEM_GLOBAL),
       particles(device, "__particles", MEM_GLOBAL),
       svm_nodes(device, "__svm_nodes", MEM_GLOBAL),
       shaders(device, "__shaders", MEM_GLOBAL),
@@ -121,6 +124,10 @@ Scene::Scene(const SceneParams &params_, Device *device)
   bake_manager = new BakeManager();
   procedural_manager = new ProceduralManager();
 
+  if (params.use_texture_cache) {
+    image_manager->set_texture_cache_size(params.texture_cache_size);
+  }
+
   /* Create nodes after managers, since create_node() can tag the managers. */
   camera = create_node<Camera>();
   dicing_camera = create_node<Camera>();
@@ -116,6 +116,9 @@ class DeviceScene {
   device_vector<KernelLight> lights;
   device_vector<float2> light_background_marginal_cdf;
   device_vector<float2> light_background_conditional_cdf;
+  device_vector<KernelLightTreeNode> light_tree_nodes;
+  device_vector<int> light_tree_leaf;
+  device_vector<int2> object_light_tree;
 
   /* particles */
   device_vector<KernelParticle> particles;
@@ -159,6 +162,10 @@ class SceneParams {
   CurveShapeType hair_shape;
   int texture_limit;
 
+  /* Load file images on demand through a texture cache, with a budget in megabytes. */
+  bool use_texture_cache;
+  int texture_cache_size;
+
   bool background;
 
   SceneParams()
@@ -172,6 +179,8 @@ class SceneParams {
     hair_subdivisions = 3;
     hair_shape = CURVE_RIBBON;
     texture_limit = 0;
+    use_texture_cache = false;
+    texture_cache_size = 4096;
     background = true;
   }
 
@@ -183,7 +192,9 @@ class SceneParams {
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
              hair_subdivisions == params.hair_subdivisions && hair_shape == params.hair_shape &&
-             texture_limit == params.texture_limit);
+             texture_limit == params.texture_limit &&
+             use_texture_cache == params.use_texture_cache &&
+             texture_cache_size == params.texture_cache_size);
   }
 
   int curve_subdivisions()
@@ -296,7 +296,7 @@ RenderWork Session::run_update_for_next_iteration()
     const int height = max(1, buffer_params_.full_height / resolution);
 
     if (update_scene(width, height)) {
-      profiler.reset(scene->shaders.size(), scene->objects.size());
+      profiler.reset(scene->shaders.size(), scene->objects.size(), scene->lights.size());
     }
     progress.add_skip_time(update_timer, params.background);
   }
@@ -382,7 +382,8 @@ void Session::do_delayed_reset()
   buffer_params_.use_transparent_background = scene->background->get_transparent();
 
   /* Tile and work scheduling. */
-  tile_manager_.reset_scheduling(buffer_params_, get_effective_tile_size());
+  tile_manager_.reset_scheduling(
+      buffer_params_, get_effective_tile_size(), params.tile_split_index, params.num_tile_splits);
   render_scheduler_.reset(buffer_params_, params.samples);
 
   /* Passes. */
@@ -611,7 +612,12 @@ void Session::collect_statistics(RenderStats *render_stats)
 
 void Session::process_full_buffer_from_disk(string_view filename)
 {
-  path_trace_->process_full_buffer_from_disk(filename);
+  process_full_buffer_from_disk(vector<string>{string(filename)});
+}
+
+void Session::process_full_buffer_from_disk(const vector<string> &filenames)
+{
+  path_trace_->process_full_buffer_from_disk(filenames);
 }
 
 CCL_NAMESPACE_END
@@ -66,6 +66,12 @@ class SessionParams {
   bool use_auto_tile;
   int tile_size;
 
+  /* Render only a share of the tiles, for splitting a frame across processes. Tiles are split
+   * into the given number of contiguous ranges, and only the range of the given index is
+   * rendered. */
+  int tile_split_index;
+  int num_tile_splits;
+
   ShadingSystem shadingsystem;
 
   SessionParams()
@@ -84,6 +90,9 @@ class SessionParams {
     use_auto_tile = true;
     tile_size = 2048;
 
+    tile_split_index = 0;
+    num_tile_splits = 1;
+
     shadingsystem = SHADINGSYSTEM_SVM;
   }
 
@@ -95,7 +104,9 @@ class SessionParams {
              background == params.background && experimental == params.experimental &&
              pixel_size == params.pixel_size && threads == params.threads &&
              use_profiling == params.use_profiling && shadingsystem == params.shadingsystem &&
-             use_auto_tile == params.use_auto_tile && tile_size == params.tile_size);
+             use_auto_tile == params.use_auto_tile && tile_size == params.tile_size &&
+             tile_split_index == params.tile_split_index &&
+             num_tile_splits == params.num_tile_splits);
   }
 };
 
@@ -159,6 +170,9 @@ class Session {
    * via the write callback. */
   void process_full_buffer_from_disk(string_view filename);
 
+  /* Same as above, but the full-frame is merged from files of all tile splits of the frame. */
+  void process_full_buffer_from_disk(const vector<string> &filenames);
+
  protected:
   struct DelayedReset {
     thread_mutex mutex;
@@ -213,6 +213,7 @@ Shader::Shader() : Node(get_node_type())
   has_volume_spatial_varying = false;
   has_volume_attribute_dependency = false;
   has_integrator_dependency = false;
+  specialization = SHADER_SPECIALIZATION_NONE;
   has_volume_connected = false;
   prev_volume_step_rate = 0.0f;
 
@@ -552,6 +553,7 @@ void ShaderManager::device_update_common(Device * /*device*/,
     /* regular shader */
     kshader->flags = flag;
     kshader->pass_id = shader->get_pass_id();
+    kshader->specialization = shader->specialization;
     kshader->constant_emission[0] = constant_emission.x;
     kshader->constant_emission[1] = constant_emission.y;
     kshader->constant_emission[2] = constant_emission.z;
@@ -127,6 +127,9 @@ class Shader : public Node {
   bool has_volume_attribute_dependency;
   bool has_integrator_dependency;
 
+  /* Specialized interpreter loop for the surface on the CPU, set by the SVM compiler. */
+  ShaderSpecialization specialization;
+
   /* requested mesh attributes */
   AttributeRequestSet attributes;
 
@@ -15,6 +15,7 @@
  */
 
 #include "render/stats.h"
+#include "render/light.h"
 #include "render/object.h"
 #include "util/util_algorithm.h"
 #include "util/util_foreach.h"
@@ -51,6 +52,36 @@ bool namedSampleCountPairComparator(const NamedSampleCountPair &a, const NamedSa
   return a.samples > b.samples;
 }
 
+string json_escape(const string &str)
+{
+  string result = "\"";
+  foreach (const char c, str) {
+    switch (c) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          result += string_printf("\\u%04x", (int)c);
+        }
+        else {
+          result += c;
+        }
+        break;
+    }
+  }
+  return result + "\"";
+}
+
 }  // namespace
 
 NamedSizeEntry::NamedSizeEntry() : name(""), size(0)
@@ -170,6 +201,25 @@ string NamedNestedSampleStats::full_report(int indent_level, uint64_t total_samp
   return result;
 }
 
+string NamedNestedSampleStats::json_report()
+{
+  update_sum();
+
+  string result = string_printf("{\"name\": %s, \"time\": %.3f, \"self_time\": %.3f",
+                                json_escape(name).c_str(),
+                                sum_samples * 0.001,
+                                self_samples * 0.001);
+  if (!entries.empty()) {
+    sort(entries.begin(), entries.end(), namedTimeSampleEntryComparator);
+    result += ", \"entries\": [";
+    for (size_t i = 0; i < entries.size(); i++) {
+      result += (i > 0 ? ", " : "") + entries[i].json_report();
+    }
+    result += "]";
+  }
+  return result + "}";
+}
+
 /* Named sample count pairs. */
 
 NamedSampleCountPair::NamedSampleCountPair(const ustring &name, uint64_t samples, uint64_t hits)
@@ -224,6 +274,42 @@ string NamedSampleCountStats::full_report(int indent_level)
   return result;
 }
 
+string NamedSampleCountStats::json_report()
+{
+  vector<NamedSampleCountPair> sorted_entries;
+  sorted_entries.reserve(entries.size());
+
+  uint64_t total_hits = 0, total_samples = 0;
+  foreach (entry_map::const_reference entry, entries) {
+    const NamedSampleCountPair &pair = entry.second;
+
+    total_hits += pair.hits;
+    total_samples += pair.samples;
+
+    sorted_entries.push_back(pair);
+  }
+  const double avg_samples_per_hit = ((double)total_samples) / total_hits;
+
+  sort(sorted_entries.begin(), sorted_entries.end(), namedSampleCountPairComparator);
+
+  string result = "[";
+  for (size_t i = 0; i < sorted_entries.size(); i++) {
+    const NamedSampleCountPair &entry = sorted_entries[i];
+    const double relative = (entry.hits) ? ((double)entry.samples) /
+                                               (entry.hits * avg_samples_per_hit) :
+                                           0.0;
+
+    result += string_printf(
+        "%s{\"name\": %s, \"time\": %.3f, \"hits\": %llu, \"relative_cost\": %.3f}",
+        (i > 0) ? ", " : "",
+        json_escape(entry.name.string()).c_str(),
+        entry.samples * 0.001,
+        (unsigned long long)entry.hits,
+        relative);
+  }
+  return result + "]";
+}
+
 /* Mesh statistics. */
 
 MeshStats::MeshStats()
@@ -252,6 +338,31 @@ string ImageStats::full_report(int indent_level)
   return result;
 }
 
+/* Ray statistics. */
+
+RayStats::RayStats() : closest(0), shadow(0), subsurface(0), volume_stack(0)
+{
+}
+
+string RayStats::full_report(int indent_level)
+{
+  const string indent(indent_level * kIndentNumSpaces, ' ');
+  string result = "";
+  result += indent + string_printf("%-32s: %s\n",
+                                   "Closest",
+                                   string_human_readable_number(closest).c_str());
+  result += indent + string_printf("%-32s: %s\n",
+                                   "Shadow",
+                                   string_human_readable_number(shadow).c_str());
+  result += indent + string_printf("%-32s: %s\n",
+                                   "Subsurface",
+                                   string_human_readable_number(subsurface).c_str());
+  result += indent + string_printf("%-32s: %s\n",
+                                   "Volume Stack",
+                                   string_human_readable_number(volume_stack).c_str());
+  return result;
+}
+
 /* Overall statistics. */
 
 RenderStats::RenderStats()
@@ -308,6 +419,24 @@ void RenderStats::collect_profiling(Scene *scene, Profiler &prof)
       objects.add(object->name, samples, hits);
     }
   }
+
+  /* Lights are indexed in the kernel in the order of the enabled lights in the scene. */
+  lights.entries.clear();
+  int light_index = 0;
+  foreach (Light *light, scene->lights) {
+    if (!light->get_is_enabled()) {
+      continue;
+    }
+    uint64_t samples, hits;
+    if (prof.get_light(light_index++, samples, hits)) {
+      lights.add(light->name, samples, hits);
+    }
+  }
+
+  rays.closest = prof.get_event_hits(PROFILING_INTERSECT_CLOSEST);
+  rays.shadow = prof.get_event_hits(PROFILING_INTERSECT_SHADOW);
+  rays.subsurface = prof.get_event_hits(PROFILING_INTERSECT_SUBSURFACE);
+  rays.volume_stack = prof.get_event_hits(PROFILING_INTERSECT_VOLUME_STACK);
 }
 
 string RenderStats::full_report()
@@ -319,6 +448,8 @@ string RenderStats::full_report()
     result += "Kernel statistics:\n" + kernel.full_report(1);
     result += "Shader statistics:\n" + shaders.full_report(1);
     result += "Object statistics:\n" + objects.full_report(1);
+    result += "Light statistics:\n" + lights.full_report(1);
+    result += "Ray statistics:\n" + rays.full_report(1);
   }
   else {
     result += "Profiling information not available (only works with CPU rendering)";
@@ -326,6 +457,29 @@ string RenderStats::full_report()
   return result;
 }
 
+string RenderStats::json_report(const string &name)
+{
+  string result = "{\"name\": " + json_escape(name);
+  result += string_printf(", \"has_profiling\": %s", has_profiling ? "true" : "false");
+  result += string_printf(", \"mesh_memory\": %llu, \"texture_memory\": %llu",
+                          (unsigned long long)mesh.geometry.total_size,
+                          (unsigned long long)image.textures.total_size);
+  if (has_profiling) {
+    result += ", \"kernel\": " + kernel.json_report();
+    result += ", \"shaders\": " + shaders.json_report();
+    result += ", \"objects\": " + objects.json_report();
+    result += ", \"lights\": " + lights.json_report();
+    result += string_printf(
+        ", \"rays\": {\"closest\": %llu, \"shadow\": %llu, \"subsurface\": %llu, "
+        "\"volume_stack\": %llu}",
+        (unsigned long long)rays.closest,
+        (unsigned long long)rays.shadow,
+        (unsigned long long)rays.subsurface,
+        (unsigned long long)rays.volume_stack);
+  }
+  return result + "}";
+}
+
 NamedTimeStats::NamedTimeStats() : total_time(0.0)
 {
 }
@@ -113,6 +113,7 @@ class NamedNestedSampleStats {
   void update_sum();
 
   string full_report(int indent_level = 0, uint64_t total_samples = 0);
+  string json_report();
 
   string name;
 
@@ -141,6 +142,7 @@ class NamedSampleCountStats {
   NamedSampleCountStats();
 
   string full_report(int indent_level = 0);
+  string json_report();
   void add(const ustring &name, uint64_t samples, uint64_t hits);
 
   typedef unordered_map<ustring, NamedSampleCountPair, ustringHash> entry_map;
@@ -173,6 +175,20 @@ class ImageStats {
   NamedSizeStats textures;
 };
 
+/* Statistics about the number of rays traced by the kernel. */
+class RayStats {
+ public:
+  RayStats();
+
+  /* Generate full human-readable report. */
+  string full_report(int indent_level = 0);
+
+  uint64_t closest;
+  uint64_t shadow;
+  uint64_t subsurface;
+  uint64_t volume_stack;
+};
+
 /* Render process statistics. */
 class RenderStats {
  public:
@@ -181,6 +197,10 @@ class RenderStats {
   /* Return full report as string. */
   string full_report();
 
+  /* Return profiling report as a single line JSON object, for parsing by render farm tools.
+   * The name identifies the render, for example the scene, view layer and frame. */
+  string json_report(const string &name);
+
   /* Collect kernel sampling information from Stats. */
   void collect_profiling(Scene *scene, Profiler &prof);
 
@@ -191,6 +211,8 @@ class RenderStats {
   NamedNestedSampleStats kernel;
   NamedSampleCountStats shaders;
   NamedSampleCountStats objects;
+  NamedSampleCountStats lights;
+  RayStats rays;
 };
 
 class UpdateTimeStats {
@@ -26,6 +26,7 @@
 #include "render/stats.h"
 #include "render/svm.h"
 
+#include "util/util_debug.h"
 #include "util/util_foreach.h"
 #include "util/util_logging.h"
 #include "util/util_progress.h"
@@ -183,6 +184,7 @@ SVMCompiler::SVMCompiler(Scene *scene) : scene(scene)
   background = false;
   mix_weight_offset = SVM_STACK_INVALID;
   compile_failed = false;
+  current_use_surface_bsdf_specialization = false;
 }
 
 int SVMCompiler::stack_size(SocketType::Type type)
@@ -389,13 +391,27 @@ void SVMCompiler::add_node(int a, int b, int c, int d)
   current_svm_nodes.push_back_slow(make_int4(a, b, c, d));
 }
 
+/* Nodes handled by svm_eval_nodes_surface_bsdf() in the kernel. */
+static bool svm_node_has_surface_bsdf_specialization(ShaderNodeType type)
+{
+  switch (type) {
+#define SVM_SURFACE_BSDF_NODE(node_type, ...) case node_type:
+#include "kernel/svm/svm_surface_bsdf_nodes.h"
+    return true;
+    default:
+      return false;
+  }
+}
+
 void SVMCompiler::add_node(ShaderNodeType type, int a, int b, int c)
 {
+  current_use_surface_bsdf_specialization &= svm_node_has_surface_bsdf_specialization(type);
   current_svm_nodes.push_back_slow(make_int4(type, a, b, c));
 }
 
 void SVMCompiler::add_node(ShaderNodeType type, const float3 &f)
 {
+  current_use_surface_bsdf_specialization &= svm_node_has_surface_bsdf_specialization(type);
   current_svm_nodes.push_back_slow(
       make_int4(type, __float_as_int(f.x), __float_as_int(f.y), __float_as_int(f.z)));
 }
@@ -768,6 +784,7 @@ void SVMCompiler::compile_type(Shader *shader, ShaderGraph *graph, ShaderType ty
   /* clear all compiler state */
   memset((void *)&active_stack, 0, sizeof(active_stack));
   current_svm_nodes.clear();
+  current_use_surface_bsdf_specialization = true;
 
   foreach (ShaderNode *node, graph->nodes) {
     foreach (ShaderInput *input, node->inputs)
@@ -890,6 +907,7 @@ void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Sum
   shader->has_volume_spatial_varying = false;
   shader->has_volume_attribute_dependency = false;
   shader->has_integrator_dependency = false;
+  shader->specialization = SHADER_SPECIALIZATION_NONE;
 
   /* generate bump shader */
   if (has_bump) {
@@ -909,6 +927,13 @@ void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Sum
       svm_nodes[index].y = svm_nodes.size();
     }
     svm_nodes.append(current_svm_nodes);
+
+    /* The bump shader falls through to the surface shader, so it has to be evaluated by the
+     * full interpreter loop. */
+    if (!has_bump && shader->has_surface && current_use_surface_bsdf_specialization &&
+        DebugFlags().cpu.use_svm_specialization) {
+      shader->specialization = SHADER_SPECIALIZATION_SURFACE_BSDF;
+    }
   }
 
   /* generate volume shader */
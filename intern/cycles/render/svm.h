@@ -225,6 +225,9 @@ class SVMCompiler {
   void compile_type(Shader *shader, ShaderGraph *graph, ShaderType type);
 
   array<int4> current_svm_nodes;
+  /* Whether the specialized surface BSDF loop of the CPU kernel can evaluate all nodes added for
+   * the current shader type. */
+  bool current_use_surface_bsdf_specialization;
   ShaderType current_type;
   Shader *current_shader;
   Stack active_stack;
@@ -344,10 +344,16 @@ int TileManager::compute_render_tile_size(const int suggested_tile_size) const
                                                     align_up(suggested_tile_size, IMAGE_TILE_SIZE);
 }
 
-void TileManager::reset_scheduling(const BufferParams &params, int2 tile_size)
+void TileManager::reset_scheduling(const BufferParams &params,
+                                   int2 tile_size,
+                                   int tile_split_index,
+                                   int num_tile_splits)
 {
   VLOG(3) << "Using tile size of " << tile_size;
 
+  DCHECK_GE(tile_split_index, 0);
+  DCHECK_LT(tile_split_index, num_tile_splits);
+
   close_tile_output();
 
   tile_size_ = tile_size;
@@ -356,7 +362,20 @@ void TileManager::reset_scheduling(const BufferParams &params, int2 tile_size)
   tile_state_.num_tiles_y = divide_up(params.height, tile_size_.y);
   tile_state_.num_tiles = tile_state_.num_tiles_x * tile_state_.num_tiles_y;
 
-  tile_state_.next_tile_index = 0;
+  tile_state_.num_tile_splits = num_tile_splits;
+
+  /* Contiguous ranges keep the tiles of a split spatially close to each other. */
+  tile_state_.tile_range_begin = int64_t(tile_state_.num_tiles) * tile_split_index /
+                                 num_tile_splits;
+  tile_state_.tile_range_end = int64_t(tile_state_.num_tiles) * (tile_split_index + 1) /
+                               num_tile_splits;
+
+  if (num_tile_splits > 1) {
+    VLOG(3) << "Rendering tiles " << tile_state_.tile_range_begin << " to "
+            << tile_state_.tile_range_end << " of " << tile_state_.num_tiles;
+  }
+
+  tile_state_.next_tile_index = tile_state_.tile_range_begin;
 
   tile_state_.current_tile = Tile();
 }
@@ -378,7 +397,7 @@ void TileManager::update(const BufferParams &params, const Scene *scene)
 
 bool TileManager::done()
 {
-  return tile_state_.next_tile_index == tile_state_.num_tiles;
+  return tile_state_.next_tile_index == tile_state_.tile_range_end;
 }
 
 bool TileManager::next()
@@ -523,12 +542,20 @@ void TileManager::finish_write_tiles()
     return;
   }
 
-  /* EXR expects all tiles to present in file. So explicitly write missing tiles as all-zero. */
-  if (write_state_.num_tiles_written < tile_state_.num_tiles) {
+  /* EXR expects all tiles to present in file. So explicitly write missing tiles as all-zero.
+   * This includes tiles outside of the scheduled range, which are rendered by another split. */
+  const int written_tiles_end = tile_state_.tile_range_begin + write_state_.num_tiles_written;
+  if (tile_state_.tile_range_begin > 0 || written_tiles_end < tile_state_.num_tiles) {
     vector<float> pixel_storage(tile_size_.x * tile_size_.y * buffer_params_.pass_stride);
 
-    for (int tile_index = write_state_.num_tiles_written; tile_index < tile_state_.num_tiles;
-         ++tile_index) {
+    for (int tile_index = 0; tile_index < tile_state_.num_tiles; ++tile_index) {
+      if (tile_index == tile_state_.tile_range_begin) {
+        tile_index = written_tiles_end;
+        if (tile_index == tile_state_.num_tiles) {
+          break;
+        }
+      }
+
       const Tile tile = get_tile_for_index(tile_index);
 
       VLOG(3) << "Write dummy tile at " << tile.x << ", " << tile.y;
@@ -593,4 +620,43 @@ bool TileManager::read_full_buffer_from_disk(const string_view filename,
   return true;
 }
 
+bool TileManager::read_full_buffer_from_disk(const vector<string> &filenames,
+                                             RenderBuffers *buffers,
+                                             DenoiseParams *denoise_params)
+{
+  if (filenames.empty()) {
+    LOG(ERROR) << "No tile files to read.";
+    return false;
+  }
+
+  if (!read_full_buffer_from_disk(filenames[0], buffers, denoise_params)) {
+    return false;
+  }
+
+  /* Tiles which are not rendered by a split are stored as all-zero, so accumulating the files
+   * gives the full frame. This covers all passes, including the sample count and the adaptive
+   * sampling state. */
+  RenderBuffers split_buffers(buffers->buffer.device);
+  for (int i = 1; i < filenames.size(); ++i) {
+    DenoiseParams split_denoise_params;
+    if (!read_full_buffer_from_disk(filenames[i], &split_buffers, &split_denoise_params)) {
+      return false;
+    }
+
+    if (split_buffers.params.modified(buffers->params)) {
+      LOG(ERROR) << "Tile file " << filenames[i] << " does not match frame of " << filenames[0];
+      return false;
+    }
+
+    float *pixels = buffers->buffer.data();
+    const float *split_pixels = split_buffers.buffer.data();
+    const size_t size = buffers->buffer.size();
+    for (size_t j = 0; j < size; ++j) {
+      pixels[j] += split_pixels[j];
+    }
+  }
+
+  return true;
+}
+
 CCL_NAMESPACE_END
@@ -20,6 +20,7 @@
 #include "util/util_image.h"
 #include "util/util_string.h"
 #include "util/util_unique_ptr.h"
+#include "util/util_vector.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -59,23 +60,34 @@ class TileManager {
 
   /* Reset current progress and start new rendering of the full-frame parameters in tiles of the
    * given size.
-   * Only touches scheduling-related state of the tile manager. */
+   * Only touches scheduling-related state of the tile manager.
+   *
+   * The tiles are split into the given number of contiguous ranges, and only tiles of the range
+   * with the given index are scheduled. This allows several processes to render the same frame,
+   * each of them writing its share of the tiles to its own file. */
   /* TODO(sergey): Consider using tile area instead of exact size to help dealing with extreme
    * cases of stretched renders. */
-  void reset_scheduling(const BufferParams &params, int2 tile_size);
+  void reset_scheduling(const BufferParams &params,
+                        int2 tile_size,
+                        int tile_split_index = 0,
+                        int num_tile_splits = 1);
 
   /* Update for the known buffer passes and scene parameters.
    * Will store all parameters needed for buffers access outside of the scene graph. */
   void update(const BufferParams &params, const Scene *scene);
 
+  /* Number of tiles scheduled for rendering, which is less than the number of tiles in the frame
+   * when only a share of the tiles is rendered. */
   inline int get_num_tiles() const
   {
-    return tile_state_.num_tiles;
+    return tile_state_.tile_range_end - tile_state_.tile_range_begin;
   }
 
+  /* Tiles are rendered into a file on disk when there is more than one tile in the frame, or
+   * when only a share of the tiles is rendered, so that the shares can be merged afterwards. */
   inline bool has_multiple_tiles() const
   {
-    return tile_state_.num_tiles > 1;
+    return tile_state_.num_tiles > 1 || tile_state_.num_tile_splits > 1;
   }
 
   bool next();
@@ -108,6 +120,14 @@ class TileManager {
                                   RenderBuffers *buffers,
                                   DenoiseParams *denoise_params);
 
+  /* Read full frame render buffer merged from several tiles files on disk, each of them written
+   * with a different tile split of the same frame.
+   *
+   * Returns true on success. */
+  bool read_full_buffer_from_disk(const vector<string> &filenames,
+                                  RenderBuffers *buffers,
+                                  DenoiseParams *denoise_params);
+
   /* Compute valid tile size compatible with image saving. */
   int compute_render_tile_size(const int suggested_tile_size) const;
 
@@ -136,6 +156,11 @@ class TileManager {
     int num_tiles_y = 0;
     int num_tiles = 0;
 
+    /* Range of tile indices scheduled for rendering, out of the given number of splits. */
+    int num_tile_splits = 1;
+    int tile_range_begin = 0;
+    int tile_range_end = 0;
+
     int next_tile_index;
 
     Tile current_tile;
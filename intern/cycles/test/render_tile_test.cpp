@@ -0,0 +1,231 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include "device/device.h"
+#include "device/device_denoise.h"
+
+#include "render/buffers.h"
+#include "render/scene.h"
+#include "render/tile.h"
+
+#include "util/util_path.h"
+#include "util/util_stats.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+namespace {
+
+BufferParams make_buffer_params(const Scene *scene, const int width, const int height)
+{
+  BufferParams params;
+  params.width = width;
+  params.height = height;
+  params.full_width = width;
+  params.full_height = height;
+  params.update_passes(scene->passes);
+  return params;
+}
+
+/* Collect indices of the tiles scheduled for the given split, in the order of scheduling. */
+vector<int> scheduled_tiles(TileManager &tile_manager,
+                            const BufferParams &params,
+                            const Scene *scene,
+                            const int2 tile_size,
+                            const int tile_split_index,
+                            const int num_tile_splits)
+{
+  tile_manager.reset_scheduling(params, tile_size, tile_split_index, num_tile_splits);
+  tile_manager.update(params, scene);
+
+  const int num_tiles_x = divide_up(params.width, tile_size.x);
+
+  vector<int> tile_indices;
+  while (tile_manager.next()) {
+    const Tile &tile = tile_manager.get_current_tile();
+    tile_indices.push_back((tile.y / tile_size.y) * num_tiles_x + tile.x / tile_size.x);
+  }
+
+  EXPECT_TRUE(tile_manager.done());
+  EXPECT_EQ(tile_manager.get_num_tiles(), int(tile_indices.size()));
+
+  return tile_indices;
+}
+
+/* Value of a pixel channel which is unique across the frame. */
+float pixel_value(const BufferParams &params, const int x, const int y, const int channel)
+{
+  return float((y * params.width + x) * params.pass_stride + channel + 1);
+}
+
+/* Render the tiles of the given split into a file, and return the file name. */
+string write_split_tiles(const BufferParams &params,
+                         Device *device,
+                         const Scene *scene,
+                         const int2 tile_size,
+                         const int tile_split_index,
+                         const int num_tile_splits)
+{
+  TileManager tile_manager;
+
+  string filename;
+  tile_manager.full_buffer_written_cb = [&](string_view written_filename) {
+    filename = written_filename;
+  };
+
+  tile_manager.reset_scheduling(params, tile_size, tile_split_index, num_tile_splits);
+  tile_manager.update(params, scene);
+
+  while (tile_manager.next()) {
+    const Tile &tile = tile_manager.get_current_tile();
+
+    BufferParams tile_params = params;
+    tile_params.width = tile.width;
+    tile_params.height = tile.height;
+    tile_params.full_x = params.full_x + tile.x;
+    tile_params.full_y = params.full_y + tile.y;
+    tile_params.update_offset_stride();
+
+    RenderBuffers tile_buffers(device);
+    tile_buffers.reset(tile_params);
+
+    float *pixels = tile_buffers.buffer.data();
+    for (int y = 0; y < tile.height; ++y) {
+      for (int x = 0; x < tile.width; ++x) {
+        for (int channel = 0; channel < params.pass_stride; ++channel) {
+          *pixels++ = pixel_value(params, tile.x + x, tile.y + y, channel);
+        }
+      }
+    }
+
+    EXPECT_TRUE(tile_manager.write_tile(tile_buffers));
+  }
+
+  tile_manager.finish_write_tiles();
+
+  EXPECT_EQ(tile_manager.has_written_tiles(), !filename.empty());
+
+  return filename;
+}
+
+}  // namespace
+
+class RenderTile : public testing::Test {
+ protected:
+  Stats stats;
+  Profiler profiler;
+  DeviceInfo device_info;
+  Device *device_cpu;
+  SceneParams scene_params;
+  Scene *scene;
+
+  virtual void SetUp()
+  {
+    device_cpu = Device::create(device_info, stats, profiler);
+    scene = new Scene(scene_params, device_cpu);
+  }
+
+  virtual void TearDown()
+  {
+    delete scene;
+    delete device_cpu;
+  }
+};
+
+TEST_F(RenderTile, split_ranges)
+{
+  /* 4x2 tiles, with partial tiles at the right and the bottom. */
+  const BufferParams params = make_buffer_params(scene, 100, 60);
+  const int2 tile_size = make_int2(32, 32);
+
+  TileManager tile_manager;
+
+  const vector<int> all_tiles = scheduled_tiles(tile_manager, params, scene, tile_size, 0, 1);
+  EXPECT_EQ(all_tiles, vector<int>({0, 1, 2, 3, 4, 5, 6, 7}));
+  EXPECT_TRUE(tile_manager.has_multiple_tiles());
+
+  /* Splits are contiguous, disjoint and cover all of the tiles. */
+  EXPECT_EQ(scheduled_tiles(tile_manager, params, scene, tile_size, 0, 3), vector<int>({0, 1}));
+  EXPECT_EQ(scheduled_tiles(tile_manager, params, scene, tile_size, 1, 3),
+            vector<int>({2, 3, 4}));
+  EXPECT_EQ(scheduled_tiles(tile_manager, params, scene, tile_size, 2, 3),
+            vector<int>({5, 6, 7}));
+}
+
+TEST_F(RenderTile, split_single_tile)
+{
+  const BufferParams params = make_buffer_params(scene, 100, 60);
+  const int2 tile_size = make_int2(128, 128);
+
+  TileManager tile_manager;
+
+  EXPECT_EQ(scheduled_tiles(tile_manager, params, scene, tile_size, 0, 1), vector<int>({0}));
+  EXPECT_FALSE(tile_manager.has_multiple_tiles());
+
+  /* A split of a single tile frame still renders into a file, so that it can be merged. */
+  EXPECT_EQ(scheduled_tiles(tile_manager, params, scene, tile_size, 0, 2), vector<int>());
+  EXPECT_TRUE(tile_manager.has_multiple_tiles());
+
+  EXPECT_EQ(scheduled_tiles(tile_manager, params, scene, tile_size, 1, 2), vector<int>({0}));
+  EXPECT_TRUE(tile_manager.has_multiple_tiles());
+}
+
+TEST_F(RenderTile, read_full_buffer_from_split_files)
+{
+  /* 3x2 tiles, split unevenly between the files. */
+  const BufferParams params = make_buffer_params(scene, 300, 200);
+  const int2 tile_size = make_int2(TileManager::IMAGE_TILE_SIZE, TileManager::IMAGE_TILE_SIZE);
+  const int num_tile_splits = 4;
+
+  vector<string> filenames;
+  for (int i = 0; i < num_tile_splits; ++i) {
+    const string filename = write_split_tiles(
+        params, device_cpu, scene, tile_size, i, num_tile_splits);
+    if (!filename.empty()) {
+      filenames.push_back(filename);
+    }
+  }
+  ASSERT_EQ(filenames.size(), size_t(num_tile_splits));
+
+  TileManager tile_manager;
+  RenderBuffers buffers(device_cpu);
+  DenoiseParams denoise_params;
+  const bool success = tile_manager.read_full_buffer_from_disk(
+      filenames, &buffers, &denoise_params);
+
+  for (const string &filename : filenames) {
+    path_remove(filename);
+  }
+
+  ASSERT_TRUE(success);
+  ASSERT_EQ(buffers.params.width, params.width);
+  ASSERT_EQ(buffers.params.height, params.height);
+  ASSERT_EQ(buffers.params.pass_stride, params.pass_stride);
+
+  /* Every pixel comes from exactly one of the files, the others store zero for it. */
+  const float *pixels = buffers.buffer.data();
+  for (int y = 0; y < params.height; ++y) {
+    for (int x = 0; x < params.width; ++x) {
+      for (int channel = 0; channel < params.pass_stride; ++channel) {
+        EXPECT_EQ(*pixels++, pixel_value(params, x, y, channel));
+      }
+    }
+  }
+}
+
+CCL_NAMESPACE_END
@@ -26,7 +26,15 @@
 CCL_NAMESPACE_BEGIN
 
 DebugFlags::CPU::CPU()
-    : avx2(true), avx(true), sse41(true), sse3(true), sse2(true), bvh_layout(BVH_LAYOUT_AUTO)
+    : avx2(true),
+      avx(true),
+      sse41(true),
+      sse3(true),
+      sse2(true),
+      bvh_layout(BVH_LAYOUT_AUTO),
+      use_wavefront(false),
+      use_numa(false),
+      use_svm_specialization(true)
 {
   reset();
 }
@@ -52,6 +60,10 @@ void DebugFlags::CPU::reset()
 #undef CHECK_CPU_FLAGS
 
   bvh_layout = BVH_LAYOUT_AUTO;
+
+  use_wavefront = (getenv("CYCLES_CPU_WAVEFRONT") != NULL);
+  use_numa = (getenv("CYCLES_CPU_NUMA") != NULL);
+  use_svm_specialization = (getenv("CYCLES_CPU_NO_SVM_SPECIALIZATION") == NULL);
 }
 
 DebugFlags::CUDA::CUDA() : adaptive_compile(false)
@@ -107,7 +119,10 @@ std::ostream &operator<<(std::ostream &os, DebugFlagsConstRef debug_flags)
      << "  SSE4.1     : " << string_from_bool(debug_flags.cpu.sse41) << "\n"
      << "  SSE3       : " << string_from_bool(debug_flags.cpu.sse3) << "\n"
      << "  SSE2       : " << string_from_bool(debug_flags.cpu.sse2) << "\n"
-     << "  BVH layout : " << bvh_layout_name(debug_flags.cpu.bvh_layout) << "\n";
+     << "  BVH layout : " << bvh_layout_name(debug_flags.cpu.bvh_layout) << "\n"
+     << "  Wavefront  : " << string_from_bool(debug_flags.cpu.use_wavefront) << "\n"
+     << "  NUMA       : " << string_from_bool(debug_flags.cpu.use_numa) << "\n"
+     << "  Specialize : " << string_from_bool(debug_flags.cpu.use_svm_specialization) << "\n";
 
   os << "CUDA flags:\n"
      << "  Adaptive Compile : " << string_from_bool(debug_flags.cuda.adaptive_compile) << "\n";
@@ -79,6 +79,17 @@ class DebugFlags {
      * CPUs and GPUs can be selected here instead.
      */
     BVHLayout bvh_layout;
+
+    /* Render with the wavefront integrator instead of the megakernel: all paths of a batch of
+     * pixels execute one kernel at a time, with surface shading sorted by shader. */
+    bool use_wavefront;
+
+    /* Render with one thread arena per NUMA node, with pixels split between the nodes and
+     * scene data replicated in the memory of every node. */
+    bool use_numa;
+
+    /* Evaluate surface shaders made of common nodes with a specialized interpreter loop. */
+    bool use_svm_specialization;
   };
 
   /* Descriptor of CUDA feature-set to be used. */
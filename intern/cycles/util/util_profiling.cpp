@@ -40,6 +40,7 @@ void Profiler::run()
       uint32_t cur_event = state->event;
       int32_t cur_shader = state->shader;
       int32_t cur_object = state->object;
+      int32_t cur_light = state->light;
 
       /* The state reads/writes should be atomic, but just to be sure
        * check the values for validity anyways. */
@@ -54,6 +55,10 @@ void Profiler::run()
       if (cur_object >= 0 && cur_object < object_samples.size()) {
         object_samples[cur_object]++;
       }
+
+      if (cur_light >= 0 && cur_light < light_samples.size()) {
+        light_samples[cur_light]++;
+      }
     }
     lock.unlock();
 
@@ -66,7 +71,7 @@ void Profiler::run()
   }
 }
 
-void Profiler::reset(int num_shaders, int num_objects)
+void Profiler::reset(int num_shaders, int num_objects, int num_lights)
 {
   bool running = (worker != NULL);
   if (running) {
@@ -74,12 +79,15 @@ void Profiler::reset(int num_shaders, int num_objects)
   }
 
   /* Resize and clear the accumulation vectors. */
+  event_hits.assign(PROFILING_NUM_EVENTS, 0);
   shader_hits.assign(num_shaders, 0);
   object_hits.assign(num_objects, 0);
+  light_hits.assign(num_lights, 0);
 
   event_samples.assign(PROFILING_NUM_EVENTS, 0);
   shader_samples.assign(num_shaders, 0);
   object_samples.assign(num_objects, 0);
+  light_samples.assign(num_lights, 0);
 
   if (running) {
     start();
@@ -113,13 +121,16 @@ void Profiler::add_state(ProfilingState *state)
   states.push_back(state);
 
   /* Resize thread-local hit counters. */
+  std::fill(state->event_hits, state->event_hits + PROFILING_NUM_EVENTS, 0);
   state->shader_hits.assign(shader_hits.size(), 0);
   state->object_hits.assign(object_hits.size(), 0);
+  state->light_hits.assign(light_hits.size(), 0);
 
   /* Initialize the state. */
   state->event = PROFILING_UNKNOWN;
   state->shader = -1;
   state->object = -1;
+  state->light = -1;
   state->active = true;
 }
 
@@ -132,6 +143,11 @@ void Profiler::remove_state(ProfilingState *state)
   state->active = false;
 
   /* Merge thread-local hit counters. */
+  assert(event_hits.size() == PROFILING_NUM_EVENTS);
+  for (int i = 0; i < PROFILING_NUM_EVENTS; i++) {
+    event_hits[i] += state->event_hits[i];
+  }
+
   assert(shader_hits.size() == state->shader_hits.size());
   for (int i = 0; i < shader_hits.size(); i++) {
     shader_hits[i] += state->shader_hits[i];
@@ -141,6 +157,11 @@ void Profiler::remove_state(ProfilingState *state)
   for (int i = 0; i < object_hits.size(); i++) {
     object_hits[i] += state->object_hits[i];
   }
+
+  assert(light_hits.size() == state->light_hits.size());
+  for (int i = 0; i < light_hits.size(); i++) {
+    light_hits[i] += state->light_hits[i];
+  }
 }
 
 uint64_t Profiler::get_event(ProfilingEvent event)
@@ -149,6 +170,12 @@ uint64_t Profiler::get_event(ProfilingEvent event)
   return event_samples[event];
 }
 
+uint64_t Profiler::get_event_hits(ProfilingEvent event)
+{
+  assert(worker == NULL);
+  return event_hits[event];
+}
+
 bool Profiler::get_shader(int shader, uint64_t &samples, uint64_t &hits)
 {
   assert(worker == NULL);
@@ -171,4 +198,15 @@ bool Profiler::get_object(int object, uint64_t &samples, uint64_t &hits)
   return true;
 }
 
+bool Profiler::get_light(int light, uint64_t &samples, uint64_t &hits)
+{
+  assert(worker == NULL);
+  if (light_samples[light] == 0) {
+    return false;
+  }
+  samples = light_samples[light];
+  hits = light_hits[light];
+  return true;
+}
+
 CCL_NAMESPACE_END
@@ -73,10 +73,16 @@ struct ProfilingState {
   volatile uint32_t event = PROFILING_UNKNOWN;
   volatile int32_t shader = -1;
   volatile int32_t object = -1;
+  volatile int32_t light = -1;
   volatile bool active = false;
 
+  /* Number of times each event was entered, which for intersection events is the number of rays
+   * traced. */
+  uint64_t event_hits[PROFILING_NUM_EVENTS];
+
   vector<uint64_t> shader_hits;
   vector<uint64_t> object_hits;
+  vector<uint64_t> light_hits;
 };
 
 class Profiler {
@@ -84,7 +90,7 @@ class Profiler {
   Profiler();
   ~Profiler();
 
-  void reset(int num_shaders, int num_objects);
+  void reset(int num_shaders, int num_objects, int num_lights = 0);
 
   void start();
   void stop();
@@ -93,8 +99,10 @@ class Profiler {
   void remove_state(ProfilingState *state);
 
   uint64_t get_event(ProfilingEvent event);
+  uint64_t get_event_hits(ProfilingEvent event);
   bool get_shader(int shader, uint64_t &samples, uint64_t &hits);
   bool get_object(int object, uint64_t &samples, uint64_t &hits);
+  bool get_light(int light, uint64_t &samples, uint64_t &hits);
 
  protected:
   void run();
@@ -105,13 +113,16 @@ class Profiler {
   vector<uint64_t> event_samples;
   vector<uint64_t> shader_samples;
   vector<uint64_t> object_samples;
+  vector<uint64_t> light_samples;
 
-  /* Tracks the total amounts every object/shader was hit.
+  /* Tracks the total amounts every event was entered and every object/shader/light was hit.
    * Used to evaluate relative cost, written by the render thread.
-   * Indexed by the shader and object IDs that the kernel also uses
-   * to index __object_flag and __shaders. */
+   * Indexed by the shader, object and light IDs that the kernel also uses
+   * to index __object_flag, __shaders and __lights. */
+  vector<uint64_t> event_hits;
   vector<uint64_t> shader_hits;
   vector<uint64_t> object_hits;
+  vector<uint64_t> light_hits;
 
   volatile bool do_stop_worker;
   thread *worker;
@@ -126,6 +137,10 @@ class ProfilingHelper {
   {
     previous_event = state->event;
     state->event = event;
+
+    if (state->active) {
+      state->event_hits[event]++;
+    }
   }
 
   ~ProfilingHelper()
@@ -154,6 +169,7 @@ class ProfilingWithShaderHelper : public ProfilingHelper {
   {
     state->object = -1;
     state->shader = -1;
+    state->light = -1;
   }
 
   inline void set_shader(int object, int shader)
@@ -173,6 +189,18 @@ class ProfilingWithShaderHelper : public ProfilingHelper {
       }
     }
   }
+
+  inline void set_light(int light)
+  {
+    if (state->active) {
+      state->light = light;
+
+      if (light >= 0) {
+        assert(light < state->light_hits.size());
+        state->light_hits[light]++;
+      }
+    }
+  }
 };
 
 CCL_NAMESPACE_END
@@ -35,7 +35,10 @@ OIIO_NAMESPACE_USING
 #  include <sys/sysctl.h>
 #  include <sys/types.h>
 #else
+#  include <pthread.h>
+#  include <sched.h>
 #  include <sys/ioctl.h>
+#  include <sys/syscall.h>
 #  include <unistd.h>
 #endif
 
@@ -118,6 +121,95 @@ bool system_cpu_run_thread_on_node(int node)
   return numaAPI_RunThreadOnNode(node);
 }
 
+#if !defined(_WIN32) && !defined(__APPLE__)
+/* Number of nodes in the memory policy masks, matches the largest kernel configuration. */
+static const int kMaxMemoryPolicyNodes = 1024;
+#endif
+
+bool system_cpu_thread_affinity_get(SystemThreadAffinity *affinity)
+{
+#ifdef _WIN32
+  GROUP_AFFINITY group_affinity;
+  if (!GetThreadGroupAffinity(GetCurrentThread(), &group_affinity)) {
+    return false;
+  }
+  affinity->processor_mask = {uint64_t(group_affinity.Mask)};
+  affinity->processor_group = group_affinity.Group;
+  return true;
+#elif defined(__APPLE__)
+  /* Threads can not be bound to processors. */
+  (void)affinity;
+  return false;
+#else
+  cpu_set_t cpu_set;
+  if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) != 0) {
+    return false;
+  }
+  affinity->processor_mask.resize(divide_up(sizeof(cpu_set), sizeof(uint64_t)));
+  memcpy(affinity->processor_mask.data(), &cpu_set, sizeof(cpu_set));
+
+  /* The memory policy is changed as well when the thread is run on a node. */
+  affinity->memory_node_mask.resize(kMaxMemoryPolicyNodes / 64);
+  if (syscall(SYS_get_mempolicy,
+              &affinity->memory_policy,
+              affinity->memory_node_mask.data(),
+              kMaxMemoryPolicyNodes,
+              NULL,
+              0) != 0) {
+    return false;
+  }
+  return true;
+#endif
+}
+
+bool system_cpu_thread_affinity_set(const SystemThreadAffinity &affinity)
+{
+#ifdef _WIN32
+  if (affinity.processor_mask.empty()) {
+    return false;
+  }
+  GROUP_AFFINITY group_affinity = {0};
+  group_affinity.Mask = KAFFINITY(affinity.processor_mask[0]);
+  group_affinity.Group = WORD(affinity.processor_group);
+  return SetThreadGroupAffinity(GetCurrentThread(), &group_affinity, NULL);
+#elif defined(__APPLE__)
+  (void)affinity;
+  return false;
+#else
+  cpu_set_t cpu_set;
+  if (affinity.processor_mask.size() * sizeof(uint64_t) < sizeof(cpu_set) ||
+      affinity.memory_node_mask.size() * 64 < kMaxMemoryPolicyNodes) {
+    return false;
+  }
+  memcpy(&cpu_set, affinity.processor_mask.data(), sizeof(cpu_set));
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) != 0) {
+    return false;
+  }
+
+  /* The kernel reads one node less than the given number of nodes. */
+  return syscall(SYS_set_mempolicy,
+                 affinity.memory_policy,
+                 affinity.memory_node_mask.data(),
+                 kMaxMemoryPolicyNodes + 1) == 0;
+#endif
+}
+
+void *system_cpu_numa_node_alloc(size_t size, int node)
+{
+  if (!system_cpu_ensure_initialized()) {
+    return NULL;
+  }
+  return numaAPI_AllocateOnNode(size, node);
+}
+
+void system_cpu_numa_node_free(void *memory, size_t size)
+{
+  if (memory == NULL) {
+    return;
+  }
+  numaAPI_Free(memory, size);
+}
+
 int system_console_width()
 {
   int columns = 0;
@@ -48,6 +48,36 @@ int system_cpu_num_numa_node_processors(int node);
  * Returns truth if affinity has successfully changed. */
 bool system_cpu_run_thread_on_node(int node);
 
+/* Processor affinity and memory placement policy of a thread. */
+struct SystemThreadAffinity {
+  /* Processors the thread is allowed to run on, within the processor group on Windows. */
+  vector<uint64_t> processor_mask;
+  int processor_group = 0;
+
+  /* Memory policy and its mask of nodes, only used on Linux. */
+  int memory_policy = 0;
+  vector<uint64_t> memory_node_mask;
+};
+
+/* Get affinity of the current thread, so that it can be restored after the thread has been run
+ * on a specific node.
+ *
+ * Returns false if the affinity can not be queried on this platform. */
+bool system_cpu_thread_affinity_get(SystemThreadAffinity *affinity);
+
+/* Restore affinity of the current thread from system_cpu_thread_affinity_get().
+ *
+ * Returns truth if affinity has successfully changed. */
+bool system_cpu_thread_affinity_set(const SystemThreadAffinity &affinity);
+
+/* Allocate memory which is physically placed on the given node.
+ *
+ * Returns NULL if the allocation failed, or if NUMA is not available. */
+void *system_cpu_numa_node_alloc(size_t size, int node);
+
+/* Free memory allocated with system_cpu_numa_node_alloc(). */
+void system_cpu_numa_node_free(void *memory, size_t size);
+
 /* Number of processors within the current CPU group (or within active thread
  * thread affinity). */
 int system_cpu_num_active_group_processors();
@@ -50,6 +50,7 @@ typedef enum ImageDataType {
   IMAGE_DATA_TYPE_USHORT = 7,
   IMAGE_DATA_TYPE_NANOVDB_FLOAT = 8,
   IMAGE_DATA_TYPE_NANOVDB_FLOAT3 = 9,
+  IMAGE_DATA_TYPE_TEXTURE_CACHE = 10,
 
   IMAGE_DATA_NUM_TYPES
 } ImageDataType;
@@ -94,6 +95,16 @@ typedef struct TextureInfo {
   Transform transform_3d;
 } TextureInfo;
 
+/* Image that is loaded on demand by the texture cache on the CPU. The texture data is this
+ * struct instead of pixels. */
+typedef struct TextureCacheImage {
+  /* OpenImageIO texture system and handle of the image file. */
+  void *texture_system;
+  void *texture_handle;
+  /* Number of channels in the file. */
+  int channels;
+} TextureCacheImage;
+
 CCL_NAMESPACE_END
 
 #endif /* __UTIL_TEXTURE_H__ */
@@ -184,9 +184,44 @@ extern unsigned int (*MEM_get_memory_blocks_in_use)(void);
 /** Reset the peak memory statistic to zero. */
 extern void (*MEM_reset_peak_memory)(void);
 
-/** Get the peak memory usage in bytes, including mmap allocations. */
+/**
+ * Get the peak memory usage in bytes, including mmap allocations.
+ *
+ * The guarded allocator tracks the exact peak. To avoid synchronizing threads on every
+ * allocation, the lock-free allocator only samples the total usage after a thread allocated
+ * another megabyte, so its peak can be lower than the real one by up to a megabyte per thread.
+ */
 extern size_t (*MEM_get_peak_memory)(void) ATTR_WARN_UNUSED_RESULT;
 
+/**
+ * Maximum number of memory scopes, including the "Other" scope with index 0 which holds memory
+ * allocated outside of any scope.
+ */
+#define MEM_SCOPE_MAX 32
+
+/**
+ * Attribute memory allocated by the calling thread to the named scope (usually a subsystem),
+ * until the matching #MEM_scope_pop. Scopes can be nested, the innermost one is used.
+ * The name has to be a static string.
+ *
+ * Blocks stay attributed to the scope they were allocated in, also when they are freed outside
+ * of it or from another thread. Scopes are per thread: tasks executed on other threads are not
+ * part of the scope unless they push it themselves.
+ */
+void MEM_scope_push(const char *name);
+void MEM_scope_pop(void);
+/** Number of registered scopes. */
+int MEM_scope_num(void);
+const char *MEM_scope_name(int scope);
+
+/** Memory in use by blocks allocated in the scope. */
+extern size_t (*MEM_get_scope_memory_in_use)(int scope);
+/**
+ * Peak memory usage of the scope. The lock-free allocator only samples scope usage when the total
+ * usage grows, so it can be lower than the real peak.
+ */
+extern size_t (*MEM_get_scope_peak_memory)(int scope);
+
 #ifdef __GNUC__
 #  define MEM_SAFE_FREE(v) \
     do { \
@@ -291,6 +326,21 @@ void MEM_use_guarded_allocator(void);
     { \
     }
 
+/** Attribute allocations of the calling thread to a memory scope while the object lives. */
+class MEM_ScopeGuard {
+ public:
+  MEM_ScopeGuard(const char *name)
+  {
+    MEM_scope_push(name);
+  }
+  ~MEM_ScopeGuard()
+  {
+    MEM_scope_pop();
+  }
+  MEM_ScopeGuard(const MEM_ScopeGuard &other) = delete;
+  MEM_ScopeGuard &operator=(const MEM_ScopeGuard &other) = delete;
+};
+
 /* Needed when type includes a namespace, then the namespace should not be
  * specified after ~, so using a macro fails. */
 template<class T> inline void OBJECT_GUARDED_DESTRUCTOR(T *what)
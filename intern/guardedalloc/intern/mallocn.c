@@ -60,6 +60,8 @@ size_t (*MEM_get_memory_in_use)(void) = MEM_lockfree_get_memory_in_use;
 unsigned int (*MEM_get_memory_blocks_in_use)(void) = MEM_lockfree_get_memory_blocks_in_use;
 void (*MEM_reset_peak_memory)(void) = MEM_lockfree_reset_peak_memory;
 size_t (*MEM_get_peak_memory)(void) = MEM_lockfree_get_peak_memory;
+size_t (*MEM_get_scope_memory_in_use)(int scope) = MEM_lockfree_get_scope_memory_in_use;
+size_t (*MEM_get_scope_peak_memory)(int scope) = MEM_lockfree_get_scope_peak_memory;
 
 #ifndef NDEBUG
 const char *(*MEM_name_ptr)(void *vmemh) = MEM_lockfree_name_ptr;
@@ -118,6 +120,8 @@ void MEM_use_lockfree_allocator(void)
 
   assert_for_allocator_change();
 
+  memory_usage_init();
+
   MEM_allocN_len = MEM_lockfree_allocN_len;
   MEM_freeN = MEM_lockfree_freeN;
   MEM_dupallocN = MEM_lockfree_dupallocN;
@@ -139,6 +143,8 @@ void MEM_use_lockfree_allocator(void)
   MEM_get_memory_blocks_in_use = MEM_lockfree_get_memory_blocks_in_use;
   MEM_reset_peak_memory = MEM_lockfree_reset_peak_memory;
   MEM_get_peak_memory = MEM_lockfree_get_peak_memory;
+  MEM_get_scope_memory_in_use = MEM_lockfree_get_scope_memory_in_use;
+  MEM_get_scope_peak_memory = MEM_lockfree_get_scope_peak_memory;
 
 #ifndef NDEBUG
   MEM_name_ptr = MEM_lockfree_name_ptr;
@@ -149,6 +155,8 @@ void MEM_use_guarded_allocator(void)
 {
   assert_for_allocator_change();
 
+  memory_usage_init();
+
   MEM_allocN_len = MEM_guarded_allocN_len;
   MEM_freeN = MEM_guarded_freeN;
   MEM_dupallocN = MEM_guarded_dupallocN;
@@ -170,6 +178,8 @@ void MEM_use_guarded_allocator(void)
   MEM_get_memory_blocks_in_use = MEM_guarded_get_memory_blocks_in_use;
   MEM_reset_peak_memory = MEM_guarded_reset_peak_memory;
   MEM_get_peak_memory = MEM_guarded_get_peak_memory;
+  MEM_get_scope_memory_in_use = MEM_guarded_get_scope_memory_in_use;
+  MEM_get_scope_peak_memory = MEM_guarded_get_scope_peak_memory;
 
 #ifndef NDEBUG
   MEM_name_ptr = MEM_guarded_name_ptr;
@@ -97,7 +97,8 @@ typedef struct MemHead {
   const char *name;
   const char *nextname;
   int tag2;
-  short pad1;
+  /* Memory scope the block is attributed to. */
+  short scope;
   /* if non-zero aligned allocation was used and alignment is stored here. */
   short alignment;
 #ifdef DEBUG_MEMCOUNTER
@@ -162,6 +163,7 @@ static const char *check_memlist(MemHead *memh);
 
 static unsigned int totblock = 0;
 static size_t mem_in_use = 0, peak_mem = 0;
+static size_t scope_mem_in_use[MEM_SCOPE_MAX] = {0}, scope_peak_mem[MEM_SCOPE_MAX] = {0};
 
 static volatile struct localListBase _membase;
 static volatile struct localListBase *membase = &_membase;
@@ -418,7 +420,7 @@ static void make_memhead_header(MemHead *memh, size_t len, const char *str)
   memh->name = str;
   memh->nextname = NULL;
   memh->len = len;
-  memh->pad1 = 0;
+  memh->scope = (short)memory_scope_current();
   memh->alignment = 0;
   memh->tag2 = MEMTAG2;
 
@@ -442,6 +444,10 @@ static void make_memhead_header(MemHead *memh, size_t len, const char *str)
     memh->nextname = MEMNEXT(memh->next)->name;
   }
   peak_mem = mem_in_use > peak_mem ? mem_in_use : peak_mem;
+  scope_mem_in_use[memh->scope] += len;
+  if (scope_mem_in_use[memh->scope] > scope_peak_mem[memh->scope]) {
+    scope_peak_mem[memh->scope] = scope_mem_in_use[memh->scope];
+  }
   mem_unlock_thread();
 }
 
@@ -700,6 +706,13 @@ void MEM_guarded_printmemlist_stats(void)
   printf("\ntotal memory len: %.3f MB\n", (double)mem_in_use / (double)(1024 * 1024));
   printf("peak memory len: %.3f MB\n", (double)peak_mem / (double)(1024 * 1024));
   printf("slop memory len: %.3f MB\n", (double)mem_in_use_slop / (double)(1024 * 1024));
+  printf(" SCOPE TOTAL-MiB PEAK-MiB\n");
+  for (int scope = 0; scope < MEM_scope_num(); scope++) {
+    printf("%s (%8.3f  %8.3f)\n",
+           MEM_scope_name(scope),
+           (double)scope_mem_in_use[scope] / (double)(1024 * 1024),
+           (double)scope_peak_mem[scope] / (double)(1024 * 1024));
+  }
   printf(" ITEMS TOTAL-MiB AVERAGE-KiB TYPE\n");
   for (a = 0, pb = printblock; a < totpb; a++, pb++) {
     printf("%6d (%8.3f  %8.3f) %s\n",
@@ -1002,6 +1015,7 @@ static void rem_memblock(MemHead *memh)
       MEMNEXT(memh->prev)->nextname = NULL;
     }
   }
+  scope_mem_in_use[memh->scope] -= memh->len;
   mem_unlock_thread();
 
   atomic_sub_and_fetch_u(&totblock, 1);
@@ -1179,6 +1193,7 @@ void MEM_guarded_reset_peak_memory(void)
 {
   mem_lock_thread();
   peak_mem = mem_in_use;
+  memcpy(scope_peak_mem, scope_mem_in_use, sizeof(scope_peak_mem));
   mem_unlock_thread();
 }
 
@@ -1193,6 +1208,28 @@ size_t MEM_guarded_get_memory_in_use(void)
   return _mem_in_use;
 }
 
+size_t MEM_guarded_get_scope_memory_in_use(int scope)
+{
+  size_t _mem_in_use;
+
+  mem_lock_thread();
+  _mem_in_use = scope_mem_in_use[scope];
+  mem_unlock_thread();
+
+  return _mem_in_use;
+}
+
+size_t MEM_guarded_get_scope_peak_memory(int scope)
+{
+  size_t _peak_mem;
+
+  mem_lock_thread();
+  _peak_mem = scope_peak_mem[scope];
+  mem_unlock_thread();
+
+  return _peak_mem;
+}
+
 unsigned int MEM_guarded_get_memory_blocks_in_use(void)
 {
   unsigned int _totblock;
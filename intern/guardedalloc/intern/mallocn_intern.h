@@ -92,6 +92,17 @@ size_t malloc_usable_size(void *ptr);
 /* Real pointer returned by the malloc or aligned_alloc. */
 #define MEMHEAD_REAL_PTR(memh) ((char *)memh - MEMHEAD_ALIGN_PADDING(memh->alignment))
 
+#ifdef WITH_MEM_THREAD_CACHE
+/* Small blocks are rounded up to size classes of this granularity, so that freed blocks can be
+ * kept in a thread-local cache and reused by later allocations of the same class. */
+#  define MEM_THREAD_CACHE_GRANULARITY ((size_t)16)
+/* Largest block size which goes through the thread-local cache. */
+#  define MEM_THREAD_CACHE_MAX_SIZE ((size_t)256)
+#  define MEM_THREAD_CACHE_CLASS_INDEX(size) \
+    ((size) ? ((size) - (size_t)1) / MEM_THREAD_CACHE_GRANULARITY : (size_t)0)
+#  define MEM_THREAD_CACHE_CLASS_SIZE(index) (((index) + (size_t)1) * MEM_THREAD_CACHE_GRANULARITY)
+#endif
+
 #include "mallocn_inline.h"
 
 #ifdef __cplusplus
@@ -106,6 +117,31 @@ void aligned_free(void *ptr);
 extern bool leak_detector_has_run;
 extern char free_after_leak_detection_message[];
 
+/* Per-thread memory usage counters, used by the lock-free allocator.
+ * Allocation returns the memory scope the block is attributed to, which has to be passed back
+ * when the block is freed. Without use_scope the block is attributed to scope 0, for when the
+ * scope can not be stored with the block. */
+void memory_usage_init(void);
+int memory_usage_block_alloc(size_t size, bool use_scope);
+void memory_usage_block_free(size_t size, int scope);
+size_t memory_usage_block_num(void);
+size_t memory_usage_current(void);
+size_t memory_usage_peak(void);
+void memory_usage_peak_reset(void);
+size_t memory_usage_scope_current(int scope);
+size_t memory_usage_scope_peak(int scope);
+
+/* Current memory scope of the calling thread. */
+int memory_scope_current(void);
+
+#ifdef WITH_MEM_THREAD_CACHE
+/* Thread-local cache of freed small blocks. The pointers are the ones returned by the system
+ * allocator, the size is the length of the block as stored in its #MemHead. */
+void *memory_cache_block_pop(size_t size);
+bool memory_cache_block_push(void *ptr, size_t size);
+void memory_cache_stats(size_t *r_hits, size_t *r_misses, size_t *r_cached_bytes);
+#endif
+
 /* Prototypes for counted allocator functions */
 size_t MEM_lockfree_allocN_len(const void *vmemh) ATTR_WARN_UNUSED_RESULT;
 void MEM_lockfree_freeN(void *vmemh);
@@ -145,6 +181,8 @@ size_t MEM_lockfree_get_memory_in_use(void);
 unsigned int MEM_lockfree_get_memory_blocks_in_use(void);
 void MEM_lockfree_reset_peak_memory(void);
 size_t MEM_lockfree_get_peak_memory(void) ATTR_WARN_UNUSED_RESULT;
+size_t MEM_lockfree_get_scope_memory_in_use(int scope);
+size_t MEM_lockfree_get_scope_peak_memory(int scope);
 #ifndef NDEBUG
 const char *MEM_lockfree_name_ptr(void *vmemh);
 #endif
@@ -188,6 +226,8 @@ size_t MEM_guarded_get_memory_in_use(void);
 unsigned int MEM_guarded_get_memory_blocks_in_use(void);
 void MEM_guarded_reset_peak_memory(void);
 size_t MEM_guarded_get_peak_memory(void) ATTR_WARN_UNUSED_RESULT;
+size_t MEM_guarded_get_scope_memory_in_use(int scope);
+size_t MEM_guarded_get_scope_peak_memory(int scope);
 #ifndef NDEBUG
 const char *MEM_guarded_name_ptr(void *vmemh);
 #endif
@@ -20,7 +20,9 @@
  * Memory allocation which keeps track on allocated memory counters
  */
 
+#include <assert.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h> /* printf */
 #include <stdlib.h>
 #include <string.h> /* memcpy */
@@ -31,7 +33,6 @@
 /* to ensure strict conversions */
 #include "../../source/blender/blenlib/BLI_strict_flags.h"
 
-#include "atomic_ops.h"
 #include "mallocn_intern.h"
 
 typedef struct MemHead {
@@ -44,8 +45,6 @@ typedef struct MemHeadAligned {
   size_t len;
 } MemHeadAligned;
 
-static unsigned int totblock = 0;
-static size_t mem_in_use = 0, peak_mem = 0;
 static bool malloc_debug_memset = false;
 
 static void (*error_callback)(const char *) = NULL;
@@ -59,16 +58,53 @@ enum {
 #define MEMHEAD_ALIGNED_FROM_PTR(ptr) (((MemHeadAligned *)ptr) - 1)
 #define MEMHEAD_IS_ALIGNED(memhead) ((memhead)->len & (size_t)MEMHEAD_ALIGN_FLAG)
 
-/* Uncomment this to have proper peak counter. */
-#define USE_ATOMIC_MAX
+/* The memory scope of a block is stored in the high bits of its length, which are never used by
+ * real allocation sizes. Scopes are not tracked on 32 bit platforms. */
+#if SIZE_MAX > UINT32_MAX
+#  define MEMHEAD_USE_SCOPE true
+#  define MEMHEAD_SCOPE_SHIFT 56
+#  define MEMHEAD_SCOPE_BITS(scope) ((size_t)(scope) << MEMHEAD_SCOPE_SHIFT)
+#  define MEMHEAD_SCOPE(memhead) ((int)((memhead)->len >> MEMHEAD_SCOPE_SHIFT))
+#  define MEMHEAD_LEN_MASK ((((size_t)1 << MEMHEAD_SCOPE_SHIFT) - 1) & ~(size_t)MEMHEAD_ALIGN_FLAG)
+#else
+#  define MEMHEAD_USE_SCOPE false
+#  define MEMHEAD_SCOPE_BITS(scope) ((void)(scope), (size_t)0)
+#  define MEMHEAD_SCOPE(memhead) 0
+#  define MEMHEAD_LEN_MASK (~(size_t)MEMHEAD_ALIGN_FLAG)
+#endif
+
+/* Allocate a non-aligned block of the given (already 4 bytes aligned) length, reusing a block
+ * from the thread-local cache when possible. */
+MEM_INLINE MemHead *memhead_alloc(size_t len, bool clear)
+{
+#ifdef WITH_MEM_THREAD_CACHE
+  if (len <= MEM_THREAD_CACHE_MAX_SIZE) {
+    MemHead *memh = (MemHead *)memory_cache_block_pop(len);
+    if (memh) {
+      if (clear) {
+        memset(memh + 1, 0, len);
+      }
+      return memh;
+    }
+    /* Allocate the full size class, so the block can be reused for any length of its class. */
+    const size_t alloc_len = MEM_THREAD_CACHE_CLASS_SIZE(MEM_THREAD_CACHE_CLASS_INDEX(len));
+    return (MemHead *)(clear ? calloc(1, alloc_len + sizeof(MemHead)) :
+                               malloc(alloc_len + sizeof(MemHead)));
+  }
+#endif
+  return (MemHead *)(clear ? calloc(1, len + sizeof(MemHead)) : malloc(len + sizeof(MemHead)));
+}
 
-MEM_INLINE void update_maximum(size_t *maximum_value, size_t value)
+MEM_INLINE void memhead_free(MemHead *memh, size_t len)
 {
-#ifdef USE_ATOMIC_MAX
-  atomic_fetch_and_update_max_z(maximum_value, value);
+#ifdef WITH_MEM_THREAD_CACHE
+  if (len <= MEM_THREAD_CACHE_MAX_SIZE && memory_cache_block_push(memh, len)) {
+    return;
+  }
 #else
-  *maximum_value = value > *maximum_value ? value : *maximum_value;
+  (void)len;
 #endif
+  free(memh);
 }
 
 #ifdef __GNUC__
@@ -93,7 +129,7 @@ print_error(const char *str, ...)
 size_t MEM_lockfree_allocN_len(const void *vmemh)
 {
   if (vmemh) {
-    return MEMHEAD_FROM_PTR(vmemh)->len & ~((size_t)(MEMHEAD_ALIGN_FLAG));
+    return MEMHEAD_FROM_PTR(vmemh)->len & MEMHEAD_LEN_MASK;
   }
 
   return 0;
@@ -116,8 +152,7 @@ void MEM_lockfree_freeN(void *vmemh)
     return;
   }
 
-  atomic_sub_and_fetch_u(&totblock, 1);
-  atomic_sub_and_fetch_z(&mem_in_use, len);
+  memory_usage_block_free(len, MEMHEAD_SCOPE(memh));
 
   if (UNLIKELY(malloc_debug_memset && len)) {
     memset(memh + 1, 255, len);
@@ -127,7 +162,7 @@ void MEM_lockfree_freeN(void *vmemh)
     aligned_free(MEMHEAD_REAL_PTR(memh_aligned));
   }
   else {
-    free(memh);
+    memhead_free(memh, len);
   }
 }
 
@@ -233,20 +268,17 @@ void *MEM_lockfree_callocN(size_t len, const char *str)
 
   len = SIZET_ALIGN_4(len);
 
-  memh = (MemHead *)calloc(1, len + sizeof(MemHead));
+  memh = memhead_alloc(len, true);
 
   if (LIKELY(memh)) {
-    memh->len = len;
-    atomic_add_and_fetch_u(&totblock, 1);
-    atomic_add_and_fetch_z(&mem_in_use, len);
-    update_maximum(&peak_mem, mem_in_use);
+    memh->len = len | MEMHEAD_SCOPE_BITS(memory_usage_block_alloc(len, MEMHEAD_USE_SCOPE));
 
     return PTR_FROM_MEMHEAD(memh);
   }
   print_error("Calloc returns null: len=" SIZET_FORMAT " in %s, total %u\n",
               SIZET_ARG(len),
               str,
-              (unsigned int)mem_in_use);
+              (unsigned int)memory_usage_current());
   return NULL;
 }
 
@@ -260,7 +292,7 @@ void *MEM_lockfree_calloc_arrayN(size_t len, size_t size, const char *str)
         SIZET_ARG(len),
         SIZET_ARG(size),
         str,
-        (unsigned int)mem_in_use);
+        (unsigned int)memory_usage_current());
     abort();
     return NULL;
   }
@@ -274,24 +306,21 @@ void *MEM_lockfree_mallocN(size_t len, const char *str)
 
   len = SIZET_ALIGN_4(len);
 
-  memh = (MemHead *)malloc(len + sizeof(MemHead));
+  memh = memhead_alloc(len, false);
 
   if (LIKELY(memh)) {
     if (UNLIKELY(malloc_debug_memset && len)) {
       memset(memh + 1, 255, len);
     }
 
-    memh->len = len;
-    atomic_add_and_fetch_u(&totblock, 1);
-    atomic_add_and_fetch_z(&mem_in_use, len);
-    update_maximum(&peak_mem, mem_in_use);
+    memh->len = len | MEMHEAD_SCOPE_BITS(memory_usage_block_alloc(len, MEMHEAD_USE_SCOPE));
 
     return PTR_FROM_MEMHEAD(memh);
   }
   print_error("Malloc returns null: len=" SIZET_FORMAT " in %s, total %u\n",
               SIZET_ARG(len),
               str,
-              (unsigned int)mem_in_use);
+              (unsigned int)memory_usage_current());
   return NULL;
 }
 
@@ -305,7 +334,7 @@ void *MEM_lockfree_malloc_arrayN(size_t len, size_t size, const char *str)
         SIZET_ARG(len),
         SIZET_ARG(size),
         str,
-        (unsigned int)mem_in_use);
+        (unsigned int)memory_usage_current());
     abort();
     return NULL;
   }
@@ -351,18 +380,16 @@ void *MEM_lockfree_mallocN_aligned(size_t len, size_t alignment, const char *str
       memset(memh + 1, 255, len);
     }
 
-    memh->len = len | (size_t)MEMHEAD_ALIGN_FLAG;
+    const int scope = memory_usage_block_alloc(len, MEMHEAD_USE_SCOPE);
+    memh->len = len | (size_t)MEMHEAD_ALIGN_FLAG | MEMHEAD_SCOPE_BITS(scope);
     memh->alignment = (short)alignment;
-    atomic_add_and_fetch_u(&totblock, 1);
-    atomic_add_and_fetch_z(&mem_in_use, len);
-    update_maximum(&peak_mem, mem_in_use);
 
     return PTR_FROM_MEMHEAD(memh);
   }
   print_error("Malloc returns null: len=" SIZET_FORMAT " in %s, total %u\n",
               SIZET_ARG(len),
               str,
-              (unsigned int)mem_in_use);
+              (unsigned int)memory_usage_current());
   return NULL;
 }
 
@@ -382,8 +409,24 @@ void MEM_lockfree_callbackmemlist(void (*func)(void *))
 
 void MEM_lockfree_printmemlist_stats(void)
 {
-  printf("\ntotal memory len: %.3f MB\n", (double)mem_in_use / (double)(1024 * 1024));
-  printf("peak memory len: %.3f MB\n", (double)peak_mem / (double)(1024 * 1024));
+  printf("\ntotal memory len: %.3f MB\n",
+         (double)memory_usage_current() / (double)(1024 * 1024));
+  printf("peak memory len: %.3f MB\n", (double)memory_usage_peak() / (double)(1024 * 1024));
+  printf(" SCOPE TOTAL-MiB PEAK-MiB\n");
+  for (int scope = 0; scope < MEM_scope_num(); scope++) {
+    printf("%s (%8.3f  %8.3f)\n",
+           MEM_scope_name(scope),
+           (double)memory_usage_scope_current(scope) / (double)(1024 * 1024),
+           (double)memory_usage_scope_peak(scope) / (double)(1024 * 1024));
+  }
+#ifdef WITH_MEM_THREAD_CACHE
+  size_t cache_hits, cache_misses, cache_bytes;
+  memory_cache_stats(&cache_hits, &cache_misses, &cache_bytes);
+  printf("thread cache: " SIZET_FORMAT " hits, " SIZET_FORMAT " misses, %.3f MB cached\n",
+         SIZET_ARG(cache_hits),
+         SIZET_ARG(cache_misses),
+         (double)cache_bytes / (double)(1024 * 1024));
+#endif
   printf(
       "\nFor more detailed per-block statistics run Blender with memory debugging command line "
       "argument.\n");
@@ -411,23 +454,32 @@ void MEM_lockfree_set_memory_debug(void)
 
 size_t MEM_lockfree_get_memory_in_use(void)
 {
-  return mem_in_use;
+  return memory_usage_current();
 }
 
 unsigned int MEM_lockfree_get_memory_blocks_in_use(void)
 {
-  return totblock;
+  return (unsigned int)memory_usage_block_num();
 }
 
-/* dummy */
 void MEM_lockfree_reset_peak_memory(void)
 {
-  peak_mem = mem_in_use;
+  memory_usage_peak_reset();
 }
 
 size_t MEM_lockfree_get_peak_memory(void)
 {
-  return peak_mem;
+  return memory_usage_peak();
+}
+
+size_t MEM_lockfree_get_scope_memory_in_use(int scope)
+{
+  return memory_usage_scope_current(scope);
+}
+
+size_t MEM_lockfree_get_scope_peak_memory(int scope)
+{
+  return memory_usage_scope_peak(scope);
 }
 
 #ifndef NDEBUG
@@ -0,0 +1,543 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup MEM
+ *
+ * Per-thread state of the lock-free allocator.
+ *
+ * Every thread which allocates memory gets its own #Local data. It holds the memory usage
+ * counters of the thread and a cache of recently freed small blocks. Both are only written by the
+ * owning thread, so allocations do not have to synchronize with other threads. The totals are
+ * computed on demand by summing up the counters of all threads.
+ *
+ * #Local data is allocated on the heap and never freed. When a thread exits, its counters are
+ * moved to the global counters and the data is reused by the next thread that starts. This way
+ * memory can still be allocated and freed by destructors which run while or after threads exit.
+ *
+ * The thread-local data also holds the stack of memory scopes, which is used by both allocator
+ * implementations to attribute blocks to subsystems.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#include "MEM_guardedalloc.h"
+#include "mallocn_intern.h"
+
+namespace {
+
+/**
+ * Peak memory usage is only updated when a thread allocated this many bytes since the last update
+ * of the peak. This avoids having to compute the total memory usage on every allocation, at the
+ * cost of the peak being lower than the real value by up to this amount per thread.
+ */
+constexpr int64_t peak_update_threshold = 1024 * 1024;
+
+/** Maximum nesting of memory scopes on a single thread. */
+constexpr int scope_stack_max = 64;
+
+#ifdef WITH_MEM_THREAD_CACHE
+constexpr size_t cache_class_num = MEM_THREAD_CACHE_MAX_SIZE / MEM_THREAD_CACHE_GRANULARITY;
+/** Upper limit of the bytes cached per size class and thread. */
+constexpr size_t cache_class_max_bytes = 16 * 1024;
+
+/** Freed block in the thread cache. The link is stored in the memory of the block itself. */
+struct CachedBlock {
+  CachedBlock *next;
+};
+#endif
+
+struct Local;
+
+struct Global {
+  /** Protects the list of #Local and the update of the peak. */
+  std::mutex locals_mutex;
+  Local *locals_first = nullptr;
+  /**
+   * Counters of allocations which happened when thread-local data was not available, and
+   * counters of threads which have exited already.
+   */
+  std::atomic<int64_t> blocks_num_outside_locals = 0;
+  std::atomic<int64_t> mem_in_use_outside_locals = 0;
+  std::atomic<size_t> peak = 0;
+
+  /** Registered memory scopes, names are never freed. Index 0 is used for unscoped memory. */
+  const char *scope_names[MEM_SCOPE_MAX] = {"Other"};
+  std::atomic<int> scope_num = 1;
+  std::atomic<int64_t> scope_mem_in_use_outside_locals[MEM_SCOPE_MAX] = {};
+  std::atomic<size_t> scope_peak[MEM_SCOPE_MAX] = {};
+};
+
+/**
+ * Aligned to a cache line, so that counters of different threads never share one and do not
+ * cause false sharing.
+ */
+struct alignas(64) Local {
+  /**
+   * Counters of the blocks allocated minus the blocks freed by this thread. They can become
+   * negative when memory is freed by another thread than the one that allocated it.
+   * Atomics are only used so that other threads can read them while computing the totals.
+   */
+  std::atomic<int64_t> blocks_num = 0;
+  std::atomic<int64_t> mem_in_use = 0;
+  int64_t mem_in_use_during_peak_update = 0;
+  std::atomic<int64_t> scope_mem_in_use[MEM_SCOPE_MAX] = {};
+
+  /** Memory scopes pushed on this thread, the last one is the current scope. */
+  int scope_stack[scope_stack_max];
+  int scope_depth = 0;
+
+#ifdef WITH_MEM_THREAD_CACHE
+  CachedBlock *cache[cache_class_num] = {nullptr};
+  size_t cache_len[cache_class_num] = {0};
+  std::atomic<int64_t> cache_hits = 0;
+  std::atomic<int64_t> cache_misses = 0;
+  std::atomic<int64_t> cache_bytes = 0;
+#endif
+
+  Local *next = nullptr;
+  /** False when the thread that used this data exited, so it can be reused by another thread. */
+  bool in_use = false;
+};
+
+/** Releases the #Local data of a thread when the thread exits. */
+struct LocalReleaser {
+  ~LocalReleaser();
+};
+
+/**
+ * #Local data of the current thread. Trivially destructible thread-local variables stay valid
+ * while the thread exits, so these can be used by any destructor.
+ */
+thread_local Local *local_data = nullptr;
+/** True when the thread is exiting and its #Local data was released already. */
+thread_local bool local_data_released = false;
+
+/**
+ * Construct on first use, so that the global data exists before the first allocation happens.
+ * It is intentionally never destructed, since memory can be freed by static destructors which
+ * run after this function's static storage would have been destroyed.
+ */
+Global &get_global()
+{
+  static Global *global = new (aligned_malloc(sizeof(Global), alignof(Global))) Global();
+  return *global;
+}
+
+/** Get #Local data for a new thread, reusing the data of a thread that exited. */
+Local *local_data_acquire()
+{
+  Global &global = get_global();
+  std::lock_guard<std::mutex> lock{global.locals_mutex};
+  for (Local *local = global.locals_first; local; local = local->next) {
+    if (!local->in_use) {
+      local->in_use = true;
+      return local;
+    }
+  }
+  /* Plain `malloc` does not guarantee the cache line alignment. */
+  Local *local = new (aligned_malloc(sizeof(Local), alignof(Local))) Local();
+  local->in_use = true;
+  local->next = global.locals_first;
+  global.locals_first = local;
+  return local;
+}
+
+/** Move the counters of a thread that exits to the global counters, so the data can be reused. */
+void local_data_release(Local *local)
+{
+  Global &global = get_global();
+
+#ifdef WITH_MEM_THREAD_CACHE
+  for (size_t i = 0; i < cache_class_num; i++) {
+    CachedBlock *block = local->cache[i];
+    while (block) {
+      CachedBlock *next = block->next;
+      free(block);
+      block = next;
+    }
+    local->cache[i] = nullptr;
+    local->cache_len[i] = 0;
+  }
+  local->cache_bytes = 0;
+#endif
+
+  std::lock_guard<std::mutex> lock{global.locals_mutex};
+  global.blocks_num_outside_locals.fetch_add(local->blocks_num, std::memory_order_relaxed);
+  global.mem_in_use_outside_locals.fetch_add(local->mem_in_use, std::memory_order_relaxed);
+  local->blocks_num = 0;
+  local->mem_in_use = 0;
+  local->mem_in_use_during_peak_update = 0;
+  for (int scope = 0; scope < MEM_SCOPE_MAX; scope++) {
+    global.scope_mem_in_use_outside_locals[scope].fetch_add(local->scope_mem_in_use[scope],
+                                                            std::memory_order_relaxed);
+    local->scope_mem_in_use[scope] = 0;
+  }
+  local->scope_depth = 0;
+  local->in_use = false;
+}
+
+LocalReleaser::~LocalReleaser()
+{
+  if (local_data) {
+    local_data_release(local_data);
+    local_data = nullptr;
+  }
+  /* Memory allocated or freed by destructors which run after this one is counted globally. */
+  local_data_released = true;
+}
+
+/**
+ * Get the thread-local data when it can be used, null otherwise.
+ */
+Local *get_local_data_safe()
+{
+  Local *local = local_data;
+  if (LIKELY(local)) {
+    return local;
+  }
+  if (UNLIKELY(local_data_released)) {
+    return nullptr;
+  }
+  local = local_data_acquire();
+  local_data = local;
+  /* Registers the release of the data when the thread exits. */
+  static thread_local LocalReleaser releaser;
+  (void)releaser;
+  return local;
+}
+
+int get_current_scope(const Local &local)
+{
+  if (local.scope_depth == 0) {
+    return 0;
+  }
+  return local.scope_stack[std::min(local.scope_depth, scope_stack_max) - 1];
+}
+
+/** Sum of the counters of all threads, the caller must hold the lock of the locals list. */
+void get_totals_locked(const Global &global, int64_t *r_blocks_num, int64_t *r_mem_in_use)
+{
+  int64_t blocks_num = global.blocks_num_outside_locals.load(std::memory_order_relaxed);
+  int64_t mem_in_use = global.mem_in_use_outside_locals.load(std::memory_order_relaxed);
+  for (const Local *local = global.locals_first; local; local = local->next) {
+    blocks_num += local->blocks_num.load(std::memory_order_relaxed);
+    mem_in_use += local->mem_in_use.load(std::memory_order_relaxed);
+  }
+  *r_blocks_num = blocks_num;
+  *r_mem_in_use = mem_in_use;
+}
+
+/** Sum of the counters of a scope of all threads, the caller must hold the lock. */
+int64_t get_scope_total_locked(const Global &global, const int scope)
+{
+  int64_t mem_in_use = global.scope_mem_in_use_outside_locals[scope].load(
+      std::memory_order_relaxed);
+  for (const Local *local = global.locals_first; local; local = local->next) {
+    mem_in_use += local->scope_mem_in_use[scope].load(std::memory_order_relaxed);
+  }
+  return mem_in_use;
+}
+
+void update_maximum(std::atomic<size_t> &maximum, const int64_t value)
+{
+  const size_t value_clamped = size_t(std::max<int64_t>(value, 0));
+  size_t prev = maximum.load(std::memory_order_relaxed);
+  while (prev < value_clamped &&
+         !maximum.compare_exchange_weak(prev, value_clamped, std::memory_order_relaxed)) {
+    /* Pass. */
+  }
+}
+
+/**
+ * Update the peak of the total memory usage and of all scopes. The peaks of scopes are only
+ * sampled at these points, so they are less precise than the total peak.
+ */
+void update_global_peak()
+{
+  Global &global = get_global();
+  std::lock_guard<std::mutex> lock{global.locals_mutex};
+  int64_t blocks_num, mem_in_use;
+  get_totals_locked(global, &blocks_num, &mem_in_use);
+  update_maximum(global.peak, mem_in_use);
+
+  const int scope_num = global.scope_num.load(std::memory_order_acquire);
+  for (int scope = 0; scope < scope_num; scope++) {
+    update_maximum(global.scope_peak[scope], get_scope_total_locked(global, scope));
+  }
+}
+
+int find_scope(const Global &global, const int scope_num, const char *name)
+{
+  for (int scope = 0; scope < scope_num; scope++) {
+    const char *scope_name = global.scope_names[scope];
+    if (scope_name == name || strcmp(scope_name, name) == 0) {
+      return scope;
+    }
+  }
+  return -1;
+}
+
+/** Get the index of the scope with the given name, registering it when it doesn't exist yet. */
+int ensure_scope(const char *name)
+{
+  Global &global = get_global();
+  int scope = find_scope(global, global.scope_num.load(std::memory_order_acquire), name);
+  if (LIKELY(scope != -1)) {
+    return scope;
+  }
+
+  std::lock_guard<std::mutex> lock{global.locals_mutex};
+  const int scope_num = global.scope_num.load(std::memory_order_relaxed);
+  scope = find_scope(global, scope_num, name);
+  if (scope != -1) {
+    return scope;
+  }
+  if (scope_num == MEM_SCOPE_MAX) {
+    /* Out of scopes, attribute memory to the unscoped category. */
+    return 0;
+  }
+  global.scope_names[scope_num] = name;
+  global.scope_num.store(scope_num + 1, std::memory_order_release);
+  return scope_num;
+}
+
+}  // namespace
+
+void memory_usage_init(void)
+{
+  /* Makes sure the global data and the thread-local data of the main thread are initialized
+   * before any other thread is started. */
+  get_local_data_safe();
+}
+
+int memory_usage_block_alloc(size_t size, bool use_scope)
+{
+  Local *local = get_local_data_safe();
+  if (LIKELY(local)) {
+    const int scope = use_scope ? get_current_scope(*local) : 0;
+    /* Relaxed atomics on a cache line owned by this thread. These only synchronize when another
+     * thread computes the totals at the same time, which is rare compared to allocations. */
+    local->blocks_num.fetch_add(1, std::memory_order_relaxed);
+    local->scope_mem_in_use[scope].fetch_add(int64_t(size), std::memory_order_relaxed);
+    const int64_t mem_in_use = local->mem_in_use.fetch_add(int64_t(size),
+                                                           std::memory_order_relaxed) +
+                               int64_t(size);
+    if (mem_in_use - local->mem_in_use_during_peak_update > peak_update_threshold) {
+      local->mem_in_use_during_peak_update = mem_in_use;
+      update_global_peak();
+    }
+    return scope;
+  }
+
+  Global &global = get_global();
+  global.blocks_num_outside_locals.fetch_add(1, std::memory_order_relaxed);
+  global.mem_in_use_outside_locals.fetch_add(int64_t(size), std::memory_order_relaxed);
+  global.scope_mem_in_use_outside_locals[0].fetch_add(int64_t(size), std::memory_order_relaxed);
+  return 0;
+}
+
+void memory_usage_block_free(size_t size, int scope)
+{
+  Local *local = get_local_data_safe();
+  if (LIKELY(local)) {
+    local->blocks_num.fetch_sub(1, std::memory_order_relaxed);
+    local->scope_mem_in_use[scope].fetch_sub(int64_t(size), std::memory_order_relaxed);
+    const int64_t mem_in_use = local->mem_in_use.fetch_sub(int64_t(size),
+                                                           std::memory_order_relaxed) -
+                               int64_t(size);
+    /* Allow the peak to be updated again once this thread allocates more memory. */
+    local->mem_in_use_during_peak_update = std::min(local->mem_in_use_during_peak_update,
+                                                    mem_in_use);
+  }
+  else {
+    Global &global = get_global();
+    global.blocks_num_outside_locals.fetch_sub(1, std::memory_order_relaxed);
+    global.mem_in_use_outside_locals.fetch_sub(int64_t(size), std::memory_order_relaxed);
+    global.scope_mem_in_use_outside_locals[scope].fetch_sub(int64_t(size),
+                                                            std::memory_order_relaxed);
+  }
+}
+
+size_t memory_usage_block_num(void)
+{
+  Global &global = get_global();
+  std::lock_guard<std::mutex> lock{global.locals_mutex};
+  int64_t blocks_num, mem_in_use;
+  get_totals_locked(global, &blocks_num, &mem_in_use);
+  return size_t(std::max<int64_t>(blocks_num, 0));
+}
+
+size_t memory_usage_current(void)
+{
+  Global &global = get_global();
+  std::lock_guard<std::mutex> lock{global.locals_mutex};
+  int64_t blocks_num, mem_in_use;
+  get_totals_locked(global, &blocks_num, &mem_in_use);
+  return size_t(std::max<int64_t>(mem_in_use, 0));
+}
+
+size_t memory_usage_peak(void)
+{
+  update_global_peak();
+  Global &global = get_global();
+  return global.peak.load(std::memory_order_relaxed);
+}
+
+void memory_usage_peak_reset(void)
+{
+  Global &global = get_global();
+  std::lock_guard<std::mutex> lock{global.locals_mutex};
+  int64_t blocks_num, mem_in_use;
+  get_totals_locked(global, &blocks_num, &mem_in_use);
+  global.peak = size_t(std::max<int64_t>(mem_in_use, 0));
+
+  const int scope_num = global.scope_num.load(std::memory_order_acquire);
+  for (int scope = 0; scope < scope_num; scope++) {
+    global.scope_peak[scope] = size_t(std::max<int64_t>(get_scope_total_locked(global, scope), 0));
+  }
+}
+
+size_t memory_usage_scope_current(int scope)
+{
+  Global &global = get_global();
+  std::lock_guard<std::mutex> lock{global.locals_mutex};
+  return size_t(std::max<int64_t>(get_scope_total_locked(global, scope), 0));
+}
+
+size_t memory_usage_scope_peak(int scope)
+{
+  update_global_peak();
+  Global &global = get_global();
+  return global.scope_peak[scope].load(std::memory_order_relaxed);
+}
+
+int memory_scope_current(void)
+{
+  Local *local = get_local_data_safe();
+  if (UNLIKELY(local == nullptr)) {
+    return 0;
+  }
+  return get_current_scope(*local);
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Memory Scopes API
+ * \{ */
+
+void MEM_scope_push(const char *name)
+{
+  const int scope = ensure_scope(name);
+  Local *local = get_local_data_safe();
+  if (UNLIKELY(local == nullptr)) {
+    return;
+  }
+  /* Deeper nesting keeps attributing memory to the innermost scope which fits on the stack,
+   * the depth is still counted so that pushes and pops stay balanced. */
+  if (local->scope_depth < scope_stack_max) {
+    local->scope_stack[local->scope_depth] = scope;
+  }
+  local->scope_depth++;
+}
+
+void MEM_scope_pop(void)
+{
+  Local *local = get_local_data_safe();
+  if (UNLIKELY(local == nullptr)) {
+    return;
+  }
+  assert(local->scope_depth > 0);
+  local->scope_depth--;
+}
+
+int MEM_scope_num(void)
+{
+  return get_global().scope_num.load(std::memory_order_acquire);
+}
+
+const char *MEM_scope_name(int scope)
+{
+  assert(scope >= 0 && scope < MEM_scope_num());
+  return get_global().scope_names[scope];
+}
+
+/** \} */
+
+#ifdef WITH_MEM_THREAD_CACHE
+
+void *memory_cache_block_pop(size_t size)
+{
+  assert(size <= MEM_THREAD_CACHE_MAX_SIZE);
+  Local *local = get_local_data_safe();
+  if (UNLIKELY(local == nullptr)) {
+    return nullptr;
+  }
+  const size_t class_index = MEM_THREAD_CACHE_CLASS_INDEX(size);
+  CachedBlock *block = local->cache[class_index];
+  if (block == nullptr) {
+    local->cache_misses.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  local->cache[class_index] = block->next;
+  local->cache_len[class_index]--;
+  local->cache_hits.fetch_add(1, std::memory_order_relaxed);
+  local->cache_bytes.fetch_sub(int64_t(MEM_THREAD_CACHE_CLASS_SIZE(class_index)),
+                               std::memory_order_relaxed);
+  return block;
+}
+
+bool memory_cache_block_push(void *ptr, size_t size)
+{
+  assert(size <= MEM_THREAD_CACHE_MAX_SIZE);
+  Local *local = get_local_data_safe();
+  if (UNLIKELY(local == nullptr)) {
+    return false;
+  }
+  const size_t class_index = MEM_THREAD_CACHE_CLASS_INDEX(size);
+  const size_t class_size = MEM_THREAD_CACHE_CLASS_SIZE(class_index);
+  if (local->cache_len[class_index] * class_size >= cache_class_max_bytes) {
+    return false;
+  }
+  CachedBlock *block = static_cast<CachedBlock *>(ptr);
+  block->next = local->cache[class_index];
+  local->cache[class_index] = block;
+  local->cache_len[class_index]++;
+  local->cache_bytes.fetch_add(int64_t(class_size), std::memory_order_relaxed);
+  return true;
+}
+
+void memory_cache_stats(size_t *r_hits, size_t *r_misses, size_t *r_cached_bytes)
+{
+  Global &global = get_global();
+  std::lock_guard<std::mutex> lock{global.locals_mutex};
+  int64_t hits = 0, misses = 0, cached_bytes = 0;
+  for (const Local *local = global.locals_first; local; local = local->next) {
+    hits += local->cache_hits.load(std::memory_order_relaxed);
+    misses += local->cache_misses.load(std::memory_order_relaxed);
+    cached_bytes += local->cache_bytes.load(std::memory_order_relaxed);
+  }
+  *r_hits = size_t(hits);
+  *r_misses = size_t(misses);
+  *r_cached_bytes = size_t(cached_bytes);
+}
+
+#endif /* WITH_MEM_THREAD_CACHE */
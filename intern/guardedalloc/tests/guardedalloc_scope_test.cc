@@ -0,0 +1,68 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <thread>
+
+#include "BLI_utildefines.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "guardedalloc_test_base.h"
+
+namespace {
+
+int FindScope(const char *name)
+{
+  for (int scope = 0; scope < MEM_scope_num(); scope++) {
+    if (STREQ(MEM_scope_name(scope), name)) {
+      return scope;
+    }
+  }
+  return -1;
+}
+
+void DoBasicScopeChecks()
+{
+  MEM_scope_push("test outer");
+  void *outer = MEM_mallocN(1000, __func__);
+  MEM_scope_push("test inner");
+  void *inner = MEM_mallocN_aligned(2000, 16, __func__);
+  MEM_scope_pop();
+  MEM_scope_pop();
+
+  const int outer_scope = FindScope("test outer");
+  const int inner_scope = FindScope("test inner");
+  ASSERT_GT(outer_scope, 0);
+  ASSERT_GT(inner_scope, 0);
+  EXPECT_EQ(MEM_get_scope_memory_in_use(outer_scope), 1000);
+  EXPECT_EQ(MEM_get_scope_memory_in_use(inner_scope), 2000);
+
+  /* Freeing outside of the scope and on another thread still updates the scope. */
+  std::thread free_thread([&]() { MEM_freeN(inner); });
+  free_thread.join();
+  MEM_freeN(outer);
+
+  EXPECT_EQ(MEM_get_scope_memory_in_use(outer_scope), 0);
+  EXPECT_EQ(MEM_get_scope_memory_in_use(inner_scope), 0);
+
+  {
+    MEM_ScopeGuard scope("test outer");
+    void *mem = MEM_callocN(500, __func__);
+    EXPECT_EQ(MEM_get_scope_memory_in_use(outer_scope), 500);
+    MEM_freeN(mem);
+  }
+  EXPECT_EQ(MEM_get_scope_memory_in_use(outer_scope), 0);
+}
+
+}  // namespace
+
+TEST_F(LockFreeAllocatorTest, MEM_scope)
+{
+  DoBasicScopeChecks();
+}
+
+TEST_F(GuardedAllocatorTest, MEM_scope)
+{
+  DoBasicScopeChecks();
+}
@@ -0,0 +1,110 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <thread>
+#include <vector>
+
+#include "MEM_guardedalloc.h"
+
+#include "guardedalloc_test_base.h"
+
+namespace {
+
+void AllocateAndFreeSmallBlocks(const int blocks_num)
+{
+  std::vector<void *> blocks;
+  for (int i = 0; i < blocks_num; i++) {
+    blocks.push_back(MEM_mallocN(size_t(i % 300), __func__));
+  }
+  for (void *block : blocks) {
+    MEM_freeN(block);
+  }
+}
+
+/** Frees a block when the thread exits, possibly after the allocator released its thread data. */
+struct FreeOnThreadExit {
+  void *block = nullptr;
+  ~FreeOnThreadExit()
+  {
+    MEM_freeN(block);
+  }
+};
+
+}  // namespace
+
+TEST_F(LockFreeAllocatorTest, memory_usage_across_threads)
+{
+  const size_t mem_in_use = MEM_get_memory_in_use();
+  const unsigned int blocks_in_use = MEM_get_memory_blocks_in_use();
+
+  /* Blocks allocated on one thread and freed on another. */
+  std::vector<void *> blocks(64, nullptr);
+  std::thread allocate_thread([&]() {
+    for (void *&block : blocks) {
+      block = MEM_mallocN(100, __func__);
+    }
+  });
+  allocate_thread.join();
+
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), blocks_in_use + 64);
+  EXPECT_EQ(MEM_get_memory_in_use(), mem_in_use + 64 * 100);
+
+  std::thread free_thread([&]() {
+    for (void *block : blocks) {
+      MEM_freeN(block);
+    }
+  });
+  free_thread.join();
+
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), blocks_in_use);
+  EXPECT_EQ(MEM_get_memory_in_use(), mem_in_use);
+}
+
+TEST_F(LockFreeAllocatorTest, small_blocks_parallel)
+{
+  const size_t mem_in_use = MEM_get_memory_in_use();
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back(AllocateAndFreeSmallBlocks, 10000);
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(MEM_get_memory_in_use(), mem_in_use);
+}
+
+TEST_F(LockFreeAllocatorTest, free_during_thread_exit)
+{
+  const size_t mem_in_use = MEM_get_memory_in_use();
+  const unsigned int blocks_in_use = MEM_get_memory_blocks_in_use();
+
+  /* Start threads one after another, so that the thread data of exited threads is reused. */
+  for (int i = 0; i < 16; i++) {
+    std::thread thread([]() {
+      static thread_local FreeOnThreadExit free_on_exit;
+      free_on_exit.block = MEM_mallocN(100, __func__);
+    });
+    thread.join();
+  }
+
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), blocks_in_use);
+  EXPECT_EQ(MEM_get_memory_in_use(), mem_in_use);
+}
+
+TEST_F(LockFreeAllocatorTest, reused_block_calloc)
+{
+  char *mem = (char *)MEM_mallocN(40, __func__);
+  memset(mem, 0xff, 40);
+  MEM_freeN(mem);
+
+  /* Possibly gets the same block from the thread cache, which has to be cleared. */
+  mem = (char *)MEM_callocN(36, __func__);
+  EXPECT_EQ(MEM_allocN_len(mem), 36);
+  for (int i = 0; i < 36; i++) {
+    EXPECT_EQ(mem[i], 0);
+  }
+  MEM_freeN(mem);
+}
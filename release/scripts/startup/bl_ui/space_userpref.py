@@ -299,6 +299,9 @@ class USERPREF_PT_interface_statusbar(InterfacePanel, CenterAlignMixIn, Panel):
         col = layout.column(heading="Show")
         col.prop(view, "show_statusbar_stats", text="Scene Statistics")
         col.prop(view, "show_statusbar_memory", text="System Memory")
+        sub = col.column()
+        sub.active = view.show_statusbar_memory
+        sub.prop(view, "show_statusbar_memory_scopes", text="Largest Subsystem")
         col.prop(view, "show_statusbar_vram", text="Video Memory")
         col.prop(view, "show_statusbar_version", text="Blender Version")
 
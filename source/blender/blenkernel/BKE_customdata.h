@@ -591,6 +591,14 @@ typedef struct CustomDataTransferLayerMap {
 void CustomData_data_transfer(const struct MeshPairRemap *me_remap,
                               const CustomDataTransferLayerMap *laymap);
 
+/* Pool of large layer buffers, reused by evaluated meshes during depsgraph evaluation. */
+void CustomData_buffer_pool_begin(void);
+void CustomData_buffer_pool_end(void);
+void CustomData_buffer_pool_free(void);
+void *CustomData_buffer_pool_alloc(size_t size, bool clear);
+bool CustomData_buffer_pool_release(void *data);
+size_t CustomData_buffer_pool_size(void);
+
 /* .blend file I/O */
 void CustomData_blend_write_prepare(struct CustomData *data,
                                     struct CustomDataLayer **r_write_layers,
@@ -276,6 +276,7 @@ void BKE_mesh_recalc_looptri_with_normals(const struct MLoop *mloop,
 /* *** mesh_normals.cc *** */
 
 void BKE_mesh_normals_tag_dirty(struct Mesh *mesh);
+void BKE_mesh_tag_coords_changed(struct Mesh *mesh);
 void BKE_mesh_calc_normals_poly(const struct MVert *mvert,
                                 int mvert_len,
                                 const struct MLoop *mloop,
@@ -291,7 +292,18 @@ void BKE_mesh_calc_normals_poly_and_vertex(struct MVert *mvert,
                                            int mpoly_len,
                                            float (*r_poly_normals)[3],
                                            float (*r_vert_normals)[3]);
+void BKE_mesh_calc_normals_poly_and_vertex_coords(const float (*vert_coords)[3],
+                                                  int vert_coords_len,
+                                                  struct MVert *mvert,
+                                                  const struct MLoop *mloop,
+                                                  int mloop_len,
+                                                  const struct MPoly *mpolys,
+                                                  int mpoly_len,
+                                                  float (*r_poly_normals)[3],
+                                                  float (*r_vert_normals)[3]);
 void BKE_mesh_calc_normals(struct Mesh *me);
+void BKE_mesh_vert_coords_apply_and_calc_normals(struct Mesh *mesh,
+                                                 const float (*vert_coords)[3]);
 void BKE_mesh_ensure_normals(struct Mesh *me);
 void BKE_mesh_ensure_normals_for_display(struct Mesh *mesh);
 void BKE_mesh_calc_normals_looptri(struct MVert *mverts,
@@ -594,6 +606,7 @@ void BKE_mesh_calc_relative_deform(const struct MPoly *mpoly,
 
 bool BKE_mesh_validate(struct Mesh *me, const bool do_verbose, const bool cddata_check_mask);
 bool BKE_mesh_is_valid(struct Mesh *me);
+bool BKE_mesh_validate_structure(const struct Mesh *mesh);
 bool BKE_mesh_validate_material_indices(struct Mesh *me);
 
 bool BKE_mesh_validate_arrays(struct Mesh *me,
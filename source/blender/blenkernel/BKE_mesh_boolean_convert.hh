@@ -40,4 +40,17 @@ Mesh *direct_mesh_boolean(blender::Span<const Mesh *> meshes,
                           const bool hole_tolerant,
                           const int boolean_mode);
 
+/** Data kept between evaluations by #direct_mesh_boolean_cached. */
+struct DirectBooleanCache;
+
+DirectBooleanCache *direct_mesh_boolean_cache_new();
+void direct_mesh_boolean_cache_free(DirectBooleanCache *cache);
+
+Mesh *direct_mesh_boolean_cached(DirectBooleanCache *cache,
+                                 blender::Span<const Mesh *> meshes,
+                                 blender::Span<const float4x4 *> obmats,
+                                 const float4x4 &target_transform,
+                                 blender::Span<blender::Array<short>> material_remaps,
+                                 const int boolean_mode);
+
 }  // namespace blender::meshintersect
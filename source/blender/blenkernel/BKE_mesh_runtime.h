@@ -38,6 +38,7 @@ struct MLoop;
 struct MLoopTri;
 struct MVertTri;
 struct Mesh;
+struct MeshElemMap;
 struct Object;
 struct Scene;
 
@@ -52,6 +53,15 @@ bool BKE_mesh_runtime_reset_edit_data(struct Mesh *mesh);
 void BKE_mesh_runtime_clear_geometry(struct Mesh *mesh);
 void BKE_mesh_runtime_clear_cache(struct Mesh *mesh);
 
+/* NOTE: the functions below are defined in mesh_runtime_cache.cc. */
+
+const struct MeshElemMap *BKE_mesh_runtime_vert_edge_map_ensure(const struct Mesh *mesh);
+const struct MeshElemMap *BKE_mesh_runtime_vert_poly_map_ensure(const struct Mesh *mesh);
+const struct MeshElemMap *BKE_mesh_runtime_vert_loop_map_ensure(const struct Mesh *mesh);
+const struct MeshElemMap *BKE_mesh_runtime_edge_poly_map_ensure(const struct Mesh *mesh);
+const float (*BKE_mesh_runtime_poly_normals_ensure(const struct Mesh *mesh))[3];
+void BKE_mesh_runtime_derived_cache_free(struct Mesh *mesh);
+
 void BKE_mesh_runtime_verttri_from_looptri(struct MVertTri *r_verttri,
                                            const struct MLoop *mloop,
                                            const struct MLoopTri *looptri,
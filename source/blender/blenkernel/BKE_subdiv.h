@@ -92,6 +92,7 @@ typedef enum eSubdivStatsValue {
   SUBDIV_STATS_TOPOLOGY_REFINER_CREATION_TIME = 0,
   SUBDIV_STATS_SUBDIV_TO_MESH,
   SUBDIV_STATS_SUBDIV_TO_MESH_GEOMETRY,
+  SUBDIV_STATS_SUBDIV_TO_MESH_CACHED,
   SUBDIV_STATS_EVALUATOR_CREATE,
   SUBDIV_STATS_EVALUATOR_REFINE,
   SUBDIV_STATS_SUBDIV_TO_CCG,
@@ -112,6 +113,8 @@ typedef struct SubdivStats {
       double subdiv_to_mesh_time;
       /* Geometry (MVert and co) creation time during SUBDIV_TYO_MESH. */
       double subdiv_to_mesh_geometry_time;
+      /* Time spent on re-using cached topology during SUBDIV_TO_MESH. */
+      double subdiv_to_mesh_cached_time;
       /* Time spent on evaluator creation from topology refiner. */
       double evaluator_creation_time;
       /* Time spent on evaluator->refine(). */
@@ -129,6 +132,11 @@ typedef struct SubdivStats {
   /* Per-value timestamp on when corresponding BKE_subdiv_stats_begin() was
    * called. */
   double begin_timestamp_[NUM_SUBDIV_STATS_VALUES];
+
+  /* Number of BKE_subdiv_to_mesh() calls which did re-use cached topology,
+   * and which had to do a full traversal. */
+  int subdiv_to_mesh_cache_hits;
+  int subdiv_to_mesh_cache_misses;
 } SubdivStats;
 
 /* Functor which evaluates displacement at a given (u, v) of given ptex face. */
@@ -190,6 +198,9 @@ typedef struct Subdiv {
     /* Indexed by base face index, element indicates total number of ptex
      * faces created for preceding base faces. */
     int *face_ptex_offset;
+    /* Subdivided topology of the last BKE_subdiv_to_mesh() call, re-used
+     * when the coarse topology and settings did not change. */
+    struct SubdivMeshCache *mesh;
   } cache_;
 } Subdiv;
 
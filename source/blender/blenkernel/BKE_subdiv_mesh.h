@@ -49,6 +49,9 @@ struct Mesh *BKE_subdiv_to_mesh(struct Subdiv *subdiv,
                                 const SubdivToMeshSettings *settings,
                                 const struct Mesh *coarse_mesh);
 
+/* Free topology cache of BKE_subdiv_to_mesh(). */
+void BKE_subdiv_mesh_cache_free(struct Subdiv *subdiv);
+
 #ifdef __cplusplus
 }
 #endif
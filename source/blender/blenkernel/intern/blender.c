@@ -44,6 +44,7 @@
 #include "BKE_brush.h"
 #include "BKE_cachefile.h"
 #include "BKE_callbacks.h"
+#include "BKE_customdata.h"
 #include "BKE_global.h"
 #include "BKE_idprop.h"
 #include "BKE_image.h"
@@ -101,6 +102,8 @@ void BKE_blender_free(void)
   IMB_moviecache_destruct();
 
   BKE_node_system_exit();
+
+  CustomData_buffer_pool_free();
 }
 
 /** \} */
@@ -2216,6 +2216,22 @@ void CustomData_copy(const struct CustomData *source,
   CustomData_merge(source, dest, mask, alloctype, totelem);
 }
 
+/**
+ * Allocate the data array of a layer, possibly reusing a buffer from the layer buffer pool.
+ */
+static void *customData_layer_data_alloc(const int type, const int totelem, const bool clear)
+{
+  const LayerTypeInfo *typeInfo = layerType_getInfo(type);
+  void *data = CustomData_buffer_pool_alloc((size_t)totelem * typeInfo->size, clear);
+  if (data) {
+    return data;
+  }
+  if (clear) {
+    return MEM_calloc_arrayN((size_t)totelem, typeInfo->size, layerType_getName(type));
+  }
+  return MEM_malloc_arrayN((size_t)totelem, typeInfo->size, layerType_getName(type));
+}
+
 static void customData_free_layer__internal(CustomDataLayer *layer, int totelem)
 {
   const LayerTypeInfo *typeInfo;
@@ -2231,7 +2247,7 @@ static void customData_free_layer__internal(CustomDataLayer *layer, int totelem)
       typeInfo->free(layer->data, totelem, typeInfo->size);
     }
 
-    if (layer->data) {
+    if (layer->data && !CustomData_buffer_pool_release(layer->data)) {
       MEM_freeN(layer->data);
     }
   }
@@ -2548,12 +2564,8 @@ static CustomDataLayer *customData_add_layer__internal(CustomData *data,
     newlayerdata = layerdata;
   }
   else if (totelem > 0 && typeInfo->size > 0) {
-    if (alloctype == CD_DUPLICATE && layerdata) {
-      newlayerdata = MEM_malloc_arrayN((size_t)totelem, typeInfo->size, layerType_getName(type));
-    }
-    else {
-      newlayerdata = MEM_calloc_arrayN((size_t)totelem, typeInfo->size, layerType_getName(type));
-    }
+    newlayerdata = customData_layer_data_alloc(
+        type, totelem, !(alloctype == CD_DUPLICATE && layerdata));
 
     if (!newlayerdata) {
       return NULL;
@@ -2806,13 +2818,19 @@ static void *customData_duplicate_referenced_layer_index(CustomData *data,
     const LayerTypeInfo *typeInfo = layerType_getInfo(layer->type);
 
     if (typeInfo->copy) {
-      void *dst_data = MEM_malloc_arrayN(
-          (size_t)totelem, typeInfo->size, "CD duplicate ref layer");
+      void *dst_data = customData_layer_data_alloc(layer->type, totelem, false);
       typeInfo->copy(layer->data, dst_data, totelem);
       layer->data = dst_data;
     }
     else {
-      layer->data = MEM_dupallocN(layer->data);
+      void *dst_data = CustomData_buffer_pool_alloc(MEM_allocN_len(layer->data), false);
+      if (dst_data) {
+        memcpy(dst_data, layer->data, MEM_allocN_len(layer->data));
+        layer->data = dst_data;
+      }
+      else {
+        layer->data = MEM_dupallocN(layer->data);
+      }
     }
 
     layer->flag &= ~CD_FLAG_NOFREE;
@@ -0,0 +1,237 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup bke
+ *
+ * Pool of large custom data layer buffers.
+ *
+ * Evaluated meshes are created and freed by every modifier and on every frame, which means
+ * allocating and freeing the same large layer arrays over and over again. For big meshes this
+ * results in lots of page faults, since the system allocator returns such buffers to the
+ * operating system. While the pool is active, freed layer buffers are kept and handed out again
+ * to allocations of the same size.
+ *
+ * Buffers which were not reused since the previous evaluation are freed at the end of every
+ * evaluation, so the pool only holds on to memory of meshes which are re-evaluated. The pool is
+ * also trimmed to the size of the pooled buffers allocated during the evaluation, which is what
+ * the next evaluation of the same data needs. This way freeing data which is not re-evaluated,
+ * like a deleted object, does not leave its buffers resident while idle.
+ */
+
+#include <climits>
+#include <cstring>
+#include <mutex>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_map.hh"
+#include "BLI_vector.hh"
+
+#include "BKE_customdata.h"
+
+namespace blender::bke {
+
+/** Smaller buffers are cheap to allocate and are not pooled. */
+static constexpr int64_t pool_min_buffer_size = 64 * 1024;
+/** Upper limit of the memory held by freed buffers in the pool. */
+static constexpr int64_t pool_max_size = int64_t(256) * 1024 * 1024;
+
+struct PooledBuffer {
+  void *data;
+  /** Evaluation during which the buffer was added to the pool. */
+  int generation;
+};
+
+struct CustomDataBufferPool {
+  /** Freed buffers, by their size in bytes as reported by #MEM_allocN_len. */
+  Map<int64_t, Vector<PooledBuffer>> buffers;
+  int64_t pooled_size = 0;
+  /** Size of the buffers of poolable size allocated since the evaluations started. */
+  int64_t allocated_size = 0;
+  /** Number of evaluations which are using the pool at the same time. */
+  int users = 0;
+  int generation = 0;
+
+  MEM_CXX_CLASS_ALLOC_FUNCS("CustomDataBufferPool")
+};
+
+static std::mutex pool_mutex;
+/* Created when the pool is first used, freed by #CustomData_buffer_pool_free. */
+static CustomDataBufferPool *pool = nullptr;
+
+/** Size of a buffer as returned by #MEM_allocN_len, which rounds up to multiples of 4. */
+static int64_t pool_buffer_size(const size_t size)
+{
+  return int64_t((size + 3) & ~size_t(3));
+}
+
+/** Free buffers which were added before the given generation, the caller must hold the lock. */
+static void pool_free_older_than(const int generation)
+{
+  Vector<int64_t> unused_sizes;
+  for (auto item : pool->buffers.items()) {
+    Vector<PooledBuffer> &buffers = item.value;
+    int64_t i = 0;
+    while (i < buffers.size()) {
+      if (buffers[i].generation < generation) {
+        MEM_freeN(buffers[i].data);
+        pool->pooled_size -= item.key;
+        buffers.remove_and_reorder(i);
+      }
+      else {
+        i++;
+      }
+    }
+    if (buffers.is_empty()) {
+      unused_sizes.append(item.key);
+    }
+  }
+  for (const int64_t size : unused_sizes) {
+    pool->buffers.remove_contained(size);
+  }
+}
+
+/** Free buffers until the pool holds at most the given size, the caller must hold the lock. */
+static void pool_trim(const int64_t max_size)
+{
+  Vector<int64_t> unused_sizes;
+  for (auto item : pool->buffers.items()) {
+    Vector<PooledBuffer> &buffers = item.value;
+    while (pool->pooled_size > max_size && !buffers.is_empty()) {
+      MEM_freeN(buffers.pop_last().data);
+      pool->pooled_size -= item.key;
+    }
+    if (buffers.is_empty()) {
+      unused_sizes.append(item.key);
+    }
+  }
+  for (const int64_t size : unused_sizes) {
+    pool->buffers.remove_contained(size);
+  }
+}
+
+}  // namespace blender::bke
+
+using namespace blender;
+using namespace blender::bke;
+
+/**
+ * Start using the pool for layer buffers, for the duration of a depsgraph evaluation.
+ * Calls can overlap when multiple depsgraphs are evaluated at the same time.
+ */
+void CustomData_buffer_pool_begin(void)
+{
+  std::lock_guard lock{pool_mutex};
+  if (pool == nullptr) {
+    pool = new CustomDataBufferPool();
+  }
+  if (pool->users == 0) {
+    pool->generation++;
+    pool->allocated_size = 0;
+  }
+  pool->users++;
+}
+
+/**
+ * Stop using the pool. Buffers which were added during the previous evaluation and not reused
+ * since are freed, and the remaining ones are limited to the size allocated by this evaluation.
+ */
+void CustomData_buffer_pool_end(void)
+{
+  std::lock_guard lock{pool_mutex};
+  BLI_assert(pool != nullptr && pool->users > 0);
+  pool->users--;
+  if (pool->users == 0) {
+    pool_free_older_than(pool->generation);
+    pool_trim(pool->allocated_size);
+  }
+}
+
+/** Free all buffers held by the pool, the pool must not be in use. */
+void CustomData_buffer_pool_free(void)
+{
+  std::lock_guard lock{pool_mutex};
+  if (pool == nullptr) {
+    return;
+  }
+  BLI_assert(pool->users == 0);
+  pool_free_older_than(INT_MAX);
+  delete pool;
+  pool = nullptr;
+}
+
+/**
+ * Get a buffer of the given size from the pool.
+ * \return null when there is no buffer of that size, the caller has to allocate one then.
+ */
+void *CustomData_buffer_pool_alloc(size_t size, bool clear)
+{
+  const int64_t buffer_size = pool_buffer_size(size);
+  if (buffer_size < pool_min_buffer_size) {
+    return nullptr;
+  }
+
+  void *data;
+  {
+    std::lock_guard lock{pool_mutex};
+    if (pool == nullptr || pool->users == 0) {
+      return nullptr;
+    }
+    pool->allocated_size += buffer_size;
+    Vector<PooledBuffer> *buffers = pool->buffers.lookup_ptr(buffer_size);
+    if (buffers == nullptr || buffers->is_empty()) {
+      return nullptr;
+    }
+    data = buffers->pop_last().data;
+    pool->pooled_size -= buffer_size;
+  }
+
+  if (clear) {
+    memset(data, 0, size);
+  }
+  return data;
+}
+
+/**
+ * Give a freed layer buffer to the pool.
+ * \return false when the buffer is not taken by the pool, the caller has to free it then.
+ */
+bool CustomData_buffer_pool_release(void *data)
+{
+  const int64_t buffer_size = int64_t(MEM_allocN_len(data));
+  if (buffer_size < pool_min_buffer_size) {
+    return false;
+  }
+
+  std::lock_guard lock{pool_mutex};
+  if (pool == nullptr || pool->users == 0) {
+    return false;
+  }
+  if (pool->pooled_size + buffer_size > pool_max_size) {
+    return false;
+  }
+  pool->buffers.lookup_or_add_default(buffer_size).append({data, pool->generation});
+  pool->pooled_size += buffer_size;
+  return true;
+}
+
+/** Memory held by freed buffers in the pool, in bytes. */
+size_t CustomData_buffer_pool_size(void)
+{
+  std::lock_guard lock{pool_mutex};
+  return pool ? size_t(pool->pooled_size) : 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BKE_customdata.h"
+
+#include "DNA_customdata_types.h"
+#include "DNA_meshdata_types.h"
+
+namespace blender::bke::tests {
+
+static constexpr int verts_num = 100000;
+
+static void add_and_free_layer(CustomData *data, const eCDAllocType alloctype)
+{
+  CustomData_add_layer(data, CD_MVERT, alloctype, nullptr, verts_num);
+  CustomData_free(data, verts_num);
+}
+
+TEST(customdata_pool, reuse_between_evaluations)
+{
+  CustomData data;
+  CustomData_reset(&data);
+
+  /* Nothing is pooled outside of evaluation. */
+  add_and_free_layer(&data, CD_CALLOC);
+  EXPECT_EQ(CustomData_buffer_pool_size(), 0);
+
+  CustomData_buffer_pool_begin();
+  CustomData_add_layer(&data, CD_MVERT, CD_CALLOC, nullptr, verts_num);
+  const void *layer_data = CustomData_get_layer(&data, CD_MVERT);
+  CustomData_free(&data, verts_num);
+  EXPECT_EQ(CustomData_buffer_pool_size(), sizeof(MVert) * verts_num);
+
+  /* The buffer is reused, and cleared again. */
+  CustomData_add_layer(&data, CD_MVERT, CD_CALLOC, nullptr, verts_num);
+  const MVert *verts = static_cast<const MVert *>(CustomData_get_layer(&data, CD_MVERT));
+  EXPECT_EQ(verts, layer_data);
+  EXPECT_EQ(CustomData_buffer_pool_size(), 0);
+  EXPECT_EQ(verts[verts_num - 1].co[0], 0.0f);
+  CustomData_free(&data, verts_num);
+  CustomData_buffer_pool_end();
+
+  /* Buffers freed during the last evaluation are kept for the next one. */
+  EXPECT_EQ(CustomData_buffer_pool_size(), sizeof(MVert) * verts_num);
+
+  /* Buffers not reused in the following evaluation are freed. */
+  CustomData_buffer_pool_begin();
+  CustomData_buffer_pool_end();
+  EXPECT_EQ(CustomData_buffer_pool_size(), 0);
+
+  CustomData_buffer_pool_free();
+}
+
+TEST(customdata_pool, trim_to_evaluated_size)
+{
+  CustomData data;
+  CustomData_reset(&data);
+
+  /* Data allocated outside of evaluation and freed during it, like a deleted object. */
+  CustomData_add_layer(&data, CD_MVERT, CD_CALLOC, nullptr, verts_num);
+
+  CustomData_buffer_pool_begin();
+  CustomData_free(&data, verts_num);
+  EXPECT_EQ(CustomData_buffer_pool_size(), sizeof(MVert) * verts_num);
+  CustomData_buffer_pool_end();
+
+  /* Nothing of that size was allocated by the evaluation, so the buffer is not kept. */
+  EXPECT_EQ(CustomData_buffer_pool_size(), 0);
+
+  CustomData_buffer_pool_free();
+}
+
+TEST(customdata_pool, small_buffers_not_pooled)
+{
+  CustomData data;
+  CustomData_reset(&data);
+
+  CustomData_buffer_pool_begin();
+  CustomData_add_layer(&data, CD_MVERT, CD_CALLOC, nullptr, 10);
+  CustomData_free(&data, 10);
+  EXPECT_EQ(CustomData_buffer_pool_size(), 0);
+  CustomData_buffer_pool_end();
+
+  CustomData_buffer_pool_free();
+}
+
+}  // namespace blender::bke::tests
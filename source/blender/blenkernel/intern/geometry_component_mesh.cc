@@ -26,6 +26,7 @@
 #include "BKE_geometry_set.hh"
 #include "BKE_lib_id.h"
 #include "BKE_mesh.h"
+#include "BKE_mesh_runtime.h"
 
 #include "attribute_access_intern.hh"
 
@@ -1188,12 +1189,9 @@ class NormalAttributeProvider final : public BuiltinAttributeProvider {
           Span<float3>((const float3 *)data, mesh->totpoly));
     }
 
-    Array<float3> normals(mesh->totpoly);
-    for (const int i : IndexRange(mesh->totpoly)) {
-      const MPoly *poly = &mesh->mpoly[i];
-      BKE_mesh_calc_poly_normal(poly, &mesh->mloop[poly->loopstart], mesh->mvert, normals[i]);
-    }
-
+    /* Normals cached in the mesh are freed when it changes, so the virtual array gets a copy. */
+    const float(*poly_normals)[3] = BKE_mesh_runtime_poly_normals_ensure(mesh);
+    Array<float3> normals(Span<float3>((const float3 *)poly_normals, mesh->totpoly));
     return std::make_unique<fn::GVArray_For_ArrayContainer<Array<float3>>>(std::move(normals));
   }
 
@@ -5228,9 +5228,11 @@ ImBuf *BKE_image_acquire_ibuf(Image *ima, ImageUser *iuser, void **r_lock)
   ImBuf *ibuf;
 
   BLI_mutex_lock(image_mutex);
+  MEM_scope_push("Image Cache");
 
   ibuf = image_acquire_ibuf(ima, iuser, r_lock);
 
+  MEM_scope_pop();
   BLI_mutex_unlock(image_mutex);
 
   return ibuf;
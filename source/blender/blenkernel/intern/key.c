@@ -2241,6 +2241,7 @@ void BKE_keyblock_convert_to_mesh(KeyBlock *kb, Mesh *me)
   for (a = 0; a < tot; a++, fp++, mvert++) {
     copy_v3_v3(mvert->co, *fp);
   }
+  BKE_mesh_tag_coords_changed(me);
 }
 
 /**
@@ -1612,6 +1612,7 @@ void BKE_mesh_transform(Mesh *me, const float mat[4][4], bool do_keys)
   for (i = 0; i < me->totvert; i++, mvert++) {
     mul_m4_v3(mat, mvert->co);
   }
+  BKE_mesh_tag_coords_changed(me);
 
   if (do_keys && me->key) {
     KeyBlock *kb;
@@ -1647,6 +1648,7 @@ void BKE_mesh_translate(Mesh *me, const float offset[3], const bool do_keys)
   for (MVert *mvert = me->mvert; i--; mvert++) {
     add_v3_v3(mvert->co, offset);
   }
+  BKE_mesh_tag_coords_changed(me);
 
   if (do_keys && me->key) {
     KeyBlock *kb;
@@ -21,6 +21,10 @@
  * \ingroup bke
  */
 
+#include <memory>
+
+#include "MEM_guardedalloc.h"
+
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
@@ -245,11 +249,14 @@ const MEdge *MeshesToIMeshInfo::input_medge_for_orig_index(int orig_index,
  * The `*r_info class` is filled in with information needed to make the
  * correspondence between the Mesh MVerts/MPolys and the IMesh Verts/Faces.
  * All allocation of memory for the IMesh comes from `arena`.
+ * With `skip_first_mesh`, no Verts and Faces are made for the first Mesh, because the caller
+ * already has them, and the returned IMesh only contains the Faces of the other Meshes.
  */
 static IMesh meshes_to_imesh(Span<const Mesh *> meshes,
                              Span<const float4x4 *> obmats,
                              Span<Array<short>> material_remaps,
                              const float4x4 &target_transform,
+                             const bool skip_first_mesh,
                              IMeshArena &arena,
                              MeshesToIMeshInfo *r_info)
 {
@@ -270,8 +277,10 @@ static IMesh meshes_to_imesh(Span<const Mesh *> meshes,
   /* Estimate the number of vertices and faces in the boolean output,
    * so that the memory arena can reserve some space. It is OK if these
    * estimates are wrong. */
-  const int estimate_num_outv = 3 * totvert;
-  const int estimate_num_outf = 4 * totpoly;
+  const int skip_totvert = skip_first_mesh ? meshes[0]->totvert : 0;
+  const int skip_totpoly = skip_first_mesh ? meshes[0]->totpoly : 0;
+  const int estimate_num_outv = 3 * (totvert - skip_totvert);
+  const int estimate_num_outf = 4 * (totpoly - skip_totpoly);
   arena.reserve(estimate_num_outv, estimate_num_outf);
   r_info->mesh_to_imesh_vert = Array<const Vert *>(totvert);
   r_info->mesh_to_imesh_face = Array<Face *>(totpoly);
@@ -319,6 +328,13 @@ static IMesh meshes_to_imesh(Span<const Mesh *> meshes,
      * that would have a negative transform if you do that. */
     bool need_face_flip = r_info->has_negative_transform[mi] != r_info->has_negative_transform[0];
 
+    if (mi == 0 && skip_first_mesh) {
+      v += me->totvert;
+      e += me->totedge;
+      f += me->totpoly;
+      continue;
+    }
+
     Vector<Vert *> verts(me->totvert);
     Span<MVert> mverts = Span(me->mvert, me->totvert);
 
@@ -377,7 +393,7 @@ static IMesh meshes_to_imesh(Span<const Mesh *> meshes,
     }
     e += me->totedge;
   }
-  return IMesh(r_info->mesh_to_imesh_face);
+  return IMesh(r_info->mesh_to_imesh_face.as_span().drop_front(skip_totpoly));
 }
 
 /* Copy vertex attributes, including customdata, from `orig_mv` to `mv`.
@@ -838,7 +854,8 @@ Mesh *direct_mesh_boolean(Span<const Mesh *> meshes,
   }
   MeshesToIMeshInfo mim;
   IMeshArena arena;
-  IMesh m_in = meshes_to_imesh(meshes, obmats, material_remaps, target_transform, arena, &mim);
+  IMesh m_in = meshes_to_imesh(
+      meshes, obmats, material_remaps, target_transform, false, arena, &mim);
   std::function<int(int)> shape_fn = [&mim](int f) {
     for (int mi = 0; mi < mim.mesh_poly_offset.size() - 1; ++mi) {
       if (f < mim.mesh_poly_offset[mi + 1]) {
@@ -868,4 +885,127 @@ Mesh *direct_mesh_boolean(Span<const Mesh *> meshes,
 #endif  // WITH_GMP
 }
 
+struct DirectBooleanCache {
+#ifdef WITH_GMP
+  /* Everything that goes into the #IMesh of the first mesh for which the cached data was made:
+   * its transformation to the target space, vertex positions, loops and polygons. */
+  float4x4 transform;
+  Array<float3> positions;
+  Array<MLoop> loops;
+  Array<MPoly> polys;
+  /* Owns the Verts and Faces of the first mesh, which stay unchanged between operations. */
+  std::unique_ptr<IMeshArena> arena;
+  std::unique_ptr<BooleanBaseCache> base;
+#endif
+
+  MEM_CXX_CLASS_ALLOC_FUNCS("DirectBooleanCache")
+};
+
+DirectBooleanCache *direct_mesh_boolean_cache_new()
+{
+  return new DirectBooleanCache();
+}
+
+void direct_mesh_boolean_cache_free(DirectBooleanCache *cache)
+{
+  delete cache;
+}
+
+#ifdef WITH_GMP
+
+/* Whether the cached data was made for `me` with `to_target` as its transformation to the target
+ * space. The mesh is compared exactly, so the cache is never used for a different mesh. */
+static bool boolean_cache_matches(const DirectBooleanCache &cache,
+                                  const Mesh *me,
+                                  const float4x4 &to_target)
+{
+  if (!cache.base || cache.positions.size() != me->totvert ||
+      cache.loops.size() != me->totloop || cache.polys.size() != me->totpoly) {
+    return false;
+  }
+  if (memcmp(cache.transform.values, to_target.values, sizeof(to_target.values)) != 0) {
+    return false;
+  }
+  for (const int i : IndexRange(me->totvert)) {
+    if (cache.positions[i] != float3(me->mvert[i].co)) {
+      return false;
+    }
+  }
+  for (const int i : IndexRange(me->totloop)) {
+    if (cache.loops[i].v != me->mloop[i].v) {
+      return false;
+    }
+  }
+  for (const int i : IndexRange(me->totpoly)) {
+    if (cache.polys[i].loopstart != me->mpoly[i].loopstart ||
+        cache.polys[i].totloop != me->mpoly[i].totloop) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void boolean_cache_store_key(DirectBooleanCache &cache,
+                                    const Mesh *me,
+                                    const float4x4 &to_target)
+{
+  cache.transform = to_target;
+  cache.positions.reinitialize(me->totvert);
+  for (const int i : IndexRange(me->totvert)) {
+    cache.positions[i] = float3(me->mvert[i].co);
+  }
+  cache.loops = Array<MLoop>(Span(me->mloop, me->totloop));
+  cache.polys = Array<MPoly>(Span(me->mpoly, me->totpoly));
+}
+
+#endif  // WITH_GMP
+
+/**
+ * Like #direct_mesh_boolean with two meshes and without self intersection, but keep the data
+ * made for the first mesh in `cache`, to reuse it when only the second mesh or its transform
+ * changes. Only the part of the first mesh close to the second one is intersected again then,
+ * see #boolean_mesh_local.
+ */
+Mesh *direct_mesh_boolean_cached(DirectBooleanCache *cache,
+                                 Span<const Mesh *> meshes,
+                                 Span<const float4x4 *> obmats,
+                                 const float4x4 &target_transform,
+                                 Span<Array<short>> material_remaps,
+                                 const int boolean_mode)
+{
+#ifdef WITH_GMP
+  BLI_assert(meshes.size() == 2 && obmats.size() == 2);
+  const Mesh *base_mesh = meshes[0];
+  const float4x4 base_transform = clean_obmat(target_transform).inverted() *
+                                  ((obmats[0] == nullptr) ? float4x4::identity() :
+                                                            clean_obmat(*obmats[0]));
+  if (!boolean_cache_matches(*cache, base_mesh, base_transform)) {
+    cache->base.reset();
+    cache->arena = std::make_unique<IMeshArena>();
+    MeshesToIMeshInfo base_mim;
+    IMesh m_base = meshes_to_imesh(meshes.take_front(1),
+                                   obmats.take_front(1),
+                                   material_remaps.is_empty() ? material_remaps :
+                                                                material_remaps.take_front(1),
+                                   target_transform,
+                                   false,
+                                   *cache->arena,
+                                   &base_mim);
+    cache->base = std::make_unique<BooleanBaseCache>(std::move(m_base), cache->arena.get());
+    boolean_cache_store_key(*cache, base_mesh, base_transform);
+  }
+
+  MeshesToIMeshInfo mim;
+  IMeshArena arena(cache->arena.get());
+  IMesh m_operand = meshes_to_imesh(
+      meshes, obmats, material_remaps, target_transform, true, arena, &mim);
+  IMesh m_out = boolean_mesh_local(
+      *cache->base, m_operand, static_cast<BoolOpType>(boolean_mode), &arena);
+  return imesh_to_mesh(&m_out, mim);
+#else   // WITH_GMP
+  UNUSED_VARS(cache, meshes, obmats, material_remaps, target_transform, boolean_mode);
+  return nullptr;
+#endif  // WITH_GMP
+}
+
 }  // namespace blender::meshintersect
@@ -35,8 +35,14 @@
 #include "BKE_mesh_mapping.h"
 #include "BLI_memarena.h"
 
+#include "BLI_array.hh"
+#include "BLI_span.hh"
+#include "BLI_task.hh"
+
 #include "BLI_strict_flags.h"
 
+using namespace blender;
+
 /* -------------------------------------------------------------------- */
 /** \name Mesh Connectivity Mapping
  * \{ */
@@ -81,7 +87,7 @@ UvVertMap *BKE_mesh_uv_vert_map_create(const MPoly *mpoly,
   buf = vmap->buf = (UvMapVert *)MEM_callocN(sizeof(*vmap->buf) * (size_t)totuv, "UvMapVert");
   vmap->vert = (UvMapVert **)MEM_callocN(sizeof(*vmap->vert) * totvert, "UvMapVert*");
   if (use_winding) {
-    winding = MEM_callocN(sizeof(*winding) * totpoly, "winding");
+    winding = (bool *)MEM_callocN(sizeof(*winding) * totpoly, "winding");
   }
 
   if (!vmap->vert || !vmap->buf) {
@@ -194,6 +200,59 @@ void BKE_mesh_uv_vert_map_free(UvVertMap *vmap)
   }
 }
 
+/* Grain size for building the maps, the work per element is small. */
+static constexpr int64_t map_grain_size = 4096;
+
+/**
+ * Fill the map from the offsets of the groups in \a indices, as created by
+ * #threading::parallel_group_by.
+ */
+static void mesh_elem_map_from_offsets(MeshElemMap *map, int *indices, Span<int> offsets)
+{
+  threading::parallel_for(IndexRange(offsets.size() - 1), map_grain_size, [&](IndexRange range) {
+    for (const int64_t i : range) {
+      map[i].indices = indices + offsets[i];
+      map[i].count = offsets[i + 1] - offsets[i];
+    }
+  });
+}
+
+/**
+ * Create an array with the index of the poly of every loop. Loops which are not used by any poly,
+ * which is only the case in invalid meshes, get -1.
+ */
+static Array<int> mesh_loop_to_poly_map(const MPoly *mpoly, const int totpoly, const int totloop)
+{
+  Array<int> loop_to_poly(totloop, -1);
+  threading::parallel_for(IndexRange(totpoly), map_grain_size, [&](IndexRange range) {
+    for (const int64_t i : range) {
+      const MPoly *mp = &mpoly[i];
+      for (const int64_t loop : IndexRange(mp->loopstart, mp->totloop)) {
+        loop_to_poly[loop] = int(i);
+      }
+    }
+  });
+  return loop_to_poly;
+}
+
+/**
+ * Group the loops with #threading::parallel_group_by, where \a r_offsets has one more group than
+ * \a group_fn returns. Loops which are not used by a poly are put in that last group, so they are
+ * skipped when only the first groups are used, like the serial code iterating over the polys.
+ */
+template<typename GroupFn>
+static void mesh_poly_loops_group_by(Span<int> loop_to_poly,
+                                     MutableSpan<int> r_offsets,
+                                     MutableSpan<int> r_indices,
+                                     const GroupFn &group_fn)
+{
+  const int unused_group = int(r_offsets.size()) - 2;
+  threading::parallel_group_by(
+      loop_to_poly.size(), map_grain_size, r_offsets, r_indices, [&](const int64_t loop) {
+        return loop_to_poly[loop] == -1 ? unused_group : group_fn(loop);
+      });
+}
+
 /**
  * Generates a map where the key is the vertex and the value is a list
  * of polys or loops that use that vertex as a corner. The lists are allocated
@@ -210,41 +269,26 @@ static void mesh_vert_poly_or_loop_map_create(MeshElemMap **r_map,
                                               int totloop,
                                               const bool do_loops)
 {
-  MeshElemMap *map = MEM_callocN(sizeof(MeshElemMap) * (size_t)totvert, __func__);
-  int *indices, *index_iter;
-  int i, j;
-
-  indices = index_iter = MEM_mallocN(sizeof(int) * (size_t)totloop, __func__);
-
-  /* Count number of polys for each vertex */
-  for (i = 0; i < totpoly; i++) {
-    const MPoly *p = &mpoly[i];
-
-    for (j = 0; j < p->totloop; j++) {
-      map[mloop[p->loopstart + j].v].count++;
-    }
-  }
-
-  /* Assign indices mem */
-  for (i = 0; i < totvert; i++) {
-    map[i].indices = index_iter;
-    index_iter += map[i].count;
-
-    /* Reset 'count' for use as index in last loop */
-    map[i].count = 0;
+  MeshElemMap *map = (MeshElemMap *)MEM_malloc_arrayN(
+      (size_t)totvert, sizeof(MeshElemMap), __func__);
+  int *indices = (int *)MEM_malloc_arrayN((size_t)totloop, sizeof(int), __func__);
+
+  /* Group the loops by vertex, then replace them by their poly if needed. */
+  const Array<int> loop_to_poly = mesh_loop_to_poly_map(mpoly, totpoly, totloop);
+  Array<int> offsets(totvert + 2);
+  mesh_poly_loops_group_by(loop_to_poly, offsets, {indices, totloop}, [&](const int64_t loop) {
+    return int(mloop[loop].v);
+  });
+
+  if (!do_loops) {
+    threading::parallel_for(IndexRange(offsets[totvert]), map_grain_size, [&](IndexRange range) {
+      for (const int64_t i : range) {
+        indices[i] = loop_to_poly[indices[i]];
+      }
+    });
   }
 
-  /* Find the users */
-  for (i = 0; i < totpoly; i++) {
-    const MPoly *p = &mpoly[i];
-
-    for (j = 0; j < p->totloop; j++) {
-      uint v = mloop[p->loopstart + j].v;
-
-      map[v].indices[map[v].count] = do_loops ? p->loopstart + j : i;
-      map[v].count++;
-    }
-  }
+  mesh_elem_map_from_offsets(map, indices, offsets.as_span().drop_back(1));
 
   *r_map = map;
   *r_mem = indices;
@@ -296,41 +340,49 @@ void BKE_mesh_vert_looptri_map_create(MeshElemMap **r_map,
                                       const MLoop *mloop,
                                       const int UNUSED(totloop))
 {
-  MeshElemMap *map = MEM_callocN(sizeof(MeshElemMap) * (size_t)totvert, __func__);
-  int *indices = MEM_mallocN(sizeof(int) * (size_t)totlooptri * 3, __func__);
-  int *index_step;
-  const MLoopTri *mlt;
-  int i;
-
-  /* count face users */
-  for (i = 0, mlt = mlooptri; i < totlooptri; mlt++, i++) {
-    for (int j = 3; j--;) {
-      map[mloop[mlt->tri[j]].v].count++;
-    }
-  }
-
-  /* create offsets */
-  index_step = indices;
-  for (i = 0; i < totvert; i++) {
-    map[i].indices = index_step;
-    index_step += map[i].count;
-
-    /* re-count, using this as an index below */
-    map[i].count = 0;
-  }
+  MeshElemMap *map = (MeshElemMap *)MEM_malloc_arrayN(
+      (size_t)totvert, sizeof(MeshElemMap), __func__);
+  int *indices = (int *)MEM_malloc_arrayN((size_t)totlooptri * 3, sizeof(int), __func__);
+
+  /* Group the corners of the triangles by vertex, then replace them by their triangle. */
+  Array<int> offsets(totvert + 1);
+  threading::parallel_group_by(
+      int64_t(totlooptri) * 3,
+      map_grain_size,
+      offsets,
+      {indices, int64_t(totlooptri) * 3},
+      [&](const int64_t corner) { return int(mloop[mlooptri[corner / 3].tri[corner % 3]].v); });
+
+  threading::parallel_for(
+      IndexRange(int64_t(totlooptri) * 3), map_grain_size, [&](IndexRange range) {
+        for (const int64_t i : range) {
+          indices[i] /= 3;
+        }
+      });
 
-  /* assign looptri-edge users */
-  for (i = 0, mlt = mlooptri; i < totlooptri; mlt++, i++) {
-    for (int j = 3; j--;) {
-      MeshElemMap *map_ele = &map[mloop[mlt->tri[j]].v];
-      map_ele->indices[map_ele->count++] = i;
-    }
-  }
+  mesh_elem_map_from_offsets(map, indices, offsets);
 
   *r_map = map;
   *r_mem = indices;
 }
 
+/**
+ * Group both ends of the edges by vertex. The resulting indices are `edge * 2` for the first
+ * vertex of an edge and `edge * 2 + 1` for the second one.
+ */
+static void mesh_vert_edge_ends_group(
+    const MEdge *medge, int totvert, int totedge, int *indices, MutableSpan<int> offsets)
+{
+  BLI_assert(offsets.size() == totvert + 1);
+  UNUSED_VARS_NDEBUG(totvert);
+  threading::parallel_group_by(
+      int64_t(totedge) * 2,
+      map_grain_size,
+      offsets,
+      {indices, int64_t(totedge) * 2},
+      [&](const int64_t end) { return int((end & 1) ? medge[end >> 1].v2 : medge[end >> 1].v1); });
+}
+
 /**
  * Generates a map where the key is the vertex and the value
  * is a list of edges that use that vertex as an endpoint.
@@ -339,37 +391,20 @@ void BKE_mesh_vert_looptri_map_create(MeshElemMap **r_map,
 void BKE_mesh_vert_edge_map_create(
     MeshElemMap **r_map, int **r_mem, const MEdge *medge, int totvert, int totedge)
 {
-  MeshElemMap *map = MEM_callocN(sizeof(MeshElemMap) * (size_t)totvert, "vert-edge map");
-  int *indices = MEM_mallocN(sizeof(int[2]) * (size_t)totedge, "vert-edge map mem");
-  int *i_pt = indices;
+  MeshElemMap *map = (MeshElemMap *)MEM_malloc_arrayN(
+      (size_t)totvert, sizeof(MeshElemMap), "vert-edge map");
+  int *indices = (int *)MEM_malloc_arrayN((size_t)totedge, sizeof(int[2]), "vert-edge map mem");
 
-  int i;
-
-  /* Count number of edges for each vertex */
-  for (i = 0; i < totedge; i++) {
-    map[medge[i].v1].count++;
-    map[medge[i].v2].count++;
-  }
-
-  /* Assign indices mem */
-  for (i = 0; i < totvert; i++) {
-    map[i].indices = i_pt;
-    i_pt += map[i].count;
-
-    /* Reset 'count' for use as index in last loop */
-    map[i].count = 0;
-  }
-
-  /* Find the users */
-  for (i = 0; i < totedge; i++) {
-    const uint v[2] = {medge[i].v1, medge[i].v2};
+  Array<int> offsets(totvert + 1);
+  mesh_vert_edge_ends_group(medge, totvert, totedge, indices, offsets);
 
-    map[v[0]].indices[map[v[0]].count] = i;
-    map[v[1]].indices[map[v[1]].count] = i;
+  threading::parallel_for(IndexRange(int64_t(totedge) * 2), map_grain_size, [&](IndexRange range) {
+    for (const int64_t i : range) {
+      indices[i] >>= 1;
+    }
+  });
 
-    map[v[0]].count++;
-    map[v[1]].count++;
-  }
+  mesh_elem_map_from_offsets(map, indices, offsets);
 
   *r_map = map;
   *r_mem = indices;
@@ -382,37 +417,22 @@ void BKE_mesh_vert_edge_map_create(
 void BKE_mesh_vert_edge_vert_map_create(
     MeshElemMap **r_map, int **r_mem, const MEdge *medge, int totvert, int totedge)
 {
-  MeshElemMap *map = MEM_callocN(sizeof(MeshElemMap) * (size_t)totvert, "vert-edge map");
-  int *indices = MEM_mallocN(sizeof(int[2]) * (size_t)totedge, "vert-edge map mem");
-  int *i_pt = indices;
-
-  int i;
-
-  /* Count number of edges for each vertex */
-  for (i = 0; i < totedge; i++) {
-    map[medge[i].v1].count++;
-    map[medge[i].v2].count++;
-  }
-
-  /* Assign indices mem */
-  for (i = 0; i < totvert; i++) {
-    map[i].indices = i_pt;
-    i_pt += map[i].count;
-
-    /* Reset 'count' for use as index in last loop */
-    map[i].count = 0;
-  }
-
-  /* Find the users */
-  for (i = 0; i < totedge; i++) {
-    const uint v[2] = {medge[i].v1, medge[i].v2};
-
-    map[v[0]].indices[map[v[0]].count] = (int)v[1];
-    map[v[1]].indices[map[v[1]].count] = (int)v[0];
+  MeshElemMap *map = (MeshElemMap *)MEM_malloc_arrayN(
+      (size_t)totvert, sizeof(MeshElemMap), "vert-edge map");
+  int *indices = (int *)MEM_malloc_arrayN((size_t)totedge, sizeof(int[2]), "vert-edge map mem");
+
+  Array<int> offsets(totvert + 1);
+  mesh_vert_edge_ends_group(medge, totvert, totedge, indices, offsets);
+
+  /* Replace every end of an edge by the vertex at the other end. */
+  threading::parallel_for(IndexRange(int64_t(totedge) * 2), map_grain_size, [&](IndexRange range) {
+    for (const int64_t i : range) {
+      const MEdge *edge = &medge[indices[i] >> 1];
+      indices[i] = int((indices[i] & 1) ? edge->v1 : edge->v2);
+    }
+  });
 
-    map[v[0]].count++;
-    map[v[1]].count++;
-  }
+  mesh_elem_map_from_offsets(map, indices, offsets);
 
   *r_map = map;
   *r_mem = indices;
@@ -432,45 +452,33 @@ void BKE_mesh_edge_loop_map_create(MeshElemMap **r_map,
                                    const MLoop *mloop,
                                    const int totloop)
 {
-  MeshElemMap *map = MEM_callocN(sizeof(MeshElemMap) * (size_t)totedge, "edge-poly map");
-  int *indices = MEM_mallocN(sizeof(int) * (size_t)totloop * 2, "edge-poly map mem");
-  int *index_step;
-  const MPoly *mp;
-  int i;
-
-  /* count face users */
-  for (i = 0, mp = mpoly; i < totpoly; mp++, i++) {
-    const MLoop *ml;
-    int j = mp->totloop;
-    for (ml = &mloop[mp->loopstart]; j--; ml++) {
-      map[ml->e].count += 2;
+  MeshElemMap *map = (MeshElemMap *)MEM_malloc_arrayN(
+      (size_t)totedge, sizeof(MeshElemMap), "edge-poly map");
+  int *indices = (int *)MEM_malloc_arrayN((size_t)totloop, sizeof(int[2]), "edge-poly map mem");
+
+  const Array<int> loop_to_poly = mesh_loop_to_poly_map(mpoly, totpoly, totloop);
+  Array<int> offsets(totedge + 2);
+  Array<int> edge_loops(totloop);
+  mesh_poly_loops_group_by(loop_to_poly, offsets, edge_loops, [&](const int64_t loop) {
+    return int(mloop[loop].e);
+  });
+
+  /* Store every loop along with the next loop of its poly, which uses the other vertex of the
+   * edge. The last edge/loop of a poly must point back to the first loop! */
+  threading::parallel_for(IndexRange(offsets[totedge]), map_grain_size, [&](IndexRange range) {
+    for (const int64_t i : range) {
+      const int loop = edge_loops[i];
+      const MPoly *mp = &mpoly[loop_to_poly[loop]];
+      indices[i * 2] = loop;
+      indices[i * 2 + 1] = (loop == mp->loopstart + mp->totloop - 1) ? mp->loopstart : loop + 1;
     }
-  }
-
-  /* create offsets */
-  index_step = indices;
-  for (i = 0; i < totedge; i++) {
-    map[i].indices = index_step;
-    index_step += map[i].count;
-
-    /* re-count, using this as an index below */
-    map[i].count = 0;
-  }
-
-  /* assign loop-edge users */
-  for (i = 0, mp = mpoly; i < totpoly; mp++, i++) {
-    const MLoop *ml;
-    MeshElemMap *map_ele;
-    const int max_loop = mp->loopstart + mp->totloop;
-    int j = mp->loopstart;
-    for (ml = &mloop[j]; j < max_loop; j++, ml++) {
-      map_ele = &map[ml->e];
-      map_ele->indices[map_ele->count++] = j;
-      map_ele->indices[map_ele->count++] = j + 1;
+  });
+  threading::parallel_for(IndexRange(totedge), map_grain_size, [&](IndexRange range) {
+    for (const int64_t i : range) {
+      map[i].indices = indices + offsets[i] * 2;
+      map[i].count = (offsets[i + 1] - offsets[i]) * 2;
     }
-    /* last edge/loop of poly, must point back to first loop! */
-    map_ele->indices[map_ele->count - 1] = mp->loopstart;
-  }
+  });
 
   *r_map = map;
   *r_mem = indices;
@@ -490,40 +498,24 @@ void BKE_mesh_edge_poly_map_create(MeshElemMap **r_map,
                                    const MLoop *mloop,
                                    const int totloop)
 {
-  MeshElemMap *map = MEM_callocN(sizeof(MeshElemMap) * (size_t)totedge, "edge-poly map");
-  int *indices = MEM_mallocN(sizeof(int) * (size_t)totloop, "edge-poly map mem");
-  int *index_step;
-  const MPoly *mp;
-  int i;
-
-  /* count face users */
-  for (i = 0, mp = mpoly; i < totpoly; mp++, i++) {
-    const MLoop *ml;
-    int j = mp->totloop;
-    for (ml = &mloop[mp->loopstart]; j--; ml++) {
-      map[ml->e].count++;
+  MeshElemMap *map = (MeshElemMap *)MEM_malloc_arrayN(
+      (size_t)totedge, sizeof(MeshElemMap), "edge-poly map");
+  int *indices = (int *)MEM_malloc_arrayN((size_t)totloop, sizeof(int), "edge-poly map mem");
+
+  /* Group the loops by edge, then replace them by their poly. */
+  const Array<int> loop_to_poly = mesh_loop_to_poly_map(mpoly, totpoly, totloop);
+  Array<int> offsets(totedge + 2);
+  mesh_poly_loops_group_by(loop_to_poly, offsets, {indices, totloop}, [&](const int64_t loop) {
+    return int(mloop[loop].e);
+  });
+
+  threading::parallel_for(IndexRange(offsets[totedge]), map_grain_size, [&](IndexRange range) {
+    for (const int64_t i : range) {
+      indices[i] = loop_to_poly[indices[i]];
     }
-  }
-
-  /* create offsets */
-  index_step = indices;
-  for (i = 0; i < totedge; i++) {
-    map[i].indices = index_step;
-    index_step += map[i].count;
+  });
 
-    /* re-count, using this as an index below */
-    map[i].count = 0;
-  }
-
-  /* assign poly-edge users */
-  for (i = 0, mp = mpoly; i < totpoly; mp++, i++) {
-    const MLoop *ml;
-    int j = mp->totloop;
-    for (ml = &mloop[mp->loopstart]; j--; ml++) {
-      MeshElemMap *map_ele = &map[ml->e];
-      map_ele->indices[map_ele->count++] = i;
-    }
-  }
+  mesh_elem_map_from_offsets(map, indices, offsets.as_span().drop_back(1));
 
   *r_map = map;
   *r_mem = indices;
@@ -549,8 +541,9 @@ void BKE_mesh_origindex_map_create(MeshElemMap **r_map,
                                    const int *final_origindex,
                                    const int totfinal)
 {
-  MeshElemMap *map = MEM_callocN(sizeof(MeshElemMap) * (size_t)totsource, "poly-tessface map");
-  int *indices = MEM_mallocN(sizeof(int) * (size_t)totfinal, "poly-tessface map mem");
+  MeshElemMap *map = (MeshElemMap *)MEM_callocN(sizeof(MeshElemMap) * (size_t)totsource,
+                                                "poly-tessface map");
+  int *indices = (int *)MEM_mallocN(sizeof(int) * (size_t)totfinal, "poly-tessface map mem");
   int *index_step;
   int i;
 
@@ -595,8 +588,9 @@ void BKE_mesh_origindex_map_create_looptri(MeshElemMap **r_map,
                                            const MLoopTri *looptri,
                                            const int looptri_num)
 {
-  MeshElemMap *map = MEM_callocN(sizeof(MeshElemMap) * (size_t)mpoly_num, "poly-tessface map");
-  int *indices = MEM_mallocN(sizeof(int) * (size_t)looptri_num, "poly-tessface map mem");
+  MeshElemMap *map = (MeshElemMap *)MEM_callocN(sizeof(MeshElemMap) * (size_t)mpoly_num,
+                                                "poly-tessface map");
+  int *indices = (int *)MEM_mallocN(sizeof(int) * (size_t)looptri_num, "poly-tessface map mem");
   int *index_step;
   int i;
 
@@ -688,8 +682,8 @@ static void poly_edge_loop_islands_calc(const MEdge *medge,
         &edge_poly_map, &edge_poly_mem, medge, totedge, mpoly, totpoly, mloop, totloop);
   }
 
-  poly_groups = MEM_callocN(sizeof(int) * (size_t)totpoly, __func__);
-  poly_stack = MEM_mallocN(sizeof(int) * (size_t)totpoly, __func__);
+  poly_groups = (int *)MEM_callocN(sizeof(int) * (size_t)totpoly, __func__);
+  poly_stack = (int *)MEM_mallocN(sizeof(int) * (size_t)totpoly, __func__);
 
   while (true) {
     int poly;
@@ -910,16 +904,16 @@ void BKE_mesh_loop_islands_init(MeshIslandStore *island_store,
 
   island_store->item_type = item_type;
   island_store->items_to_islands_num = items_num;
-  island_store->items_to_islands = BLI_memarena_alloc(
+  island_store->items_to_islands = (int *)BLI_memarena_alloc(
       mem, sizeof(*island_store->items_to_islands) * (size_t)items_num);
 
   island_store->island_type = island_type;
   island_store->islands_num_alloc = MISLAND_DEFAULT_BUFSIZE;
-  island_store->islands = BLI_memarena_alloc(
+  island_store->islands = (MeshElemMap **)BLI_memarena_alloc(
       mem, sizeof(*island_store->islands) * island_store->islands_num_alloc);
 
   island_store->innercut_type = innercut_type;
-  island_store->innercuts = BLI_memarena_alloc(
+  island_store->innercuts = (MeshElemMap **)BLI_memarena_alloc(
       mem, sizeof(*island_store->innercuts) * island_store->islands_num_alloc);
 }
 
@@ -974,24 +968,29 @@ void BKE_mesh_loop_islands_add(MeshIslandStore *island_store,
     MeshElemMap **islds, **innrcuts;
 
     island_store->islands_num_alloc *= 2;
-    islds = BLI_memarena_alloc(mem, sizeof(*islds) * island_store->islands_num_alloc);
+    islds = (MeshElemMap **)BLI_memarena_alloc(mem,
+                                               sizeof(*islds) * island_store->islands_num_alloc);
     memcpy(islds, island_store->islands, sizeof(*islds) * (curr_num_islands - 1));
     island_store->islands = islds;
 
-    innrcuts = BLI_memarena_alloc(mem, sizeof(*innrcuts) * island_store->islands_num_alloc);
+    innrcuts = (MeshElemMap **)BLI_memarena_alloc(
+        mem, sizeof(*innrcuts) * island_store->islands_num_alloc);
     memcpy(innrcuts, island_store->innercuts, sizeof(*innrcuts) * (curr_num_islands - 1));
     island_store->innercuts = innrcuts;
   }
 
-  island_store->islands[curr_island_idx] = isld = BLI_memarena_alloc(mem, sizeof(*isld));
+  island_store->islands[curr_island_idx] = isld = (MeshElemMap *)BLI_memarena_alloc(
+      mem, sizeof(*isld));
   isld->count = num_island_items;
-  isld->indices = BLI_memarena_alloc(mem, sizeof(*isld->indices) * (size_t)num_island_items);
+  isld->indices = (int *)BLI_memarena_alloc(mem,
+                                            sizeof(*isld->indices) * (size_t)num_island_items);
   memcpy(isld->indices, island_item_indices, sizeof(*isld->indices) * (size_t)num_island_items);
 
-  island_store->innercuts[curr_island_idx] = innrcut = BLI_memarena_alloc(mem, sizeof(*innrcut));
+  island_store->innercuts[curr_island_idx] = innrcut = (MeshElemMap *)BLI_memarena_alloc(
+      mem, sizeof(*innrcut));
   innrcut->count = num_innercut_items;
-  innrcut->indices = BLI_memarena_alloc(mem,
-                                        sizeof(*innrcut->indices) * (size_t)num_innercut_items);
+  innrcut->indices = (int *)BLI_memarena_alloc(
+      mem, sizeof(*innrcut->indices) * (size_t)num_innercut_items);
   memcpy(innrcut->indices,
          innercut_item_indices,
          sizeof(*innrcut->indices) * (size_t)num_innercut_items);
@@ -1018,7 +1017,7 @@ static bool mesh_check_island_boundary_uv(const MPoly *UNUSED(mp),
                                           void *user_data)
 {
   if (user_data) {
-    const MeshCheckIslandBoundaryUv *data = user_data;
+    const MeshCheckIslandBoundaryUv *data = (const MeshCheckIslandBoundaryUv *)user_data;
     const MLoop *loops = data->loops;
     const MLoopUV *luvs = data->luvs;
     const MeshElemMap *edge_to_loops = &data->edge_loop_map[ml->e];
@@ -1132,13 +1131,14 @@ static bool mesh_calc_islands_loop_poly_uv(MVert *UNUSED(verts),
   }
 
   if (num_edge_borders) {
-    edge_border_count = MEM_mallocN(sizeof(*edge_border_count) * (size_t)totedge, __func__);
-    edge_innercut_indices = MEM_mallocN(sizeof(*edge_innercut_indices) * (size_t)num_edge_borders,
-                                        __func__);
+    edge_border_count = (char *)MEM_mallocN(sizeof(*edge_border_count) * (size_t)totedge,
+                                            __func__);
+    edge_innercut_indices = (int *)MEM_mallocN(
+        sizeof(*edge_innercut_indices) * (size_t)num_edge_borders, __func__);
   }
 
-  poly_indices = MEM_mallocN(sizeof(*poly_indices) * (size_t)totpoly, __func__);
-  loop_indices = MEM_mallocN(sizeof(*loop_indices) * (size_t)totloop, __func__);
+  poly_indices = (int *)MEM_mallocN(sizeof(*poly_indices) * (size_t)totpoly, __func__);
+  loop_indices = (int *)MEM_mallocN(sizeof(*loop_indices) * (size_t)totloop, __func__);
 
   /* NOTE: here we ignore '0' invalid group - this should *never* happen in this case anyway? */
   for (grp_idx = 1; grp_idx <= num_poly_groups; grp_idx++) {
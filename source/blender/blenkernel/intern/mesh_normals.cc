@@ -107,6 +107,18 @@ void BKE_mesh_normals_tag_dirty(Mesh *mesh)
 {
   mesh->runtime.cd_dirty_vert |= CD_MASK_NORMAL;
   mesh->runtime.cd_dirty_poly |= CD_MASK_NORMAL;
+  /* Most code which moves vertices only tags normals dirty. */
+  BKE_mesh_tag_coords_changed(mesh);
+}
+
+/**
+ * Call after changing vertex positions, so that data derived from them (like cached polygon
+ * normals) is recomputed on next access. Unlike #BKE_mesh_normals_tag_dirty the normals stored
+ * in the mesh are left as they are.
+ */
+void BKE_mesh_tag_coords_changed(Mesh *mesh)
+{
+  mesh->runtime.positions_version++;
 }
 
 /** \} */
@@ -165,10 +177,28 @@ void BKE_mesh_calc_normals_poly(const MVert *mvert,
  *
  * Take care making optimizations to this function as improvements to low-poly
  * meshes can slow down high-poly meshes. For details on performance, see D11993.
+ *
+ * Vertex positions are read either from #MVert.co or from a dense array of coordinates,
+ * see #BKE_mesh_calc_normals_poly_and_vertex_coords. The dense array is about half the size of
+ * the #MVert array, so less memory has to be fetched by the (random) position lookups.
  * \{ */
 
-struct MeshCalcNormalsData_PolyAndVertex {
-  /** Write into vertex normals #MVert.no. */
+static const float *vert_position(const MVert *mverts, const int index)
+{
+  return mverts[index].co;
+}
+
+static const float *vert_position(const float (*vert_coords)[3], const int index)
+{
+  return vert_coords[index];
+}
+
+/**
+ * \param Positions: Either `const MVert *` or `const float (*)[3]`.
+ */
+template<typename Positions> struct MeshCalcNormalsData_PolyAndVertex {
+  Positions positions;
+  /** Write into vertex normals #MVert.no, may be null. */
   MVert *mvert;
   const MLoop *mloop;
   const MPoly *mpoly;
@@ -179,13 +209,15 @@ struct MeshCalcNormalsData_PolyAndVertex {
   float (*vnors)[3];
 };
 
+template<typename Positions>
 static void mesh_calc_normals_poly_and_vertex_accum_fn(
     void *__restrict userdata, const int pidx, const TaskParallelTLS *__restrict UNUSED(tls))
 {
-  const MeshCalcNormalsData_PolyAndVertex *data = (MeshCalcNormalsData_PolyAndVertex *)userdata;
+  const MeshCalcNormalsData_PolyAndVertex<Positions> *data =
+      (MeshCalcNormalsData_PolyAndVertex<Positions> *)userdata;
   const MPoly *mp = &data->mpoly[pidx];
   const MLoop *ml = &data->mloop[mp->loopstart];
-  const MVert *mverts = data->mvert;
+  const Positions positions = data->positions;
   float(*vnors)[3] = data->vnors;
 
   float pnor_temp[3];
@@ -198,9 +230,9 @@ static void mesh_calc_normals_poly_and_vertex_accum_fn(
   {
     zero_v3(pnor);
     /* Newell's Method */
-    const float *v_curr = mverts[ml[i_end].v].co;
+    const float *v_curr = vert_position(positions, ml[i_end].v);
     for (int i_next = 0; i_next <= i_end; i_next++) {
-      const float *v_next = mverts[ml[i_next].v].co;
+      const float *v_next = vert_position(positions, ml[i_next].v);
       add_newell_cross_v3_v3v3(pnor, v_curr, v_next);
       v_curr = v_next;
     }
@@ -213,13 +245,13 @@ static void mesh_calc_normals_poly_and_vertex_accum_fn(
   /* Inline version of #accumulate_vertex_normals_poly_v3. */
   {
     float edvec_prev[3], edvec_next[3], edvec_end[3];
-    const float *v_curr = mverts[ml[i_end].v].co;
-    sub_v3_v3v3(edvec_prev, mverts[ml[i_end - 1].v].co, v_curr);
+    const float *v_curr = vert_position(positions, ml[i_end].v);
+    sub_v3_v3v3(edvec_prev, vert_position(positions, ml[i_end - 1].v), v_curr);
     normalize_v3(edvec_prev);
     copy_v3_v3(edvec_end, edvec_prev);
 
     for (int i_next = 0, i_curr = i_end; i_next <= i_end; i_curr = i_next++) {
-      const float *v_next = mverts[ml[i_next].v].co;
+      const float *v_next = vert_position(positions, ml[i_next].v);
 
       /* Skip an extra normalization by reusing the first calculated edge. */
       if (i_next != i_end) {
@@ -241,30 +273,34 @@ static void mesh_calc_normals_poly_and_vertex_accum_fn(
   }
 }
 
+template<typename Positions>
 static void mesh_calc_normals_poly_and_vertex_finalize_fn(
     void *__restrict userdata, const int vidx, const TaskParallelTLS *__restrict UNUSED(tls))
 {
-  MeshCalcNormalsData_PolyAndVertex *data = (MeshCalcNormalsData_PolyAndVertex *)userdata;
+  MeshCalcNormalsData_PolyAndVertex<Positions> *data =
+      (MeshCalcNormalsData_PolyAndVertex<Positions> *)userdata;
 
-  MVert *mv = &data->mvert[vidx];
   float *no = data->vnors[vidx];
 
   if (UNLIKELY(normalize_v3(no) == 0.0f)) {
     /* Following Mesh convention; we use vertex coordinate itself for normal in this case. */
-    normalize_v3_v3(no, mv->co);
+    normalize_v3_v3(no, vert_position(data->positions, vidx));
   }
 
-  normal_float_to_short_v3(mv->no, no);
+  if (data->mvert) {
+    normal_float_to_short_v3(data->mvert[vidx].no, no);
+  }
 }
 
-void BKE_mesh_calc_normals_poly_and_vertex(MVert *mvert,
-                                           const int mvert_len,
-                                           const MLoop *mloop,
-                                           const int UNUSED(mloop_len),
-                                           const MPoly *mpoly,
-                                           const int mpoly_len,
-                                           float (*r_poly_normals)[3],
-                                           float (*r_vert_normals)[3])
+template<typename Positions>
+static void mesh_calc_normals_poly_and_vertex_impl(const Positions positions,
+                                                   MVert *mvert,
+                                                   const int mvert_len,
+                                                   const MLoop *mloop,
+                                                   const MPoly *mpoly,
+                                                   const int mpoly_len,
+                                                   float (*r_poly_normals)[3],
+                                                   float (*r_vert_normals)[3])
 {
   TaskParallelSettings settings;
   BLI_parallel_range_settings_defaults(&settings);
@@ -282,7 +318,8 @@ void BKE_mesh_calc_normals_poly_and_vertex(MVert *mvert,
     memset(vnors, 0, sizeof(*vnors) * (size_t)mvert_len);
   }
 
-  MeshCalcNormalsData_PolyAndVertex data = {};
+  MeshCalcNormalsData_PolyAndVertex<Positions> data = {};
+  data.positions = positions;
   data.mpoly = mpoly;
   data.mloop = mloop;
   data.mvert = mvert;
@@ -291,17 +328,58 @@ void BKE_mesh_calc_normals_poly_and_vertex(MVert *mvert,
 
   /* Compute poly normals (`pnors`), accumulating them into vertex normals (`vnors`). */
   BLI_task_parallel_range(
-      0, mpoly_len, &data, mesh_calc_normals_poly_and_vertex_accum_fn, &settings);
+      0, mpoly_len, &data, mesh_calc_normals_poly_and_vertex_accum_fn<Positions>, &settings);
 
   /* Normalize and validate computed vertex normals (`vnors`). */
   BLI_task_parallel_range(
-      0, mvert_len, &data, mesh_calc_normals_poly_and_vertex_finalize_fn, &settings);
+      0, mvert_len, &data, mesh_calc_normals_poly_and_vertex_finalize_fn<Positions>, &settings);
 
   if (free_vnors) {
     MEM_freeN(vnors);
   }
 }
 
+void BKE_mesh_calc_normals_poly_and_vertex(MVert *mvert,
+                                           const int mvert_len,
+                                           const MLoop *mloop,
+                                           const int UNUSED(mloop_len),
+                                           const MPoly *mpoly,
+                                           const int mpoly_len,
+                                           float (*r_poly_normals)[3],
+                                           float (*r_vert_normals)[3])
+{
+  mesh_calc_normals_poly_and_vertex_impl<const MVert *>(
+      mvert, mvert, mvert_len, mloop, mpoly, mpoly_len, r_poly_normals, r_vert_normals);
+}
+
+/**
+ * Calculate polygon and vertex normals from a dense array of vertex coordinates (as used by
+ * deform modifiers), without reading #MVert.
+ *
+ * \param mvert: Optional, when not null the vertex normals are written into #MVert.no.
+ * \param r_poly_normals: Optional, may be null.
+ * \param r_vert_normals: Optional, may be null.
+ */
+void BKE_mesh_calc_normals_poly_and_vertex_coords(const float (*vert_coords)[3],
+                                                  const int vert_coords_len,
+                                                  MVert *mvert,
+                                                  const MLoop *mloop,
+                                                  const int UNUSED(mloop_len),
+                                                  const MPoly *mpoly,
+                                                  const int mpoly_len,
+                                                  float (*r_poly_normals)[3],
+                                                  float (*r_vert_normals)[3])
+{
+  mesh_calc_normals_poly_and_vertex_impl<const float(*)[3]>(vert_coords,
+                                                            mvert,
+                                                            vert_coords_len,
+                                                            mloop,
+                                                            mpoly,
+                                                            mpoly_len,
+                                                            r_poly_normals,
+                                                            r_vert_normals);
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -401,6 +479,25 @@ void BKE_mesh_calc_normals(Mesh *mesh)
   mesh->runtime.cd_dirty_vert &= ~CD_MASK_NORMAL;
 }
 
+/**
+ * Same as #BKE_mesh_vert_coords_apply followed by #BKE_mesh_calc_normals, but the normals are
+ * calculated from \a vert_coords, which is less memory to read than the #MVert array.
+ */
+void BKE_mesh_vert_coords_apply_and_calc_normals(Mesh *mesh, const float (*vert_coords)[3])
+{
+  BKE_mesh_vert_coords_apply(mesh, vert_coords);
+  BKE_mesh_calc_normals_poly_and_vertex_coords(vert_coords,
+                                               mesh->totvert,
+                                               mesh->mvert,
+                                               mesh->mloop,
+                                               mesh->totloop,
+                                               mesh->mpoly,
+                                               mesh->totpoly,
+                                               nullptr,
+                                               nullptr);
+  mesh->runtime.cd_dirty_vert &= ~CD_MASK_NORMAL;
+}
+
 void BKE_mesh_calc_normals_looptri(MVert *mverts,
                                    int numVerts,
                                    const MLoop *mloop,
@@ -794,12 +891,32 @@ struct LoopSplitTaskDataCommon {
 /* See comment about edge_to_loops below. */
 #define IS_EDGE_SHARP(_e2l) (ELEM((_e2l)[1], INDEX_UNSET, INDEX_INVALID))
 
+static void mesh_loops_to_poly_fn(void *__restrict userdata,
+                                  const int mp_index,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const LoopSplitTaskDataCommon *data = (const LoopSplitTaskDataCommon *)userdata;
+  const MPoly *mp = &data->mpolys[mp_index];
+  const int ml_end_index = mp->loopstart + mp->totloop;
+
+  for (int ml_index = mp->loopstart; ml_index < ml_end_index; ml_index++) {
+    data->loop_to_poly[ml_index] = mp_index;
+
+    /* Pre-populate all loop normals as if their verts were all-smooth,
+     * this way we don't have to compute those later!
+     */
+    if (data->loopnors) {
+      normal_short_to_float_v3(data->loopnors[ml_index],
+                               data->mverts[data->mloops[ml_index].v].no);
+    }
+  }
+}
+
 static void mesh_edges_sharp_tag(LoopSplitTaskDataCommon *data,
                                  const bool check_angle,
                                  const float split_angle,
                                  const bool do_sharp_edges_tag)
 {
-  const MVert *mverts = data->mverts;
   const MEdge *medges = data->medges;
   const MLoop *mloops = data->mloops;
 
@@ -808,7 +925,6 @@ static void mesh_edges_sharp_tag(LoopSplitTaskDataCommon *data,
   const int numEdges = data->numEdges;
   const int numPolys = data->numPolys;
 
-  float(*loopnors)[3] = data->loopnors; /* NOTE: loopnors may be nullptr here. */
   const float(*polynors)[3] = data->polynors;
 
   int(*edge_to_loops)[2] = data->edge_to_loops;
@@ -821,6 +937,14 @@ static void mesh_edges_sharp_tag(LoopSplitTaskDataCommon *data,
 
   const float split_angle_cos = check_angle ? cosf(split_angle) : -1.0f;
 
+  /* Only the edges have to be handled in order, the per-loop data is filled in parallel first. */
+  {
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = 1024;
+    BLI_task_parallel_range(0, numPolys, data, mesh_loops_to_poly_fn, &settings);
+  }
+
   for (mp = mpolys, mp_index = 0; mp_index < numPolys; mp++, mp_index++) {
     const MLoop *ml_curr;
     int *e2l;
@@ -832,15 +956,6 @@ static void mesh_edges_sharp_tag(LoopSplitTaskDataCommon *data,
     for (; ml_curr_index <= ml_last_index; ml_curr++, ml_curr_index++) {
       e2l = edge_to_loops[ml_curr->e];
 
-      loop_to_poly[ml_curr_index] = mp_index;
-
-      /* Pre-populate all loop normals as if their verts were all-smooth,
-       * this way we don't have to compute those later!
-       */
-      if (loopnors) {
-        normal_short_to_float_v3(loopnors[ml_curr_index], mverts[ml_curr->v].no);
-      }
-
       /* Check whether current edge might be smooth or sharp */
       if ((e2l[0] | e2l[1]) == 0) {
         /* 'Empty' edge until now, set e2l[0] (and e2l[1] to INDEX_UNSET to tag it as unset). */
@@ -1568,6 +1683,114 @@ static void loop_split_generator(TaskPool *pool, LoopSplitTaskDataCommon *common
 #endif
 }
 
+/**
+ * Same as #loop_split_generator_check_cyclic_smooth_fan, but without tagging any loops, so that
+ * all loops can be checked in parallel. Returns true when the loop is part of a cyclic smooth fan
+ * and comes first in it, in the order in which #loop_split_generator walks loops, so that the
+ * same entry point is used for every fan.
+ */
+static bool loop_split_cyclic_smooth_fan_is_first(const MLoop *mloops,
+                                                  const MPoly *mpolys,
+                                                  const int (*edge_to_loops)[2],
+                                                  const int *loop_to_poly,
+                                                  const int *e2l_prev,
+                                                  const MLoop *ml_curr,
+                                                  const MLoop *ml_prev,
+                                                  const int ml_curr_index,
+                                                  const int ml_prev_index,
+                                                  const int mp_curr_index)
+{
+  const uint mv_pivot_index = ml_curr->v; /* The vertex we are "fanning" around! */
+  const int *e2lfan_curr = e2l_prev;
+  const MLoop *mlfan_curr = ml_prev;
+  int mlfan_curr_index = ml_prev_index;
+  int mlfan_vert_index = ml_curr_index;
+  int mpfan_curr_index = mp_curr_index;
+
+  if (IS_EDGE_SHARP(e2lfan_curr)) {
+    /* Sharp loop, so not a cyclic smooth fan. */
+    return false;
+  }
+
+  while (true) {
+    BKE_mesh_loop_manifold_fan_around_vert_next(mloops,
+                                                mpolys,
+                                                loop_to_poly,
+                                                e2lfan_curr,
+                                                mv_pivot_index,
+                                                &mlfan_curr,
+                                                &mlfan_curr_index,
+                                                &mlfan_vert_index,
+                                                &mpfan_curr_index);
+
+    e2lfan_curr = edge_to_loops[mlfan_curr->e];
+
+    if (IS_EDGE_SHARP(e2lfan_curr)) {
+      /* Sharp loop/edge, so not a cyclic smooth fan. */
+      return false;
+    }
+    if (mlfan_vert_index == ml_curr_index) {
+      /* Walked around the whole cyclic fan without finding a loop that comes first. */
+      return true;
+    }
+    if (mpfan_curr_index < mp_curr_index ||
+        (mpfan_curr_index == mp_curr_index && mlfan_vert_index < ml_curr_index)) {
+      /* The fan is handled from another loop, whether it is cyclic or not. */
+      return false;
+    }
+  }
+}
+
+static void loop_split_poly_fn(void *__restrict userdata,
+                               const int mp_index,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  LoopSplitTaskDataCommon *common_data = (LoopSplitTaskDataCommon *)userdata;
+  const MLoop *mloops = common_data->mloops;
+  const int(*edge_to_loops)[2] = common_data->edge_to_loops;
+
+  const MPoly *mp = &common_data->mpolys[mp_index];
+  const int ml_last_index = (mp->loopstart + mp->totloop) - 1;
+  int ml_prev_index = ml_last_index;
+
+  for (int ml_curr_index = mp->loopstart; ml_curr_index <= ml_last_index; ml_curr_index++) {
+    const MLoop *ml_curr = &mloops[ml_curr_index];
+    const MLoop *ml_prev = &mloops[ml_prev_index];
+    const int *e2l_curr = edge_to_loops[ml_curr->e];
+    const int *e2l_prev = edge_to_loops[ml_prev->e];
+
+    /* Each fan is computed from the same loop as in #loop_split_generator,
+     * see the comments there. */
+    if (IS_EDGE_SHARP(e2l_curr) ||
+        loop_split_cyclic_smooth_fan_is_first(mloops,
+                                              common_data->mpolys,
+                                              edge_to_loops,
+                                              common_data->loop_to_poly,
+                                              e2l_prev,
+                                              ml_curr,
+                                              ml_prev,
+                                              ml_curr_index,
+                                              ml_prev_index,
+                                              mp_index)) {
+      LoopSplitTaskData data = {nullptr};
+      data.ml_curr = ml_curr;
+      data.ml_prev = ml_prev;
+      data.ml_curr_index = ml_curr_index;
+      data.ml_prev_index = ml_prev_index;
+      data.mp_index = mp_index;
+      if (IS_EDGE_SHARP(e2l_curr) && IS_EDGE_SHARP(e2l_prev)) {
+        data.lnor = &common_data->loopnors[ml_curr_index];
+      }
+      else {
+        data.e2l_prev = e2l_prev; /* Tag as 'fan' task. */
+      }
+      loop_split_worker_do(common_data, &data, nullptr);
+    }
+
+    ml_prev_index = ml_curr_index;
+  }
+}
+
 /**
  * Compute split normals, i.e. vertex normals associated with each poly (hence 'loop normals').
  * Useful to materialize sharp edges (or non-smooth faces) without actually modifying the geometry
@@ -1681,7 +1904,15 @@ void BKE_mesh_normals_loop_split(const MVert *mverts,
   /* This first loop check which edges are actually smooth, and compute edge vectors. */
   mesh_edges_sharp_tag(&common_data, check_angle, split_angle, false);
 
-  if (numLoops < LOOP_SPLIT_TASK_BLOCK_SIZE * 8) {
+  if (r_lnors_spacearr == nullptr) {
+    /* Without normal spaces, nothing has to be allocated for a fan, and every poly can find and
+     * compute the fans starting at its loops independently. */
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = 1024;
+    BLI_task_parallel_range(0, numPolys, &common_data, loop_split_poly_fn, &settings);
+  }
+  else if (numLoops < LOOP_SPLIT_TASK_BLOCK_SIZE * 8) {
     /* Not enough loops to be worth the whole threading overhead. */
     loop_split_generator(nullptr, &common_data);
   }
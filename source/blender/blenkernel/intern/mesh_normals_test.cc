@@ -0,0 +1,269 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BKE_mesh.h"
+
+#include "BLI_array.hh"
+#include "BLI_math.h"
+#include "BLI_rand.hh"
+#include "BLI_timeit.hh"
+
+#include "DNA_meshdata_types.h"
+
+namespace blender::bke::tests {
+
+/** Grid of quads with random heights, random sharp edges and some flat faces. */
+struct LoopNormalsTestMesh {
+  Array<MVert> verts;
+  Array<MEdge> edges;
+  Array<MLoop> loops;
+  Array<MPoly> polys;
+  Array<float3> poly_normals;
+
+  LoopNormalsTestMesh(const int size, const float sharp_factor)
+      : verts((size + 1) * (size + 1)),
+        edges(2 * size * (size + 1)),
+        loops(4 * size * size),
+        polys(size * size),
+        poly_normals(size * size)
+  {
+    RandomNumberGenerator rng;
+    const int row = size + 1;
+    for (const int y : IndexRange(row)) {
+      for (const int x : IndexRange(row)) {
+        MVert &mv = verts[y * row + x];
+        copy_v3_fl3(mv.co, float(x), float(y), rng.get_float());
+        mv.flag = 0;
+        mv.bweight = 0;
+      }
+    }
+
+    /* Edges along x first, then edges along y. */
+    const int x_edges_num = size * row;
+    for (const int y : IndexRange(row)) {
+      for (const int x : IndexRange(size)) {
+        MEdge &me = edges[y * size + x];
+        me.v1 = y * row + x;
+        me.v2 = y * row + x + 1;
+      }
+    }
+    for (const int y : IndexRange(size)) {
+      for (const int x : IndexRange(row)) {
+        MEdge &me = edges[x_edges_num + y * row + x];
+        me.v1 = y * row + x;
+        me.v2 = (y + 1) * row + x;
+      }
+    }
+    for (MEdge &me : edges) {
+      me.flag = (rng.get_float() < sharp_factor) ? ME_SHARP : 0;
+      me.crease = 0;
+      me.bweight = 0;
+    }
+
+    for (const int y : IndexRange(size)) {
+      for (const int x : IndexRange(size)) {
+        const int poly_index = y * size + x;
+        MPoly &mp = polys[poly_index];
+        mp.loopstart = poly_index * 4;
+        mp.totloop = 4;
+        mp.mat_nr = 0;
+        mp.flag = (rng.get_float() < sharp_factor) ? 0 : ME_SMOOTH;
+
+        MLoop *ml = &loops[mp.loopstart];
+        ml[0].v = y * row + x;
+        ml[0].e = y * size + x;
+        ml[1].v = y * row + x + 1;
+        ml[1].e = x_edges_num + y * row + x + 1;
+        ml[2].v = (y + 1) * row + x + 1;
+        ml[2].e = (y + 1) * size + x;
+        ml[3].v = (y + 1) * row + x;
+        ml[3].e = x_edges_num + y * row + x;
+      }
+    }
+
+    BKE_mesh_calc_normals_poly_and_vertex(verts.data(),
+                                          verts.size(),
+                                          loops.data(),
+                                          loops.size(),
+                                          polys.data(),
+                                          polys.size(),
+                                          (float(*)[3])poly_normals.data(),
+                                          nullptr);
+  }
+
+  /** Without normal spaces, the parallel code path is used. */
+  void calc_loop_normals(MutableSpan<float3> r_loop_normals,
+                         const float split_angle,
+                         MLoopNorSpaceArray *r_lnors_spacearr)
+  {
+    BKE_mesh_normals_loop_split(verts.data(),
+                                verts.size(),
+                                edges.data(),
+                                edges.size(),
+                                loops.data(),
+                                (float(*)[3])r_loop_normals.data(),
+                                loops.size(),
+                                polys.data(),
+                                (const float(*)[3])poly_normals.data(),
+                                polys.size(),
+                                true,
+                                split_angle,
+                                r_lnors_spacearr,
+                                nullptr,
+                                nullptr);
+  }
+};
+
+static void test_loop_normals_with_and_without_spaces(const int size,
+                                                      const float sharp_factor,
+                                                      const float split_angle)
+{
+  LoopNormalsTestMesh mesh(size, sharp_factor);
+
+  Array<float3> loop_normals(mesh.loops.size());
+  mesh.calc_loop_normals(loop_normals, split_angle, nullptr);
+
+  MLoopNorSpaceArray lnors_spacearr = {nullptr};
+  Array<float3> loop_normals_spaces(mesh.loops.size());
+  mesh.calc_loop_normals(loop_normals_spaces, split_angle, &lnors_spacearr);
+  BKE_lnor_spacearr_free(&lnors_spacearr);
+
+  for (const int i : loop_normals.index_range()) {
+    EXPECT_V3_NEAR(loop_normals[i], loop_normals_spaces[i], 1e-6f);
+  }
+}
+
+TEST(mesh_normals, loop_split_all_smooth)
+{
+  test_loop_normals_with_and_without_spaces(100, 0.0f, float(M_PI));
+}
+
+TEST(mesh_normals, loop_split_sharp_edges)
+{
+  test_loop_normals_with_and_without_spaces(100, 0.3f, float(M_PI));
+}
+
+TEST(mesh_normals, loop_split_angle)
+{
+  test_loop_normals_with_and_without_spaces(100, 0.1f, DEG2RADF(30.0f));
+}
+
+/* Normals from a dense coordinate array match the ones from #MVert exactly, so deform modifiers
+ * can use them without changing their results. */
+TEST(mesh_normals, poly_and_vertex_from_coords)
+{
+  LoopNormalsTestMesh mesh(100, 0.0f);
+  /* A loose vertex, which uses its normalized position as normal. */
+  Array<MVert> verts(mesh.verts.size() + 1);
+  verts.as_mutable_span().take_front(mesh.verts.size()).copy_from(mesh.verts);
+  copy_v3_fl3(verts.last().co, 0.5f, -2.0f, 1.0f);
+  Array<float3> vert_normals(verts.size());
+  BKE_mesh_calc_normals_poly_and_vertex(verts.data(),
+                                        verts.size(),
+                                        mesh.loops.data(),
+                                        mesh.loops.size(),
+                                        mesh.polys.data(),
+                                        mesh.polys.size(),
+                                        nullptr,
+                                        (float(*)[3])vert_normals.data());
+
+  Array<float3> coords(verts.size());
+  Array<MVert> verts_coords(verts);
+  for (const int i : verts.index_range()) {
+    coords[i] = verts[i].co;
+    verts_coords[i].no[0] = verts_coords[i].no[1] = verts_coords[i].no[2] = 0;
+  }
+  Array<float3> poly_normals_coords(mesh.polys.size());
+  Array<float3> vert_normals_coords(verts.size());
+  BKE_mesh_calc_normals_poly_and_vertex_coords((const float(*)[3])coords.data(),
+                                               coords.size(),
+                                               verts_coords.data(),
+                                               mesh.loops.data(),
+                                               mesh.loops.size(),
+                                               mesh.polys.data(),
+                                               mesh.polys.size(),
+                                               (float(*)[3])poly_normals_coords.data(),
+                                               (float(*)[3])vert_normals_coords.data());
+
+  for (const int i : mesh.polys.index_range()) {
+    EXPECT_EQ(poly_normals_coords[i], mesh.poly_normals[i]);
+  }
+  for (const int i : verts.index_range()) {
+    EXPECT_EQ(vert_normals_coords[i], vert_normals[i]);
+    EXPECT_EQ(verts_coords[i].no[0], verts[i].no[0]);
+    EXPECT_EQ(verts_coords[i].no[1], verts[i].no[1]);
+    EXPECT_EQ(verts_coords[i].no[2], verts[i].no[2]);
+  }
+}
+
+/**
+ * Set this to 1 to activate the benchmarks, with about 5 million loops.
+ */
+#if 0
+TEST(mesh_normals_performance, loop_split_5M)
+{
+  LoopNormalsTestMesh mesh(1118, 0.1f);
+  Array<float3> loop_normals(mesh.loops.size());
+  {
+    SCOPED_TIMER("loop normals");
+    mesh.calc_loop_normals(loop_normals, DEG2RADF(30.0f), nullptr);
+  }
+  {
+    SCOPED_TIMER("loop normals with normal spaces");
+    MLoopNorSpaceArray lnors_spacearr = {nullptr};
+    mesh.calc_loop_normals(loop_normals, DEG2RADF(30.0f), &lnors_spacearr);
+    BKE_lnor_spacearr_free(&lnors_spacearr);
+  }
+}
+
+TEST(mesh_normals_performance, poly_and_vertex_5M)
+{
+  LoopNormalsTestMesh mesh(1118, 0.0f);
+  Array<float3> coords(mesh.verts.size());
+  for (const int i : mesh.verts.index_range()) {
+    coords[i] = mesh.verts[i].co;
+  }
+  Array<float3> vert_normals(mesh.verts.size());
+  {
+    SCOPED_TIMER("normals from MVert");
+    BKE_mesh_calc_normals_poly_and_vertex(mesh.verts.data(),
+                                          mesh.verts.size(),
+                                          mesh.loops.data(),
+                                          mesh.loops.size(),
+                                          mesh.polys.data(),
+                                          mesh.polys.size(),
+                                          (float(*)[3])mesh.poly_normals.data(),
+                                          (float(*)[3])vert_normals.data());
+  }
+  {
+    SCOPED_TIMER("normals from coordinates");
+    BKE_mesh_calc_normals_poly_and_vertex_coords((const float(*)[3])coords.data(),
+                                                 coords.size(),
+                                                 nullptr,
+                                                 mesh.loops.data(),
+                                                 mesh.loops.size(),
+                                                 mesh.polys.data(),
+                                                 mesh.polys.size(),
+                                                 (float(*)[3])mesh.poly_normals.data(),
+                                                 (float(*)[3])vert_normals.data());
+  }
+}
+#endif
+
+}  // namespace blender::bke::tests
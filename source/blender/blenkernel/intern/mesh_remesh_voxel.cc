@@ -34,6 +34,7 @@
 #include "BLI_float3.hh"
 #include "BLI_index_range.hh"
 #include "BLI_span.hh"
+#include "BLI_task.hh"
 
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
@@ -207,16 +208,20 @@ static openvdb::FloatGrid::Ptr remesh_voxel_level_set_create(const Mesh *mesh,
   std::vector<openvdb::Vec3s> points(mesh->totvert);
   std::vector<openvdb::Vec3I> triangles(looptris.size());
 
-  for (const int i : IndexRange(mesh->totvert)) {
-    const float3 co = mesh->mvert[i].co;
-    points[i] = openvdb::Vec3s(co.x, co.y, co.z);
-  }
+  blender::threading::parallel_for(IndexRange(mesh->totvert), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const float3 co = mesh->mvert[i].co;
+      points[i] = openvdb::Vec3s(co.x, co.y, co.z);
+    }
+  });
 
-  for (const int i : IndexRange(looptris.size())) {
-    const MLoopTri &loop_tri = looptris[i];
-    triangles[i] = openvdb::Vec3I(
-        mloop[loop_tri.tri[0]].v, mloop[loop_tri.tri[1]].v, mloop[loop_tri.tri[2]].v);
-  }
+  blender::threading::parallel_for(looptris.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const MLoopTri &loop_tri = looptris[i];
+      triangles[i] = openvdb::Vec3I(
+          mloop[loop_tri.tri[0]].v, mloop[loop_tri.tri[1]].v, mloop[loop_tri.tri[2]].v);
+    }
+  });
 
   openvdb::math::Transform::Ptr transform = openvdb::math::Transform::createLinearTransform(
       voxel_size);
@@ -226,7 +231,11 @@ static openvdb::FloatGrid::Ptr remesh_voxel_level_set_create(const Mesh *mesh,
   return grid;
 }
 
-static Mesh *remesh_voxel_volume_to_mesh(const openvdb::FloatGrid::Ptr level_set_grid,
+/**
+ * \note The level set grid is freed as soon as the polygons are extracted from it, so that the
+ * grid and the new mesh don't have to be kept in memory at the same time.
+ */
+static Mesh *remesh_voxel_volume_to_mesh(openvdb::FloatGrid::Ptr &level_set_grid,
                                          const float isovalue,
                                          const float adaptivity,
                                          const bool relax_disoriented_triangles)
@@ -236,6 +245,7 @@ static Mesh *remesh_voxel_volume_to_mesh(const openvdb::FloatGrid::Ptr level_set
   std::vector<openvdb::Vec3I> tris;
   openvdb::tools::volumeToMesh<openvdb::FloatGrid>(
       *level_set_grid, vertices, tris, quads, isovalue, adaptivity, relax_disoriented_triangles);
+  level_set_grid.reset();
 
   Mesh *mesh = BKE_mesh_new_nomain(
       vertices.size(), 0, 0, quads.size() * 4 + tris.size() * 3, quads.size() + tris.size());
@@ -243,31 +253,42 @@ static Mesh *remesh_voxel_volume_to_mesh(const openvdb::FloatGrid::Ptr level_set
   MutableSpan<MLoop> mloops{mesh->mloop, mesh->totloop};
   MutableSpan<MPoly> mpolys{mesh->mpoly, mesh->totpoly};
 
-  for (const int i : mverts.index_range()) {
-    copy_v3_v3(mverts[i].co, float3(vertices[i].x(), vertices[i].y(), vertices[i].z()));
-  }
-
-  for (const int i : IndexRange(quads.size())) {
-    MPoly &poly = mpolys[i];
-    const int loopstart = i * 4;
-    poly.loopstart = loopstart;
-    poly.totloop = 4;
-    mloops[loopstart].v = quads[i][0];
-    mloops[loopstart + 1].v = quads[i][3];
-    mloops[loopstart + 2].v = quads[i][2];
-    mloops[loopstart + 3].v = quads[i][1];
-  }
+  blender::threading::parallel_for(mverts.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      copy_v3_v3(mverts[i].co, float3(vertices[i].x(), vertices[i].y(), vertices[i].z()));
+    }
+  });
+
+  blender::threading::parallel_for(IndexRange(quads.size()), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      MPoly &poly = mpolys[i];
+      const int loopstart = i * 4;
+      poly.loopstart = loopstart;
+      poly.totloop = 4;
+      mloops[loopstart].v = quads[i][0];
+      mloops[loopstart + 1].v = quads[i][3];
+      mloops[loopstart + 2].v = quads[i][2];
+      mloops[loopstart + 3].v = quads[i][1];
+    }
+  });
 
   const int triangle_loop_start = quads.size() * 4;
-  for (const int i : IndexRange(tris.size())) {
-    MPoly &poly = mpolys[quads.size() + i];
-    const int loopstart = triangle_loop_start + i * 3;
-    poly.loopstart = loopstart;
-    poly.totloop = 3;
-    mloops[loopstart].v = tris[i][2];
-    mloops[loopstart + 1].v = tris[i][1];
-    mloops[loopstart + 2].v = tris[i][0];
-  }
+  blender::threading::parallel_for(IndexRange(tris.size()), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      MPoly &poly = mpolys[quads.size() + i];
+      const int loopstart = triangle_loop_start + i * 3;
+      poly.loopstart = loopstart;
+      poly.totloop = 3;
+      mloops[loopstart].v = tris[i][2];
+      mloops[loopstart + 1].v = tris[i][1];
+      mloops[loopstart + 2].v = tris[i][0];
+    }
+  });
+
+  /* Free the OpenVDB buffers before the edges are calculated. */
+  std::vector<openvdb::Vec3s>().swap(vertices);
+  std::vector<openvdb::Vec4I>().swap(quads);
+  std::vector<openvdb::Vec3I>().swap(tris);
 
   BKE_mesh_calc_edges(mesh, false, false);
   BKE_mesh_normals_tag_dirty(mesh);
@@ -290,12 +311,34 @@ Mesh *BKE_mesh_remesh_voxel(const Mesh *mesh,
 #endif
 }
 
-void BKE_mesh_remesh_reproject_paint_mask(Mesh *target, Mesh *source)
+/**
+ * Find the nearest source vertex of all target vertices, -1 for vertices where none was found.
+ * The queries are independent, so they are done in parallel and only once for all layers.
+ */
+static Array<int> remesh_nearest_source_verts_find(const Mesh *target, const Mesh *source)
 {
   BVHTreeFromMesh bvhtree = {nullptr};
   BKE_bvhtree_from_mesh_get(&bvhtree, source, BVHTREE_FROM_VERTS, 2);
-  MVert *target_verts = (MVert *)CustomData_get_layer(&target->vdata, CD_MVERT);
+  const MVert *target_verts = (const MVert *)CustomData_get_layer(&target->vdata, CD_MVERT);
+
+  Array<int> nearest_indices(target->totvert);
+  blender::threading::parallel_for(IndexRange(target->totvert), 512, [&](IndexRange range) {
+    for (const int i : range) {
+      BVHTreeNearest nearest;
+      nearest.index = -1;
+      nearest.dist_sq = FLT_MAX;
+      BLI_bvhtree_find_nearest(
+          bvhtree.tree, target_verts[i].co, &nearest, bvhtree.nearest_callback, &bvhtree);
+      nearest_indices[i] = nearest.index;
+    }
+  });
+
+  free_bvhtree_from_mesh(&bvhtree);
+  return nearest_indices;
+}
 
+void BKE_mesh_remesh_reproject_paint_mask(Mesh *target, Mesh *source)
+{
   float *target_mask;
   if (CustomData_has_layer(&target->vdata, CD_PAINT_MASK)) {
     target_mask = (float *)CustomData_get_layer(&target->vdata, CD_PAINT_MASK);
@@ -314,18 +357,14 @@ void BKE_mesh_remesh_reproject_paint_mask(Mesh *target, Mesh *source)
         &source->vdata, CD_PAINT_MASK, CD_CALLOC, nullptr, source->totvert);
   }
 
-  for (int i = 0; i < target->totvert; i++) {
-    float from_co[3];
-    BVHTreeNearest nearest;
-    nearest.index = -1;
-    nearest.dist_sq = FLT_MAX;
-    copy_v3_v3(from_co, target_verts[i].co);
-    BLI_bvhtree_find_nearest(bvhtree.tree, from_co, &nearest, bvhtree.nearest_callback, &bvhtree);
-    if (nearest.index != -1) {
-      target_mask[i] = source_mask[nearest.index];
+  const Array<int> nearest_indices = remesh_nearest_source_verts_find(target, source);
+  blender::threading::parallel_for(IndexRange(target->totvert), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      if (nearest_indices[i] != -1) {
+        target_mask[i] = source_mask[nearest_indices[i]];
+      }
     }
-  }
-  free_bvhtree_from_mesh(&bvhtree);
+  });
 }
 
 void BKE_remesh_reproject_sculpt_face_sets(Mesh *target, Mesh *source)
@@ -357,30 +396,35 @@ void BKE_remesh_reproject_sculpt_face_sets(Mesh *target, Mesh *source)
   const MLoopTri *looptri = BKE_mesh_runtime_looptri_ensure(source);
   BKE_bvhtree_from_mesh_get(&bvhtree, source, BVHTREE_FROM_LOOPTRI, 2);
 
-  for (int i = 0; i < target->totpoly; i++) {
-    float from_co[3];
-    BVHTreeNearest nearest;
-    nearest.index = -1;
-    nearest.dist_sq = FLT_MAX;
-    const MPoly *mpoly = &target_polys[i];
-    BKE_mesh_calc_poly_center(mpoly, &target_loops[mpoly->loopstart], target_verts, from_co);
-    BLI_bvhtree_find_nearest(bvhtree.tree, from_co, &nearest, bvhtree.nearest_callback, &bvhtree);
-    if (nearest.index != -1) {
-      target_face_sets[i] = source_face_sets[looptri[nearest.index].poly];
-    }
-    else {
-      target_face_sets[i] = 1;
+  blender::threading::parallel_for(IndexRange(target->totpoly), 512, [&](IndexRange range) {
+    for (const int i : range) {
+      float from_co[3];
+      BVHTreeNearest nearest;
+      nearest.index = -1;
+      nearest.dist_sq = FLT_MAX;
+      const MPoly *mpoly = &target_polys[i];
+      BKE_mesh_calc_poly_center(mpoly, &target_loops[mpoly->loopstart], target_verts, from_co);
+      BLI_bvhtree_find_nearest(
+          bvhtree.tree, from_co, &nearest, bvhtree.nearest_callback, &bvhtree);
+      if (nearest.index != -1) {
+        target_face_sets[i] = source_face_sets[looptri[nearest.index].poly];
+      }
+      else {
+        target_face_sets[i] = 1;
+      }
     }
-  }
+  });
   free_bvhtree_from_mesh(&bvhtree);
 }
 
 void BKE_remesh_reproject_vertex_paint(Mesh *target, const Mesh *source)
 {
-  BVHTreeFromMesh bvhtree = {nullptr};
-  BKE_bvhtree_from_mesh_get(&bvhtree, source, BVHTREE_FROM_VERTS, 2);
+  const int tot_color_layer = CustomData_number_of_layers(&source->vdata, CD_PROP_COLOR);
+  if (tot_color_layer == 0) {
+    return;
+  }
 
-  int tot_color_layer = CustomData_number_of_layers(&source->vdata, CD_PROP_COLOR);
+  const Array<int> nearest_indices = remesh_nearest_source_verts_find(target, source);
 
   for (int layer_n = 0; layer_n < tot_color_layer; layer_n++) {
     const char *layer_name = CustomData_get_layer_name(&source->vdata, CD_PROP_COLOR, layer_n);
@@ -389,21 +433,16 @@ void BKE_remesh_reproject_vertex_paint(Mesh *target, const Mesh *source)
 
     MPropCol *target_color = (MPropCol *)CustomData_get_layer_n(
         &target->vdata, CD_PROP_COLOR, layer_n);
-    MVert *target_verts = (MVert *)CustomData_get_layer(&target->vdata, CD_MVERT);
     const MPropCol *source_color = (const MPropCol *)CustomData_get_layer_n(
         &source->vdata, CD_PROP_COLOR, layer_n);
-    for (int i = 0; i < target->totvert; i++) {
-      BVHTreeNearest nearest;
-      nearest.index = -1;
-      nearest.dist_sq = FLT_MAX;
-      BLI_bvhtree_find_nearest(
-          bvhtree.tree, target_verts[i].co, &nearest, bvhtree.nearest_callback, &bvhtree);
-      if (nearest.index != -1) {
-        copy_v4_v4(target_color[i].color, source_color[nearest.index].color);
+    blender::threading::parallel_for(IndexRange(target->totvert), 4096, [&](IndexRange range) {
+      for (const int i : range) {
+        if (nearest_indices[i] != -1) {
+          copy_v4_v4(target_color[i].color, source_color[nearest_indices[i]].color);
+        }
       }
-    }
+    });
   }
-  free_bvhtree_from_mesh(&bvhtree);
 }
 
 struct Mesh *BKE_mesh_remesh_voxel_fix_poles(const Mesh *mesh)
@@ -0,0 +1,253 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup bke
+ *
+ * Data derived from a mesh which is computed on first access and kept in #Mesh_Runtime, so that
+ * modifiers and nodes using the same mesh don't have to compute it again.
+ *
+ * Every item remembers the #Mesh_Runtime.topology_version and #Mesh_Runtime.positions_version
+ * it was computed for. #BKE_mesh_runtime_clear_geometry increments the topology version (and
+ * frees all items), #BKE_mesh_tag_coords_changed (also called by #BKE_mesh_normals_tag_dirty)
+ * increments the positions version. Items which only depend on the topology are kept when
+ * vertices are moved.
+ *
+ * As with #BKE_mesh_runtime_looptri_ensure, returned data stays valid until the mesh is changed.
+ */
+
+#include "MEM_guardedalloc.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BLI_task.hh"
+#include "BLI_threads.h"
+
+#include "BKE_customdata.h"
+#include "BKE_mesh.h"
+#include "BKE_mesh_mapping.h"
+#include "BKE_mesh_runtime.h"
+
+namespace blender::bke {
+
+struct MeshDerivedCacheItem {
+  void *data = nullptr;
+  /** Index buffer of #MeshElemMap items. */
+  int *mem = nullptr;
+  int topology_version = -1;
+  int positions_version = -1;
+  /** Vertex array used by items which depend on positions, the layer may be replaced. */
+  const MVert *mvert = nullptr;
+
+  void free()
+  {
+    MEM_SAFE_FREE(data);
+    MEM_SAFE_FREE(mem);
+  }
+};
+
+}  // namespace blender::bke
+
+using namespace blender;
+using namespace blender::bke;
+
+struct MeshDerivedCache {
+  /**
+   * The topology arrays and sizes the items were computed for. Mesh data is sometimes replaced
+   * without calling #BKE_mesh_runtime_clear_geometry, e.g. when a referenced layer is duplicated,
+   * those items are recomputed then, to be safe.
+   */
+  const MEdge *medge = nullptr;
+  const MPoly *mpoly = nullptr;
+  const MLoop *mloop = nullptr;
+  int totvert = 0;
+  int totedge = 0;
+  int totpoly = 0;
+  int totloop = 0;
+
+  MeshDerivedCacheItem vert_to_edge;
+  MeshDerivedCacheItem vert_to_poly;
+  MeshDerivedCacheItem vert_to_loop;
+  MeshDerivedCacheItem edge_to_poly;
+  MeshDerivedCacheItem poly_normals;
+
+  void free_items()
+  {
+    vert_to_edge.free();
+    vert_to_poly.free();
+    vert_to_loop.free();
+    edge_to_poly.free();
+    poly_normals.free();
+  }
+
+  MEM_CXX_CLASS_ALLOC_FUNCS("MeshDerivedCache")
+};
+
+static bool mesh_derived_cache_topology_matches(const MeshDerivedCache &cache, const Mesh &mesh)
+{
+  return cache.medge == mesh.medge && cache.mpoly == mesh.mpoly && cache.mloop == mesh.mloop &&
+         cache.totvert == mesh.totvert && cache.totedge == mesh.totedge &&
+         cache.totpoly == mesh.totpoly && cache.totloop == mesh.totloop;
+}
+
+/**
+ * Return the data of the given item, computing it with `compute_fn` first when there is none for
+ * the current versions of the mesh.
+ */
+template<typename ComputeFn>
+static const void *mesh_derived_cache_ensure(const Mesh *mesh,
+                                             MeshDerivedCacheItem MeshDerivedCache::*item_member,
+                                             const bool depends_on_positions,
+                                             const ComputeFn &compute_fn)
+{
+  /* The cache is not part of the mesh data, so it can be changed through a const mesh. */
+  Mesh_Runtime &runtime = const_cast<Mesh_Runtime &>(mesh->runtime);
+  ThreadMutex *mesh_eval_mutex = (ThreadMutex *)runtime.eval_mutex;
+  BLI_mutex_lock(mesh_eval_mutex);
+
+  if (runtime.derived_cache == nullptr) {
+    runtime.derived_cache = new MeshDerivedCache();
+  }
+  MeshDerivedCache &cache = *runtime.derived_cache;
+  if (!mesh_derived_cache_topology_matches(cache, *mesh)) {
+    cache.free_items();
+    cache.medge = mesh->medge;
+    cache.mpoly = mesh->mpoly;
+    cache.mloop = mesh->mloop;
+    cache.totvert = mesh->totvert;
+    cache.totedge = mesh->totedge;
+    cache.totpoly = mesh->totpoly;
+    cache.totloop = mesh->totloop;
+  }
+
+  MeshDerivedCacheItem &item = cache.*item_member;
+  const int positions_version = depends_on_positions ? runtime.positions_version : -1;
+  const MVert *mvert = depends_on_positions ? mesh->mvert : nullptr;
+  if (item.data == nullptr || item.topology_version != runtime.topology_version ||
+      item.positions_version != positions_version || item.mvert != mvert) {
+    item.free();
+    /* Must isolate multithreaded tasks while holding a mutex lock. */
+    threading::isolate_task([&]() { compute_fn(item); });
+    item.topology_version = runtime.topology_version;
+    item.positions_version = positions_version;
+    item.mvert = mvert;
+  }
+
+  const void *data = item.data;
+  BLI_mutex_unlock(mesh_eval_mutex);
+  return data;
+}
+
+/**
+ * Map of the edges using each vertex, like #BKE_mesh_vert_edge_map_create.
+ */
+const MeshElemMap *BKE_mesh_runtime_vert_edge_map_ensure(const Mesh *mesh)
+{
+  return static_cast<const MeshElemMap *>(mesh_derived_cache_ensure(
+      mesh, &MeshDerivedCache::vert_to_edge, false, [&](MeshDerivedCacheItem &item) {
+        BKE_mesh_vert_edge_map_create(
+            (MeshElemMap **)&item.data, &item.mem, mesh->medge, mesh->totvert, mesh->totedge);
+      }));
+}
+
+/**
+ * Map of the polygons using each vertex, like #BKE_mesh_vert_poly_map_create.
+ */
+const MeshElemMap *BKE_mesh_runtime_vert_poly_map_ensure(const Mesh *mesh)
+{
+  return static_cast<const MeshElemMap *>(mesh_derived_cache_ensure(
+      mesh, &MeshDerivedCache::vert_to_poly, false, [&](MeshDerivedCacheItem &item) {
+        BKE_mesh_vert_poly_map_create((MeshElemMap **)&item.data,
+                                      &item.mem,
+                                      mesh->mpoly,
+                                      mesh->mloop,
+                                      mesh->totvert,
+                                      mesh->totpoly,
+                                      mesh->totloop);
+      }));
+}
+
+/**
+ * Map of the loops using each vertex, like #BKE_mesh_vert_loop_map_create.
+ */
+const MeshElemMap *BKE_mesh_runtime_vert_loop_map_ensure(const Mesh *mesh)
+{
+  return static_cast<const MeshElemMap *>(mesh_derived_cache_ensure(
+      mesh, &MeshDerivedCache::vert_to_loop, false, [&](MeshDerivedCacheItem &item) {
+        BKE_mesh_vert_loop_map_create((MeshElemMap **)&item.data,
+                                      &item.mem,
+                                      mesh->mpoly,
+                                      mesh->mloop,
+                                      mesh->totvert,
+                                      mesh->totpoly,
+                                      mesh->totloop);
+      }));
+}
+
+/**
+ * Map of the polygons using each edge, like #BKE_mesh_edge_poly_map_create.
+ */
+const MeshElemMap *BKE_mesh_runtime_edge_poly_map_ensure(const Mesh *mesh)
+{
+  return static_cast<const MeshElemMap *>(mesh_derived_cache_ensure(
+      mesh, &MeshDerivedCache::edge_to_poly, false, [&](MeshDerivedCacheItem &item) {
+        BKE_mesh_edge_poly_map_create((MeshElemMap **)&item.data,
+                                      &item.mem,
+                                      mesh->medge,
+                                      mesh->totedge,
+                                      mesh->mpoly,
+                                      mesh->totpoly,
+                                      mesh->mloop,
+                                      mesh->totloop);
+      }));
+}
+
+/**
+ * Polygon normals. The #CD_NORMAL layer is used when it exists and is up to date, otherwise the
+ * normals are computed without adding that layer to the mesh.
+ */
+const float (*BKE_mesh_runtime_poly_normals_ensure(const Mesh *mesh))[3]
+{
+  if (!(mesh->runtime.cd_dirty_poly & CD_MASK_NORMAL)) {
+    const void *data = CustomData_get_layer(&mesh->pdata, CD_NORMAL);
+    if (data != nullptr) {
+      return (const float(*)[3])data;
+    }
+  }
+  return (const float(*)[3])mesh_derived_cache_ensure(
+      mesh, &MeshDerivedCache::poly_normals, true, [&](MeshDerivedCacheItem &item) {
+        float(*poly_normals)[3] = (float(*)[3])MEM_malloc_arrayN(
+            (size_t)mesh->totpoly, sizeof(float[3]), __func__);
+        BKE_mesh_calc_normals_poly(mesh->mvert,
+                                   mesh->totvert,
+                                   mesh->mloop,
+                                   mesh->totloop,
+                                   mesh->mpoly,
+                                   mesh->totpoly,
+                                   poly_normals);
+        item.data = poly_normals;
+      });
+}
+
+void BKE_mesh_runtime_derived_cache_free(Mesh *mesh)
+{
+  if (mesh->runtime.derived_cache != nullptr) {
+    mesh->runtime.derived_cache->free_items();
+    delete mesh->runtime.derived_cache;
+    mesh->runtime.derived_cache = nullptr;
+  }
+}
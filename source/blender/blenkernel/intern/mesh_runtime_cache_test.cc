@@ -0,0 +1,124 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BKE_customdata.h"
+#include "BKE_mesh.h"
+#include "BKE_mesh_mapping.h"
+#include "BKE_mesh_runtime.h"
+
+#include "BLI_float3.hh"
+#include "BLI_index_range.hh"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+namespace blender::bke::tests {
+
+/** A quad and a triangle sharing the edge between vertices 1 and 2. */
+struct MeshRuntimeCacheTestContext {
+  MVert verts[5] = {{{0, 0, 0}}, {{1, 0, 0}}, {{1, 1, 0}}, {{0, 1, 0}}, {{2, 0, 0}}};
+  MEdge edges[6] = {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {1, 4}, {4, 2}};
+  MLoop loops[7] = {{0, 0}, {1, 1}, {2, 2}, {3, 3}, {1, 4}, {4, 5}, {2, 1}};
+  MPoly polys[2] = {{0, 4}, {4, 3}};
+  Mesh mesh = {};
+
+  MeshRuntimeCacheTestContext()
+  {
+    CustomData_reset(&mesh.vdata);
+    CustomData_reset(&mesh.edata);
+    CustomData_reset(&mesh.ldata);
+    CustomData_reset(&mesh.pdata);
+    BKE_mesh_runtime_reset(&mesh);
+    mesh.mvert = verts;
+    mesh.medge = edges;
+    mesh.mloop = loops;
+    mesh.mpoly = polys;
+    mesh.totvert = 5;
+    mesh.totedge = 6;
+    mesh.totloop = 7;
+    mesh.totpoly = 2;
+    BKE_mesh_normals_tag_dirty(&mesh);
+  }
+
+  ~MeshRuntimeCacheTestContext()
+  {
+    BKE_mesh_runtime_clear_cache(&mesh);
+  }
+};
+
+TEST(mesh_runtime_cache, topology_maps)
+{
+  MeshRuntimeCacheTestContext ctx;
+  const MeshElemMap *edge_to_poly = BKE_mesh_runtime_edge_poly_map_ensure(&ctx.mesh);
+  EXPECT_EQ(edge_to_poly[1].count, 2);
+  EXPECT_EQ(edge_to_poly[0].count, 1);
+  const MeshElemMap *vert_to_edge = BKE_mesh_runtime_vert_edge_map_ensure(&ctx.mesh);
+  EXPECT_EQ(vert_to_edge[1].count, 3);
+  EXPECT_EQ(BKE_mesh_runtime_vert_poly_map_ensure(&ctx.mesh)[2].count, 2);
+  EXPECT_EQ(BKE_mesh_runtime_vert_loop_map_ensure(&ctx.mesh)[4].count, 1);
+
+  /* Maps are reused, also after the vertices moved. */
+  EXPECT_EQ(BKE_mesh_runtime_edge_poly_map_ensure(&ctx.mesh), edge_to_poly);
+  ctx.verts[4].co[2] = 1.0f;
+  BKE_mesh_normals_tag_dirty(&ctx.mesh);
+  EXPECT_EQ(BKE_mesh_runtime_edge_poly_map_ensure(&ctx.mesh), edge_to_poly);
+  EXPECT_EQ(BKE_mesh_runtime_vert_edge_map_ensure(&ctx.mesh), vert_to_edge);
+
+  /* Changing the topology recomputes them. */
+  ctx.mesh.totpoly = 1;
+  ctx.mesh.totloop = 4;
+  BKE_mesh_runtime_clear_geometry(&ctx.mesh);
+  edge_to_poly = BKE_mesh_runtime_edge_poly_map_ensure(&ctx.mesh);
+  EXPECT_EQ(edge_to_poly[1].count, 1);
+  EXPECT_EQ(edge_to_poly[4].count, 0);
+}
+
+TEST(mesh_runtime_cache, poly_normals)
+{
+  MeshRuntimeCacheTestContext ctx;
+  const float(*poly_normals)[3] = BKE_mesh_runtime_poly_normals_ensure(&ctx.mesh);
+  EXPECT_V3_NEAR(poly_normals[1], float3(0.0f, 0.0f, 1.0f), 1e-6f);
+  EXPECT_EQ(BKE_mesh_runtime_poly_normals_ensure(&ctx.mesh), poly_normals);
+
+  /* Moving vertices recomputes the normals. */
+  ctx.verts[4].co[2] = 1.0f;
+  BKE_mesh_normals_tag_dirty(&ctx.mesh);
+  poly_normals = BKE_mesh_runtime_poly_normals_ensure(&ctx.mesh);
+  EXPECT_LT(poly_normals[1][2], 0.9f);
+  EXPECT_V3_NEAR(poly_normals[0], float3(0.0f, 0.0f, 1.0f), 1e-6f);
+
+  /* Also when only the positions are tagged changed. */
+  ctx.verts[4].co[2] = 0.0f;
+  BKE_mesh_tag_coords_changed(&ctx.mesh);
+  poly_normals = BKE_mesh_runtime_poly_normals_ensure(&ctx.mesh);
+  EXPECT_V3_NEAR(poly_normals[1], float3(0.0f, 0.0f, 1.0f), 1e-6f);
+
+  /* And when the vertex array is replaced, here by one rotated into the XZ plane. */
+  MVert rotated_verts[5];
+  for (const int i : IndexRange(5)) {
+    rotated_verts[i] = ctx.verts[i];
+    rotated_verts[i].co[1] = 0.0f;
+    rotated_verts[i].co[2] = ctx.verts[i].co[1];
+  }
+  ctx.mesh.mvert = rotated_verts;
+  poly_normals = BKE_mesh_runtime_poly_normals_ensure(&ctx.mesh);
+  EXPECT_V3_NEAR(poly_normals[0], float3(0.0f, -1.0f, 0.0f), 1e-6f);
+}
+
+}  // namespace blender::bke::tests
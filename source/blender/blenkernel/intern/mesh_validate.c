@@ -1088,21 +1088,25 @@ bool BKE_mesh_validate(Mesh *me, const bool do_verbose, const bool cddata_check_
                                                true,
                                                &changed);
 
-  is_valid &= BKE_mesh_validate_arrays(me,
-                                       me->mvert,
-                                       me->totvert,
-                                       me->medge,
-                                       me->totedge,
-                                       me->mface,
-                                       me->totface,
-                                       me->mloop,
-                                       me->totloop,
-                                       me->mpoly,
-                                       me->totpoly,
-                                       me->dvert,
-                                       do_verbose,
-                                       true,
-                                       &changed);
+  /* Most meshes are valid, checking that is much faster than running the full validation.
+   * Not done when verbose, to keep reporting the mesh statistics. */
+  if (do_verbose || !BKE_mesh_validate_structure(me)) {
+    is_valid &= BKE_mesh_validate_arrays(me,
+                                         me->mvert,
+                                         me->totvert,
+                                         me->medge,
+                                         me->totedge,
+                                         me->mface,
+                                         me->totface,
+                                         me->mloop,
+                                         me->totloop,
+                                         me->mpoly,
+                                         me->totpoly,
+                                         me->dvert,
+                                         do_verbose,
+                                         true,
+                                         &changed);
+  }
 
   if (changed) {
     DEG_id_tag_update(&me->id, ID_RECALC_GEOMETRY_ALL_MODES);
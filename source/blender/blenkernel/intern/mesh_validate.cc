@@ -18,6 +18,10 @@
  * \ingroup bke
  */
 
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
@@ -28,6 +32,7 @@
 #include "BLI_task.hh"
 #include "BLI_threads.h"
 #include "BLI_timeit.hh"
+#include "BLI_vector.hh"
 
 #include "BKE_customdata.h"
 #include "BKE_mesh.h"
@@ -266,3 +271,315 @@ void BKE_mesh_calc_edges(Mesh *mesh, bool keep_existing_edges, const bool select
   /* Explicitly clear edge maps, because that way it can be parallelized. */
   clear_hash_tables(edge_maps);
 }
+
+/* -------------------------------------------------------------------- */
+/** \name Mesh Structure Check
+ *
+ * Check the invariants repaired by #BKE_mesh_validate_arrays without changing anything, so that
+ * valid meshes (the common case for importers) don't have to go through the much slower
+ * validation and repair code. All checks are done in parallel.
+ * \{ */
+
+namespace blender::bke::validate_structure {
+
+/** Return true when `fn` returns true for all indices in the range. */
+template<typename Fn>
+static bool all_of_parallel(const IndexRange range, const int64_t grain_size, const Fn &fn)
+{
+  return threading::parallel_reduce(
+      range,
+      grain_size,
+      true,
+      [&](const IndexRange sub_range, const bool is_valid) {
+        if (!is_valid) {
+          return false;
+        }
+        for (const int64_t i : sub_range) {
+          if (!fn(i)) {
+            return false;
+          }
+        }
+        return true;
+      },
+      [](const bool a, const bool b) { return a && b; });
+}
+
+static bool verts_are_valid(const Span<MVert> verts)
+{
+  return all_of_parallel(verts.index_range(), 4096, [&](const int64_t i) {
+    const MVert &mv = verts[i];
+    if (!(std::isfinite(mv.co[0]) && std::isfinite(mv.co[1]) && std::isfinite(mv.co[2]))) {
+      return false;
+    }
+    /* Zero normals are only expected for vertices at the origin. */
+    if (mv.no[0] == 0 && mv.no[1] == 0 && mv.no[2] == 0) {
+      return mv.co[0] == 0.0f && mv.co[1] == 0.0f && mv.co[2] == 0.0f;
+    }
+    return true;
+  });
+}
+
+/**
+ * Sort the indices of the given keys by their key (with a counting sort, since the keys are
+ * vertex indices), so that the indices with the same key can be compared with each other.
+ * `r_offsets[key]` is the start of the indices with that key in `r_indices`.
+ */
+static void group_indices_by_key(const Span<int> keys,
+                                 const int keys_num,
+                                 Array<int> &r_offsets,
+                                 Array<int> &r_indices)
+{
+  r_offsets.reinitialize(keys_num + 1);
+  r_offsets.fill(0);
+  for (const int key : keys) {
+    r_offsets[key + 1]++;
+  }
+  for (const int i : IndexRange(keys_num)) {
+    r_offsets[i + 1] += r_offsets[i];
+  }
+  Array<int> fill(keys_num, 0);
+  r_indices.reinitialize(keys.size());
+  for (const int i : keys.index_range()) {
+    const int key = keys[i];
+    r_indices[r_offsets[key] + fill[key]++] = i;
+  }
+}
+
+static bool edges_are_valid(const Span<MEdge> edges, const uint totvert)
+{
+  Array<int> edge_low_verts(edges.size());
+  const bool edges_valid = all_of_parallel(edges.index_range(), 4096, [&](const int64_t i) {
+    const MEdge &me = edges[i];
+    edge_low_verts[i] = int(std::min(me.v1, me.v2));
+    return me.v1 != me.v2 && me.v1 < totvert && me.v2 < totvert;
+  });
+  if (!edges_valid) {
+    return false;
+  }
+
+  /* Duplicate edges have the same lower vertex, compare the few edges sharing it. */
+  Array<int> offsets;
+  Array<int> edge_indices;
+  group_indices_by_key(edge_low_verts, int(totvert), offsets, edge_indices);
+  return all_of_parallel(IndexRange(totvert), 4096, [&](const int64_t v) {
+    const Span<int> vert_edges = edge_indices.as_span().slice(offsets[v],
+                                                              offsets[v + 1] - offsets[v]);
+    for (const int i : vert_edges.index_range()) {
+      const MEdge &me_a = edges[vert_edges[i]];
+      for (int64_t j = i + 1; j < vert_edges.size(); j++) {
+        const MEdge &me_b = edges[vert_edges[j]];
+        if (std::max(me_a.v1, me_a.v2) == std::max(me_b.v1, me_b.v2)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  });
+}
+
+static bool dverts_are_valid(const Span<MDeformVert> dverts)
+{
+  return all_of_parallel(dverts.index_range(), 4096, [&](const int64_t i) {
+    for (const MDeformWeight &dw : Span(dverts[i].dw, dverts[i].totweight)) {
+      if (!(dw.weight >= 0.0f && dw.weight <= 1.0f) || dw.def_nr >= INT_MAX) {
+        return false;
+      }
+    }
+    return true;
+  });
+}
+
+/**
+ * Check the loops of every polygon, and compute a hash of its (sorted) vertices and its lowest
+ * vertex index, used to find polygons using the same vertices afterwards.
+ */
+static bool polys_are_valid(const Span<MPoly> polys,
+                            const Span<MLoop> loops,
+                            const Span<MEdge> edges,
+                            const uint totvert,
+                            MutableSpan<uint64_t> r_poly_hashes,
+                            MutableSpan<int> r_poly_low_verts)
+{
+  return all_of_parallel(polys.index_range(), 1024, [&](const int64_t i) {
+    const MPoly &mp = polys[i];
+    if (mp.mat_nr < 0 || mp.loopstart < 0 || mp.totloop < 3 ||
+        int64_t(mp.loopstart) + mp.totloop > loops.size()) {
+      return false;
+    }
+
+    const Span<MLoop> poly_loops = loops.slice(mp.loopstart, mp.totloop);
+    Vector<uint, 16> poly_verts;
+    for (const int j : poly_loops.index_range()) {
+      const uint v1 = poly_loops[j].v;
+      const uint v2 = poly_loops[(j + 1) % mp.totloop].v;
+      const uint e = poly_loops[j].e;
+      if (v1 >= totvert || e >= uint(edges.size())) {
+        return false;
+      }
+      const MEdge &me = edges[e];
+      if (!((me.v1 == v1 && me.v2 == v2) || (me.v1 == v2 && me.v2 == v1))) {
+        return false;
+      }
+      poly_verts.append(v1);
+    }
+
+    std::sort(poly_verts.begin(), poly_verts.end());
+    if (std::adjacent_find(poly_verts.begin(), poly_verts.end()) != poly_verts.end()) {
+      return false;
+    }
+
+    uint64_t hash = uint64_t(mp.totloop);
+    for (const uint v : poly_verts) {
+      hash = hash * 0x100000001b3ULL ^ v;
+    }
+    r_poly_hashes[i] = hash;
+    r_poly_low_verts[i] = int(poly_verts.first());
+    return true;
+  });
+}
+
+static void poly_verts_sorted(const MPoly &mp, const Span<MLoop> loops, Vector<uint, 16> &r_verts)
+{
+  r_verts.clear();
+  for (const MLoop &ml : loops.slice(mp.loopstart, mp.totloop)) {
+    r_verts.append(ml.v);
+  }
+  std::sort(r_verts.begin(), r_verts.end());
+}
+
+/** Check that no two polygons use the same set of vertices. */
+static bool polys_are_unique(const Span<MPoly> polys,
+                             const Span<MLoop> loops,
+                             const Span<uint64_t> poly_hashes,
+                             const Span<int> poly_low_verts,
+                             const int totvert)
+{
+  /* Polygons using the same vertices have the same lowest vertex, only compare those. */
+  Array<int> offsets;
+  Array<int> poly_indices;
+  group_indices_by_key(poly_low_verts, totvert, offsets, poly_indices);
+  return all_of_parallel(IndexRange(totvert), 4096, [&](const int64_t v) {
+    const Span<int> vert_polys = poly_indices.as_span().slice(offsets[v],
+                                                              offsets[v + 1] - offsets[v]);
+    for (const int i : vert_polys.index_range()) {
+      const int a = vert_polys[i];
+      for (int64_t j = i + 1; j < vert_polys.size(); j++) {
+        const int b = vert_polys[j];
+        /* Only compare the vertices when the hashes match, collisions are rare. */
+        if (poly_hashes[a] != poly_hashes[b] || polys[a].totloop != polys[b].totloop) {
+          continue;
+        }
+        Vector<uint, 16> verts_a;
+        Vector<uint, 16> verts_b;
+        poly_verts_sorted(polys[a], loops, verts_a);
+        poly_verts_sorted(polys[b], loops, verts_b);
+        if (verts_a.as_span() == verts_b.as_span()) {
+          return false;
+        }
+      }
+    }
+    return true;
+  });
+}
+
+/** Check that every loop is used by exactly one polygon. */
+static bool loops_are_used_once(const Span<MPoly> polys, const int totloop)
+{
+  /* Polygons are usually stored in the order of their loops already. */
+  const bool is_sorted = all_of_parallel(
+      IndexRange(std::max<int64_t>(polys.size() - 1, 0)), 4096, [&](const int64_t i) {
+        return polys[i].loopstart < polys[i + 1].loopstart;
+      });
+
+  Array<int> order(polys.size());
+  for (const int i : order.index_range()) {
+    order[i] = i;
+  }
+  if (!is_sorted) {
+    threading::parallel_sort(order.begin(), order.end(), [&](const int a, const int b) {
+      return polys[a].loopstart < polys[b].loopstart;
+    });
+  }
+
+  int loop_end = 0;
+  for (const int i : order) {
+    if (polys[i].loopstart != loop_end) {
+      return false;
+    }
+    loop_end += polys[i].totloop;
+  }
+  return loop_end == totloop;
+}
+
+static bool select_history_is_valid(const Mesh &mesh)
+{
+  for (const MSelect &msel : Span(mesh.mselect, mesh.mselect ? mesh.totselect : 0)) {
+    int tot_elem = 0;
+    switch (msel.type) {
+      case ME_VSEL:
+        tot_elem = mesh.totvert;
+        break;
+      case ME_ESEL:
+        tot_elem = mesh.totedge;
+        break;
+      case ME_FSEL:
+        tot_elem = mesh.totpoly;
+        break;
+    }
+    if (msel.index < 0 || msel.index > tot_elem) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace blender::bke::validate_structure
+
+/**
+ * Check that the mesh is valid, without printing or fixing anything.
+ *
+ * This checks the same invariants as #BKE_mesh_validate_arrays, but only reports whether the
+ * mesh is valid, which is much faster. Meshes which only have legacy #MFace data are not checked
+ * and reported as invalid. Custom data layers are not checked, see
+ * #BKE_mesh_validate_all_customdata.
+ *
+ * \return true when #BKE_mesh_validate_arrays would not find anything to report or fix.
+ */
+bool BKE_mesh_validate_structure(const Mesh *mesh)
+{
+  using namespace blender;
+  using namespace blender::bke::validate_structure;
+
+  if (mesh->mface && !mesh->mpoly) {
+    return false;
+  }
+
+  const uint totvert = uint(mesh->totvert);
+  const Span<MVert> verts(mesh->mvert, mesh->totvert);
+  const Span<MEdge> edges(mesh->medge, mesh->totedge);
+  const Span<MLoop> loops(mesh->mloop, mesh->totloop);
+  const Span<MPoly> polys(mesh->mpoly, mesh->totpoly);
+
+  if (!verts_are_valid(verts) || !edges_are_valid(edges, totvert)) {
+    return false;
+  }
+  if (mesh->dvert && !dverts_are_valid(Span(mesh->dvert, mesh->totvert))) {
+    return false;
+  }
+
+  Array<uint64_t> poly_hashes(polys.size());
+  Array<int> poly_low_verts(polys.size());
+  if (!polys_are_valid(polys, loops, edges, totvert, poly_hashes, poly_low_verts)) {
+    return false;
+  }
+  if (!loops_are_used_once(polys, mesh->totloop)) {
+    return false;
+  }
+  if (!polys_are_unique(polys, loops, poly_hashes, poly_low_verts, mesh->totvert)) {
+    return false;
+  }
+
+  return select_history_is_valid(*mesh);
+}
+
+/** \} */
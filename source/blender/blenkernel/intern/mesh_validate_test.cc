@@ -0,0 +1,196 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BKE_mesh.h"
+
+#include "BLI_array.hh"
+#include "BLI_math.h"
+#include "BLI_timeit.hh"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+namespace blender::bke::tests {
+
+/** Grid of quads, with the arrays owned by the test instead of custom data layers. */
+struct ValidateTestMesh {
+  Array<MVert> verts;
+  Array<MEdge> edges;
+  Array<MLoop> loops;
+  Array<MPoly> polys;
+  Mesh mesh = {};
+
+  ValidateTestMesh(const int size)
+      : verts((size + 1) * (size + 1)),
+        edges(2 * size * (size + 1)),
+        loops(4 * size * size),
+        polys(size * size)
+  {
+    const int row = size + 1;
+    for (const int y : IndexRange(row)) {
+      for (const int x : IndexRange(row)) {
+        MVert &mv = verts[y * row + x];
+        copy_v3_fl3(mv.co, float(x), float(y), 0.0f);
+        mv.no[0] = 0;
+        mv.no[1] = 0;
+        mv.no[2] = SHRT_MAX;
+        mv.flag = 0;
+        mv.bweight = 0;
+      }
+    }
+
+    /* Edges along x first, then edges along y. */
+    const int x_edges_num = size * row;
+    for (const int y : IndexRange(row)) {
+      for (const int x : IndexRange(size)) {
+        edges[y * size + x] = {uint(y * row + x), uint(y * row + x + 1)};
+      }
+    }
+    for (const int y : IndexRange(size)) {
+      for (const int x : IndexRange(row)) {
+        edges[x_edges_num + y * row + x] = {uint(y * row + x), uint((y + 1) * row + x)};
+      }
+    }
+
+    for (const int y : IndexRange(size)) {
+      for (const int x : IndexRange(size)) {
+        const int poly_index = y * size + x;
+        MPoly &mp = polys[poly_index];
+        mp = {};
+        mp.loopstart = poly_index * 4;
+        mp.totloop = 4;
+
+        MLoop *ml = &loops[mp.loopstart];
+        ml[0] = {uint(y * row + x), uint(y * size + x)};
+        ml[1] = {uint(y * row + x + 1), uint(x_edges_num + y * row + x + 1)};
+        ml[2] = {uint((y + 1) * row + x + 1), uint((y + 1) * size + x)};
+        ml[3] = {uint((y + 1) * row + x), uint(x_edges_num + y * row + x)};
+      }
+    }
+
+    mesh.mvert = verts.data();
+    mesh.medge = edges.data();
+    mesh.mloop = loops.data();
+    mesh.mpoly = polys.data();
+    mesh.totvert = verts.size();
+    mesh.totedge = edges.size();
+    mesh.totloop = loops.size();
+    mesh.totpoly = polys.size();
+  }
+
+  /** Run the full validation, without fixing anything. */
+  bool validate_arrays()
+  {
+    bool changed;
+    return BKE_mesh_validate_arrays(&mesh,
+                                    verts.data(),
+                                    verts.size(),
+                                    edges.data(),
+                                    edges.size(),
+                                    nullptr,
+                                    0,
+                                    loops.data(),
+                                    loops.size(),
+                                    polys.data(),
+                                    polys.size(),
+                                    nullptr,
+                                    false,
+                                    false,
+                                    &changed);
+  }
+};
+
+TEST(mesh_validate, structure_valid)
+{
+  ValidateTestMesh test_mesh(10);
+  EXPECT_TRUE(test_mesh.validate_arrays());
+  EXPECT_TRUE(BKE_mesh_validate_structure(&test_mesh.mesh));
+
+  /* Polygons don't have to be stored in the order of their loops. */
+  std::swap(test_mesh.polys[3], test_mesh.polys[50]);
+  EXPECT_TRUE(test_mesh.validate_arrays());
+  EXPECT_TRUE(BKE_mesh_validate_structure(&test_mesh.mesh));
+}
+
+TEST(mesh_validate, structure_duplicate_edge)
+{
+  ValidateTestMesh test_mesh(10);
+  std::swap(test_mesh.edges[7].v1, test_mesh.edges[7].v2);
+  test_mesh.edges[8] = test_mesh.edges[7];
+  EXPECT_FALSE(test_mesh.validate_arrays());
+  EXPECT_FALSE(BKE_mesh_validate_structure(&test_mesh.mesh));
+}
+
+TEST(mesh_validate, structure_wrong_loop_edge)
+{
+  ValidateTestMesh test_mesh(10);
+  test_mesh.loops[21].e = test_mesh.loops[22].e;
+  EXPECT_FALSE(test_mesh.validate_arrays());
+  EXPECT_FALSE(BKE_mesh_validate_structure(&test_mesh.mesh));
+}
+
+TEST(mesh_validate, structure_duplicate_poly)
+{
+  ValidateTestMesh test_mesh(10);
+  /* Same vertices as the first polygon, in a different order and with its own loops. */
+  MLoop *ml_a = &test_mesh.loops[test_mesh.polys[0].loopstart];
+  MLoop *ml_b = &test_mesh.loops[test_mesh.polys[1].loopstart];
+  for (const int i : IndexRange(4)) {
+    ml_b[i] = ml_a[(i + 2) % 4];
+  }
+  EXPECT_FALSE(test_mesh.validate_arrays());
+  EXPECT_FALSE(BKE_mesh_validate_structure(&test_mesh.mesh));
+}
+
+TEST(mesh_validate, structure_shared_and_unused_loops)
+{
+  ValidateTestMesh test_mesh(10);
+  test_mesh.polys[5].loopstart = test_mesh.polys[4].loopstart;
+  test_mesh.polys[5].totloop = test_mesh.polys[4].totloop;
+  EXPECT_FALSE(test_mesh.validate_arrays());
+  EXPECT_FALSE(BKE_mesh_validate_structure(&test_mesh.mesh));
+}
+
+TEST(mesh_validate, structure_invalid_coordinate)
+{
+  ValidateTestMesh test_mesh(10);
+  test_mesh.verts[12].co[1] = NAN;
+  EXPECT_FALSE(test_mesh.validate_arrays());
+  EXPECT_FALSE(BKE_mesh_validate_structure(&test_mesh.mesh));
+}
+
+/**
+ * Set this to 1 to activate the benchmark, with 4 million polygons.
+ */
+#if 0
+TEST(mesh_validate_performance, structure_4M)
+{
+  ValidateTestMesh test_mesh(2000);
+  {
+    SCOPED_TIMER("validate arrays");
+    EXPECT_TRUE(test_mesh.validate_arrays());
+  }
+  {
+    SCOPED_TIMER("validate structure");
+    EXPECT_TRUE(BKE_mesh_validate_structure(&test_mesh.mesh));
+  }
+}
+#endif
+
+}  // namespace blender::bke::tests
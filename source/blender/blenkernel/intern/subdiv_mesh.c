@@ -30,7 +30,9 @@
 #include "DNA_meshdata_types.h"
 
 #include "BLI_alloca.h"
+#include "BLI_math_base.h"
 #include "BLI_math_vector.h"
+#include "BLI_task.h"
 
 #include "BKE_customdata.h"
 #include "BKE_key.h"
@@ -41,6 +43,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "opensubdiv_capi_type.h"
+
 /* -------------------------------------------------------------------- */
 /** \name Subdivision Context
  * \{ */
@@ -76,8 +80,97 @@ typedef struct SubdivMeshContext {
    * when it's not possible is when displacement is used. */
   bool can_evaluate_normals;
   bool have_displacement;
+  /* Limit surface evaluation of vertices is deferred until the traversal is done, so it can be
+   * done in batches. The flags tell what is to be evaluated for every subdivided vertex, and
+   * the patch coordinates where. */
+  char *vertex_eval_flags;
+  OpenSubdiv_PatchCoord *vertex_patch_coords;
+  /* Topology cache which is filled by the traversal, or which the mesh is created from, see
+   * #SubdivMeshCache. */
+  struct SubdivMeshCache *cache;
+  /* Samples of the normals averaging along coarse edges and corners, recorded when the
+   * topology cache is being filled, so normals can be re-evaluated without traversal. */
+  int num_boundary_samples;
+  int boundary_samples_capacity;
+  OpenSubdiv_PatchCoord *boundary_patch_coords;
+  int *boundary_vertex_indices;
 } SubdivMeshContext;
 
+/* Coarse element which the custom data of a subdivided vertex comes from. */
+typedef struct SubdivMeshVertexSource {
+  /* One of SUBDIV_MESH_VERTEX_*. */
+  char type;
+  /* Coarse vertex for corner vertices, coarse polygon otherwise. */
+  int coarse_index;
+  int coarse_corner;
+} SubdivMeshVertexSource;
+
+/* SubdivMeshVertexSource.type */
+enum {
+  /* Not created from a coarse polygon, like loose geometry. */
+  SUBDIV_MESH_VERTEX_NONE = 0,
+  SUBDIV_MESH_VERTEX_CORNER,
+  SUBDIV_MESH_VERTEX_EDGE,
+  SUBDIV_MESH_VERTEX_INNER,
+};
+
+/* Coarse polygon corner which the custom data of a subdivided loop is interpolated from. */
+typedef struct SubdivMeshLoopSource {
+  int coarse_poly;
+  int coarse_corner;
+  OpenSubdiv_PatchCoord patch_coord;
+} SubdivMeshLoopSource;
+
+/**
+ * Subdivided topology, along with the coarse element and patch coordinate every subdivided
+ * element is created from. This is all that depends on the coarse topology and settings, so
+ * when only coarse vertex positions or custom data change the mesh is created from the cache:
+ * custom data is interpolated from the current coarse mesh and positions are evaluated from
+ * the limit surface, without the traversal.
+ */
+typedef struct SubdivMeshCache {
+  /* Key: the settings and the coarse topology the cache was created for. */
+  SubdivSettings subdiv_settings;
+  SubdivToMeshSettings settings;
+  int coarse_totvert;
+  int coarse_totedge;
+  int coarse_totloop;
+  int coarse_totpoly;
+  int (*coarse_edges)[2];
+  int (*coarse_loops)[2];
+  int (*coarse_polys)[2];
+  /* Subdivided topology, filled by a traversal. Vertices of edges, vertex and edge of loops,
+   * loop start and number of loops of polygons. */
+  bool is_filled;
+  int totvert;
+  int totedge;
+  int totloop;
+  int totpoly;
+  int (*edges)[2];
+  int (*loops)[2];
+  int (*polys)[2];
+  /* Coarse element of every subdivided element, ORIGINDEX_NONE for inner edges. */
+  SubdivMeshVertexSource *vertex_sources;
+  int *edge_sources;
+  SubdivMeshLoopSource *loop_sources;
+  int *poly_sources;
+  /* Per-vertex limit surface evaluation, see #SubdivMeshContext. */
+  char *vertex_eval_flags;
+  OpenSubdiv_PatchCoord *vertex_patch_coords;
+  /* Normals averaging along coarse edges and corners, NULL if normals are not evaluated. */
+  int num_boundary_samples;
+  OpenSubdiv_PatchCoord *boundary_patch_coords;
+  int *boundary_vertex_indices;
+} SubdivMeshCache;
+
+/* SubdivMeshContext.vertex_eval_flags */
+enum {
+  /* Add the limit surface position to the vertex coordinate. */
+  SUBDIV_VERTEX_EVAL_POSITION = (1 << 0),
+  /* Set the vertex normal from the limit surface derivatives. */
+  SUBDIV_VERTEX_EVAL_NORMAL = (1 << 1),
+};
+
 static void subdiv_mesh_ctx_cache_uv_layers(SubdivMeshContext *ctx)
 {
   Mesh *subdiv_mesh = ctx->subdiv_mesh;
@@ -113,10 +206,22 @@ static void subdiv_mesh_prepare_accumulator(SubdivMeshContext *ctx, int num_vert
       sizeof(*ctx->accumulated_counters), num_vertices, "subdiv accumulated counters");
 }
 
+static void subdiv_mesh_prepare_deferred_evaluation(SubdivMeshContext *ctx, int num_vertices)
+{
+  ctx->vertex_eval_flags = MEM_calloc_arrayN(
+      sizeof(*ctx->vertex_eval_flags), num_vertices, "subdiv vertex eval flags");
+  ctx->vertex_patch_coords = MEM_malloc_arrayN(
+      sizeof(*ctx->vertex_patch_coords), num_vertices, "subdiv vertex patch coords");
+}
+
 static void subdiv_mesh_context_free(SubdivMeshContext *ctx)
 {
   MEM_SAFE_FREE(ctx->accumulated_normals);
   MEM_SAFE_FREE(ctx->accumulated_counters);
+  MEM_SAFE_FREE(ctx->vertex_eval_flags);
+  MEM_SAFE_FREE(ctx->vertex_patch_coords);
+  MEM_SAFE_FREE(ctx->boundary_patch_coords);
+  MEM_SAFE_FREE(ctx->boundary_vertex_indices);
 }
 
 /** \} */
@@ -454,27 +559,128 @@ static void subdiv_mesh_tls_free(void *tls_v)
 /** \name Evaluation helper functions
  * \{ */
 
-static void eval_final_point_and_vertex_normal(Subdiv *subdiv,
-                                               const int ptex_face_index,
-                                               const float u,
-                                               const float v,
-                                               float r_P[3],
-                                               short r_N[3])
+/* Schedule evaluation of the limit surface for the given vertex, which happens in
+ * #subdiv_mesh_evaluate_deferred_vertices. */
+static void subdiv_mesh_defer_vertex_evaluation(const SubdivMeshContext *ctx,
+                                                const int subdiv_vertex_index,
+                                                const int ptex_face_index,
+                                                const float u,
+                                                const float v,
+                                                const char eval_flags)
 {
-  if (subdiv->displacement_evaluator == NULL) {
-    BKE_subdiv_eval_limit_point_and_short_normal(subdiv, ptex_face_index, u, v, r_P, r_N);
+  OpenSubdiv_PatchCoord *patch_coord = &ctx->vertex_patch_coords[subdiv_vertex_index];
+  patch_coord->ptex_face = ptex_face_index;
+  patch_coord->u = u;
+  patch_coord->v = v;
+  ctx->vertex_eval_flags[subdiv_vertex_index] = eval_flags;
+}
+
+/* Number of vertices evaluated at once. */
+#define SUBDIV_MESH_EVAL_BATCH_SIZE 1024
+
+typedef struct SubdivMeshEvalBatch {
+  OpenSubdiv_PatchCoord patch_coords[SUBDIV_MESH_EVAL_BATCH_SIZE];
+  int vertex_indices[SUBDIV_MESH_EVAL_BATCH_SIZE];
+  float P[SUBDIV_MESH_EVAL_BATCH_SIZE][3];
+  float dPdu[SUBDIV_MESH_EVAL_BATCH_SIZE][3];
+  float dPdv[SUBDIV_MESH_EVAL_BATCH_SIZE][3];
+} SubdivMeshEvalBatch;
+
+static void subdiv_mesh_evaluate_deferred_vertices_task(void *__restrict userdata,
+                                                        const int batch_index,
+                                                        const TaskParallelTLS *__restrict tls)
+{
+  SubdivMeshContext *ctx = userdata;
+  SubdivMeshEvalBatch *batch = tls->userdata_chunk;
+  MVert *subdiv_mvert = ctx->subdiv_mesh->mvert;
+  const int start_vertex_index = batch_index * SUBDIV_MESH_EVAL_BATCH_SIZE;
+  const int end_vertex_index = min_ii(start_vertex_index + SUBDIV_MESH_EVAL_BATCH_SIZE,
+                                      ctx->subdiv_mesh->totvert);
+  /* Gather patch coordinates of the vertices which need to be evaluated. */
+  int num_patch_coords = 0;
+  bool need_derivatives = false;
+  for (int vertex_index = start_vertex_index; vertex_index < end_vertex_index; vertex_index++) {
+    const char eval_flags = ctx->vertex_eval_flags[vertex_index];
+    if (eval_flags == 0) {
+      continue;
+    }
+    batch->patch_coords[num_patch_coords] = ctx->vertex_patch_coords[vertex_index];
+    batch->vertex_indices[num_patch_coords] = vertex_index;
+    need_derivatives |= (eval_flags & SUBDIV_VERTEX_EVAL_NORMAL) != 0;
+    num_patch_coords++;
   }
-  else {
-    BKE_subdiv_eval_final_point(subdiv, ptex_face_index, u, v, r_P);
+  if (num_patch_coords == 0) {
+    return;
+  }
+  BKE_subdiv_eval_limit_points_and_derivatives(ctx->subdiv,
+                                               batch->patch_coords,
+                                               num_patch_coords,
+                                               batch->P,
+                                               need_derivatives ? batch->dPdu : NULL,
+                                               need_derivatives ? batch->dPdv : NULL);
+  /* Scatter results to the subdivided vertices. */
+  for (int i = 0; i < num_patch_coords; i++) {
+    const int vertex_index = batch->vertex_indices[i];
+    MVert *subdiv_vert = &subdiv_mvert[vertex_index];
+    add_v3_v3(subdiv_vert->co, batch->P[i]);
+    if (ctx->vertex_eval_flags[vertex_index] & SUBDIV_VERTEX_EVAL_NORMAL) {
+      float N[3];
+      cross_v3_v3v3(N, batch->dPdu[i], batch->dPdv[i]);
+      normalize_v3(N);
+      normal_float_to_short_v3(subdiv_vert->no, N);
+    }
   }
 }
 
+/* Evaluate limit surface for all vertices which were deferred during the traversal. */
+static void subdiv_mesh_evaluate_deferred_vertices(SubdivMeshContext *ctx)
+{
+  const int num_batches = divide_ceil_u(ctx->subdiv_mesh->totvert, SUBDIV_MESH_EVAL_BATCH_SIZE);
+  /* The batch is only used as storage, no need to initialize it. */
+  SubdivMeshEvalBatch *batch = MEM_mallocN(sizeof(*batch), __func__);
+  TaskParallelSettings parallel_range_settings;
+  BLI_parallel_range_settings_defaults(&parallel_range_settings);
+  parallel_range_settings.userdata_chunk = batch;
+  parallel_range_settings.userdata_chunk_size = sizeof(*batch);
+  parallel_range_settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0,
+                          num_batches,
+                          ctx,
+                          subdiv_mesh_evaluate_deferred_vertices_task,
+                          &parallel_range_settings);
+  MEM_freeN(batch);
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
 /** \name Accumulation helpers
  * \{ */
 
+static void subdiv_mesh_record_boundary_sample(SubdivMeshContext *ctx,
+                                               const int ptex_face_index,
+                                               const float u,
+                                               const float v,
+                                               const int subdiv_vertex_index)
+{
+  if (ctx->num_boundary_samples == ctx->boundary_samples_capacity) {
+    ctx->boundary_samples_capacity = max_ii(ctx->boundary_samples_capacity * 2, 1024);
+    ctx->boundary_patch_coords = MEM_reallocN(
+        ctx->boundary_patch_coords,
+        sizeof(*ctx->boundary_patch_coords) * ctx->boundary_samples_capacity);
+    ctx->boundary_vertex_indices = MEM_reallocN(
+        ctx->boundary_vertex_indices,
+        sizeof(*ctx->boundary_vertex_indices) * ctx->boundary_samples_capacity);
+  }
+  OpenSubdiv_PatchCoord *patch_coord = &ctx->boundary_patch_coords[ctx->num_boundary_samples];
+  patch_coord->ptex_face = ptex_face_index;
+  patch_coord->u = u;
+  patch_coord->v = v;
+  ctx->boundary_vertex_indices[ctx->num_boundary_samples] = subdiv_vertex_index;
+  ctx->num_boundary_samples++;
+}
+
+/* NOTE: Is only called from the single threaded part of the traversal. */
 static void subdiv_accumulate_vertex_normal_and_displacement(SubdivMeshContext *ctx,
                                                              const int ptex_face_index,
                                                              const float u,
@@ -491,6 +697,9 @@ static void subdiv_accumulate_vertex_normal_and_displacement(SubdivMeshContext *
     cross_v3_v3v3(N, dPdu, dPdv);
     normalize_v3(N);
     add_v3_v3(ctx->accumulated_normals[subdiv_vertex_index], N);
+    if (ctx->cache != NULL) {
+      subdiv_mesh_record_boundary_sample(ctx, ptex_face_index, u, v, subdiv_vertex_index);
+    }
   }
   /* Accumulate displacement if needed. */
   if (ctx->have_displacement) {
@@ -507,25 +716,81 @@ static void subdiv_accumulate_vertex_normal_and_displacement(SubdivMeshContext *
 /** \} */
 
 /* -------------------------------------------------------------------- */
-/** \name Callbacks
+/** \name Topology cache recording
  * \{ */
 
-static bool subdiv_mesh_topology_info(const SubdivForeachContext *foreach_context,
+/* Allocate the subdivided topology and sources of the cache, filled by the traversal. */
+static void subdiv_mesh_cache_prepare(SubdivMeshCache *cache,
                                       const int num_vertices,
                                       const int num_edges,
                                       const int num_loops,
                                       const int num_polygons)
+{
+  cache->totvert = num_vertices;
+  cache->totedge = num_edges;
+  cache->totloop = num_loops;
+  cache->totpoly = num_polygons;
+  cache->edges = MEM_malloc_arrayN(num_edges, sizeof(*cache->edges), "subdiv cache edges");
+  cache->loops = MEM_malloc_arrayN(num_loops, sizeof(*cache->loops), "subdiv cache loops");
+  cache->polys = MEM_malloc_arrayN(num_polygons, sizeof(*cache->polys), "subdiv cache polys");
+  /* Vertices which are not recorded are detected by their type. */
+  cache->vertex_sources = MEM_calloc_arrayN(
+      num_vertices, sizeof(*cache->vertex_sources), "subdiv cache vertex sources");
+  cache->edge_sources = MEM_malloc_arrayN(
+      num_edges, sizeof(*cache->edge_sources), "subdiv cache edge sources");
+  cache->loop_sources = MEM_malloc_arrayN(
+      num_loops, sizeof(*cache->loop_sources), "subdiv cache loop sources");
+  cache->poly_sources = MEM_malloc_arrayN(
+      num_polygons, sizeof(*cache->poly_sources), "subdiv cache poly sources");
+}
+
+static void subdiv_mesh_cache_record_vertex(const SubdivMeshContext *ctx,
+                                            const int subdiv_vertex_index,
+                                            const char type,
+                                            const int coarse_index,
+                                            const int coarse_corner)
+{
+  if (ctx->cache == NULL) {
+    return;
+  }
+  SubdivMeshVertexSource *source = &ctx->cache->vertex_sources[subdiv_vertex_index];
+  source->type = type;
+  source->coarse_index = coarse_index;
+  source->coarse_corner = coarse_corner;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Callbacks
+ * \{ */
+
+static CustomData_MeshMasks subdiv_mesh_custom_data_mask(void)
 {
   /* Multires grid data will be applied or become invalid after subdivision,
    * so don't try to preserve it and use memory. */
   CustomData_MeshMasks mask = CD_MASK_EVERYTHING;
   mask.lmask &= ~CD_MASK_MULTIRES_GRIDS;
+  return mask;
+}
 
+static bool subdiv_mesh_topology_info(const SubdivForeachContext *foreach_context,
+                                      const int num_vertices,
+                                      const int num_edges,
+                                      const int num_loops,
+                                      const int num_polygons)
+{
   SubdivMeshContext *subdiv_context = foreach_context->user_data;
+  const CustomData_MeshMasks mask = subdiv_mesh_custom_data_mask();
   subdiv_context->subdiv_mesh = BKE_mesh_new_nomain_from_template_ex(
       subdiv_context->coarse_mesh, num_vertices, num_edges, 0, num_loops, num_polygons, mask);
   subdiv_mesh_ctx_cache_custom_data_layers(subdiv_context);
   subdiv_mesh_prepare_accumulator(subdiv_context, num_vertices);
+  subdiv_mesh_prepare_deferred_evaluation(subdiv_context, num_vertices);
+  if (subdiv_context->cache != NULL) {
+    subdiv_mesh_cache_prepare(
+        subdiv_context->cache, num_vertices, num_edges, num_loops, num_polygons);
+  }
   return true;
 }
 
@@ -583,11 +848,11 @@ static void evaluate_vertex_and_apply_displacement_copy(const SubdivMeshContext
     copy_v3_v3(D, subdiv_vert->co);
     mul_v3_fl(D, inv_num_accumulated);
   }
-  /* Copy custom data and evaluate position. */
+  /* Copy custom data and schedule evaluation of position, which is added to the displacement. */
   subdiv_vertex_data_copy(ctx, coarse_vert, subdiv_vert);
-  BKE_subdiv_eval_limit_point(ctx->subdiv, ptex_face_index, u, v, subdiv_vert->co);
-  /* Apply displacement. */
-  add_v3_v3(subdiv_vert->co, D);
+  copy_v3_v3(subdiv_vert->co, D);
+  subdiv_mesh_defer_vertex_evaluation(
+      ctx, subdiv_vertex_index, ptex_face_index, u, v, SUBDIV_VERTEX_EVAL_POSITION);
   /* Copy normal from accumulated storage. */
   if (ctx->can_evaluate_normals) {
     float N[3];
@@ -616,11 +881,12 @@ static void evaluate_vertex_and_apply_displacement_interpolate(
     copy_v3_v3(D, subdiv_vert->co);
     mul_v3_fl(D, inv_num_accumulated);
   }
-  /* Interpolate custom data and evaluate position. */
+  /* Interpolate custom data and schedule evaluation of position, which is added to the
+   * displacement. */
   subdiv_vertex_data_interpolate(ctx, subdiv_vert, vertex_interpolation, u, v);
-  BKE_subdiv_eval_limit_point(ctx->subdiv, ptex_face_index, u, v, subdiv_vert->co);
-  /* Apply displacement. */
-  add_v3_v3(subdiv_vert->co, D);
+  copy_v3_v3(subdiv_vert->co, D);
+  subdiv_mesh_defer_vertex_evaluation(
+      ctx, subdiv_vertex_index, ptex_face_index, u, v, SUBDIV_VERTEX_EVAL_POSITION);
   /* Copy normal from accumulated storage. */
   if (ctx->can_evaluate_normals) {
     const float inv_num_accumulated = 1.0f / ctx->accumulated_counters[subdiv_vertex_index];
@@ -694,6 +960,8 @@ static void subdiv_mesh_vertex_corner(const SubdivForeachContext *foreach_contex
   MVert *subdiv_vert = &subdiv_mvert[subdiv_vertex_index];
   evaluate_vertex_and_apply_displacement_copy(
       ctx, ptex_face_index, u, v, coarse_vert, subdiv_vert);
+  subdiv_mesh_cache_record_vertex(
+      ctx, subdiv_vertex_index, SUBDIV_MESH_VERTEX_CORNER, coarse_vertex_index, 0);
 }
 
 static void subdiv_mesh_ensure_vertex_interpolation(SubdivMeshContext *ctx,
@@ -745,6 +1013,8 @@ static void subdiv_mesh_vertex_edge(const SubdivForeachContext *foreach_context,
   subdiv_mesh_ensure_vertex_interpolation(ctx, tls, coarse_poly, coarse_corner);
   evaluate_vertex_and_apply_displacement_interpolate(
       ctx, ptex_face_index, u, v, &tls->vertex_interpolation, subdiv_vert);
+  subdiv_mesh_cache_record_vertex(
+      ctx, subdiv_vertex_index, SUBDIV_MESH_VERTEX_EDGE, coarse_poly_index, coarse_corner);
 }
 
 static bool subdiv_mesh_is_center_vertex(const MPoly *coarse_poly, const float u, const float v)
@@ -792,9 +1062,21 @@ static void subdiv_mesh_vertex_inner(const SubdivForeachContext *foreach_context
   MVert *subdiv_vert = &subdiv_mvert[subdiv_vertex_index];
   subdiv_mesh_ensure_vertex_interpolation(ctx, tls, coarse_poly, coarse_corner);
   subdiv_vertex_data_interpolate(ctx, subdiv_vert, &tls->vertex_interpolation, u, v);
-  eval_final_point_and_vertex_normal(
-      subdiv, ptex_face_index, u, v, subdiv_vert->co, subdiv_vert->no);
+  if (subdiv->displacement_evaluator == NULL) {
+    zero_v3(subdiv_vert->co);
+    subdiv_mesh_defer_vertex_evaluation(ctx,
+                                        subdiv_vertex_index,
+                                        ptex_face_index,
+                                        u,
+                                        v,
+                                        SUBDIV_VERTEX_EVAL_POSITION | SUBDIV_VERTEX_EVAL_NORMAL);
+  }
+  else {
+    BKE_subdiv_eval_final_point(subdiv, ptex_face_index, u, v, subdiv_vert->co);
+  }
   subdiv_mesh_tag_center_vertex(coarse_poly, subdiv_vert, u, v);
+  subdiv_mesh_cache_record_vertex(
+      ctx, subdiv_vertex_index, SUBDIV_MESH_VERTEX_INNER, coarse_poly_index, coarse_corner);
 }
 
 /** \} */
@@ -846,6 +1128,11 @@ static void subdiv_mesh_edge(const SubdivForeachContext *foreach_context,
   subdiv_copy_edge_data(ctx, subdiv_edge, coarse_edge);
   subdiv_edge->v1 = subdiv_v1;
   subdiv_edge->v2 = subdiv_v2;
+  if (ctx->cache != NULL) {
+    ctx->cache->edge_sources[subdiv_edge_index] = coarse_edge_index;
+    ctx->cache->edges[subdiv_edge_index][0] = subdiv_v1;
+    ctx->cache->edges[subdiv_edge_index][1] = subdiv_v2;
+  }
 }
 
 /** \} */
@@ -942,6 +1229,16 @@ static void subdiv_mesh_loop(const SubdivForeachContext *foreach_context,
   subdiv_eval_uv_layer(ctx, subdiv_loop, ptex_face_index, u, v);
   subdiv_loop->v = subdiv_vertex_index;
   subdiv_loop->e = subdiv_edge_index;
+  if (ctx->cache != NULL) {
+    SubdivMeshLoopSource *source = &ctx->cache->loop_sources[subdiv_loop_index];
+    source->coarse_poly = coarse_poly_index;
+    source->coarse_corner = coarse_corner;
+    source->patch_coord.ptex_face = ptex_face_index;
+    source->patch_coord.u = u;
+    source->patch_coord.v = v;
+    ctx->cache->loops[subdiv_loop_index][0] = subdiv_vertex_index;
+    ctx->cache->loops[subdiv_loop_index][1] = subdiv_edge_index;
+  }
 }
 
 /** \} */
@@ -978,6 +1275,11 @@ static void subdiv_mesh_poly(const SubdivForeachContext *foreach_context,
   subdiv_copy_poly_data(ctx, subdiv_poly, coarse_poly);
   subdiv_poly->loopstart = start_loop_index;
   subdiv_poly->totloop = num_loops;
+  if (ctx->cache != NULL) {
+    ctx->cache->poly_sources[subdiv_poly_index] = coarse_poly_index;
+    ctx->cache->polys[subdiv_poly_index][0] = start_loop_index;
+    ctx->cache->polys[subdiv_poly_index][1] = num_loops;
+  }
 }
 
 /** \} */
@@ -1126,8 +1428,10 @@ static void subdiv_mesh_vertex_of_loose_edge(const struct SubdivForeachContext *
   find_edge_neighbors(ctx, coarse_edge, neighbors);
   /* Interpolate custom data. */
   subdiv_mesh_vertex_of_loose_edge_interpolate(ctx, coarse_edge, u, subdiv_vertex_index);
-  /* Interpolate coordinate. */
+  /* Interpolate coordinate. Overrides the limit surface position of vertices shared with
+   * polygons. */
   MVert *subdiv_vertex = &subdiv_mvert[subdiv_vertex_index];
+  ctx->vertex_eval_flags[subdiv_vertex_index] = 0;
   if (is_simple) {
     const MVert *coarse_mvert = coarse_mesh->mvert;
     const MVert *vert_1 = &coarse_mvert[coarse_edge->v1];
@@ -1188,6 +1492,324 @@ static void setup_foreach_callbacks(const SubdivMeshContext *subdiv_context,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Topology cache
+ *
+ * When only positions or custom data of the coarse mesh change (for example, with armature
+ * deformation) the subdivided topology stays the same. It is kept in the #Subdiv then, and
+ * following calls create the mesh from it, without the traversal.
+ *
+ * The cache is only filled when the same coarse topology was seen twice in a row, so meshes
+ * which are only evaluated once do not hold on to it.
+ * \{ */
+
+static void subdiv_mesh_cache_clear_topology(SubdivMeshCache *cache)
+{
+  cache->is_filled = false;
+  MEM_SAFE_FREE(cache->edges);
+  MEM_SAFE_FREE(cache->loops);
+  MEM_SAFE_FREE(cache->polys);
+  MEM_SAFE_FREE(cache->vertex_sources);
+  MEM_SAFE_FREE(cache->edge_sources);
+  MEM_SAFE_FREE(cache->loop_sources);
+  MEM_SAFE_FREE(cache->poly_sources);
+  MEM_SAFE_FREE(cache->vertex_eval_flags);
+  MEM_SAFE_FREE(cache->vertex_patch_coords);
+  MEM_SAFE_FREE(cache->boundary_patch_coords);
+  MEM_SAFE_FREE(cache->boundary_vertex_indices);
+  cache->num_boundary_samples = 0;
+}
+
+static void subdiv_mesh_cache_clear(SubdivMeshCache *cache)
+{
+  subdiv_mesh_cache_clear_topology(cache);
+  MEM_SAFE_FREE(cache->coarse_edges);
+  MEM_SAFE_FREE(cache->coarse_loops);
+  MEM_SAFE_FREE(cache->coarse_polys);
+}
+
+void BKE_subdiv_mesh_cache_free(Subdiv *subdiv)
+{
+  SubdivMeshCache *cache = subdiv->cache_.mesh;
+  if (cache == NULL) {
+    return;
+  }
+  subdiv_mesh_cache_clear(cache);
+  MEM_freeN(cache);
+  subdiv->cache_.mesh = NULL;
+}
+
+static bool subdiv_mesh_cache_coarse_topology_equal(const SubdivMeshCache *cache,
+                                                    const Mesh *coarse_mesh)
+{
+  if (cache->coarse_totvert != coarse_mesh->totvert ||
+      cache->coarse_totedge != coarse_mesh->totedge ||
+      cache->coarse_totloop != coarse_mesh->totloop ||
+      cache->coarse_totpoly != coarse_mesh->totpoly) {
+    return false;
+  }
+  for (int i = 0; i < coarse_mesh->totedge; i++) {
+    const MEdge *edge = &coarse_mesh->medge[i];
+    if (cache->coarse_edges[i][0] != edge->v1 || cache->coarse_edges[i][1] != edge->v2) {
+      return false;
+    }
+  }
+  for (int i = 0; i < coarse_mesh->totloop; i++) {
+    const MLoop *loop = &coarse_mesh->mloop[i];
+    if (cache->coarse_loops[i][0] != loop->v || cache->coarse_loops[i][1] != loop->e) {
+      return false;
+    }
+  }
+  for (int i = 0; i < coarse_mesh->totpoly; i++) {
+    const MPoly *poly = &coarse_mesh->mpoly[i];
+    if (cache->coarse_polys[i][0] != poly->loopstart ||
+        cache->coarse_polys[i][1] != poly->totloop) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void subdiv_mesh_cache_store_coarse_topology(SubdivMeshCache *cache,
+                                                    const Mesh *coarse_mesh)
+{
+  cache->coarse_totvert = coarse_mesh->totvert;
+  cache->coarse_totedge = coarse_mesh->totedge;
+  cache->coarse_totloop = coarse_mesh->totloop;
+  cache->coarse_totpoly = coarse_mesh->totpoly;
+  cache->coarse_edges = MEM_malloc_arrayN(
+      coarse_mesh->totedge, sizeof(*cache->coarse_edges), "subdiv cache coarse edges");
+  cache->coarse_loops = MEM_malloc_arrayN(
+      coarse_mesh->totloop, sizeof(*cache->coarse_loops), "subdiv cache coarse loops");
+  cache->coarse_polys = MEM_malloc_arrayN(
+      coarse_mesh->totpoly, sizeof(*cache->coarse_polys), "subdiv cache coarse polys");
+  for (int i = 0; i < coarse_mesh->totedge; i++) {
+    cache->coarse_edges[i][0] = coarse_mesh->medge[i].v1;
+    cache->coarse_edges[i][1] = coarse_mesh->medge[i].v2;
+  }
+  for (int i = 0; i < coarse_mesh->totloop; i++) {
+    cache->coarse_loops[i][0] = coarse_mesh->mloop[i].v;
+    cache->coarse_loops[i][1] = coarse_mesh->mloop[i].e;
+  }
+  for (int i = 0; i < coarse_mesh->totpoly; i++) {
+    cache->coarse_polys[i][0] = coarse_mesh->mpoly[i].loopstart;
+    cache->coarse_polys[i][1] = coarse_mesh->mpoly[i].totloop;
+  }
+}
+
+/* Check whether the cache was created for the given coarse topology and settings. If not, the
+ * cache is cleared and the new key is stored, so the cache gets filled on the next call. */
+static bool subdiv_mesh_cache_update_key(Subdiv *subdiv,
+                                         const SubdivToMeshSettings *settings,
+                                         const Mesh *coarse_mesh)
+{
+  if (subdiv->displacement_evaluator != NULL) {
+    BKE_subdiv_mesh_cache_free(subdiv);
+    return false;
+  }
+  SubdivMeshCache *cache = subdiv->cache_.mesh;
+  if (cache == NULL) {
+    cache = subdiv->cache_.mesh = MEM_callocN(sizeof(SubdivMeshCache), "subdiv mesh cache");
+  }
+  else if (BKE_subdiv_settings_equal(&cache->subdiv_settings, &subdiv->settings) &&
+           cache->settings.resolution == settings->resolution &&
+           cache->settings.use_optimal_display == settings->use_optimal_display &&
+           subdiv_mesh_cache_coarse_topology_equal(cache, coarse_mesh)) {
+    return true;
+  }
+  subdiv_mesh_cache_clear(cache);
+  cache->subdiv_settings = subdiv->settings;
+  cache->settings = *settings;
+  subdiv_mesh_cache_store_coarse_topology(cache, coarse_mesh);
+  return false;
+}
+
+/* Finish filling the cache after the traversal, taking ownership of the evaluation data of the
+ * context. */
+static void subdiv_mesh_cache_fill(SubdivMeshCache *cache, SubdivMeshContext *ctx)
+{
+  /* Loose geometry is not created from the coarse polygons, and is not cached. */
+  for (int vertex_index = 0; vertex_index < cache->totvert; vertex_index++) {
+    if (cache->vertex_sources[vertex_index].type == SUBDIV_MESH_VERTEX_NONE) {
+      subdiv_mesh_cache_clear_topology(cache);
+      return;
+    }
+  }
+  cache->is_filled = true;
+  cache->vertex_eval_flags = ctx->vertex_eval_flags;
+  cache->vertex_patch_coords = ctx->vertex_patch_coords;
+  cache->num_boundary_samples = ctx->num_boundary_samples;
+  cache->boundary_patch_coords = ctx->boundary_patch_coords;
+  cache->boundary_vertex_indices = ctx->boundary_vertex_indices;
+  ctx->vertex_eval_flags = NULL;
+  ctx->vertex_patch_coords = NULL;
+  ctx->boundary_patch_coords = NULL;
+  ctx->boundary_vertex_indices = NULL;
+}
+
+static void subdiv_mesh_cache_tls_free(const void *__restrict UNUSED(userdata),
+                                       void *__restrict tls)
+{
+  subdiv_mesh_tls_free(tls);
+}
+
+static void subdiv_mesh_cache_vertices_task(void *__restrict userdata,
+                                            const int vertex_index,
+                                            const TaskParallelTLS *__restrict tls_v)
+{
+  SubdivMeshContext *ctx = userdata;
+  SubdivMeshTLS *tls = tls_v->userdata_chunk;
+  const SubdivMeshVertexSource *source = &ctx->cache->vertex_sources[vertex_index];
+  const OpenSubdiv_PatchCoord *patch_coord = &ctx->vertex_patch_coords[vertex_index];
+  MVert *subdiv_vert = &ctx->subdiv_mesh->mvert[vertex_index];
+  if (source->type == SUBDIV_MESH_VERTEX_CORNER) {
+    subdiv_vertex_data_copy(ctx, &ctx->coarse_mesh->mvert[source->coarse_index], subdiv_vert);
+    subdiv_vert->flag &= ~ME_VERT_FACEDOT;
+  }
+  else {
+    const MPoly *coarse_poly = &ctx->coarse_mesh->mpoly[source->coarse_index];
+    subdiv_mesh_ensure_vertex_interpolation(ctx, tls, coarse_poly, source->coarse_corner);
+    subdiv_vertex_data_interpolate(
+        ctx, subdiv_vert, &tls->vertex_interpolation, patch_coord->u, patch_coord->v);
+    if (source->type == SUBDIV_MESH_VERTEX_INNER) {
+      subdiv_mesh_tag_center_vertex(coarse_poly, subdiv_vert, patch_coord->u, patch_coord->v);
+    }
+  }
+  /* Limit surface positions are added to the coordinates. */
+  zero_v3(subdiv_vert->co);
+}
+
+static void subdiv_mesh_cache_edges_task(void *__restrict userdata,
+                                         const int edge_index,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SubdivMeshContext *ctx = userdata;
+  const int coarse_edge_index = ctx->cache->edge_sources[edge_index];
+  const MEdge *coarse_edge = NULL;
+  if (coarse_edge_index != ORIGINDEX_NONE) {
+    coarse_edge = &ctx->coarse_mesh->medge[coarse_edge_index];
+  }
+  MEdge *subdiv_edge = &ctx->subdiv_mesh->medge[edge_index];
+  subdiv_copy_edge_data(ctx, subdiv_edge, coarse_edge);
+  subdiv_edge->v1 = ctx->cache->edges[edge_index][0];
+  subdiv_edge->v2 = ctx->cache->edges[edge_index][1];
+}
+
+static void subdiv_mesh_cache_loops_task(void *__restrict userdata,
+                                         const int loop_index,
+                                         const TaskParallelTLS *__restrict tls_v)
+{
+  SubdivMeshContext *ctx = userdata;
+  SubdivMeshTLS *tls = tls_v->userdata_chunk;
+  const SubdivMeshLoopSource *source = &ctx->cache->loop_sources[loop_index];
+  const OpenSubdiv_PatchCoord *patch_coord = &source->patch_coord;
+  const MPoly *coarse_poly = &ctx->coarse_mesh->mpoly[source->coarse_poly];
+  MLoop *subdiv_loop = &ctx->subdiv_mesh->mloop[loop_index];
+  subdiv_mesh_ensure_loop_interpolation(ctx, tls, coarse_poly, source->coarse_corner);
+  subdiv_interpolate_loop_data(
+      ctx, subdiv_loop, &tls->loop_interpolation, patch_coord->u, patch_coord->v);
+  subdiv_eval_uv_layer(
+      ctx, subdiv_loop, patch_coord->ptex_face, patch_coord->u, patch_coord->v);
+  subdiv_loop->v = ctx->cache->loops[loop_index][0];
+  subdiv_loop->e = ctx->cache->loops[loop_index][1];
+}
+
+static void subdiv_mesh_cache_polys_task(void *__restrict userdata,
+                                         const int poly_index,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SubdivMeshContext *ctx = userdata;
+  const MPoly *coarse_poly = &ctx->coarse_mesh->mpoly[ctx->cache->poly_sources[poly_index]];
+  MPoly *subdiv_poly = &ctx->subdiv_mesh->mpoly[poly_index];
+  subdiv_copy_poly_data(ctx, subdiv_poly, coarse_poly);
+  subdiv_poly->loopstart = ctx->cache->polys[poly_index][0];
+  subdiv_poly->totloop = ctx->cache->polys[poly_index][1];
+}
+
+static void subdiv_mesh_cache_parallel_range(SubdivMeshContext *ctx,
+                                             const int num_elements,
+                                             TaskParallelRangeFunc func)
+{
+  SubdivMeshTLS tls = {0};
+  TaskParallelSettings parallel_range_settings;
+  BLI_parallel_range_settings_defaults(&parallel_range_settings);
+  /* Neighbor elements mostly come from the same coarse corner, which keeps the interpolation
+   * data of the thread valid. */
+  parallel_range_settings.min_iter_per_thread = 1024;
+  parallel_range_settings.userdata_chunk = &tls;
+  parallel_range_settings.userdata_chunk_size = sizeof(tls);
+  parallel_range_settings.func_free = subdiv_mesh_cache_tls_free;
+  BLI_task_parallel_range(0, num_elements, ctx, func, &parallel_range_settings);
+}
+
+/* Average normals of vertices along coarse edges and corners from the recorded samples. */
+static void subdiv_mesh_cache_evaluate_boundary_normals(Subdiv *subdiv,
+                                                        const SubdivMeshCache *cache,
+                                                        Mesh *subdiv_mesh)
+{
+  const int num_samples = cache->num_boundary_samples;
+  if (num_samples == 0) {
+    return;
+  }
+  MVert *subdiv_mvert = subdiv_mesh->mvert;
+  float(*P)[3] = MEM_malloc_arrayN(num_samples, sizeof(*P), __func__);
+  float(*dPdu)[3] = MEM_malloc_arrayN(num_samples, sizeof(*dPdu), __func__);
+  float(*dPdv)[3] = MEM_malloc_arrayN(num_samples, sizeof(*dPdv), __func__);
+  float(*accumulated_normals)[3] = MEM_calloc_arrayN(
+      subdiv_mesh->totvert, sizeof(*accumulated_normals), __func__);
+  BKE_subdiv_eval_limit_points_and_derivatives(
+      subdiv, cache->boundary_patch_coords, num_samples, P, dPdu, dPdv);
+  for (int i = 0; i < num_samples; i++) {
+    float N[3];
+    cross_v3_v3v3(N, dPdu[i], dPdv[i]);
+    normalize_v3(N);
+    add_v3_v3(accumulated_normals[cache->boundary_vertex_indices[i]], N);
+  }
+  for (int i = 0; i < num_samples; i++) {
+    const int vertex_index = cache->boundary_vertex_indices[i];
+    float N[3];
+    normalize_v3_v3(N, accumulated_normals[vertex_index]);
+    normal_float_to_short_v3(subdiv_mvert[vertex_index].no, N);
+  }
+  MEM_freeN(P);
+  MEM_freeN(dPdu);
+  MEM_freeN(dPdv);
+  MEM_freeN(accumulated_normals);
+}
+
+/* Create subdivided mesh from the cached topology, interpolating custom data of the current
+ * coarse mesh and evaluating positions and normals from the limit surface. */
+static Mesh *subdiv_mesh_from_cache(Subdiv *subdiv,
+                                    SubdivMeshCache *cache,
+                                    const Mesh *coarse_mesh,
+                                    const bool can_evaluate_normals)
+{
+  SubdivMeshContext subdiv_context = {0};
+  subdiv_context.settings = &cache->settings;
+  subdiv_context.coarse_mesh = coarse_mesh;
+  subdiv_context.subdiv = subdiv;
+  subdiv_context.can_evaluate_normals = can_evaluate_normals;
+  subdiv_context.cache = cache;
+  subdiv_context.vertex_eval_flags = cache->vertex_eval_flags;
+  subdiv_context.vertex_patch_coords = cache->vertex_patch_coords;
+  const CustomData_MeshMasks mask = subdiv_mesh_custom_data_mask();
+  subdiv_context.subdiv_mesh = BKE_mesh_new_nomain_from_template_ex(
+      coarse_mesh, cache->totvert, cache->totedge, 0, cache->totloop, cache->totpoly, mask);
+  subdiv_mesh_ctx_cache_custom_data_layers(&subdiv_context);
+  subdiv_mesh_cache_parallel_range(
+      &subdiv_context, cache->totvert, subdiv_mesh_cache_vertices_task);
+  subdiv_mesh_cache_parallel_range(&subdiv_context, cache->totedge, subdiv_mesh_cache_edges_task);
+  subdiv_mesh_cache_parallel_range(&subdiv_context, cache->totloop, subdiv_mesh_cache_loops_task);
+  subdiv_mesh_cache_parallel_range(&subdiv_context, cache->totpoly, subdiv_mesh_cache_polys_task);
+  subdiv_mesh_evaluate_deferred_vertices(&subdiv_context);
+  if (can_evaluate_normals) {
+    subdiv_mesh_cache_evaluate_boundary_normals(subdiv, cache, subdiv_context.subdiv_mesh);
+  }
+  return subdiv_context.subdiv_mesh;
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Public entry point
  * \{ */
@@ -1210,14 +1832,32 @@ Mesh *BKE_subdiv_to_mesh(Subdiv *subdiv,
       return NULL;
     }
   }
+  const bool have_displacement = (subdiv->displacement_evaluator != NULL);
+  const bool can_evaluate_normals = !have_displacement && subdiv->settings.is_adaptive;
+  /* Re-use topology of the previous call if only coarse positions changed. */
+  const bool is_cache_key_equal = subdiv_mesh_cache_update_key(subdiv, settings, coarse_mesh);
+  if (is_cache_key_equal && subdiv->cache_.mesh->is_filled) {
+    BKE_subdiv_stats_begin(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH_CACHED);
+    Mesh *result = subdiv_mesh_from_cache(
+        subdiv, subdiv->cache_.mesh, coarse_mesh, can_evaluate_normals);
+    BKE_subdiv_stats_end(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH_CACHED);
+    BKE_subdiv_stats_reset(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH_GEOMETRY);
+    BKE_subdiv_stats_end(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH);
+    subdiv->stats.subdiv_to_mesh_cache_hits++;
+    if (!can_evaluate_normals) {
+      BKE_mesh_normals_tag_dirty(result);
+    }
+    return result;
+  }
   /* Initialize subdivision mesh creation context. */
   SubdivMeshContext subdiv_context = {0};
   subdiv_context.settings = settings;
   subdiv_context.coarse_mesh = coarse_mesh;
   subdiv_context.subdiv = subdiv;
-  subdiv_context.have_displacement = (subdiv->displacement_evaluator != NULL);
-  subdiv_context.can_evaluate_normals = !subdiv_context.have_displacement &&
-                                        subdiv_context.subdiv->settings.is_adaptive;
+  subdiv_context.have_displacement = have_displacement;
+  subdiv_context.can_evaluate_normals = can_evaluate_normals;
+  /* Fill the cache when the same topology is seen the second time. */
+  subdiv_context.cache = is_cache_key_equal ? subdiv->cache_.mesh : NULL;
   /* Multi-threaded traversal/evaluation. */
   BKE_subdiv_stats_begin(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH_GEOMETRY);
   SubdivForeachContext foreach_context;
@@ -1227,8 +1867,14 @@ Mesh *BKE_subdiv_to_mesh(Subdiv *subdiv,
   foreach_context.user_data_tls_size = sizeof(SubdivMeshTLS);
   foreach_context.user_data_tls = &tls;
   BKE_subdiv_foreach_subdiv_geometry(subdiv, &foreach_context, settings, coarse_mesh);
+  subdiv_mesh_evaluate_deferred_vertices(&subdiv_context);
   BKE_subdiv_stats_end(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH_GEOMETRY);
+  BKE_subdiv_stats_reset(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH_CACHED);
+  subdiv->stats.subdiv_to_mesh_cache_misses++;
   Mesh *result = subdiv_context.subdiv_mesh;
+  if (is_cache_key_equal) {
+    subdiv_mesh_cache_fill(subdiv->cache_.mesh, &subdiv_context);
+  }
   // BKE_mesh_validate(result, true, true);
   BKE_subdiv_stats_end(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH);
   if (!subdiv_context.can_evaluate_normals) {
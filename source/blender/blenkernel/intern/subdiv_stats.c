@@ -32,11 +32,14 @@ void BKE_subdiv_stats_init(SubdivStats *stats)
   stats->topology_refiner_creation_time = 0.0;
   stats->subdiv_to_mesh_time = 0.0;
   stats->subdiv_to_mesh_geometry_time = 0.0;
+  stats->subdiv_to_mesh_cached_time = 0.0;
   stats->evaluator_creation_time = 0.0;
   stats->evaluator_refine_time = 0.0;
   stats->subdiv_to_ccg_time = 0.0;
   stats->subdiv_to_ccg_elements_time = 0.0;
   stats->topology_compare_time = 0.0;
+  stats->subdiv_to_mesh_cache_hits = 0;
+  stats->subdiv_to_mesh_cache_misses = 0;
 }
 
 void BKE_subdiv_stats_begin(SubdivStats *stats, eSubdivStatsValue value)
@@ -68,6 +71,7 @@ void BKE_subdiv_stats_print(const SubdivStats *stats)
   STATS_PRINT_TIME(stats, topology_refiner_creation_time, "Topology refiner creation time");
   STATS_PRINT_TIME(stats, subdiv_to_mesh_time, "Subdivision to mesh time");
   STATS_PRINT_TIME(stats, subdiv_to_mesh_geometry_time, "    Geometry time");
+  STATS_PRINT_TIME(stats, subdiv_to_mesh_cached_time, "    Cached topology time");
   STATS_PRINT_TIME(stats, evaluator_creation_time, "Evaluator creation time");
   STATS_PRINT_TIME(stats, evaluator_refine_time, "Evaluator refine time");
   STATS_PRINT_TIME(stats, subdiv_to_ccg_time, "Subdivision to CCG time");
@@ -75,4 +79,10 @@ void BKE_subdiv_stats_print(const SubdivStats *stats)
   STATS_PRINT_TIME(stats, topology_compare_time, "Topology comparison time");
 
 #undef STATS_PRINT_TIME
+
+  if (stats->subdiv_to_mesh_cache_hits != 0 || stats->subdiv_to_mesh_cache_misses != 0) {
+    printf("  Subdivision to mesh topology cache: %d hits, %d misses\n",
+           stats->subdiv_to_mesh_cache_hits,
+           stats->subdiv_to_mesh_cache_misses);
+  }
 }
@@ -26,6 +26,8 @@
 #  include "BLI_mesh_intersect.hh"
 #  include <functional>
 
+struct BVHTree;
+
 namespace blender::meshintersect {
 
 /**
@@ -76,6 +78,51 @@ IMesh boolean_trimesh(IMesh &tm_in,
                       bool hole_tolerant,
                       IMeshArena *arena);
 
+/**
+ * The data of the first operand of a binary boolean that doesn't depend on the second operand,
+ * kept for repeated operations where only the second operand changes, see #boolean_mesh_local.
+ * The faces of \a imesh must have their index as their orig field, and must be allocated
+ * in \a arena. The arena must not change while the cache is in use, the operations use an
+ * arena made from it instead, see #IMeshArena.
+ */
+class BooleanBaseCache : NonCopyable, NonMovable {
+  IMesh imesh_;
+  IMesh tm_;
+  /** The triangles of face `f` of #imesh_ start at index `face_tri_offsets_[f]` in #tm_. */
+  Array<int> face_tri_offsets_;
+  Array<BoundingBox> face_bounds_;
+  double max_abs_co_ = 0.0;
+  /** Contains all triangles of #tm_, used to find out what is inside of the first operand. */
+  BVHTree *raycast_tree_ = nullptr;
+
+ public:
+  BooleanBaseCache(IMesh imesh, IMeshArena *arena);
+  ~BooleanBaseCache();
+
+  const IMesh &imesh() const
+  {
+    return imesh_;
+  }
+
+  friend IMesh boolean_mesh_local(const BooleanBaseCache &base,
+                                  IMesh &imesh_operand,
+                                  BoolOpType op,
+                                  IMeshArena *arena);
+};
+
+/**
+ * Do the boolean operation \a op with the cached first operand \a base and \a imesh_operand,
+ * whose faces should have orig indices after those of the first operand.
+ * Only the faces of the first operand that are close to the bounds of the second operand are
+ * intersected, the others are passed through unchanged (or removed for #BoolOpType::Intersect).
+ * What is inside of which operand is found by ray-casting, like when the input is not PWN.
+ * Self intersections in the operands are not handled.
+ */
+IMesh boolean_mesh_local(const BooleanBaseCache &base,
+                         IMesh &imesh_operand,
+                         BoolOpType op,
+                         IMeshArena *arena);
+
 }  // namespace blender::meshintersect
 
 #endif /* WITH_GMP */
@@ -206,6 +206,12 @@ class IMeshArena : NonCopyable, NonMovable {
 
  public:
   IMeshArena();
+  /**
+   * Make an arena that also de-duplicates against the Verts of \a base_arena.
+   * This makes it possible to reuse a mesh allocated in \a base_arena for many operations,
+   * without growing it. \a base_arena must outlive this arena and must not change meanwhile.
+   */
+  explicit IMeshArena(const IMeshArena *base_arena);
   ~IMeshArena();
 
   /**
@@ -398,6 +404,13 @@ struct BoundingBox {
 /** Assume bounding boxes have been expanded by a sufficient epsilon. */
 bool bbs_might_intersect(const BoundingBox &bb_a, const BoundingBox &bb_b);
 
+/**
+ * Return the same as `orient3d(a->co_exact, b->co_exact, c->co_exact, d->co_exact)`,
+ * but first try double arithmetic on the approximate coordinates, with error bounds.
+ * Exact arithmetic is only used when the sign can not be decided that way.
+ */
+int filtered_orient3d(const Vert *a, const Vert *b, const Vert *c, const Vert *d);
+
 /**
  * The output will have duplicate vertices merged and degenerate triangles ignored.
  * If the input has overlapping co-planar triangles, then there will be
@@ -315,6 +315,21 @@ int BLI_task_parallel_thread_id(const TaskParallelTLS *tls);
  *    TaskNode *node_3 = BLI_task_graph_node_create(task_graph, node_exec, task_data, NULL);
  *    TaskNode *node_4 = BLI_task_graph_node_create(task_graph, node_exec, task_data, NULL);
  *
+ * ** Priority **
+ *
+ * Nodes of graphs created with `BLI_task_graph_create_ex(TASK_PRIORITY_LOW)` are picked up after
+ * waiting nodes of high priority graphs, for example for final render work that shares the
+ * scheduler with interactive drawing. With TBB 2020 the priority applies to the whole graph
+ * context, like for task pools.
+ *
+ * ** Locality **
+ *
+ * Nodes created with `TASK_NODE_LOCALITY_PREDECESSOR_THREAD` run directly on the thread that
+ * finished their predecessor, instead of being scheduled as a new task that any thread can pick
+ * up. This keeps data produced by the predecessor in the caches of that thread, but successors
+ * of the same node with this locality will run one after the other. Use it for short nodes that
+ * consume the data of a single predecessor. This is a hint, TBB 2020 schedules these nodes like
+ * any other node.
  */
 struct TaskGraph;
 struct TaskNode;
@@ -322,13 +337,26 @@ struct TaskNode;
 typedef void (*TaskGraphNodeRunFunction)(void *__restrict task_data);
 typedef void (*TaskGraphNodeFreeFunction)(void *task_data);
 
+typedef enum TaskNodeLocality {
+  /* Run on any thread. */
+  TASK_NODE_LOCALITY_ANY,
+  /* Run on the thread that finished the predecessor. */
+  TASK_NODE_LOCALITY_PREDECESSOR_THREAD,
+} TaskNodeLocality;
+
 struct TaskGraph *BLI_task_graph_create(void);
+struct TaskGraph *BLI_task_graph_create_ex(TaskPriority priority);
 void BLI_task_graph_work_and_wait(struct TaskGraph *task_graph);
 void BLI_task_graph_free(struct TaskGraph *task_graph);
 struct TaskNode *BLI_task_graph_node_create(struct TaskGraph *task_graph,
                                             TaskGraphNodeRunFunction run,
                                             void *user_data,
                                             TaskGraphNodeFreeFunction free_func);
+struct TaskNode *BLI_task_graph_node_create_ex(struct TaskGraph *task_graph,
+                                               TaskGraphNodeRunFunction run,
+                                               void *user_data,
+                                               TaskGraphNodeFreeFunction free_func,
+                                               TaskNodeLocality locality);
 bool BLI_task_graph_node_push_work(struct TaskNode *task_node);
 void BLI_task_graph_edge_create(struct TaskNode *from_node, struct TaskNode *to_node);
 
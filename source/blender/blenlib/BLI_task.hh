@@ -32,6 +32,7 @@
 #  include <tbb/parallel_for.h>
 #  include <tbb/parallel_for_each.h>
 #  include <tbb/parallel_reduce.h>
+#  include <tbb/parallel_sort.h>
 #  include <tbb/task_arena.h>
 #  ifdef WIN32
 /* We cannot keep this defined, since other parts of the code deal with this on their own, leading
@@ -43,7 +44,12 @@
 #  endif
 #endif
 
+#include <algorithm>
+#include <atomic>
+
+#include "BLI_array.hh"
 #include "BLI_index_range.hh"
+#include "BLI_span.hh"
 #include "BLI_utildefines.h"
 
 namespace blender::threading {
@@ -98,6 +104,134 @@ Value parallel_reduce(IndexRange range,
 #endif
 }
 
+/**
+ * Sort the range with the given comparison function, like `std::sort`. The sort is not stable.
+ */
+template<typename RandomAccessIterator, typename Compare>
+void parallel_sort(RandomAccessIterator begin, RandomAccessIterator end, const Compare &comp)
+{
+#ifdef WITH_TBB
+  tbb::parallel_sort(begin, end, comp);
+#else
+  std::sort(begin, end, comp);
+#endif
+}
+
+template<typename RandomAccessIterator>
+void parallel_sort(RandomAccessIterator begin, RandomAccessIterator end)
+{
+#ifdef WITH_TBB
+  tbb::parallel_sort(begin, end);
+#else
+  std::sort(begin, end);
+#endif
+}
+
+/**
+ * Replace every value with the sum of all values before it, in place.
+ *
+ * \return The sum of all values.
+ */
+template<typename T> T parallel_exclusive_scan(MutableSpan<T> values, const int64_t grain_size)
+{
+  const int64_t chunks_num = std::max<int64_t>(1, values.size() / grain_size);
+  const int64_t chunk_size = values.size() / chunks_num;
+  auto chunk_range = [&](const int64_t chunk) {
+    const int64_t start = chunk * chunk_size;
+    const int64_t end = (chunk == chunks_num - 1) ? values.size() : start + chunk_size;
+    return IndexRange(start, end - start);
+  };
+
+  /* Sum every chunk, then scan the sums and use them as start of the chunks. */
+  Array<T> chunk_offsets(chunks_num);
+  parallel_for(IndexRange(chunks_num), 1, [&](IndexRange chunks) {
+    for (const int64_t chunk : chunks) {
+      T sum = T(0);
+      for (const int64_t i : chunk_range(chunk)) {
+        sum += values[i];
+      }
+      chunk_offsets[chunk] = sum;
+    }
+  });
+  T total = T(0);
+  for (T &offset : chunk_offsets) {
+    const T sum = offset;
+    offset = total;
+    total += sum;
+  }
+  parallel_for(IndexRange(chunks_num), 1, [&](IndexRange chunks) {
+    for (const int64_t chunk : chunks) {
+      T offset = chunk_offsets[chunk];
+      for (const int64_t i : chunk_range(chunk)) {
+        const T value = values[i];
+        values[i] = offset;
+        offset += value;
+      }
+    }
+  });
+  return total;
+}
+
+/**
+ * Group element indices by a key, like a counting sort. The group of every element is given by
+ * `group_fn(i)` and has to be in `[0, r_offsets.size() - 1)`.
+ *
+ * \param r_offsets: Gets the start of every group in \a r_indices, and the total number of
+ * elements as last value.
+ * \param r_indices: Gets the indices of the elements, sorted by group. Within a group, the
+ * indices are ascending, so the result is the same as a serial counting sort.
+ */
+template<typename GroupFn>
+void parallel_group_by(const int64_t elements_num,
+                       const int64_t grain_size,
+                       MutableSpan<int> r_offsets,
+                       MutableSpan<int> r_indices,
+                       const GroupFn &group_fn)
+{
+  const int64_t groups_num = r_offsets.size() - 1;
+  BLI_assert(r_indices.size() == elements_num);
+
+  Array<std::atomic<int>> counters(groups_num);
+  parallel_for(IndexRange(groups_num), grain_size, [&](IndexRange range) {
+    for (const int64_t group : range) {
+      counters[group].store(0, std::memory_order_relaxed);
+    }
+  });
+  parallel_for(IndexRange(elements_num), grain_size, [&](IndexRange range) {
+    for (const int64_t i : range) {
+      counters[group_fn(i)].fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+
+  parallel_for(IndexRange(groups_num), grain_size, [&](IndexRange range) {
+    for (const int64_t group : range) {
+      r_offsets[group] = counters[group].load(std::memory_order_relaxed);
+    }
+  });
+  r_offsets.last() = 0;
+  parallel_exclusive_scan(r_offsets, grain_size);
+
+  /* Reuse the counters as insertion position of every group. */
+  parallel_for(IndexRange(groups_num), grain_size, [&](IndexRange range) {
+    for (const int64_t group : range) {
+      counters[group].store(r_offsets[group], std::memory_order_relaxed);
+    }
+  });
+  parallel_for(IndexRange(elements_num), grain_size, [&](IndexRange range) {
+    for (const int64_t i : range) {
+      const int index = counters[group_fn(i)].fetch_add(1, std::memory_order_relaxed);
+      r_indices[index] = int(i);
+    }
+  });
+
+  /* Insertion order depends on the scheduling, sort to get a deterministic result. */
+  parallel_for(IndexRange(groups_num), grain_size, [&](IndexRange range) {
+    for (const int64_t group : range) {
+      std::sort(r_indices.data() + r_offsets[group], r_indices.data() + r_offsets[group + 1]);
+    }
+  });
+}
+
 /** See #BLI_task_isolate for a description of what isolating a task means. */
 template<typename Function> void isolate_task(const Function &function)
 {
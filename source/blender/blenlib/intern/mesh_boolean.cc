@@ -907,9 +907,6 @@ static int sort_tris_class(const Face &tri, const Face &tri0, const Edge e)
   if (dbg_level > 0) {
     std::cout << "classify  e = " << e << "\n";
   }
-  mpq3 a0 = tri0[0]->co_exact;
-  mpq3 a1 = tri0[1]->co_exact;
-  mpq3 a2 = tri0[2]->co_exact;
   bool rev;
   bool rev0;
   const Vert *flapv0 = find_flap_vert(tri0, e, &rev0);
@@ -921,9 +918,8 @@ static int sort_tris_class(const Face &tri, const Face &tri0, const Edge e)
     std::cout << " rev = " << rev << " flapv = " << flapv << "\n";
   }
   BLI_assert(flapv != nullptr && flapv0 != nullptr);
-  const mpq3 flap = flapv->co_exact;
-  /* orient will be positive if flap is below oriented plane of a0,a1,a2. */
-  int orient = orient3d(a0, a1, a2, flap);
+  /* orient will be positive if flapv is below oriented plane of tri0. */
+  int orient = filtered_orient3d(tri0[0], tri0[1], tri0[2], flapv);
   int ans;
   if (orient > 0) {
     ans = rev0 ? 4 : 3;
@@ -2579,26 +2575,26 @@ static void inside_shape_callback(void *userdata,
 }
 
 /**
- * Test the triangle with index \a t_index to see which shapes it is inside,
+ * Test the triangle \a tri_test to see which shapes it is inside,
  * and fill in \a in_shape with a confidence value between 0 and 1 that says
  * how likely we think it is that it is inside.
  * This is done by casting some rays from just on the positive side of a test
  * face in various directions and summing the parity of crossing faces of each face.
  *
  * \param tree: Contains all the triangles of \a tm and can be used for fast ray-casting.
+ * Only the shapes of the triangles in \a tm get a meaningful value in \a in_shape.
  */
 static void test_tri_inside_shapes(const IMesh &tm,
                                    std::function<int(int)> shape_fn,
                                    int nshapes,
-                                   int test_t_index,
+                                   Face &tri_test,
                                    BVHTree *tree,
                                    Array<float> &in_shape)
 {
   const int dbg_level = 0;
   if (dbg_level > 0) {
-    std::cout << "test_point_inside_shapes, t_index = " << test_t_index << "\n";
+    std::cout << "test_point_inside_shapes, tri = " << &tri_test << "\n";
   }
-  Face &tri_test = *tm.face(test_t_index);
   int shape = shape_fn(tri_test.orig);
   if (shape == -1) {
     in_shape.fill(0.0f);
@@ -2764,7 +2760,7 @@ static IMesh raycast_tris_boolean(const IMesh &tm,
         std::cout << "process triangle " << t << " = " << &tri << "\n";
         std::cout << "shape = " << shape << "\n";
       }
-      test_tri_inside_shapes(tm, shape_fn, nshapes, t, tree, in_shape);
+      test_tri_inside_shapes(tm, shape_fn, nshapes, tri, tree, in_shape);
       for (int other_shape = 0; other_shape < nshapes; ++other_shape) {
         if (other_shape == shape) {
           continue;
@@ -2844,7 +2840,7 @@ static IMesh raycast_patches_boolean(const IMesh &tm,
     if (shape == -1) {
       continue;
     }
-    test_tri_inside_shapes(tm, shape_fn, nshapes, test_t_index, tree, in_shape);
+    test_tri_inside_shapes(tm, shape_fn, nshapes, tri_test, tree, in_shape);
     for (int other_shape = 0; other_shape < nshapes; ++other_shape) {
       if (other_shape == shape) {
         continue;
@@ -3183,6 +3179,32 @@ static void splice_faces(
   me.right_face = -1;
 }
 
+static bool double3_less(const double3 &a, const double3 &b)
+{
+  if (a.x != b.x) {
+    return a.x < b.x;
+  }
+  if (a.y != b.y) {
+    return a.y < b.y;
+  }
+  return a.z < b.z;
+}
+
+/** Order edges by the coordinates of their ends, independent of the vertex ids. */
+static bool merge_edge_position_less(const MergeEdge &a, const MergeEdge &b)
+{
+  const bool a_flip = double3_less(a.v2->co, a.v1->co);
+  const bool b_flip = double3_less(b.v2->co, b.v1->co);
+  const double3 &a_lo = a_flip ? a.v2->co : a.v1->co;
+  const double3 &a_hi = a_flip ? a.v1->co : a.v2->co;
+  const double3 &b_lo = b_flip ? b.v2->co : b.v1->co;
+  const double3 &b_hi = b_flip ? b.v1->co : b.v2->co;
+  if (a_lo != b_lo) {
+    return double3_less(a_lo, b_lo);
+  }
+  return double3_less(a_hi, b_hi);
+}
+
 /**
  * Given that fms has been properly initialized to contain a set of faces that
  * together form a face or part of a face of the original #IMesh, and that
@@ -3205,10 +3227,17 @@ static void do_dissolve(FaceMergeState *fms)
   if (dissolve_edges.size() == 0) {
     return;
   }
-  /* Things look nicer if we dissolve the longer edges first. */
+  /* Things look nicer if we dissolve the longer edges first. Edges of the same length are
+   * ordered by their position, so that the result doesn't depend on the order of the triangles
+   * and on the vertex ids, which are different when only part of the mesh was intersected. */
   std::sort(
       dissolve_edges.begin(), dissolve_edges.end(), [fms](const int &a, const int &b) -> bool {
-        return (fms->edge[a].len_squared > fms->edge[b].len_squared);
+        const MergeEdge &me_a = fms->edge[a];
+        const MergeEdge &me_b = fms->edge[b];
+        if (me_a.len_squared != me_b.len_squared) {
+          return me_a.len_squared > me_b.len_squared;
+        }
+        return merge_edge_position_less(me_a, me_b);
       });
   if (dbg_level > 0) {
     std::cout << "Sorted dissolvable edges: " << dissolve_edges << "\n";
@@ -3487,7 +3516,7 @@ static IMesh polymesh_from_trimesh_with_dissolve(const IMesh &tm_out,
     if (dbg_level > 1) {
       std::cout << "merge tris for face " << in_f << "\n";
     }
-    int num_out_tris_for_face = face_output_tris.size();
+    int num_out_tris_for_face = face_output_tris[in_f].size();
     if (num_out_tris_for_face == 0) {
       continue;
     }
@@ -3744,6 +3773,169 @@ IMesh boolean_mesh(IMesh &imesh,
   return ans;
 }
 
+BooleanBaseCache::BooleanBaseCache(IMesh imesh, IMeshArena *arena) : imesh_(std::move(imesh))
+{
+  /* The triangles of each face are consecutive and in the order of the faces. */
+  tm_ = triangulate_polymesh(imesh_, arena);
+  face_tri_offsets_ = Array<int>(imesh_.face_size() + 1, 0);
+  for (const Face *tri : tm_.faces()) {
+    face_tri_offsets_[tri->orig + 1]++;
+  }
+  for (int f : imesh_.face_index_range()) {
+    face_tri_offsets_[f + 1] += face_tri_offsets_[f];
+  }
+  face_bounds_ = Array<BoundingBox>(imesh_.face_size());
+  threading::parallel_for(imesh_.face_index_range(), 2048, [&](IndexRange range) {
+    for (int f : range) {
+      for (const Vert *v : *imesh_.face(f)) {
+        face_bounds_[f].combine(v->co);
+      }
+    }
+  });
+  for (const BoundingBox &bb : face_bounds_) {
+    for (int i = 0; i < 3; i++) {
+      max_abs_co_ = max_dd(max_abs_co_, max_ff(fabsf(bb.min[i]), fabsf(bb.max[i])));
+    }
+  }
+  raycast_tree_ = raycast_tree(tm_);
+}
+
+BooleanBaseCache::~BooleanBaseCache()
+{
+  if (raycast_tree_) {
+    BLI_bvhtree_free(raycast_tree_);
+  }
+}
+
+IMesh boolean_mesh_local(const BooleanBaseCache &base,
+                         IMesh &imesh_operand,
+                         BoolOpType op,
+                         IMeshArena *arena)
+{
+  constexpr int dbg_level = 0;
+  const int tot_base_face = base.imesh_.face_size();
+  std::function<int(int)> shape_fn = [tot_base_face](int f) {
+    return f < tot_base_face ? 0 : 1;
+  };
+#  ifdef PERFDEBUG
+  double start_time = PIL_check_seconds_timer();
+  std::cout << "boolean_mesh_local, timing begins\n";
+#  endif
+  IMesh tm_operand = triangulate_polymesh(imesh_operand, arena);
+
+  /* Faces of the base outside of the bounds of the operand can't intersect it, and they are
+   * also outside of it. */
+  BoundingBox operand_bb;
+  double max_abs_co = base.max_abs_co_;
+  for (const Face *tri : tm_operand.faces()) {
+    for (const Vert *v : *tri) {
+      operand_bb.combine(v->co);
+      for (int i = 0; i < 3; i++) {
+        max_abs_co = max_dd(max_abs_co, fabs(v->co[i]));
+      }
+    }
+  }
+  constexpr float pad_factor = 10.0f;
+  const float pad = max_abs_co == 0.0 ? FLT_EPSILON : 2 * FLT_EPSILON * max_abs_co;
+  /* Twice the padding #trimesh_nary_intersect uses, since the base face bounds are not padded. */
+  operand_bb.expand(2 * pad_factor * pad);
+  Array<bool> face_is_near(tot_base_face);
+  threading::parallel_for(base.imesh_.face_index_range(), 4096, [&](IndexRange range) {
+    for (int f : range) {
+      face_is_near[f] = bbs_might_intersect(base.face_bounds_[f], operand_bb);
+    }
+  });
+  Vector<Face *> near_tris;
+  Vector<Face *> out_faces;
+  for (int f : base.imesh_.face_index_range()) {
+    if (face_is_near[f]) {
+      for (int t = base.face_tri_offsets_[f]; t < base.face_tri_offsets_[f + 1]; t++) {
+        near_tris.append(base.tm_.face(t));
+      }
+    }
+    else if (op != BoolOpType::Intersect) {
+      out_faces.append(base.imesh_.face(f));
+    }
+  }
+  near_tris.extend(tm_operand.faces());
+  if (dbg_level > 0) {
+    std::cout << "boolean_mesh_local: " << near_tris.size() - tm_operand.face_size()
+              << " near base triangles, " << out_faces.size() << " passed through faces\n";
+  }
+#  ifdef PERFDEBUG
+  double near_time = PIL_check_seconds_timer();
+  std::cout << "near faces found, time = " << near_time - start_time << "\n";
+#  endif
+
+  IMesh tm_near(near_tris);
+  IMesh tm_si = trimesh_nary_intersect(tm_near, 2, shape_fn, false, arena);
+#  ifdef PERFDEBUG
+  double intersect_time = PIL_check_seconds_timer();
+  std::cout << "intersected, time = " << intersect_time - near_time << "\n";
+#  endif
+
+  /* Like #raycast_patches_boolean, but the base triangles outside of the near region have to be
+   * taken into account too when testing if something is inside of the base. */
+  TriMeshTopology tm_si_topo(tm_si);
+  PatchesInfo pinfo = find_patches(tm_si, tm_si_topo);
+  BVHTree *operand_tree = raycast_tree(tm_operand);
+  Vector<Face *> out_tris;
+  Array<float> in_shape(2, 0);
+  Array<int> winding(2, 0);
+  for (int p : pinfo.index_range()) {
+    const Patch &patch = pinfo.patch(p);
+    Face &tri_test = *tm_si.face(patch.tri(patch.tot_tri() / 2));
+    const int shape = shape_fn(tri_test.orig);
+    const int other_shape = 1 - shape;
+    if (shape == 0) {
+      test_tri_inside_shapes(tm_operand, shape_fn, 2, tri_test, operand_tree, in_shape);
+    }
+    else {
+      test_tri_inside_shapes(base.tm_, shape_fn, 2, tri_test, base.raycast_tree_, in_shape);
+    }
+    /* Same confidence thresholds as #raycast_patches_boolean. */
+    const bool need_high_confidence = (op == BoolOpType::Difference && shape != 0) ||
+                                      op == BoolOpType::Intersect;
+    winding[other_shape] = in_shape[other_shape] >= (need_high_confidence ? 0.5f : 0.1f);
+    bool do_flip;
+    if (raycast_test_remove(op, winding, shape, &do_flip)) {
+      continue;
+    }
+    for (int t : patch.tris()) {
+      Face *f = tm_si.face(t);
+      if (!do_flip) {
+        out_tris.append(f);
+      }
+      else {
+        raycast_add_flipped(out_tris, *f, arena);
+      }
+    }
+  }
+  BLI_bvhtree_free(operand_tree);
+#  ifdef PERFDEBUG
+  double classify_time = PIL_check_seconds_timer();
+  std::cout << "patches classified, time = " << classify_time - intersect_time << "\n";
+#  endif
+
+  /* Merging the triangles back into faces needs all input faces, by their orig index. */
+  Array<Face *> in_faces(tot_base_face + imesh_operand.face_size());
+  std::copy(base.imesh_.faces().begin(), base.imesh_.faces().end(), in_faces.begin());
+  for (Face *f : imesh_operand.faces()) {
+    BLI_assert(f->orig >= tot_base_face && f->orig < in_faces.size());
+    in_faces[f->orig] = f;
+  }
+  IMesh imesh_in(in_faces);
+  IMesh tm_out(out_tris);
+  IMesh imesh_out = polymesh_from_trimesh_with_dissolve(tm_out, imesh_in, arena);
+  out_faces.extend(imesh_out.faces());
+#  ifdef PERFDEBUG
+  double end_time = PIL_check_seconds_timer();
+  std::cout << "polymesh from dissolving, time = " << end_time - classify_time << "\n";
+  std::cout << "boolean_mesh_local done, total time = " << end_time - start_time << "\n";
+#  endif
+  return IMesh(out_faces);
+}
+
 }  // namespace blender::meshintersect
 
 #endif  // WITH_GMP
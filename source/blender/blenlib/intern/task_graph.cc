@@ -29,14 +29,47 @@
 
 #ifdef WITH_TBB
 #  include <tbb/flow_graph.h>
+#  include <tbb/task_group.h>
+#  if __has_include(<tbb/version.h>)
+/* TBB 2021 no longer defines the version in the other headers. */
+#    include <tbb/version.h>
+#  endif
+/* TBB 2020 has node priorities and the lightweight policy only as preview features, there the
+ * priority is set on the context of the graph and all nodes are scheduled as tasks. */
+#  if TBB_INTERFACE_VERSION_MAJOR >= 12
+#    define WITH_TBB_FLOW_GRAPH_PRIORITIES
+#    define WITH_TBB_FLOW_GRAPH_LIGHTWEIGHT
+#  endif
 #endif
 
 /* Task Graph */
 struct TaskGraph {
 #ifdef WITH_TBB
+  /* Context of all tasks of the graph, must be constructed before the graph. */
+  tbb::task_group_context tbb_context;
   tbb::flow::graph tbb_graph;
 #endif
   std::vector<std::unique_ptr<TaskNode>> nodes;
+  TaskPriority priority;
+
+  TaskGraph(TaskPriority priority)
+      :
+#ifdef WITH_TBB
+        tbb_graph(tbb_context),
+#endif
+        priority(priority)
+  {
+#if defined(WITH_TBB) && !defined(WITH_TBB_FLOW_GRAPH_PRIORITIES)
+    switch (priority) {
+      case TASK_PRIORITY_LOW:
+        tbb_context.set_priority(tbb::priority_low);
+        break;
+      case TASK_PRIORITY_HIGH:
+        tbb_context.set_priority(tbb::priority_normal);
+        break;
+    }
+#endif
+  }
 
 #ifdef WITH_CXX_GUARDEDALLOC
   MEM_CXX_CLASS_ALLOC_FUNCS("task_graph:TaskGraph")
@@ -45,10 +78,23 @@ struct TaskGraph {
 
 /* TaskNode - a node in the task graph. */
 struct TaskNode {
-  /* TBB Node. */
 #ifdef WITH_TBB
-  tbb::flow::continue_node<tbb::flow::continue_msg> tbb_node;
+  using TBBNode = tbb::flow::continue_node<tbb::flow::continue_msg>;
+#  ifdef WITH_TBB_FLOW_GRAPH_LIGHTWEIGHT
+  /* Lightweight nodes run their body directly in the thread that sent the message, instead of
+   * spawning a task that can be stolen by another thread. */
+  using TBBLightweightNode =
+      tbb::flow::continue_node<tbb::flow::continue_msg, tbb::flow::lightweight>;
+#  else
+  using TBBLightweightNode = TBBNode;
+#  endif
+
+  /* TBB Node, either a #TBBNode or #TBBLightweightNode depending on the locality. */
+  std::unique_ptr<tbb::flow::graph_node> tbb_node;
+  tbb::flow::sender<tbb::flow::continue_msg> *tbb_sender;
+  tbb::flow::receiver<tbb::flow::continue_msg> *tbb_receiver;
 #endif
+  TaskGraph *task_graph;
   /* Successors to execute after this task, for serial execution fallback. */
   std::vector<TaskNode *> successors;
 
@@ -62,19 +108,21 @@ struct TaskNode {
   TaskNode(TaskGraph *task_graph,
            TaskGraphNodeRunFunction run_func,
            void *task_data,
-           TaskGraphNodeFreeFunction free_func)
-      :
-#ifdef WITH_TBB
-        tbb_node(task_graph->tbb_graph,
-                 tbb::flow::unlimited,
-                 [&](const tbb::flow::continue_msg input) { run(input); }),
-#endif
-        run_func(run_func),
-        task_data(task_data),
-        free_func(free_func)
+           TaskGraphNodeFreeFunction free_func,
+           TaskNodeLocality locality)
+      : task_graph(task_graph), run_func(run_func), task_data(task_data), free_func(free_func)
   {
-#ifndef WITH_TBB
-    UNUSED_VARS(task_graph);
+#ifdef WITH_TBB
+    switch (locality) {
+      case TASK_NODE_LOCALITY_ANY:
+        init_tbb_node<TBBNode>();
+        break;
+      case TASK_NODE_LOCALITY_PREDECESSOR_THREAD:
+        init_tbb_node<TBBLightweightNode>();
+        break;
+    }
+#else
+    UNUSED_VARS(locality);
 #endif
   }
 
@@ -89,6 +137,23 @@ struct TaskNode {
   }
 
 #ifdef WITH_TBB
+  template<typename NodeT> void init_tbb_node()
+  {
+    auto body = [&](const tbb::flow::continue_msg input) { return run(input); };
+#  ifdef WITH_TBB_FLOW_GRAPH_PRIORITIES
+    /* Tasks of nodes with a higher priority are executed before other waiting graph tasks. */
+    const tbb::flow::node_priority_t node_priority = task_graph->priority == TASK_PRIORITY_HIGH ?
+                                                         1 :
+                                                         tbb::flow::no_priority;
+    NodeT *node = new NodeT(task_graph->tbb_graph, tbb::flow::unlimited, body, node_priority);
+#  else
+    NodeT *node = new NodeT(task_graph->tbb_graph, tbb::flow::unlimited, body);
+#  endif
+    tbb_node.reset(node);
+    tbb_sender = node;
+    tbb_receiver = node;
+  }
+
   tbb::flow::continue_msg run(const tbb::flow::continue_msg UNUSED(input))
   {
     run_func(task_data);
@@ -111,7 +176,12 @@ struct TaskNode {
 
 TaskGraph *BLI_task_graph_create(void)
 {
-  return new TaskGraph();
+  return BLI_task_graph_create_ex(TASK_PRIORITY_HIGH);
+}
+
+TaskGraph *BLI_task_graph_create_ex(TaskPriority priority)
+{
+  return new TaskGraph(priority);
 }
 
 void BLI_task_graph_free(TaskGraph *task_graph)
@@ -123,8 +193,6 @@ void BLI_task_graph_work_and_wait(TaskGraph *task_graph)
 {
 #ifdef WITH_TBB
   task_graph->tbb_graph.wait_for_all();
-#else
-  UNUSED_VARS(task_graph);
 #endif
 }
 
@@ -133,7 +201,17 @@ struct TaskNode *BLI_task_graph_node_create(struct TaskGraph *task_graph,
                                             void *user_data,
                                             TaskGraphNodeFreeFunction free_func)
 {
-  TaskNode *task_node = new TaskNode(task_graph, run, user_data, free_func);
+  return BLI_task_graph_node_create_ex(
+      task_graph, run, user_data, free_func, TASK_NODE_LOCALITY_ANY);
+}
+
+struct TaskNode *BLI_task_graph_node_create_ex(struct TaskGraph *task_graph,
+                                               TaskGraphNodeRunFunction run,
+                                               void *user_data,
+                                               TaskGraphNodeFreeFunction free_func,
+                                               TaskNodeLocality locality)
+{
+  TaskNode *task_node = new TaskNode(task_graph, run, user_data, free_func, locality);
   task_graph->nodes.push_back(std::unique_ptr<TaskNode>(task_node));
   return task_node;
 }
@@ -142,7 +220,7 @@ bool BLI_task_graph_node_push_work(struct TaskNode *task_node)
 {
 #ifdef WITH_TBB
   if (BLI_task_scheduler_num_threads() > 1) {
-    return task_node->tbb_node.try_put(tbb::flow::continue_msg());
+    return task_node->tbb_receiver->try_put(tbb::flow::continue_msg());
   }
 #endif
 
@@ -154,7 +232,7 @@ void BLI_task_graph_edge_create(struct TaskNode *from_node, struct TaskNode *to_
 {
 #ifdef WITH_TBB
   if (BLI_task_scheduler_num_threads() > 1) {
-    tbb::flow::make_edge(from_node->tbb_node, to_node->tbb_node);
+    tbb::flow::make_edge(*from_node->tbb_sender, *to_node->tbb_receiver);
     return;
   }
 #endif
@@ -2,19 +2,25 @@
 
 #include "testing/testing.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 
 #include "MEM_guardedalloc.h"
 
+#include "PIL_time.h"
+
 #include "BLI_array.hh"
 #include "BLI_map.hh"
 #include "BLI_math_mpq.hh"
 #include "BLI_mesh_boolean.hh"
 #include "BLI_mpq3.hh"
+#include "BLI_task.h"
 #include "BLI_vector.hh"
 
+#define DO_PERF_TESTS 0
+
 #ifdef WITH_GMP
 namespace blender::meshintersect::tests {
 
@@ -46,6 +52,22 @@ class IMeshBuilder {
    *  int int int ... [#faces lines; indices into verts for given face]
    */
   IMeshBuilder(const char *spec)
+  {
+    build(spec, 0);
+  }
+
+  /**
+   * Build the mesh in an arena made from \a base_arena, with face orig indices starting at
+   * \a face_offset, to use it together with a mesh built in \a base_arena.
+   */
+  IMeshBuilder(const char *spec, int face_offset, const IMeshArena *base_arena)
+      : arena(base_arena)
+  {
+    build(spec, face_offset);
+  }
+
+ private:
+  void build(const char *spec, int face_offset)
   {
     std::istringstream ss(spec);
     std::string line;
@@ -86,10 +108,10 @@ class IMeshBuilder {
           continue;
         }
         face_verts.append(verts[v_index]);
-        edge_orig.append(edge_index(f_index, fpos));
+        edge_orig.append(edge_index(face_offset + f_index, fpos));
         ++fpos;
       }
-      Face *facep = arena.add_face(face_verts, f_index, edge_orig);
+      Face *facep = arena.add_face(face_verts, face_offset + f_index, edge_orig);
       faces.append(facep);
       ++f_index;
     }
@@ -953,5 +975,383 @@ TEST(boolean_polymesh, CubePlane)
   }
 }
 
+/* An axis aligned box, given by the minimum and maximum coordinate strings on every axis. */
+struct Box {
+  const char *min[3];
+  const char *max[3];
+};
+
+static Box cube(const char *min, const char *max)
+{
+  return {{min, min, min}, {max, max, max}};
+}
+
+/* Spec for axis aligned boxes. */
+static std::string boxes_spec(Span<Box> boxes)
+{
+  const int box_faces[6][4] = {
+      {0, 1, 3, 2}, {6, 2, 3, 7}, {4, 6, 7, 5}, {0, 4, 5, 1}, {0, 2, 6, 4}, {3, 1, 5, 7}};
+  std::ostringstream ss;
+  ss << 8 * boxes.size() << " " << 6 * boxes.size() << "\n";
+  for (const Box &box : boxes) {
+    for (int i = 0; i < 8; i++) {
+      ss << ((i & 4) ? box.max[0] : box.min[0]) << " " << ((i & 2) ? box.max[1] : box.min[1])
+         << " " << ((i & 1) ? box.max[2] : box.min[2]) << "\n";
+    }
+  }
+  for (int b : boxes.index_range()) {
+    for (int f = 0; f < 6; f++) {
+      ss << 8 * b + box_faces[f][0] << " " << 8 * b + box_faces[f][1] << " "
+         << 8 * b + box_faces[f][2] << " " << 8 * b + box_faces[f][3] << "\n";
+    }
+  }
+  return ss.str();
+}
+
+static bool mpq3_less(const mpq3 &a, const mpq3 &b)
+{
+  if (a.x != b.x) {
+    return a.x < b.x;
+  }
+  if (a.y != b.y) {
+    return a.y < b.y;
+  }
+  return a.z < b.z;
+}
+
+/* Vertex indices of \a mesh in the order of their exact coordinates. */
+static Array<int> sorted_vert_indices(const IMesh &mesh)
+{
+  Array<int> indices(mesh.vert_size());
+  for (int i : indices.index_range()) {
+    indices[i] = i;
+  }
+  std::sort(indices.begin(), indices.end(), [&](int a, int b) {
+    return mpq3_less(mesh.vert(a)->co_exact, mesh.vert(b)->co_exact);
+  });
+  return indices;
+}
+
+/**
+ * The vertex cycles of all faces of \a mesh, using the vertex indices given by \a vert_map,
+ * each rotated to start at its smallest index. The cycles are sorted.
+ */
+static Vector<Vector<int>> sorted_face_cycles(const IMesh &mesh, Span<int> vert_map)
+{
+  Vector<Vector<int>> cycles;
+  for (const Face *f : mesh.faces()) {
+    Vector<int> cycle;
+    for (const Vert *v : *f) {
+      cycle.append(vert_map[mesh.lookup_vert(v)]);
+    }
+    std::rotate(cycle.begin(), std::min_element(cycle.begin(), cycle.end()), cycle.end());
+    cycles.append(std::move(cycle));
+  }
+  std::sort(cycles.begin(), cycles.end(), [](const Vector<int> &a, const Vector<int> &b) {
+    return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+  });
+  return cycles;
+}
+
+/**
+ * Check that \a mesh and \a mesh_expected are the same, allowing a different order of their
+ * vertices and faces and cyclic shifts of the face vertices. Both need populated vertices.
+ */
+static void expect_same_imesh(const IMesh &mesh, const IMesh &mesh_expected)
+{
+  ASSERT_EQ(mesh.vert_size(), mesh_expected.vert_size());
+  ASSERT_EQ(mesh.face_size(), mesh_expected.face_size());
+  const Array<int> sorted = sorted_vert_indices(mesh);
+  const Array<int> sorted_expected = sorted_vert_indices(mesh_expected);
+  /* Map the vertices of both meshes to the index of their coordinate in the sorted order. */
+  Array<int> vert_map(mesh.vert_size());
+  Array<int> vert_map_expected(mesh.vert_size());
+  for (int i : sorted.index_range()) {
+    EXPECT_EQ(mesh.vert(sorted[i])->co_exact, mesh_expected.vert(sorted_expected[i])->co_exact);
+    vert_map[sorted[i]] = i;
+    vert_map_expected[sorted_expected[i]] = i;
+  }
+  const Vector<Vector<int>> cycles = sorted_face_cycles(mesh, vert_map);
+  const Vector<Vector<int>> cycles_expected = sorted_face_cycles(mesh_expected,
+                                                                 vert_map_expected);
+  for (int i : cycles.index_range()) {
+    EXPECT_EQ(cycles[i].as_span(), cycles_expected[i].as_span());
+  }
+}
+
+/* Check that the boolean with a cached base gives the same result as the regular one. */
+static void test_boolean_local(const Box &operand_box)
+{
+  const Box base_box = cube("-1", "1");
+  const std::string base_spec = boxes_spec({base_box});
+  const std::string operand_spec = boxes_spec({operand_box});
+  const std::string both_spec = boxes_spec({base_box, operand_box});
+  IMeshBuilder mb_base(base_spec.c_str());
+  BooleanBaseCache base(mb_base.imesh, &mb_base.arena);
+  for (BoolOpType op : {BoolOpType::Intersect, BoolOpType::Union, BoolOpType::Difference}) {
+    IMeshBuilder mb_operand(operand_spec.c_str(), 6, &mb_base.arena);
+    IMesh out = boolean_mesh_local(base, mb_operand.imesh, op, &mb_operand.arena);
+    out.populate_vert();
+
+    IMeshBuilder mb_both(both_spec.c_str());
+    IMesh out_expected = boolean_mesh(
+        mb_both.imesh,
+        op,
+        2,
+        [](int t) { return t < 6 ? 0 : 1; },
+        false,
+        false,
+        nullptr,
+        &mb_both.arena);
+    out_expected.populate_vert();
+    expect_same_imesh(out, out_expected);
+  }
+  /* The cached base can be used again. */
+  EXPECT_EQ(base.imesh().face_size(), 6);
+  EXPECT_EQ(mb_base.arena.tot_allocated_verts(), 8);
+}
+
+TEST(boolean_local, CubeCube)
+{
+  test_boolean_local(cube("1/2", "5/2"));
+}
+
+TEST(boolean_local, CubeInsideCube)
+{
+  test_boolean_local(cube("-1/2", "1/2"));
+}
+
+TEST(boolean_local, CubeBesideCube)
+{
+  test_boolean_local(cube("2", "3"));
+}
+
+/* The operand only goes through the middle of the top face of the base. */
+TEST(boolean_local, BoxThroughTop)
+{
+  test_boolean_local({{"-1/2", "-1/3", "1/2"}, {"1/2", "1/3", "3/2"}});
+}
+
+/* The operand goes through the top and bottom faces of the base off center, and out of a side. */
+TEST(boolean_local, BoxThroughTopAndSide)
+{
+  test_boolean_local({{"1/2", "-1/5", "-2"}, {"3/2", "1/2", "3/2"}});
+}
+
+/* The operand goes through the base along the x axis, cutting a tunnel for the difference. */
+TEST(boolean_local, BoxThroughCube)
+{
+  test_boolean_local({{"-2", "-1/2", "-1/4"}, {"2", "1/2", "1/4"}});
+}
+
+#  if DO_PERF_TESTS
+
+/**
+ * Append a box from -1 to 1 in all dimensions to `ss_verts` and `ss_faces`, with every side
+ * divided into `subdivs` x `subdivs` quads which share their vertices.
+ * Return the number of vertices and faces in `r_verts_num` and `r_faces_num`.
+ */
+static void add_subdivided_box(int subdivs,
+                               std::ostringstream &ss_verts,
+                               std::ostringstream &ss_faces,
+                               int *r_verts_num,
+                               int *r_faces_num)
+{
+  const int size = subdivs + 1;
+  Array<int> lattice_vert(size * size * size, -1);
+  auto lattice_index = [size](int i, int j, int k) { return (i * size + j) * size + k; };
+  int verts_num = 0;
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      for (int k = 0; k < size; k++) {
+        if (i != 0 && i != subdivs && j != 0 && j != subdivs && k != 0 && k != subdivs) {
+          continue;
+        }
+        lattice_vert[lattice_index(i, j, k)] = verts_num++;
+        mpq_class x(2 * i - subdivs, subdivs);
+        mpq_class y(2 * j - subdivs, subdivs);
+        mpq_class z(2 * k - subdivs, subdivs);
+        x.canonicalize();
+        y.canonicalize();
+        z.canonicalize();
+        ss_verts << x << " " << y << " " << z << "\n";
+      }
+    }
+  }
+  int faces_num = 0;
+  for (int axis = 0; axis < 3; axis++) {
+    const int axis_u = (axis + 1) % 3;
+    const int axis_v = (axis + 2) % 3;
+    for (const int side : {0, subdivs}) {
+      for (int u = 0; u < subdivs; u++) {
+        for (int v = 0; v < subdivs; v++) {
+          int face_verts[4];
+          const int corner_u[4] = {u, u + 1, u + 1, u};
+          const int corner_v[4] = {v, v, v + 1, v + 1};
+          for (int c = 0; c < 4; c++) {
+            int co[3];
+            co[axis] = side;
+            co[axis_u] = corner_u[c];
+            co[axis_v] = corner_v[c];
+            face_verts[c] = lattice_vert[lattice_index(co[0], co[1], co[2])];
+          }
+          if (side == 0) {
+            std::swap(face_verts[1], face_verts[3]);
+          }
+          ss_faces << face_verts[0] << " " << face_verts[1] << " " << face_verts[2] << " "
+                   << face_verts[3] << "\n";
+          faces_num++;
+        }
+      }
+    }
+  }
+  *r_verts_num = verts_num;
+  *r_faces_num = faces_num;
+}
+
+/**
+ * Append `cutters` x `cutters` small boxes going through the top of the box made by
+ * #add_subdivided_box, every other one of them rotated around the z axis.
+ * Vertex indices start at `vert_start`.
+ * Return the number of added vertices and faces in `r_verts_num` and `r_faces_num`.
+ */
+static void add_cutter_boxes(int cutters,
+                             int vert_start,
+                             std::ostringstream &ss_verts,
+                             std::ostringstream &ss_faces,
+                             int *r_verts_num,
+                             int *r_faces_num)
+{
+  /* Rotation by an angle with rational sine and cosine, to keep the coordinates exact. */
+  const mpq_class cos_rot(4, 5);
+  const mpq_class sin_rot(3, 5);
+  const mpq_class half_size(1, 2 * cutters);
+  const mpq_class z_lo(1, 2);
+  const mpq_class z_hi(3, 2);
+  /* Same face order as the cubes in the tests above, vertex index bits are x: 4, y: 2, z: 1. */
+  const int cube_faces[6][4] = {
+      {0, 1, 3, 2}, {6, 2, 3, 7}, {4, 6, 7, 5}, {0, 4, 5, 1}, {0, 2, 6, 4}, {3, 1, 5, 7}};
+  int v_index = vert_start;
+  for (int cx = 0; cx < cutters; cx++) {
+    for (int cy = 0; cy < cutters; cy++) {
+      mpq_class center_x(2 * cx + 1 - cutters, cutters);
+      mpq_class center_y(2 * cy + 1 - cutters, cutters);
+      center_x.canonicalize();
+      center_y.canonicalize();
+      const bool rotate = (cx + cy) % 2 == 1;
+      for (int corner = 0; corner < 8; corner++) {
+        const mpq_class dx = (corner & 4) ? half_size : mpq_class(-half_size);
+        const mpq_class dy = (corner & 2) ? half_size : mpq_class(-half_size);
+        mpq_class x = center_x + (rotate ? mpq_class(cos_rot * dx - sin_rot * dy) : dx);
+        mpq_class y = center_y + (rotate ? mpq_class(sin_rot * dx + cos_rot * dy) : dy);
+        x.canonicalize();
+        y.canonicalize();
+        ss_verts << x << " " << y << " " << ((corner & 1) ? z_hi : z_lo) << "\n";
+      }
+      for (int f = 0; f < 6; f++) {
+        ss_faces << v_index + cube_faces[f][0] << " " << v_index + cube_faces[f][1] << " "
+                 << v_index + cube_faces[f][2] << " " << v_index + cube_faces[f][3] << "\n";
+      }
+      v_index += 8;
+    }
+  }
+  *r_verts_num = cutters * cutters * 8;
+  *r_faces_num = cutters * cutters * 6;
+}
+
+/**
+ * A typical hard-surface boolean: cut `cutters` x `cutters` boxes out of the top of a box with
+ * `subdivs` x `subdivs` quads on each side. Many of the edges and faces of the cutters are
+ * aligned with those of the base, so this exercises the degenerate cases as well.
+ */
+static void hard_surface_test(int subdivs, int cutters)
+{
+  BLI_task_scheduler_init(); /* Without this, no parallelism. */
+  double time_start = PIL_check_seconds_timer();
+  std::ostringstream ss_verts;
+  std::ostringstream ss_faces;
+  int base_verts_num, base_faces_num, cutter_verts_num, cutter_faces_num;
+  add_subdivided_box(subdivs, ss_verts, ss_faces, &base_verts_num, &base_faces_num);
+  add_cutter_boxes(
+      cutters, base_verts_num, ss_verts, ss_faces, &cutter_verts_num, &cutter_faces_num);
+  std::ostringstream ss;
+  ss << base_verts_num + cutter_verts_num << " " << base_faces_num + cutter_faces_num << "\n"
+     << ss_verts.str() << ss_faces.str();
+  const std::string spec = ss.str();
+  IMeshBuilder mb(spec.c_str());
+  double time_create = PIL_check_seconds_timer();
+  IMesh out = boolean_mesh(
+      mb.imesh,
+      BoolOpType::Difference,
+      2,
+      [base_faces_num](int t) { return t < base_faces_num ? 0 : 1; },
+      false,
+      false,
+      nullptr,
+      &mb.arena);
+  double time_boolean = PIL_check_seconds_timer();
+  out.populate_vert();
+  std::cout << "Input faces: " << base_faces_num + cutter_faces_num
+            << ", output faces: " << out.face_size() << "\n";
+  std::cout << "Create time: " << time_create - time_start << "\n";
+  std::cout << "Boolean time: " << time_boolean - time_create << "\n";
+  std::cout << "Total time: " << time_boolean - time_start << "\n";
+  if (DO_OBJ) {
+    write_obj_mesh(out, "hardsurface");
+  }
+  BLI_task_scheduler_exit();
+}
+
+/**
+ * Like #hard_surface_test with a single cutter, but using a cached base for a number of cutter
+ * positions, like when interactively moving the cutter.
+ */
+static void hard_surface_local_test(int subdivs)
+{
+  BLI_task_scheduler_init(); /* Without this, no parallelism. */
+  double time_start = PIL_check_seconds_timer();
+  std::ostringstream ss_verts;
+  std::ostringstream ss_faces;
+  int base_verts_num, base_faces_num;
+  add_subdivided_box(subdivs, ss_verts, ss_faces, &base_verts_num, &base_faces_num);
+  std::ostringstream ss;
+  ss << base_verts_num << " " << base_faces_num << "\n" << ss_verts.str() << ss_faces.str();
+  const std::string spec = ss.str();
+  IMeshBuilder mb_base(spec.c_str());
+  double time_create = PIL_check_seconds_timer();
+  BooleanBaseCache base(mb_base.imesh, &mb_base.arena);
+  double time_cache = PIL_check_seconds_timer();
+  std::cout << "Create time: " << time_create - time_start << "\n";
+  std::cout << "Cache time: " << time_cache - time_create << "\n";
+  for (const Box &cutter : {cube("1/2", "3/2"), cube("3/4", "5/4"), cube("7/8", "9/8")}) {
+    const std::string cutter_spec = boxes_spec({cutter});
+    double time_boolean_start = PIL_check_seconds_timer();
+    IMeshBuilder mb_cutter(cutter_spec.c_str(), base_faces_num, &mb_base.arena);
+    IMesh out = boolean_mesh_local(
+        base, mb_cutter.imesh, BoolOpType::Difference, &mb_cutter.arena);
+    double time_boolean = PIL_check_seconds_timer();
+    std::cout << "Output faces: " << out.face_size() << "\n";
+    std::cout << "Boolean time: " << time_boolean - time_boolean_start << "\n";
+  }
+  BLI_task_scheduler_exit();
+}
+
+TEST(boolean_perf, HardSurface)
+{
+  hard_surface_test(32, 8);
+}
+
+TEST(boolean_perf, HardSurfaceDense)
+{
+  hard_surface_test(128, 16);
+}
+
+TEST(boolean_perf, HardSurfaceLocal)
+{
+  hard_surface_local_test(256);
+}
+
+#  endif
+
 }  // namespace blender::meshintersect::tests
 #endif
@@ -188,3 +188,27 @@ TEST(task, GraphTaskData)
   EXPECT_EQ(1, data.value);
   EXPECT_EQ(0, data.store);
 }
+
+TEST(task, GraphPredecessorThreadLocality)
+{
+  TaskData data = {1, 0};
+  TaskGraph *graph = BLI_task_graph_create_ex(TASK_PRIORITY_LOW);
+
+  /* Nodes with a locality hint still run after their predecessors. */
+  TaskNode *node_a = BLI_task_graph_node_create(graph, TaskData_increase_value, &data, nullptr);
+  TaskNode *node_b = BLI_task_graph_node_create_ex(
+      graph, TaskData_store_value, &data, nullptr, TASK_NODE_LOCALITY_PREDECESSOR_THREAD);
+  TaskNode *node_c = BLI_task_graph_node_create_ex(graph,
+                                                   TaskData_multiply_by_two_store,
+                                                   &data,
+                                                   nullptr,
+                                                   TASK_NODE_LOCALITY_PREDECESSOR_THREAD);
+  BLI_task_graph_edge_create(node_a, node_b);
+  BLI_task_graph_edge_create(node_b, node_c);
+  EXPECT_TRUE(BLI_task_graph_node_push_work(node_a));
+  BLI_task_graph_work_and_wait(graph);
+
+  EXPECT_EQ(2, data.value);
+  EXPECT_EQ(4, data.store);
+  BLI_task_graph_free(graph);
+}
@@ -12,6 +12,7 @@
 #include "BLI_listbase.h"
 #include "BLI_mempool.h"
 #include "BLI_task.h"
+#include "BLI_task.hh"
 
 #define NUM_ITEMS 10000
 
@@ -280,3 +281,56 @@ TEST(task, ListBaseIter)
   MEM_freeN(items_buffer);
   BLI_threadapi_exit();
 }
+
+/* *** Parallel sorting and grouping. *** */
+
+TEST(task, ParallelSort)
+{
+  blender::Array<int> values(NUM_ITEMS);
+  for (const int i : values.index_range()) {
+    values[i] = (i * 7919) % NUM_ITEMS;
+  }
+  blender::threading::parallel_sort(values.begin(), values.end());
+  for (const int i : values.index_range()) {
+    EXPECT_EQ(values[i], i);
+  }
+
+  blender::threading::parallel_sort(
+      values.begin(), values.end(), [](const int a, const int b) { return a > b; });
+  for (const int i : values.index_range()) {
+    EXPECT_EQ(values[i], NUM_ITEMS - 1 - i);
+  }
+}
+
+TEST(task, ParallelExclusiveScan)
+{
+  blender::Array<int> values(NUM_ITEMS, 3);
+  const int total = blender::threading::parallel_exclusive_scan(values.as_mutable_span(), 128);
+  EXPECT_EQ(total, NUM_ITEMS * 3);
+  for (const int i : values.index_range()) {
+    EXPECT_EQ(values[i], i * 3);
+  }
+
+  blender::Array<int> empty_values(0);
+  EXPECT_EQ(blender::threading::parallel_exclusive_scan(empty_values.as_mutable_span(), 128), 0);
+}
+
+TEST(task, ParallelGroupBy)
+{
+  const int groups_num = 97;
+  blender::Array<int> offsets(groups_num + 1);
+  blender::Array<int> indices(NUM_ITEMS);
+  blender::threading::parallel_group_by(
+      NUM_ITEMS, 64, offsets, indices, [&](const int64_t i) { return i % groups_num; });
+
+  EXPECT_EQ(offsets[0], 0);
+  EXPECT_EQ(offsets[groups_num], NUM_ITEMS);
+  for (int group = 0; group < groups_num; group++) {
+    const int start = offsets[group];
+    const int size = offsets[group + 1] - start;
+    EXPECT_EQ(size, NUM_ITEMS / groups_num + (group < NUM_ITEMS % groups_num ? 1 : 0));
+    for (int i = 0; i < size; i++) {
+      EXPECT_EQ(indices[start + i], group + i * groups_num);
+    }
+  }
+}
@@ -1719,5 +1719,16 @@ void blo_do_versions_300(FileData *fd, Library *UNUSED(lib), Main *bmain)
    */
   {
     /* Keep this block, even when empty. */
+
+    if (!DNA_struct_elem_find(fd->filesdna, "SubsurfModifierData", "float", "dicing_rate")) {
+      LISTBASE_FOREACH (Object *, ob, &bmain->objects) {
+        LISTBASE_FOREACH (ModifierData *, md, &ob->modifiers) {
+          if (md->type == eModifierType_Subsurf) {
+            SubsurfModifierData *smd = (SubsurfModifierData *)md;
+            smd->dicing_rate = 1.0f;
+          }
+        }
+      }
+    }
   }
 }
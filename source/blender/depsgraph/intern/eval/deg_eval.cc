@@ -32,6 +32,7 @@
 #include "BLI_task.h"
 #include "BLI_utildefines.h"
 
+#include "BKE_customdata.h"
 #include "BKE_global.h"
 
 #include "DNA_node_types.h"
@@ -385,6 +386,8 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
 #endif
 
   graph->is_evaluating = true;
+  /* Reuse layer buffers of evaluated meshes freed during evaluation. */
+  CustomData_buffer_pool_begin();
   depsgraph_ensure_view_layer(graph);
   /* Set up evaluation state. */
   DepsgraphEvalState state;
@@ -422,6 +425,7 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   }
   /* Clear any uncleared tags - just in case. */
   deg_graph_clear_tags(graph);
+  CustomData_buffer_pool_end();
   graph->is_evaluating = false;
 
 #ifdef WITH_PYTHON
@@ -3415,6 +3415,8 @@ void drw_batch_cache_validate(Object *ob)
 
 void drw_batch_cache_generate_requested(Object *ob)
 {
+  MEM_scope_push("Draw Cache");
+
   const DRWContextState *draw_ctx = DRW_context_state_get();
   const Scene *scene = draw_ctx->scene;
   const enum eContextObjectMode mode = CTX_data_mode_enum_ex(
@@ -3448,6 +3450,8 @@ void drw_batch_cache_generate_requested(Object *ob)
     default:
       break;
   }
+
+  MEM_scope_pop();
 }
 
 void drw_batch_cache_generate_requested_delayed(Object *ob)
@@ -434,6 +434,8 @@ BLI_INLINE void extract_task_range_run_iter(const MeshRenderData *mr,
 
 static void extract_task_range_run(void *__restrict taskdata)
 {
+  /* Runs in a task, so the scope of #drw_batch_cache_generate_requested doesn't apply. */
+  MEM_ScopeGuard mem_scope("Draw Cache");
   ExtractTaskData *data = (ExtractTaskData *)taskdata;
   const eMRIterType iter_type = data->iter_type;
   const bool is_mesh = data->mr->extract_type != MR_EXTRACT_BMESH;
@@ -479,14 +481,16 @@ static struct TaskNode *extract_task_node_create(struct TaskGraph *task_graph,
                                                  MeshBatchCache *cache,
                                                  ExtractorRunDatas *extractors,
                                                  MeshBufferList *mbuflist,
-                                                 const bool use_threading)
+                                                 const bool use_threading,
+                                                 const TaskNodeLocality locality)
 {
   ExtractTaskData *taskdata = new ExtractTaskData(mr, cache, extractors, mbuflist, use_threading);
-  struct TaskNode *task_node = BLI_task_graph_node_create(
+  struct TaskNode *task_node = BLI_task_graph_node_create_ex(
       task_graph,
       extract_task_range_run,
       taskdata,
-      (TaskGraphNodeFreeFunction)extract_task_data_free);
+      (TaskGraphNodeFreeFunction)extract_task_data_free,
+      locality);
   return task_node;
 }
 
@@ -528,6 +532,7 @@ static void mesh_render_data_update_task_data_free(void *data)
 
 static void mesh_extract_render_data_node_exec(void *__restrict task_data)
 {
+  MEM_ScopeGuard mem_scope("Draw Cache");
   MeshRenderDataUpdateTaskData *update_task_data = static_cast<MeshRenderDataUpdateTaskData *>(
       task_data);
   MeshRenderData *mr = update_task_data->mr;
@@ -718,8 +723,13 @@ static void mesh_buffer_cache_create_requested(struct TaskGraph *task_graph,
       if (!extractor->use_threading) {
         ExtractorRunDatas *single_threaded_extractors = new ExtractorRunDatas();
         single_threaded_extractors->append(extractor);
-        struct TaskNode *task_node = extract_task_node_create(
-            task_graph, mr, cache, single_threaded_extractors, mbuflist, false);
+        struct TaskNode *task_node = extract_task_node_create(task_graph,
+                                                              mr,
+                                                              cache,
+                                                              single_threaded_extractors,
+                                                              mbuflist,
+                                                              false,
+                                                              TASK_NODE_LOCALITY_ANY);
 
         BLI_task_graph_edge_create(task_node_mesh_render_data, task_node);
       }
@@ -729,8 +739,13 @@ static void mesh_buffer_cache_create_requested(struct TaskGraph *task_graph,
     ExtractorRunDatas *multi_threaded_extractors = new ExtractorRunDatas();
     extractors.filter_threaded_extractors_into(*multi_threaded_extractors);
     if (!multi_threaded_extractors->is_empty()) {
-      struct TaskNode *task_node = extract_task_node_create(
-          task_graph, mr, cache, multi_threaded_extractors, mbuflist, true);
+      struct TaskNode *task_node = extract_task_node_create(task_graph,
+                                                            mr,
+                                                            cache,
+                                                            multi_threaded_extractors,
+                                                            mbuflist,
+                                                            true,
+                                                            TASK_NODE_LOCALITY_ANY);
 
       BLI_task_graph_edge_create(task_node_mesh_render_data, task_node);
     }
@@ -740,10 +755,16 @@ static void mesh_buffer_cache_create_requested(struct TaskGraph *task_graph,
     }
   }
   else {
-    /* Run all requests on the same thread. */
+    /* Run all requests on the same thread, the one that just updated the render data of this
+     * small mesh. */
     ExtractorRunDatas *extractors_copy = new ExtractorRunDatas(extractors);
-    struct TaskNode *task_node = extract_task_node_create(
-        task_graph, mr, cache, extractors_copy, mbuflist, false);
+    struct TaskNode *task_node = extract_task_node_create(task_graph,
+                                                          mr,
+                                                          cache,
+                                                          extractors_copy,
+                                                          mbuflist,
+                                                          false,
+                                                          TASK_NODE_LOCALITY_PREDECESSOR_THREAD);
 
     BLI_task_graph_edge_create(task_node_mesh_render_data, task_node);
   }
@@ -156,10 +156,14 @@ static bool drw_draw_show_annotation(void)
 /** \name Threading
  * \{ */
 
-static void drw_task_graph_init(void)
+/**
+ * Batch cache extraction for final renders uses a low priority, so it does not delay the
+ * interactive drawing and evaluation that share the task scheduler.
+ */
+static void drw_task_graph_init(const TaskPriority priority)
 {
   BLI_assert(DST.task_graph == NULL);
-  DST.task_graph = BLI_task_graph_create();
+  DST.task_graph = BLI_task_graph_create_ex(priority);
   DST.delayed_extraction = BLI_gset_ptr_new(__func__);
 }
 
@@ -1528,7 +1532,7 @@ void DRW_draw_render_loop_ex(struct Depsgraph *depsgraph,
       /* reuse if caller sets */
       .evil_C = DST.draw_ctx.evil_C,
   };
-  drw_task_graph_init();
+  drw_task_graph_init(TASK_PRIORITY_HIGH);
   drw_context_state_init();
 
   drw_viewport_var_init();
@@ -1922,7 +1926,7 @@ void DRW_render_object_iter(
   const DRWContextState *draw_ctx = DRW_context_state_get();
   DRW_hair_init();
 
-  drw_task_graph_init();
+  drw_task_graph_init(TASK_PRIORITY_LOW);
   const int object_type_exclude_viewport = draw_ctx->v3d ?
                                                draw_ctx->v3d->object_type_exclude_viewport :
                                                0;
@@ -2078,7 +2082,7 @@ void DRW_draw_render_loop_2d_ex(struct Depsgraph *depsgraph,
 
   /* Init engines */
   drw_engines_init();
-  drw_task_graph_init();
+  drw_task_graph_init(TASK_PRIORITY_HIGH);
 
   /* Cache filling */
   {
@@ -2312,7 +2316,7 @@ void DRW_draw_select_loop(struct Depsgraph *depsgraph,
   DST.viewport = viewport;
   DST.options.is_select = true;
   DST.options.is_material_select = do_material_sub_selection;
-  drw_task_graph_init();
+  drw_task_graph_init(TASK_PRIORITY_HIGH);
   /* Get list of enabled engines */
   if (use_obedit) {
     drw_engines_enable_overlays();
@@ -2499,7 +2503,7 @@ static void drw_draw_depth_loop_impl(struct Depsgraph *depsgraph,
       .engine_type = engine_type,
       .depsgraph = depsgraph,
   };
-  drw_task_graph_init();
+  drw_task_graph_init(TASK_PRIORITY_HIGH);
   drw_engines_data_validate();
 
   /* Setup frame-buffer. */
@@ -2645,7 +2649,7 @@ void DRW_draw_select_id(Depsgraph *depsgraph, ARegion *region, View3D *v3d, cons
       .obact = OBACT(view_layer),
       .depsgraph = depsgraph,
   };
-  drw_task_graph_init();
+  drw_task_graph_init(TASK_PRIORITY_HIGH);
   drw_context_state_init();
 
   /* Setup viewport */
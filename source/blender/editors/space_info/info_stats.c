@@ -659,6 +659,24 @@ static const char *info_statusbar_string(Main *bmain,
     uintptr_t mem_in_use = MEM_get_memory_in_use();
     BLI_str_format_byte_unit(formatted_mem, mem_in_use, false);
     ofs += BLI_snprintf_rlen(info + ofs, len, TIP_("Memory: %s"), formatted_mem);
+
+    if (statusbar_flag & STATUSBAR_SHOW_MEMORY_SCOPES) {
+      /* Skip the unscoped memory, which is not attributed to any subsystem. */
+      int scope_max = 0;
+      size_t scope_mem_max = 0;
+      for (int scope = 1; scope < MEM_scope_num(); scope++) {
+        const size_t scope_mem = MEM_get_scope_memory_in_use(scope);
+        if (scope_mem > scope_mem_max) {
+          scope_max = scope;
+          scope_mem_max = scope_mem;
+        }
+      }
+      if (scope_max != 0) {
+        BLI_str_format_byte_unit(formatted_mem, scope_mem_max, false);
+        ofs += BLI_snprintf_rlen(
+            info + ofs, len - ofs, " (%s: %s)", MEM_scope_name(scope_max), formatted_mem);
+      }
+    }
   }
 
   /* GPU VRAM status. */
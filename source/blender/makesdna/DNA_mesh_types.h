@@ -103,6 +103,15 @@ typedef struct Mesh_Runtime {
   /** Non-manifold boundary data for Shrinkwrap Target Project. */
   struct ShrinkwrapBoundaryData *shrinkwrap_data;
 
+  /** Topology maps and normals computed on demand, see #BKE_mesh_runtime_vert_edge_map_ensure. */
+  struct MeshDerivedCache *derived_cache;
+  /**
+   * Incremented when the topology or the vertex positions change,
+   * data in #derived_cache computed for older versions is recomputed on access.
+   */
+  int topology_version;
+  int positions_version;
+
   /** Set by modifier stack if only deformed from original. */
   char deformed_only;
   /**
@@ -173,6 +173,7 @@ typedef enum {
   eSubsurfModifierFlag_UseCrease = (1 << 4),
   eSubsurfModifierFlag_UseCustomNormals = (1 << 5),
   eSubsurfModifierFlag_UseRecursiveSubdivision = (1 << 6),
+  eSubsurfModifierFlag_UseAdaptiveLevel = (1 << 7),
 } SubsurfModifierFlag;
 
 typedef enum {
@@ -202,6 +203,9 @@ typedef struct SubsurfModifierData {
   short quality;
   short boundary_smooth;
   char _pad[2];
+  /** Target size of subdivided edges in pixels, for #eSubsurfModifierFlag_UseAdaptiveLevel. */
+  float dicing_rate;
+  char _pad1[4];
 
   /* TODO(sergey): Get rid of those with the old CCG subdivision code. */
   void *emCache, *mCache;
@@ -918,6 +922,7 @@ enum {
   eBooleanModifierFlag_Object = (1 << 1),
   eBooleanModifierFlag_Collection = (1 << 2),
   eBooleanModifierFlag_HoleTolerant = (1 << 3),
+  eBooleanModifierFlag_Incremental = (1 << 4),
 };
 
 /* bm_flag only used when G_DEBUG. */
@@ -1718,6 +1718,22 @@ static void rna_def_modifier_subsurf(BlenderRNA *brna)
                            "levels of subdivision (smoothest possible shape)");
   RNA_def_property_update(prop, 0, "rna_Modifier_update");
 
+  prop = RNA_def_property(srna, "use_adaptive_levels", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flags", eSubsurfModifierFlag_UseAdaptiveLevel);
+  RNA_def_property_ui_text(prop,
+                           "Adaptive Levels",
+                           "Lower the number of subdivisions based on the size of the object's "
+                           "edges as seen from the scene camera, using levels as the maximum");
+  RNA_def_property_update(prop, 0, "rna_Modifier_dependency_update");
+
+  prop = RNA_def_property(srna, "dicing_rate", PROP_FLOAT, PROP_PIXEL);
+  RNA_def_property_float_sdna(prop, NULL, "dicing_rate");
+  RNA_def_property_range(prop, 0.1f, FLT_MAX);
+  RNA_def_property_ui_range(prop, 0.5f, 1000.0f, 10, 2);
+  RNA_def_property_ui_text(
+      prop, "Dicing Rate", "Target size of subdivided edges in pixels for adaptive levels");
+  RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
   RNA_define_lib_overridable(false);
 }
 
@@ -2754,6 +2770,15 @@ static void rna_def_modifier_boolean(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Hole Tolerant", "Better results when there are holes (slower)");
   RNA_def_property_update(prop, 0, "rna_Modifier_update");
 
+  prop = RNA_def_property(srna, "use_incremental", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", eBooleanModifierFlag_Incremental);
+  RNA_def_property_ui_text(prop,
+                           "Incremental",
+                           "Keep intersection data of this mesh between evaluations, and only "
+                           "recompute the part near the operand object (faster when only the "
+                           "operand changes, uses more memory)");
+  RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
   /* BMesh debugging options, only used when G_DEBUG is set */
 
   /* BMesh intersection options */
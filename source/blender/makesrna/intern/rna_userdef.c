@@ -4910,6 +4910,12 @@ static void rna_def_userdef_view(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Show Memory", "Show Blender memory usage");
   RNA_def_property_update(prop, NC_SPACE | ND_SPACE_INFO, "rna_userdef_update");
 
+  prop = RNA_def_property(srna, "show_statusbar_memory_scopes", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "statusbar_flag", STATUSBAR_SHOW_MEMORY_SCOPES);
+  RNA_def_property_ui_text(
+      prop, "Show Memory Scopes", "Show the subsystem using the most memory next to the total");
+  RNA_def_property_update(prop, NC_SPACE | ND_SPACE_INFO, "rna_userdef_update");
+
   prop = RNA_def_property(srna, "show_statusbar_vram", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "statusbar_flag", STATUSBAR_SHOW_VRAM);
   RNA_def_property_ui_text(prop, "Show VRAM", "Show GPU video memory usage");
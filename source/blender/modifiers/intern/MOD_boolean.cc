@@ -446,6 +446,22 @@ static Mesh *exact_boolean_mesh(BooleanModifierData *bmd,
 
   const bool use_self = (bmd->flag & eBooleanModifierFlag_Self) != 0;
   const bool hole_tolerant = (bmd->flag & eBooleanModifierFlag_HoleTolerant) != 0;
+  if ((bmd->flag & eBooleanModifierFlag_Object) && (bmd->flag & eBooleanModifierFlag_Incremental) &&
+      !use_self && !hole_tolerant) {
+    /* Keep the intersection data of this mesh, which is reused as long as only the operand
+     * changes. The local intersection does not support hole tolerant classification, the full
+     * boolean is used for it. */
+    if (bmd->modifier.runtime == nullptr) {
+      bmd->modifier.runtime = blender::meshintersect::direct_mesh_boolean_cache_new();
+    }
+    return blender::meshintersect::direct_mesh_boolean_cached(
+        static_cast<blender::meshintersect::DirectBooleanCache *>(bmd->modifier.runtime),
+        meshes,
+        obmats,
+        *(float4x4 *)&ctx->object->obmat,
+        material_remaps,
+        bmd->operation);
+  }
   return blender::meshintersect::direct_mesh_boolean(meshes,
                                                      obmats,
                                                      *(float4x4 *)&ctx->object->obmat,
@@ -456,6 +472,21 @@ static Mesh *exact_boolean_mesh(BooleanModifierData *bmd,
 }
 #endif
 
+static void freeRuntimeData(void *runtime_data)
+{
+  if (runtime_data == nullptr) {
+    return;
+  }
+  blender::meshintersect::direct_mesh_boolean_cache_free(
+      static_cast<blender::meshintersect::DirectBooleanCache *>(runtime_data));
+}
+
+static void freeData(ModifierData *md)
+{
+  freeRuntimeData(md->runtime);
+  md->runtime = nullptr;
+}
+
 static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *mesh)
 {
   BooleanModifierData *bmd = (BooleanModifierData *)md;
@@ -596,6 +627,9 @@ static void solver_options_panel_draw(const bContext *UNUSED(C), Panel *panel)
     /* When operand is collection, we always use_self. */
     if (RNA_enum_get(ptr, "operand_type") == eBooleanModifierFlag_Object) {
       uiItemR(col, ptr, "use_self", 0, nullptr, ICON_NONE);
+      uiLayout *row = uiLayoutRow(col, true);
+      uiLayoutSetActive(row, !RNA_boolean_get(ptr, "use_self"));
+      uiItemR(row, ptr, "use_incremental", 0, nullptr, ICON_NONE);
     }
     uiItemR(col, ptr, "use_hole_tolerant", 0, nullptr, ICON_NONE);
   }
@@ -637,14 +671,14 @@ ModifierTypeInfo modifierType_Boolean = {
 
     /* initData */ initData,
     /* requiredDataMask */ requiredDataMask,
-    /* freeData */ nullptr,
+    /* freeData */ freeData,
     /* isDisabled */ isDisabled,
     /* updateDepsgraph */ updateDepsgraph,
     /* dependsOnTime */ nullptr,
     /* dependsOnNormals */ nullptr,
     /* foreachIDLink */ foreachIDLink,
     /* foreachTexLink */ nullptr,
-    /* freeRuntimeData */ nullptr,
+    /* freeRuntimeData */ freeRuntimeData,
     /* panelRegister */ panelRegister,
     /* blendWrite */ nullptr,
     /* blendRead */ nullptr,
@@ -136,8 +136,7 @@ static void deformVerts(ModifierData *md,
     float current_time = 0;
     uint mvert_num = 0;
 
-    BKE_mesh_vert_coords_apply(mesh_src, vertexCos);
-    BKE_mesh_calc_normals(mesh_src);
+    BKE_mesh_vert_coords_apply_and_calc_normals(mesh_src, vertexCos);
 
     current_time = DEG_get_ctime(ctx->depsgraph);
 
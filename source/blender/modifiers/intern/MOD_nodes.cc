@@ -1035,6 +1035,8 @@ static void modifyGeometry(ModifierData *md,
     return;
   }
 
+  MEM_ScopeGuard mem_scope("Geometry Nodes");
+
   check_property_socket_sync(ctx->object, md);
 
   NodeTreeRefMap tree_refs;
@@ -171,8 +171,7 @@ static void deformVerts(ModifierData *md,
 
   /* make new mesh */
   psmd->mesh_final = BKE_mesh_copy_for_eval(mesh_src, false);
-  BKE_mesh_vert_coords_apply(psmd->mesh_final, vertexCos);
-  BKE_mesh_calc_normals(psmd->mesh_final);
+  BKE_mesh_vert_coords_apply_and_calc_normals(psmd->mesh_final, vertexCos);
 
   BKE_mesh_tessface_ensure(psmd->mesh_final);
 
@@ -27,16 +27,21 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_alloca.h"
+#include "BLI_math.h"
+#include "BLI_rect.h"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.h"
 
 #include "DNA_defaults.h"
 #include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
 #include "DNA_screen_types.h"
 
+#include "BKE_camera.h"
 #include "BKE_context.h"
 #include "BKE_mesh.h"
 #include "BKE_scene.h"
@@ -55,6 +60,7 @@
 #include "RNA_access.h"
 
 #include "DEG_depsgraph.h"
+#include "DEG_depsgraph_build.h"
 #include "DEG_depsgraph_query.h"
 
 #include "MOD_modifiertypes.h"
@@ -145,6 +151,66 @@ static bool isDisabled(const Scene *scene, ModifierData *md, bool useRenderParam
   return get_render_subsurf_level(&scene->r, levels, useRenderParams != 0) == 0;
 }
 
+/* Fraction of the edges which are not larger than the dicing rate at the adaptive level. The few
+ * longest or closest edges do not force the maximum level for the whole mesh. */
+#define SUBDIV_ADAPTIVE_EDGES_FRACTION 0.9f
+
+/* Lowest level at which most subdivided edges of the mesh are not larger than the dicing rate
+ * when seen from the scene camera, similar to the dicing of Cycles. The whole mesh uses the same
+ * level, so that the result is free of cracks. */
+static int subdiv_adaptive_level_get(const SubsurfModifierData *smd,
+                                     const ModifierEvalContext *ctx,
+                                     const Mesh *mesh,
+                                     const int max_level)
+{
+  Scene *scene = DEG_get_evaluated_scene(ctx->depsgraph);
+  Object *camera = scene->camera;
+  if (camera == NULL || max_level == 0 || mesh->totedge == 0) {
+    return max_level;
+  }
+  const int winx = max_ii(scene->r.xsch * scene->r.size / 100, 1);
+  const int winy = max_ii(scene->r.ysch * scene->r.size / 100, 1);
+  CameraParams params;
+  BKE_camera_params_init(&params);
+  BKE_camera_params_from_object(&params, camera);
+  BKE_camera_params_compute_viewplane(&params, winx, winy, scene->r.xasp, scene->r.yasp);
+  /* Size of a pixel in world space. For perspective cameras this is the size at unit distance
+   * from the camera, which is then scaled by the distance of the edge. */
+  const float pixel_size = params.is_ortho ? params.viewdx : params.viewdx / params.clip_start;
+  const float edge_target_size = pixel_size * max_ff(smd->dicing_rate, 0.1f);
+  const float *camera_location = camera->obmat[3];
+
+  /* Number of edges which need every level, so that their subdivided edges are not larger than
+   * the target size. */
+  int *num_edges_of_level = BLI_array_alloca(num_edges_of_level, max_level + 1);
+  memset(num_edges_of_level, 0, sizeof(*num_edges_of_level) * (max_level + 1));
+  const MVert *mvert = mesh->mvert;
+  const MEdge *medge = mesh->medge;
+  for (int i = 0; i < mesh->totedge; i++) {
+    float co_1[3], co_2[3], center[3];
+    mul_v3_m4v3(co_1, ctx->object->obmat, mvert[medge[i].v1].co);
+    mul_v3_m4v3(co_2, ctx->object->obmat, mvert[medge[i].v2].co);
+    mid_v3_v3v3(center, co_1, co_2);
+    float target_size = edge_target_size;
+    if (!params.is_ortho) {
+      target_size *= max_ff(len_v3v3(center, camera_location), params.clip_start);
+    }
+    const float segments = max_ff(len_v3v3(co_1, co_2) / target_size, 1.0f);
+    /* Every level doubles the number of segments of an edge. */
+    const int level = clamp_i((int)ceilf(log2f(segments)), 0, max_level);
+    num_edges_of_level[level]++;
+  }
+  const int num_edges_needed = (int)ceilf(mesh->totedge * SUBDIV_ADAPTIVE_EDGES_FRACTION);
+  int num_edges_satisfied = 0;
+  for (int level = 0; level < max_level; level++) {
+    num_edges_satisfied += num_edges_of_level[level];
+    if (num_edges_satisfied >= num_edges_needed) {
+      return level;
+    }
+  }
+  return max_level;
+}
+
 static int subdiv_levels_for_modifier_get(const SubsurfModifierData *smd,
                                           const ModifierEvalContext *ctx)
 {
@@ -189,9 +255,13 @@ static Subdiv *subdiv_descriptor_ensure(SubsurfModifierData *smd,
 
 static void subdiv_mesh_settings_init(SubdivToMeshSettings *settings,
                                       const SubsurfModifierData *smd,
-                                      const ModifierEvalContext *ctx)
+                                      const ModifierEvalContext *ctx,
+                                      const Mesh *mesh)
 {
-  const int level = subdiv_levels_for_modifier_get(smd, ctx);
+  int level = subdiv_levels_for_modifier_get(smd, ctx);
+  if (smd->flags & eSubsurfModifierFlag_UseAdaptiveLevel) {
+    level = subdiv_adaptive_level_get(smd, ctx, mesh, level);
+  }
   settings->resolution = (1 << level) + 1;
   settings->use_optimal_display = (smd->flags & eSubsurfModifierFlag_ControlEdges) &&
                                   !(ctx->flag & MOD_APPLY_TO_BASE_MESH);
@@ -204,7 +274,7 @@ static Mesh *subdiv_as_mesh(SubsurfModifierData *smd,
 {
   Mesh *result = mesh;
   SubdivToMeshSettings mesh_settings;
-  subdiv_mesh_settings_init(&mesh_settings, smd, ctx);
+  subdiv_mesh_settings_init(&mesh_settings, smd, ctx, mesh);
   if (mesh_settings.resolution < 3) {
     return result;
   }
@@ -218,6 +288,8 @@ static void subdiv_ccg_settings_init(SubdivToCCGSettings *settings,
                                      const SubsurfModifierData *smd,
                                      const ModifierEvalContext *ctx)
 {
+  /* Adaptive levels are not used for CCG, its resolution has to stay the same for sculpting
+   * and multires regardless of the camera. */
   const int level = subdiv_levels_for_modifier_get(smd, ctx);
   settings->resolution = (1 << level) + 1;
   settings->need_normal = true;
@@ -302,6 +374,18 @@ static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *
   return result;
 }
 
+static void updateDepsgraph(ModifierData *md, const ModifierUpdateDepsgraphContext *ctx)
+{
+  SubsurfModifierData *smd = (SubsurfModifierData *)md;
+  if ((smd->flags & eSubsurfModifierFlag_UseAdaptiveLevel) && ctx->scene->camera != NULL) {
+    DEG_add_object_relation(
+        ctx->node, ctx->scene->camera, DEG_OB_COMP_TRANSFORM, "Subdivision Adaptive Levels");
+    DEG_add_object_relation(
+        ctx->node, ctx->scene->camera, DEG_OB_COMP_PARAMETERS, "Subdivision Adaptive Levels");
+    DEG_add_modifier_to_transform_relation(ctx->node, "Subdivision Adaptive Levels");
+  }
+}
+
 static void deformMatrices(ModifierData *md,
                            const ModifierEvalContext *ctx,
                            Mesh *mesh,
@@ -426,6 +510,12 @@ static void panel_draw(const bContext *C, Panel *panel)
     uiLayout *col = uiLayoutColumn(layout, true);
     uiItemR(col, ptr, "levels", 0, IFACE_("Levels Viewport"), ICON_NONE);
     uiItemR(col, ptr, "render_levels", 0, IFACE_("Render"), ICON_NONE);
+
+    col = uiLayoutColumn(layout, false);
+    uiItemR(col, ptr, "use_adaptive_levels", 0, NULL, ICON_NONE);
+    uiLayout *sub = uiLayoutColumn(col, false);
+    uiLayoutSetActive(sub, RNA_boolean_get(ptr, "use_adaptive_levels"));
+    uiItemR(sub, ptr, "dicing_rate", 0, NULL, ICON_NONE);
   }
 
   uiItemR(layout, ptr, "show_only_control_edges", 0, NULL, ICON_NONE);
@@ -509,7 +599,7 @@ ModifierTypeInfo modifierType_Subsurf = {
     /* requiredDataMask */ requiredDataMask,
     /* freeData */ freeData,
     /* isDisabled */ isDisabled,
-    /* updateDepsgraph */ NULL,
+    /* updateDepsgraph */ updateDepsgraph,
     /* dependsOnTime */ NULL,
     /* dependsOnNormals */ dependsOnNormals,
     /* foreachIDLink */ NULL,
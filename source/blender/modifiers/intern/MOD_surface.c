@@ -145,8 +145,7 @@ static void deformVerts(ModifierData *md,
     float *vec;
     MVert *x, *v;
 
-    BKE_mesh_vert_coords_apply(surmd->mesh, vertexCos);
-    BKE_mesh_calc_normals(surmd->mesh);
+    BKE_mesh_vert_coords_apply_and_calc_normals(surmd->mesh, vertexCos);
 
     numverts = surmd->mesh->totvert;
 
@@ -47,6 +47,8 @@
 
 #include "BLI_utildefines.h"
 
+#include "MEM_guardedalloc.h"
+
 #include "BKE_appdir.h"
 #include "BKE_blender_version.h"
 #include "BKE_global.h"
@@ -350,6 +352,24 @@ static PyObject *bpy_app_preview_render_size_get(PyObject *UNUSED(self), void *c
   return PyLong_FromLong((long)UI_icon_preview_to_render_size(POINTER_AS_INT(closure)));
 }
 
+PyDoc_STRVAR(bpy_app_memory_scopes_doc,
+             "Memory usage per subsystem, a dictionary mapping scope names to "
+             "(memory in use, peak memory) tuples in bytes (read-only)");
+static PyObject *bpy_app_memory_scopes_get(PyObject *UNUSED(self), void *UNUSED(closure))
+{
+  PyObject *ret = PyDict_New();
+  const int scope_num = MEM_scope_num();
+  for (int scope = 0; scope < scope_num; scope++) {
+    PyObject *item = PyTuple_New(2);
+    PyTuple_SET_ITEMS(item,
+                      PyLong_FromSize_t(MEM_get_scope_memory_in_use(scope)),
+                      PyLong_FromSize_t(MEM_get_scope_peak_memory(scope)));
+    PyDict_SetItemString(ret, MEM_scope_name(scope), item);
+    Py_DECREF(item);
+  }
+  return ret;
+}
+
 static PyObject *bpy_app_autoexec_fail_message_get(PyObject *UNUSED(self), void *UNUSED(closure))
 {
   return PyC_UnicodeFromByte(G.autoexec_fail);
@@ -439,6 +459,7 @@ static PyGetSetDef bpy_app_getsets[] = {
      NULL},
     {"tempdir", bpy_app_tempdir_get, NULL, bpy_app_tempdir_doc, NULL},
     {"driver_namespace", bpy_app_driver_dict_get, NULL, bpy_app_driver_dict_doc, NULL},
+    {"memory_scopes", bpy_app_memory_scopes_get, NULL, bpy_app_memory_scopes_doc, NULL},
 
     {"render_icon_size",
      bpy_app_preview_render_size_get,
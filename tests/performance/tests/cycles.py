@@ -51,6 +51,94 @@ def _run(args):
     return None
 
 
+def _run_variant(args):
+    import bpy
+
+    # Some variants are debug options, only used when the debug UI is enabled.
+    prefs = bpy.context.preferences
+    for group, overrides in args['preferences'].items():
+        for prop, value in overrides.items():
+            setattr(getattr(prefs, group), prop, value)
+
+    scene = bpy.context.scene
+    scene.render.engine = 'CYCLES'
+    scene.cycles.device = 'CPU'
+
+    # Render for fixed amount of time, so the variants are compared by the time
+    # per sample, or by the noise that can be achieved in the same time.
+    scene.cycles.use_adaptive_sampling = False
+    scene.cycles.samples = 16384
+    scene.cycles.time_limit = 10.0
+
+    for prop, value in args['cycles'].items():
+        setattr(scene.cycles, prop, value)
+
+    if not args['measure_noise']:
+        scene.render.filepath = args['render_filepath'] + '.png'
+        scene.render.image_settings.file_format = 'PNG'
+        bpy.ops.render.render(write_still=True)
+        return None
+
+    import numpy
+
+    scene.render.image_settings.file_format = 'OPEN_EXR'
+    scene.render.image_settings.color_depth = '32'
+    scene.cycles.use_animated_seed = False
+    scene.cycles.use_denoising = False
+
+    # Two renders with different seeds, the difference between them is only
+    # noise. Its standard deviation is sqrt(2) times that of a single render.
+    pixels = []
+    for seed in range(2):
+        filepath = f"{args['render_filepath']}_{seed}.exr"
+        scene.cycles.seed = seed
+        scene.render.filepath = filepath
+        bpy.ops.render.render(write_still=True)
+
+        image = bpy.data.images.load(filepath)
+        pixels.append(numpy.array(image.pixels[:]).reshape(-1, 4)[:, :3])
+        bpy.data.images.remove(image)
+
+    rmse = numpy.sqrt(numpy.mean(numpy.square(pixels[0] - pixels[1])))
+    print(f"Noise: {rmse / numpy.sqrt(2.0)}")
+
+    return None
+
+
+def _parse_render_output(lines):
+    # Parse render time and memory from output
+    prefix_time = "Render time (without synchronization): "
+    prefix_memory = "Peak: "
+    prefix_time_per_sample = "Average time per sample: "
+    time = None
+    time_per_sample = None
+    memory = None
+    for line in lines:
+        line = line.strip()
+        offset = line.find(prefix_time)
+        if offset != -1:
+            time = line[offset + len(prefix_time):]
+            time = float(time)
+        offset = line.find(prefix_time_per_sample)
+        if offset != -1:
+            time_per_sample = line[offset + len(prefix_time_per_sample):]
+            time_per_sample = time_per_sample.split()[0]
+            time_per_sample = float(time_per_sample)
+        offset = line.find(prefix_memory)
+        if offset != -1:
+            memory = line[offset + len(prefix_memory):]
+            memory = memory.split()[0].replace(',', '')
+            memory = float(memory)
+
+    if time_per_sample:
+        time = time_per_sample
+
+    if not (time and memory):
+        raise Exception("Error parsing render time output")
+
+    return time, memory
+
+
 class CyclesTest(api.Test):
     def __init__(self, filepath):
         self.filepath = filepath
@@ -74,39 +162,79 @@ class CyclesTest(api.Test):
 
         _, lines = env.run_in_blender(_run, args, ['--debug-cycles', '--verbose', '2', self.filepath])
 
-        # Parse render time from output
-        prefix_time = "Render time (without synchronization): "
-        prefix_memory = "Peak: "
-        prefix_time_per_sample = "Average time per sample: "
-        time = None
-        time_per_sample = None
-        memory = None
-        for line in lines:
-            line = line.strip()
-            offset = line.find(prefix_time)
-            if offset != -1:
-                time = line[offset + len(prefix_time):]
-                time = float(time)
-            offset = line.find(prefix_time_per_sample)
-            if offset != -1:
-                time_per_sample = line[offset + len(prefix_time_per_sample):]
-                time_per_sample = time_per_sample.split()[0]
-                time_per_sample = float(time_per_sample)
-            offset = line.find(prefix_memory)
-            if offset != -1:
-                memory = line[offset + len(prefix_memory):]
-                memory = memory.split()[0].replace(',', '')
-                memory = float(memory)
-
-        if time_per_sample:
-            time = time_per_sample
-
-        if not (time and memory):
-            raise Exception("Error parsing render time output")
-
+        time, memory = _parse_render_output(lines)
         return {'time': time, 'peak_memory': memory}
 
 
+class CyclesVariantTest(CyclesTest):
+    # Compare a Cycles option on the CPU, by overriding scene.cycles and
+    # preferences settings given as {'cycles': {...}, 'preferences': {group: {...}}}.
+    def __init__(self, filepath, name_suffix, category, settings, measure_noise=False):
+        super().__init__(filepath)
+        self.name_suffix = name_suffix
+        self.category_name = category
+        self.settings = settings
+        self.measure_noise = measure_noise
+
+    def name(self):
+        return f"{self.filepath.stem}_{self.name_suffix}"
+
+    def category(self):
+        return self.category_name
+
+    def use_device(self):
+        return False
+
+    def run(self, env, device_id):
+        args = {'cycles': self.settings.get('cycles', {}),
+                'preferences': self.settings.get('preferences', {}),
+                'measure_noise': self.measure_noise,
+                'render_filepath': str(env.log_file.parent / env.log_file.stem)}
+
+        _, lines = env.run_in_blender(_run_variant, args, ['--debug-cycles', '--verbose', '2', self.filepath])
+
+        time, memory = _parse_render_output(lines)
+        result = {'time': time, 'peak_memory': memory}
+
+        if self.measure_noise:
+            prefix_noise = "Noise: "
+            noise = None
+            for line in lines:
+                line = line.strip()
+                if line.startswith(prefix_noise):
+                    noise = float(line[len(prefix_noise):])
+
+            if noise is None:
+                raise Exception("Error parsing noise output")
+
+            result['noise'] = noise
+
+        return result
+
+
+def _variant_tests(filepath):
+    bvh_debug_prefs = {'experimental': {'use_cycles_debug': True}, 'view': {'show_developer_ui': True}}
+    return [
+        # Noise after a fixed render time with and without the light tree.
+        CyclesVariantTest(filepath, 'light_distribution', 'cycles_light_tree',
+                          {'cycles': {'use_light_tree': False}}, measure_noise=True),
+        CyclesVariantTest(filepath, 'light_tree', 'cycles_light_tree',
+                          {'cycles': {'use_light_tree': True}}, measure_noise=True),
+        # Render time of the CPU BVH layouts.
+        CyclesVariantTest(filepath, 'bvh2', 'cycles_bvh_layout',
+                          {'cycles': {'debug_bvh_layout': 'BVH2'}, 'preferences': bvh_debug_prefs}),
+        CyclesVariantTest(filepath, 'bvh4', 'cycles_bvh_layout',
+                          {'cycles': {'debug_bvh_layout': 'BVH4'}, 'preferences': bvh_debug_prefs}),
+        # Render time of the CPU megakernel and wavefront integrators.
+        CyclesVariantTest(filepath, 'megakernel', 'cycles_cpu_wavefront',
+                          {'cycles': {'debug_use_cpu_wavefront': False}}),
+        CyclesVariantTest(filepath, 'wavefront', 'cycles_cpu_wavefront',
+                          {'cycles': {'debug_use_cpu_wavefront': True}}),
+    ]
+
+
 def generate(env):
     filepaths = env.find_blend_files('cycles/*')
-    return [CyclesTest(filepath) for filepath in filepaths]
+    tests = [CyclesTest(filepath) for filepath in filepaths]
+    tests += [test for filepath in filepaths for test in _variant_tests(filepath)]
+    return tests
@@ -0,0 +1,125 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --factory-startup --python tests/python/cycles_svm_specialization_test.py -- --verbose
+#
+# Render a surface shader made of nodes handled by the specialized SVM interpreter loop, with and
+# without the specialization, and check both renders match.
+
+import os
+import tempfile
+import unittest
+
+import bpy
+
+
+def create_specialized_material():
+    # Only nodes listed in svm_surface_bsdf_nodes.h, without bump, so that the shader is evaluated
+    # with the specialized loop.
+    material = bpy.data.materials.new("SVMSpecialization")
+    material.use_nodes = True
+    nodes = material.node_tree.nodes
+    links = material.node_tree.links
+    nodes.clear()
+
+    image = bpy.data.images.new("SVMSpecializationGrid", 64, 64)
+    image.generated_type = 'COLOR_GRID'
+
+    tex_coord = nodes.new('ShaderNodeTexCoord')
+    mapping = nodes.new('ShaderNodeMapping')
+    mapping.inputs['Scale'].default_value = (2.0, 3.0, 1.0)
+    tex_image = nodes.new('ShaderNodeTexImage')
+    tex_image.image = image
+    hsv = nodes.new('ShaderNodeHueSaturation')
+    hsv.inputs['Hue'].default_value = 0.3
+    math = nodes.new('ShaderNodeMath')
+    math.operation = 'MULTIPLY'
+    math.inputs[1].default_value = 0.5
+    diffuse = nodes.new('ShaderNodeBsdfDiffuse')
+    glossy = nodes.new('ShaderNodeBsdfGlossy')
+    layer_weight = nodes.new('ShaderNodeLayerWeight')
+    mix_shader = nodes.new('ShaderNodeMixShader')
+    emission = nodes.new('ShaderNodeEmission')
+    emission.inputs['Strength'].default_value = 0.2
+    add_shader = nodes.new('ShaderNodeAddShader')
+    output = nodes.new('ShaderNodeOutputMaterial')
+
+    links.new(tex_coord.outputs['UV'], mapping.inputs['Vector'])
+    links.new(mapping.outputs['Vector'], tex_image.inputs['Vector'])
+    links.new(tex_image.outputs['Color'], hsv.inputs['Color'])
+    links.new(hsv.outputs['Color'], diffuse.inputs['Color'])
+    links.new(tex_image.outputs['Alpha'], math.inputs[0])
+    links.new(math.outputs['Value'], glossy.inputs['Roughness'])
+    links.new(tex_image.outputs['Color'], emission.inputs['Color'])
+    links.new(layer_weight.outputs['Facing'], mix_shader.inputs['Fac'])
+    links.new(diffuse.outputs['BSDF'], mix_shader.inputs[1])
+    links.new(glossy.outputs['BSDF'], mix_shader.inputs[2])
+    links.new(mix_shader.outputs['Shader'], add_shader.inputs[0])
+    links.new(emission.outputs['Emission'], add_shader.inputs[1])
+    links.new(add_shader.outputs['Shader'], output.inputs['Surface'])
+
+    return material
+
+
+class TestSVMSpecialization(unittest.TestCase):
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=False)
+
+        # The debug flags are only passed to Cycles with the debug preferences enabled.
+        prefs = bpy.context.preferences
+        prefs.experimental.use_cycles_debug = True
+        prefs.view.show_developer_ui = True
+
+        scene = bpy.context.scene
+        scene.render.engine = 'CYCLES'
+        scene.render.resolution_x = 64
+        scene.render.resolution_y = 64
+        scene.render.resolution_percentage = 100
+        scene.render.image_settings.file_format = 'OPEN_EXR'
+        scene.render.image_settings.color_depth = '32'
+        scene.cycles.device = 'CPU'
+        scene.cycles.samples = 8
+        scene.cycles.use_adaptive_sampling = False
+        scene.cycles.use_denoising = False
+        scene.cycles.seed = 1
+
+        cube = bpy.data.objects['Cube']
+        cube.data.materials.clear()
+        cube.data.materials.append(create_specialized_material())
+
+        self.tempdir = tempfile.TemporaryDirectory()
+
+    def tearDown(self):
+        self.tempdir.cleanup()
+
+    def render(self, use_svm_specialization):
+        scene = bpy.context.scene
+        scene.cycles.debug_use_cpu_svm_specialization = use_svm_specialization
+
+        filepath = os.path.join(self.tempdir.name, "specialization_%d.exr" % use_svm_specialization)
+        scene.render.filepath = filepath
+        bpy.ops.render.render(write_still=True)
+
+        image = bpy.data.images.load(filepath)
+        pixels = image.pixels[:]
+        bpy.data.images.remove(image)
+        return pixels
+
+    def test_surface_bsdf(self):
+        specialized = self.render(True)
+        generic = self.render(False)
+
+        self.assertEqual(len(specialized), len(generic))
+        self.assertGreater(max(specialized), 0.0)
+
+        # Both loops call the same node functions, so only differences from code generation of
+        # the interpreter loops are expected. A node which is not evaluated changes the image as
+        # a whole, while rounding differences only change the path of a few pixels.
+        difference = sum(abs(a - b) for a, b in zip(specialized, generic)) / len(generic)
+        self.assertLess(difference, 1e-4)
+
+
+if __name__ == '__main__':
+    import sys
+
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()